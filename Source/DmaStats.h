@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Types.h"
+
+//Activity counters for a DMA channel, accumulated until they are cleared (usually on every frame)
+struct DMA_CHANNEL_STATS
+{
+	//Amount of data moved by the channel
+	uint32 qwordCount = 0;
+	//Number of chain tags fetched
+	uint32 tagCount = 0;
+	//Number of times a transfer was left unfinished because the device or the channel couldn't proceed
+	uint32 stallCount = 0;
+	//Number of times a stalled transfer made progress again
+	uint32 resumeCount = 0;
+	//Ticks spent with a stalled transfer
+	uint32 waitTicks = 0;
+};
@@ -1,6 +1,6 @@
 #include <cstring>
 #include "FrameDump.h"
-#include "states/MemoryStateFile.h"
+#include "FrameDumpStream.h"
 #include "states/RegisterStateFile.h"
 
 #define STATE_INITIAL_GSRAM "init/gsram"
@@ -78,6 +78,20 @@ void CFrameDump::Read(Framework::CStream& input)
 {
 	Reset();
 
+	if(FrameDumpStream::IsFrameDumpStream(input))
+	{
+		CFrameDumpStreamReader reader(input);
+		reader.ReadInitialState(*this);
+		uint32 packetCount = reader.GetPacketCount();
+		m_packets.reserve(packetCount);
+		for(uint32 packetIndex = 0; packetIndex < packetCount; packetIndex++)
+		{
+			m_packets.push_back(reader.ReadPacket(packetIndex));
+		}
+		return;
+	}
+
+	//Legacy zip archive format
 	Framework::CZipArchiveReader archive(input);
 
 	archive.BeginReadFile(STATE_INITIAL_GSRAM)->Read(m_initialGsRam, CGSHandler::RAMSIZE);
@@ -134,36 +148,20 @@ void CFrameDump::Read(Framework::CStream& input)
 
 void CFrameDump::Write(Framework::CStream& output) const
 {
-	Framework::CZipArchiveWriter archive;
-
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_INITIAL_GSRAM, m_initialGsRam, CGSHandler::RAMSIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_INITIAL_GSREGS, m_initialGsRegisters, sizeof(uint64) * CGSHandler::REGISTER_MAX));
-
-	{
-		auto privRegsStateFile = std::make_unique<CRegisterStateFile>(STATE_INITIAL_GSPRIVREGS);
-		privRegsStateFile->SetRegister64(STATE_PRIVREG_SMODE2, m_initialSMODE2);
-		archive.InsertFile(std::move(privRegsStateFile));
-	}
-
-	unsigned int currentPacket = 0;
+	CFrameDumpStreamWriter writer(output);
+	writer.WriteInitialState(m_initialGsRam, m_initialGsRegisters, m_initialSMODE2);
 	for(const auto& packet : m_packets)
 	{
-		auto packetMetadataFileName = STATE_PACKET_METADATA_PREFIX + std::to_string(currentPacket);
-		archive.InsertFile(std::make_unique<CMemoryStateFile>(packetMetadataFileName.c_str(), &packet.metadata, sizeof(CGsPacketMetadata)));
-		if(!packet.registerWrites.empty())
+		if(packet.registerWrites.empty())
 		{
-			auto packetRegisterWritesFileName = STATE_PACKET_REGISTERWRITES_PREFIX + std::to_string(currentPacket);
-			archive.InsertFile(std::make_unique<CMemoryStateFile>(packetRegisterWritesFileName.c_str(), packet.registerWrites.data(), packet.registerWrites.size() * sizeof(CGSHandler::RegisterWrite)));
+			writer.AddImagePacket(packet.imageData.data(), static_cast<uint32>(packet.imageData.size()));
 		}
-		if(!packet.imageData.empty())
+		else
 		{
-			auto packetImageDataName = STATE_PACKET_IMAGEDATA_PREFIX + std::to_string(currentPacket);
-			archive.InsertFile(std::make_unique<CMemoryStateFile>(packetImageDataName.c_str(), packet.imageData.data(), packet.imageData.size()));
+			writer.AddRegisterPacket(packet.registerWrites.data(), static_cast<uint32>(packet.registerWrites.size()), &packet.metadata);
 		}
-		currentPacket++;
 	}
-
-	archive.Write(output);
+	writer.Finish();
 }
 
 void CFrameDump::IdentifyDrawingKicks()
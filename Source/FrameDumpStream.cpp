@@ -0,0 +1,394 @@
+#include <cstring>
+#include <stdexcept>
+#include "FrameDumpStream.h"
+#include "zstd_zlibwrapper.h"
+#include "xxhash.h"
+
+using namespace FrameDumpStream;
+
+//Register writes are stored packed (register, value) to avoid writing struct padding
+static const uint32 g_packedRegisterWriteSize = sizeof(uint8) + sizeof(uint64);
+
+static const uint32 g_maxCachedSnapshots = 64;
+
+bool FrameDumpStream::IsFrameDumpStream(Framework::CStream& stream)
+{
+	FILE_HEADER header = {};
+	uint64 position = stream.Tell();
+	uint64 readSize = stream.Read(&header, sizeof(FILE_HEADER));
+	stream.Seek(position, Framework::STREAM_SEEK_SET);
+	return (readSize == sizeof(FILE_HEADER)) && (header.magic == FILE_MAGIC);
+}
+
+CFrameDumpStreamWriter::CFrameDumpStreamWriter(Framework::CStream& stream)
+    : m_stream(stream)
+{
+	FILE_HEADER header = {};
+	header.magic = FILE_MAGIC;
+	header.version = FILE_VERSION;
+	m_stream.Write(&header, sizeof(FILE_HEADER));
+}
+
+void CFrameDumpStreamWriter::WriteInitialState(const uint8* gsRam, const uint64* gsRegisters, uint64 smode2)
+{
+	static const uint32 registersSize = sizeof(uint64) * CGSHandler::REGISTER_MAX;
+
+	ByteArray initialState(CGSHandler::RAMSIZE + registersSize + sizeof(uint64));
+	memcpy(initialState.data(), gsRam, CGSHandler::RAMSIZE);
+	memcpy(initialState.data() + CGSHandler::RAMSIZE, gsRegisters, registersSize);
+	memcpy(initialState.data() + CGSHandler::RAMSIZE + registersSize, &smode2, sizeof(uint64));
+	WriteChunk(CHUNK_TYPE_INITIAL_STATE, initialState.data(), static_cast<uint32>(initialState.size()));
+}
+
+void CFrameDumpStreamWriter::AddRegisterPacket(const CGSHandler::RegisterWrite* registerWrites, uint32 count, const CGsPacketMetadata* metadata)
+{
+	assert(!m_finished);
+
+	PACKET_ENTRY packet = {};
+	packet.chunkOffset = static_cast<uint32>(m_packetChunk.size());
+	packet.registerWriteCount = count;
+	packet.vuStateChunkIndex = INVALID_CHUNK;
+	packet.vuMemChunkIndex = INVALID_CHUNK;
+	packet.microMemChunkIndex = INVALID_CHUNK;
+
+	if(metadata)
+	{
+		packet.pathIndex = metadata->pathIndex;
+#ifdef DEBUGGER_INCLUDED
+		packet.vuStateChunkIndex = WriteSnapshot(&metadata->vu1State, sizeof(MIPSSTATE));
+		packet.vuMemChunkIndex = WriteSnapshot(metadata->vuMem1, PS2::VUMEM1SIZE);
+		packet.microMemChunkIndex = WriteSnapshot(metadata->microMem1, PS2::MICROMEM1SIZE);
+		packet.vpu1Top = metadata->vpu1Top;
+		packet.vpu1Itop = metadata->vpu1Itop;
+		packet.vuMemPacketAddress = metadata->vuMemPacketAddress;
+#endif
+	}
+
+	m_packetChunk.resize(m_packetChunk.size() + (count * g_packedRegisterWriteSize));
+	uint8* output = m_packetChunk.data() + packet.chunkOffset;
+	for(uint32 i = 0; i < count; i++)
+	{
+		const auto& registerWrite = registerWrites[i];
+		output[0] = registerWrite.first;
+		memcpy(output + 1, &registerWrite.second, sizeof(uint64));
+		output += g_packedRegisterWriteSize;
+	}
+
+	m_packets.push_back(packet);
+
+	if(m_packetChunk.size() >= PACKET_CHUNK_SIZE_THRESHOLD)
+	{
+		FlushPacketChunk();
+	}
+}
+
+void CFrameDumpStreamWriter::AddImagePacket(const uint8* imageData, uint32 size)
+{
+	assert(!m_finished);
+
+	PACKET_ENTRY packet = {};
+	packet.chunkOffset = static_cast<uint32>(m_packetChunk.size());
+	packet.imageDataSize = size;
+	packet.vuStateChunkIndex = INVALID_CHUNK;
+	packet.vuMemChunkIndex = INVALID_CHUNK;
+	packet.microMemChunkIndex = INVALID_CHUNK;
+
+	m_packetChunk.insert(m_packetChunk.end(), imageData, imageData + size);
+	m_packets.push_back(packet);
+
+	if(m_packetChunk.size() >= PACKET_CHUNK_SIZE_THRESHOLD)
+	{
+		FlushPacketChunk();
+	}
+}
+
+void CFrameDumpStreamWriter::Finish()
+{
+	if(m_finished) return;
+
+	FlushPacketChunk();
+
+	ByteArray index(m_chunks.size() * sizeof(CHUNK_ENTRY) + m_packets.size() * sizeof(PACKET_ENTRY));
+	if(!m_chunks.empty())
+	{
+		memcpy(index.data(), m_chunks.data(), m_chunks.size() * sizeof(CHUNK_ENTRY));
+	}
+	if(!m_packets.empty())
+	{
+		memcpy(index.data() + m_chunks.size() * sizeof(CHUNK_ENTRY), m_packets.data(), m_packets.size() * sizeof(PACKET_ENTRY));
+	}
+
+	FILE_FOOTER footer = {};
+	footer.chunkCount = static_cast<uint32>(m_chunks.size());
+	footer.packetCount = static_cast<uint32>(m_packets.size());
+	footer.magic = FILE_MAGIC;
+
+	uint32 indexChunkIndex = WriteChunk(CHUNK_TYPE_INDEX, index.data(), static_cast<uint32>(index.size()));
+	footer.indexOffset = m_chunks[indexChunkIndex].offset;
+
+	m_stream.Write(&footer, sizeof(FILE_FOOTER));
+
+	m_finished = true;
+}
+
+uint32 CFrameDumpStreamWriter::GetPacketCount() const
+{
+	return static_cast<uint32>(m_packets.size());
+}
+
+uint32 CFrameDumpStreamWriter::WriteChunk(CHUNK_TYPE type, const void* data, uint32 size)
+{
+	uLongf compressedSize = compressBound(size);
+	ByteArray compressedData(compressedSize);
+	int result = compress2(compressedData.data(), &compressedSize, reinterpret_cast<const Bytef*>(data), size, Z_BEST_SPEED);
+	if(result != Z_OK)
+	{
+		throw std::runtime_error("Failed to compress frame dump chunk.");
+	}
+
+	CHUNK_ENTRY chunk = {};
+	chunk.offset = m_stream.Tell();
+	chunk.type = type;
+	chunk.compressedSize = static_cast<uint32>(compressedSize);
+	chunk.uncompressedSize = size;
+
+	CHUNK_HEADER header = {};
+	header.type = type;
+	header.compressedSize = chunk.compressedSize;
+	header.uncompressedSize = chunk.uncompressedSize;
+
+	m_stream.Write(&header, sizeof(CHUNK_HEADER));
+	m_stream.Write(compressedData.data(), compressedSize);
+
+	uint32 chunkIndex = static_cast<uint32>(m_chunks.size());
+	m_chunks.push_back(chunk);
+	return chunkIndex;
+}
+
+uint32 CFrameDumpStreamWriter::WriteSnapshot(const void* data, uint32 size)
+{
+	uint64 hash = XXH3_64bits(data, size);
+	auto snapshotIterator = m_snapshotChunks.find(hash);
+	if(snapshotIterator != std::end(m_snapshotChunks))
+	{
+		return snapshotIterator->second;
+	}
+	uint32 chunkIndex = WriteChunk(CHUNK_TYPE_VU_SNAPSHOT, data, size);
+	m_snapshotChunks.insert(std::make_pair(hash, chunkIndex));
+	return chunkIndex;
+}
+
+void CFrameDumpStreamWriter::FlushPacketChunk()
+{
+	uint32 packetCount = static_cast<uint32>(m_packets.size());
+	if(m_packetChunkFirstPacket == packetCount) return;
+
+	//Empty chunks are valid (ie.: a chunk containing only empty register packets)
+	uint32 chunkIndex = WriteChunk(CHUNK_TYPE_PACKETS, m_packetChunk.data(), static_cast<uint32>(m_packetChunk.size()));
+	for(uint32 i = m_packetChunkFirstPacket; i < packetCount; i++)
+	{
+		m_packets[i].chunkIndex = chunkIndex;
+	}
+
+	m_packetChunk.clear();
+	m_packetChunkFirstPacket = packetCount;
+}
+
+CFrameDumpStreamReader::CFrameDumpStreamReader(Framework::CStream& stream)
+    : m_stream(stream)
+{
+	FILE_HEADER header = {};
+	m_stream.Seek(0, Framework::STREAM_SEEK_SET);
+	m_stream.Read(&header, sizeof(FILE_HEADER));
+	if(header.magic != FILE_MAGIC)
+	{
+		throw std::runtime_error("Not a frame dump stream.");
+	}
+	if(header.version != FILE_VERSION)
+	{
+		throw std::runtime_error("Unsupported frame dump stream version.");
+	}
+
+	FILE_FOOTER footer = {};
+	m_stream.Seek(-static_cast<int64>(sizeof(FILE_FOOTER)), Framework::STREAM_SEEK_END);
+	m_stream.Read(&footer, sizeof(FILE_FOOTER));
+	if(footer.magic != FILE_MAGIC)
+	{
+		throw std::runtime_error("Frame dump stream is truncated.");
+	}
+
+	CHUNK_HEADER indexHeader = {};
+	m_stream.Seek(footer.indexOffset, Framework::STREAM_SEEK_SET);
+	m_stream.Read(&indexHeader, sizeof(CHUNK_HEADER));
+	if(indexHeader.type != CHUNK_TYPE_INDEX)
+	{
+		throw std::runtime_error("Invalid frame dump stream index.");
+	}
+
+	//The index chunk doesn't reference itself, build a temporary entry for it
+	CHUNK_ENTRY indexChunk = {};
+	indexChunk.offset = footer.indexOffset;
+	indexChunk.type = indexHeader.type;
+	indexChunk.compressedSize = indexHeader.compressedSize;
+	indexChunk.uncompressedSize = indexHeader.uncompressedSize;
+	m_chunks.push_back(indexChunk);
+	auto index = ReadChunk(0);
+	m_chunks.clear();
+
+	uint64 chunksSize = static_cast<uint64>(footer.chunkCount) * sizeof(CHUNK_ENTRY);
+	uint64 packetsSize = static_cast<uint64>(footer.packetCount) * sizeof(PACKET_ENTRY);
+	if(index.size() != (chunksSize + packetsSize))
+	{
+		throw std::runtime_error("Invalid frame dump stream index size.");
+	}
+
+	m_chunks.resize(footer.chunkCount);
+	m_packets.resize(footer.packetCount);
+	if(chunksSize != 0)
+	{
+		memcpy(m_chunks.data(), index.data(), chunksSize);
+	}
+	if(packetsSize != 0)
+	{
+		memcpy(m_packets.data(), index.data() + chunksSize, packetsSize);
+	}
+}
+
+void CFrameDumpStreamReader::ReadInitialState(CFrameDump& frameDump)
+{
+	static const uint32 registersSize = sizeof(uint64) * CGSHandler::REGISTER_MAX;
+
+	for(uint32 chunkIndex = 0; chunkIndex < m_chunks.size(); chunkIndex++)
+	{
+		if(m_chunks[chunkIndex].type != CHUNK_TYPE_INITIAL_STATE) continue;
+
+		auto initialState = ReadChunk(chunkIndex);
+		if(initialState.size() != (CGSHandler::RAMSIZE + registersSize + sizeof(uint64)))
+		{
+			throw std::runtime_error("Invalid frame dump stream initial state size.");
+		}
+
+		uint64 smode2 = 0;
+		memcpy(frameDump.GetInitialGsRam(), initialState.data(), CGSHandler::RAMSIZE);
+		memcpy(frameDump.GetInitialGsRegisters(), initialState.data() + CGSHandler::RAMSIZE, registersSize);
+		memcpy(&smode2, initialState.data() + CGSHandler::RAMSIZE + registersSize, sizeof(uint64));
+		frameDump.SetInitialSMODE2(smode2);
+		return;
+	}
+
+	throw std::runtime_error("Frame dump stream has no initial state.");
+}
+
+uint32 CFrameDumpStreamReader::GetPacketCount() const
+{
+	return static_cast<uint32>(m_packets.size());
+}
+
+CGsPacket CFrameDumpStreamReader::ReadPacket(uint32 packetIndex)
+{
+	assert(packetIndex < m_packets.size());
+	const auto& packetEntry = m_packets[packetIndex];
+
+	CGsPacket packet;
+	packet.metadata.pathIndex = packetEntry.pathIndex;
+
+	const auto& chunk = GetChunk(packetEntry.chunkIndex);
+	//Sizes come from the stream's index, compute in 64 bits so that bogus values can't wrap around
+	uint64 dataSize = (static_cast<uint64>(packetEntry.registerWriteCount) * g_packedRegisterWriteSize) + static_cast<uint64>(packetEntry.imageDataSize);
+	if((static_cast<uint64>(packetEntry.chunkOffset) + dataSize) > chunk.size())
+	{
+		throw std::runtime_error("Frame dump stream packet is out of chunk bounds.");
+	}
+
+	const uint8* input = chunk.data() + packetEntry.chunkOffset;
+	if(packetEntry.registerWriteCount != 0)
+	{
+		packet.registerWrites.resize(packetEntry.registerWriteCount);
+		for(auto& registerWrite : packet.registerWrites)
+		{
+			registerWrite.first = input[0];
+			memcpy(&registerWrite.second, input + 1, sizeof(uint64));
+			input += g_packedRegisterWriteSize;
+		}
+	}
+	else
+	{
+		packet.imageData = CGsPacket::ImageDataArray(input, input + packetEntry.imageDataSize);
+	}
+
+#ifdef DEBUGGER_INCLUDED
+	if(packetEntry.vuStateChunkIndex != INVALID_CHUNK)
+	{
+		//Copy snapshots one at a time, fetching one can evict the others from the cache
+		ReadSnapshot(packetEntry.vuStateChunkIndex, &packet.metadata.vu1State, sizeof(MIPSSTATE));
+		ReadSnapshot(packetEntry.vuMemChunkIndex, packet.metadata.vuMem1, PS2::VUMEM1SIZE);
+		ReadSnapshot(packetEntry.microMemChunkIndex, packet.metadata.microMem1, PS2::MICROMEM1SIZE);
+		packet.metadata.vpu1Top = packetEntry.vpu1Top;
+		packet.metadata.vpu1Itop = packetEntry.vpu1Itop;
+		packet.metadata.vuMemPacketAddress = packetEntry.vuMemPacketAddress;
+	}
+#endif
+
+	return packet;
+}
+
+void CFrameDumpStreamReader::ReadSnapshot(uint32 chunkIndex, void* output, uint32 size)
+{
+	const auto& snapshot = GetChunk(chunkIndex);
+	if(snapshot.size() != size)
+	{
+		throw std::runtime_error("Invalid frame dump stream VU snapshot size.");
+	}
+	memcpy(output, snapshot.data(), size);
+}
+
+const CFrameDumpStreamReader::ByteArray& CFrameDumpStreamReader::GetChunk(uint32 chunkIndex)
+{
+	if(chunkIndex >= m_chunks.size())
+	{
+		throw std::runtime_error("Invalid frame dump stream chunk index.");
+	}
+
+	if(m_chunks[chunkIndex].type == CHUNK_TYPE_VU_SNAPSHOT)
+	{
+		auto snapshotIterator = m_cachedSnapshots.find(chunkIndex);
+		if(snapshotIterator != std::end(m_cachedSnapshots))
+		{
+			return snapshotIterator->second;
+		}
+		if(m_cachedSnapshots.size() >= g_maxCachedSnapshots)
+		{
+			m_cachedSnapshots.clear();
+		}
+		return m_cachedSnapshots.insert(std::make_pair(chunkIndex, ReadChunk(chunkIndex))).first->second;
+	}
+
+	if(m_cachedPacketChunkIndex != chunkIndex)
+	{
+		m_cachedPacketChunk = ReadChunk(chunkIndex);
+		m_cachedPacketChunkIndex = chunkIndex;
+	}
+	return m_cachedPacketChunk;
+}
+
+CFrameDumpStreamReader::ByteArray CFrameDumpStreamReader::ReadChunk(uint32 chunkIndex)
+{
+	const auto& chunk = m_chunks[chunkIndex];
+
+	ByteArray compressedData(chunk.compressedSize);
+	m_stream.Seek(chunk.offset + sizeof(CHUNK_HEADER), Framework::STREAM_SEEK_SET);
+	if(m_stream.Read(compressedData.data(), chunk.compressedSize) != chunk.compressedSize)
+	{
+		throw std::runtime_error("Frame dump stream is truncated.");
+	}
+
+	ByteArray data(chunk.uncompressedSize);
+	uLongf uncompressedSize = chunk.uncompressedSize;
+	int result = uncompress(data.data(), &uncompressedSize, compressedData.data(), chunk.compressedSize);
+	if((result != Z_OK) || (uncompressedSize != chunk.uncompressedSize))
+	{
+		throw std::runtime_error("Failed to decompress frame dump chunk.");
+	}
+
+	return data;
+}
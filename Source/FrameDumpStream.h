@@ -0,0 +1,152 @@
+#pragma once
+
+#include <unordered_map>
+#include "Types.h"
+#include "Stream.h"
+#include "FrameDump.h"
+
+//Chunked frame dump format
+//-------------------------
+//File is made of a header, a sequence of compressed chunks, an index chunk and a footer.
+//Packets are appended to a packet chunk which is compressed and written to the stream when it
+//grows past a threshold, so captures don't need to be kept in memory. VU memory snapshots attached
+//to packets (debugger builds) are stored once per unique content and referenced by chunk index.
+//The index at the end of the file allows a reader to seek to any packet without decompressing
+//anything else than the chunk containing it.
+
+namespace FrameDumpStream
+{
+	enum
+	{
+		FILE_MAGIC = 0x44534750, //'PGSD'
+		FILE_VERSION = 1,
+		INVALID_CHUNK = ~0U,
+	};
+
+	enum CHUNK_TYPE
+	{
+		CHUNK_TYPE_INITIAL_STATE = 1,
+		CHUNK_TYPE_PACKETS = 2,
+		CHUNK_TYPE_VU_SNAPSHOT = 3,
+		CHUNK_TYPE_INDEX = 4,
+	};
+
+	struct FILE_HEADER
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 reserved[2];
+	};
+	static_assert(sizeof(FILE_HEADER) == 0x10, "FILE_HEADER must be 16 bytes.");
+
+	struct CHUNK_HEADER
+	{
+		uint32 type;
+		uint32 compressedSize;
+		uint32 uncompressedSize;
+		uint32 reserved;
+	};
+	static_assert(sizeof(CHUNK_HEADER) == 0x10, "CHUNK_HEADER must be 16 bytes.");
+
+	struct CHUNK_ENTRY
+	{
+		uint64 offset;
+		uint32 type;
+		uint32 compressedSize;
+		uint32 uncompressedSize;
+		uint32 reserved;
+	};
+	static_assert(sizeof(CHUNK_ENTRY) == 0x18, "CHUNK_ENTRY must be 24 bytes.");
+
+	struct PACKET_ENTRY
+	{
+		uint32 chunkIndex;
+		uint32 chunkOffset;
+		uint32 registerWriteCount;
+		uint32 imageDataSize;
+		uint32 pathIndex;
+		uint32 vuStateChunkIndex;
+		uint32 vuMemChunkIndex;
+		uint32 microMemChunkIndex;
+		uint32 vpu1Top;
+		uint32 vpu1Itop;
+		uint32 vuMemPacketAddress;
+		uint32 reserved;
+	};
+	static_assert(sizeof(PACKET_ENTRY) == 0x30, "PACKET_ENTRY must be 48 bytes.");
+
+	struct FILE_FOOTER
+	{
+		uint64 indexOffset;
+		uint32 chunkCount;
+		uint32 packetCount;
+		uint32 reserved;
+		uint32 magic;
+	};
+	static_assert(sizeof(FILE_FOOTER) == 0x18, "FILE_FOOTER must be 24 bytes.");
+
+	bool IsFrameDumpStream(Framework::CStream&);
+}
+
+class CFrameDumpStreamWriter
+{
+public:
+	CFrameDumpStreamWriter(Framework::CStream&);
+	virtual ~CFrameDumpStreamWriter() = default;
+
+	void WriteInitialState(const uint8*, const uint64*, uint64);
+	void AddRegisterPacket(const CGSHandler::RegisterWrite*, uint32, const CGsPacketMetadata*);
+	void AddImagePacket(const uint8*, uint32);
+	void Finish();
+
+	uint32 GetPacketCount() const;
+
+private:
+	typedef std::vector<uint8> ByteArray;
+	typedef std::unordered_map<uint64, uint32> SnapshotChunkMap;
+
+	enum
+	{
+		PACKET_CHUNK_SIZE_THRESHOLD = 0x100000,
+	};
+
+	uint32 WriteChunk(FrameDumpStream::CHUNK_TYPE, const void*, uint32);
+	uint32 WriteSnapshot(const void*, uint32);
+	void FlushPacketChunk();
+
+	Framework::CStream& m_stream;
+	bool m_finished = false;
+	std::vector<FrameDumpStream::CHUNK_ENTRY> m_chunks;
+	std::vector<FrameDumpStream::PACKET_ENTRY> m_packets;
+	ByteArray m_packetChunk;
+	uint32 m_packetChunkFirstPacket = 0;
+	SnapshotChunkMap m_snapshotChunks;
+};
+
+class CFrameDumpStreamReader
+{
+public:
+	CFrameDumpStreamReader(Framework::CStream&);
+	virtual ~CFrameDumpStreamReader() = default;
+
+	void ReadInitialState(CFrameDump&);
+
+	uint32 GetPacketCount() const;
+	CGsPacket ReadPacket(uint32);
+
+private:
+	typedef std::vector<uint8> ByteArray;
+
+	void ReadSnapshot(uint32, void*, uint32);
+	const ByteArray& GetChunk(uint32);
+	ByteArray ReadChunk(uint32);
+
+	Framework::CStream& m_stream;
+	std::vector<FrameDumpStream::CHUNK_ENTRY> m_chunks;
+	std::vector<FrameDumpStream::PACKET_ENTRY> m_packets;
+
+	//Keep the last packet chunk and snapshots around, consecutive packets usually share them
+	uint32 m_cachedPacketChunkIndex = FrameDumpStream::INVALID_CHUNK;
+	ByteArray m_cachedPacketChunk;
+	std::unordered_map<uint32, ByteArray> m_cachedSnapshots;
+};
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <vector>
+#include <cstring>
 #include <cassert>
 #include "Types.h"
 #include "Stream.h"
@@ -20,8 +23,25 @@ namespace ISO9660
 		virtual void ReadRawBlock(uint32, void*) = 0;
 		virtual uint32 GetBlockCount() = 0;
 		virtual uint32 GetRawBlockSize() const = 0;
+
+		virtual void ReadBlocks(uint32 address, uint32 count, void* blocks)
+		{
+			auto output = reinterpret_cast<uint8*>(blocks);
+			for(uint32 i = 0; i < count; i++)
+			{
+				ReadBlock(address + i, output + (i * BLOCKSIZE));
+			}
+		}
+
+		//Hints that blocks will be read soon, providers that can read asynchronously
+		//may start fetching them
+		virtual void PrefetchBlocks(uint32, uint32)
+		{
+		}
 	};
 
+	typedef std::shared_ptr<CBlockProvider> BlockProviderPtr;
+
 	class CBlockProvider2048 : public CBlockProvider
 	{
 	public:
@@ -39,6 +59,12 @@ namespace ISO9660
 			m_stream->Read(block, BLOCKSIZE);
 		}
 
+		void ReadBlocks(uint32 address, uint32 count, void* blocks) override
+		{
+			m_stream->Seek(static_cast<uint64>(address + m_offset) * BLOCKSIZE, Framework::STREAM_SEEK_SET);
+			m_stream->Read(blocks, static_cast<uint64>(count) * BLOCKSIZE);
+		}
+
 		void ReadRawBlock(uint32 address, void* block) override
 		{
 			ReadBlock(address, block);
@@ -78,6 +104,26 @@ namespace ISO9660
 			m_stream->Read(block, BLOCKSIZE);
 		}
 
+		void ReadBlocks(uint32 address, uint32 count, void* blocks) override
+		{
+			//Read raw blocks in batches and extract the user data from each of them
+			static const uint32 batchBlockCount = 0x20;
+			m_rawBuffer.resize(batchBlockCount * INTERNAL_BLOCKSIZE);
+			auto output = reinterpret_cast<uint8*>(blocks);
+			m_stream->Seek(static_cast<uint64>(address) * INTERNAL_BLOCKSIZE, Framework::STREAM_SEEK_SET);
+			while(count != 0)
+			{
+				uint32 batchCount = std::min(count, batchBlockCount);
+				m_stream->Read(m_rawBuffer.data(), batchCount * INTERNAL_BLOCKSIZE);
+				for(uint32 i = 0; i < batchCount; i++)
+				{
+					memcpy(output, m_rawBuffer.data() + (i * INTERNAL_BLOCKSIZE) + BLOCKHEADER_SIZE, BLOCKSIZE);
+					output += BLOCKSIZE;
+				}
+				count -= batchCount;
+			}
+		}
+
 		void ReadRawBlock(uint32 address, void* block) override
 		{
 			m_stream->Seek(static_cast<uint64>(address) * INTERNAL_BLOCKSIZE, Framework::STREAM_SEEK_SET);
@@ -98,7 +144,54 @@ namespace ISO9660
 
 	private:
 		StreamPtr m_stream;
+		std::vector<uint8> m_rawBuffer;
 	};
 
 	typedef CBlockProviderCustom<0x930ULL, 0x18ULL> CBlockProviderCDROMXA;
+
+	//Exposes blocks of another provider starting at a given block, used to access
+	//a disc's second layer through the same provider as the first one
+	class CBlockProviderOffset : public CBlockProvider
+	{
+	public:
+		CBlockProviderOffset(const BlockProviderPtr& provider, uint32 offset)
+		    : m_provider(provider)
+		    , m_offset(offset)
+		{
+		}
+
+		void ReadBlock(uint32 address, void* block) override
+		{
+			m_provider->ReadBlock(address + m_offset, block);
+		}
+
+		void ReadBlocks(uint32 address, uint32 count, void* blocks) override
+		{
+			m_provider->ReadBlocks(address + m_offset, count, blocks);
+		}
+
+		void PrefetchBlocks(uint32 address, uint32 count) override
+		{
+			m_provider->PrefetchBlocks(address + m_offset, count);
+		}
+
+		void ReadRawBlock(uint32 address, void* block) override
+		{
+			m_provider->ReadRawBlock(address + m_offset, block);
+		}
+
+		uint32 GetBlockCount() override
+		{
+			return m_provider->GetBlockCount();
+		}
+
+		uint32 GetRawBlockSize() const override
+		{
+			return m_provider->GetRawBlockSize();
+		}
+
+	private:
+		BlockProviderPtr m_provider;
+		uint32 m_offset = 0;
+	};
 }
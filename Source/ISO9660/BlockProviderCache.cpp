@@ -0,0 +1,140 @@
+#include <cstring>
+#include "BlockProviderCache.h"
+
+using namespace ISO9660;
+
+CBlockProviderCache::CBlockProviderCache(const BlockProviderPtr& provider, uint32 maxSize)
+    : m_provider(provider)
+{
+	SetMaxSize(maxSize);
+}
+
+void CBlockProviderCache::SetMaxSize(uint32 maxSize)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_slotCount = maxSize / BLOCKSIZE;
+	m_entries.clear();
+	m_entryMap.clear();
+	//Storage grows as blocks get inserted
+	m_storage.clear();
+	m_storage.shrink_to_fit();
+}
+
+CBlockProviderCache::STATS CBlockProviderCache::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void CBlockProviderCache::ClearStats()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats = STATS();
+}
+
+void CBlockProviderCache::ReadBlock(uint32 address, void* block)
+{
+	ReadBlocks(address, 1, block);
+}
+
+void CBlockProviderCache::ReadBlocks(uint32 address, uint32 count, void* blocks)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if(m_slotCount == 0)
+	{
+		m_provider->ReadBlocks(address, count, blocks);
+		return;
+	}
+
+	bool canInsert = (count <= MAX_INSERT_BLOCKS);
+	auto output = reinterpret_cast<uint8*>(blocks);
+	uint32 index = 0;
+	while(index < count)
+	{
+		if(auto cachedBlock = FindBlock(address + index))
+		{
+			memcpy(output + (index * BLOCKSIZE), cachedBlock, BLOCKSIZE);
+			m_stats.hitCount++;
+			m_stats.savedBytes += m_provider->GetRawBlockSize();
+			index++;
+			continue;
+		}
+
+		//Read all missing blocks up to the next cached one at once
+		uint32 missCount = 1;
+		while(((index + missCount) < count) && (m_entryMap.find(address + index + missCount) == std::end(m_entryMap)))
+		{
+			missCount++;
+		}
+		m_provider->ReadBlocks(address + index, missCount, output + (index * BLOCKSIZE));
+		m_stats.missCount += missCount;
+		if(canInsert)
+		{
+			for(uint32 i = 0; i < missCount; i++)
+			{
+				InsertBlock(address + index + i, output + ((index + i) * BLOCKSIZE));
+			}
+		}
+		index += missCount;
+	}
+}
+
+void CBlockProviderCache::PrefetchBlocks(uint32 address, uint32 count)
+{
+	m_provider->PrefetchBlocks(address, count);
+}
+
+void CBlockProviderCache::ReadRawBlock(uint32 address, void* block)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_provider->ReadRawBlock(address, block);
+}
+
+uint32 CBlockProviderCache::GetBlockCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_provider->GetBlockCount();
+}
+
+uint32 CBlockProviderCache::GetRawBlockSize() const
+{
+	return m_provider->GetRawBlockSize();
+}
+
+const uint8* CBlockProviderCache::FindBlock(uint32 address)
+{
+	auto entryIterator = m_entryMap.find(address);
+	if(entryIterator == std::end(m_entryMap))
+	{
+		return nullptr;
+	}
+	auto listIterator = entryIterator->second;
+	m_entries.splice(std::begin(m_entries), m_entries, listIterator);
+	return m_storage.data() + (static_cast<size_t>(listIterator->slot) * BLOCKSIZE);
+}
+
+void CBlockProviderCache::InsertBlock(uint32 address, const void* block)
+{
+	assert(m_entryMap.find(address) == std::end(m_entryMap));
+
+	ENTRY entry;
+	entry.address = address;
+	if(m_entries.size() == m_slotCount)
+	{
+		//Evict the least recently used block and reuse its slot
+		const auto& lastEntry = m_entries.back();
+		entry.slot = lastEntry.slot;
+		m_entryMap.erase(lastEntry.address);
+		m_entries.pop_back();
+	}
+	else
+	{
+		entry.slot = static_cast<uint32>(m_entries.size());
+		m_storage.resize(static_cast<size_t>(entry.slot + 1) * BLOCKSIZE);
+	}
+
+	memcpy(m_storage.data() + (static_cast<size_t>(entry.slot) * BLOCKSIZE), block, BLOCKSIZE);
+	m_entries.push_front(entry);
+	m_entryMap.emplace(address, std::begin(m_entries));
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "BlockProvider.h"
+
+namespace ISO9660
+{
+	//Keeps recently read blocks of another provider in memory, within a size budget.
+	//Meant for blocks that get read over and over again (directories, file indices),
+	//large reads are served from the cache but don't get inserted in it.
+	class CBlockProviderCache : public CBlockProvider
+	{
+	public:
+		struct STATS
+		{
+			uint32 hitCount = 0;
+			uint32 missCount = 0;
+			//Bytes that didn't have to be read from the underlying provider
+			uint64 savedBytes = 0;
+		};
+
+		CBlockProviderCache(const BlockProviderPtr&, uint32 = 0);
+		virtual ~CBlockProviderCache() = default;
+
+		void SetMaxSize(uint32);
+
+		STATS GetStats() const;
+		void ClearStats();
+
+		void ReadBlock(uint32, void*) override;
+		void ReadBlocks(uint32, uint32, void*) override;
+		void PrefetchBlocks(uint32, uint32) override;
+		void ReadRawBlock(uint32, void*) override;
+		uint32 GetBlockCount() override;
+		uint32 GetRawBlockSize() const override;
+
+	private:
+		enum
+		{
+			MAX_INSERT_BLOCKS = 0x10,
+		};
+
+		struct ENTRY
+		{
+			uint32 address = 0;
+			uint32 slot = 0;
+		};
+
+		//Most recently used entries are at the front
+		typedef std::list<ENTRY> EntryList;
+		typedef std::unordered_map<uint32, EntryList::iterator> EntryMap;
+
+		const uint8* FindBlock(uint32);
+		void InsertBlock(uint32, const void*);
+
+		BlockProviderPtr m_provider;
+
+		mutable std::mutex m_mutex;
+		uint32 m_slotCount = 0;
+		std::vector<uint8> m_storage;
+		EntryList m_entries;
+		EntryMap m_entryMap;
+		STATS m_stats;
+	};
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstring>
+#include "BlockProviderReadAhead.h"
+#include "ThreadUtils.h"
+#ifdef __ANDROID__
+#include "android/JavaVM.h"
+#endif
+
+#define THREAD_NAME ("ISO9660 Read Ahead Thread")
+
+using namespace ISO9660;
+
+CBlockProviderReadAhead::CBlockProviderReadAhead(const BlockProviderPtr& provider)
+    : m_provider(provider)
+{
+}
+
+CBlockProviderReadAhead::~CBlockProviderReadAhead()
+{
+	if(!m_thread.joinable()) return;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		WaitForRequest(lock);
+		m_threadDone = true;
+		m_requestCondition.notify_one();
+	}
+	m_thread.join();
+}
+
+void CBlockProviderReadAhead::ReadBlock(uint32 address, void* block)
+{
+	ReadBlocks(address, 1, block);
+}
+
+void CBlockProviderReadAhead::ReadBlocks(uint32 address, uint32 count, void* blocks)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	WaitForRequest(lock);
+
+	bool isSequential = (address == m_nextReadAddress);
+	bool isBuffered = IsBuffered(address, count);
+	if(isBuffered)
+	{
+		memcpy(blocks, m_buffer.data() + (static_cast<size_t>(address - m_bufferAddress) * BLOCKSIZE),
+		       static_cast<size_t>(count) * BLOCKSIZE);
+	}
+	else
+	{
+		//The I/O thread is idle at this point, we can safely use the provider
+		m_provider->ReadBlocks(address, count, blocks);
+	}
+
+	m_nextReadAddress = address + count;
+
+	//Follow the reader if it's going through the disc sequentially. Single block
+	//reads (file system lookups) only keep an ongoing read ahead going.
+	if((isSequential && (count > 1)) || isBuffered)
+	{
+		uint32 readAheadCount = std::max<uint32>(count, MIN_READAHEAD_BLOCKS);
+		if(!IsBuffered(m_nextReadAddress, readAheadCount))
+		{
+			StartRequest(lock, m_nextReadAddress, readAheadCount);
+		}
+	}
+}
+
+void CBlockProviderReadAhead::PrefetchBlocks(uint32 address, uint32 count)
+{
+	if(count == 0) return;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if(m_requestPending &&
+	   (address >= m_bufferAddress) &&
+	   ((static_cast<uint64>(address) + count) <= (static_cast<uint64>(m_requestAddress) + m_requestCount)))
+	{
+		//Already buffered or being fetched
+		return;
+	}
+	WaitForRequest(lock);
+	if(IsBuffered(address, count)) return;
+	StartRequest(lock, address, count);
+}
+
+void CBlockProviderReadAhead::ReadRawBlock(uint32 address, void* block)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	WaitForRequest(lock);
+	m_provider->ReadRawBlock(address, block);
+}
+
+uint32 CBlockProviderReadAhead::GetBlockCount()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	WaitForRequest(lock);
+	return m_provider->GetBlockCount();
+}
+
+uint32 CBlockProviderReadAhead::GetRawBlockSize() const
+{
+	return m_provider->GetRawBlockSize();
+}
+
+void CBlockProviderReadAhead::WaitForRequest(std::unique_lock<std::mutex>& lock)
+{
+	m_completeCondition.wait(lock, [this]() { return !m_requestPending; });
+}
+
+void CBlockProviderReadAhead::StartRequest(std::unique_lock<std::mutex>& lock, uint32 address, uint32 count)
+{
+	assert(lock.owns_lock());
+	assert(!m_requestPending);
+
+	if(!m_thread.joinable())
+	{
+		//Only start the thread once needed, media that is only probed never gets one
+		m_blockCount = m_provider->GetBlockCount();
+		m_buffer.resize(static_cast<size_t>(MAX_PREFETCH_BLOCKS) * BLOCKSIZE);
+		m_thread = std::thread([this]() { ThreadProc(); });
+		Framework::ThreadUtils::SetThreadName(m_thread, THREAD_NAME);
+	}
+
+	if(address >= m_blockCount) return;
+	count = std::min<uint32>(count, MAX_PREFETCH_BLOCKS);
+	count = std::min<uint32>(count, m_blockCount - address);
+
+	uint32 bufferEnd = m_bufferAddress + m_bufferCount;
+	if((address >= m_bufferAddress) && (address < bufferEnd))
+	{
+		//Keep the blocks we already have and only fetch the ones that follow them
+		uint32 keepCount = bufferEnd - address;
+		memmove(m_buffer.data(), m_buffer.data() + (static_cast<size_t>(address - m_bufferAddress) * BLOCKSIZE),
+		        static_cast<size_t>(keepCount) * BLOCKSIZE);
+		m_bufferAddress = address;
+		m_bufferCount = keepCount;
+		if(keepCount >= count) return;
+		address = bufferEnd;
+		count -= keepCount;
+	}
+	else
+	{
+		m_bufferAddress = address;
+		m_bufferCount = 0;
+	}
+
+	m_requestAddress = address;
+	m_requestCount = count;
+	m_requestPending = true;
+	m_requestCondition.notify_one();
+}
+
+bool CBlockProviderReadAhead::IsBuffered(uint32 address, uint32 count) const
+{
+	return (address >= m_bufferAddress) &&
+	       ((static_cast<uint64>(address - m_bufferAddress) + count) <= m_bufferCount);
+}
+
+void CBlockProviderReadAhead::ThreadProc()
+{
+#ifdef __ANDROID__
+	JNIEnv* env = nullptr;
+	Framework::CJavaVM::AttachCurrentThread(&env, THREAD_NAME);
+#endif
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while(1)
+	{
+		m_requestCondition.wait(lock, [this]() { return m_requestPending || m_threadDone; });
+		if(m_threadDone) break;
+
+		//Requested blocks are appended to the ones already in the buffer.
+		//Nothing else touches the buffer while a request is pending.
+		assert(m_requestAddress == (m_bufferAddress + m_bufferCount));
+		uint32 address = m_requestAddress;
+		uint32 count = m_requestCount;
+		auto output = m_buffer.data() + (static_cast<size_t>(m_bufferCount) * BLOCKSIZE);
+
+		lock.unlock();
+		bool succeeded = false;
+		try
+		{
+			m_provider->ReadBlocks(address, count, output);
+			succeeded = true;
+		}
+		catch(...)
+		{
+			//Leave these blocks out, the error will be raised again when they are read
+		}
+		lock.lock();
+
+		if(succeeded)
+		{
+			m_bufferCount += count;
+		}
+		m_requestPending = false;
+		m_completeCondition.notify_all();
+	}
+#ifdef __ANDROID__
+	Framework::CJavaVM::DetachCurrentThread();
+#endif
+}
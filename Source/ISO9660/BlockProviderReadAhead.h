@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "BlockProvider.h"
+
+namespace ISO9660
+{
+	//Wraps another provider and fetches blocks on an I/O thread ahead of the moment
+	//they are needed. Prefetch requests fill a buffer that later reads are served from,
+	//and sequential reads automatically trigger a prefetch of the blocks that follow.
+	//All accesses to the wrapped provider are serialized with the I/O thread.
+	class CBlockProviderReadAhead : public CBlockProvider
+	{
+	public:
+		CBlockProviderReadAhead(const BlockProviderPtr&);
+		virtual ~CBlockProviderReadAhead();
+
+		void ReadBlock(uint32, void*) override;
+		void ReadBlocks(uint32, uint32, void*) override;
+		void PrefetchBlocks(uint32, uint32) override;
+		void ReadRawBlock(uint32, void*) override;
+		uint32 GetBlockCount() override;
+		uint32 GetRawBlockSize() const override;
+
+	private:
+		enum
+		{
+			MAX_PREFETCH_BLOCKS = 0x200,
+			MIN_READAHEAD_BLOCKS = 0x40,
+		};
+
+		void WaitForRequest(std::unique_lock<std::mutex>&);
+		void StartRequest(std::unique_lock<std::mutex>&, uint32, uint32);
+		bool IsBuffered(uint32, uint32) const;
+		void ThreadProc();
+
+		BlockProviderPtr m_provider;
+		uint32 m_blockCount = 0;
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_requestCondition;
+		std::condition_variable m_completeCondition;
+		bool m_threadDone = false;
+
+		bool m_requestPending = false;
+		uint32 m_requestAddress = 0;
+		uint32 m_requestCount = 0;
+
+		std::vector<uint8> m_buffer;
+		uint32 m_bufferAddress = 0;
+		uint32 m_bufferCount = 0;
+
+		uint32 m_nextReadAddress = ~0U;
+	};
+}
@@ -1,4 +1,5 @@
 #include <string.h>
+#include <algorithm>
 #include "DirectoryRecord.h"
 
 using namespace ISO9660;
@@ -30,6 +31,16 @@ CDirectoryRecord::CDirectoryRecord(Framework::CStream* stream)
 	}
 }
 
+CDirectoryRecord::CDirectoryRecord(uint32 position, uint32 dataLength, uint8 flags, const char* name)
+    : m_position(position)
+    , m_dataLength(dataLength)
+    , m_flags(flags)
+{
+	strncpy(m_name, name, sizeof(m_name) - 1);
+	m_name[sizeof(m_name) - 1] = 0x00;
+	m_length = static_cast<uint8>(std::min<size_t>(0x21 + strlen(m_name), 0xFF));
+}
+
 CDirectoryRecord::~CDirectoryRecord()
 {
 }
@@ -58,3 +69,8 @@ uint32 CDirectoryRecord::GetDataLength() const
 {
 	return m_dataLength;
 }
+
+uint8 CDirectoryRecord::GetFlags() const
+{
+	return m_flags;
+}
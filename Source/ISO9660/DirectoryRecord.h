@@ -10,6 +10,7 @@ namespace ISO9660
 	public:
 		CDirectoryRecord();
 		CDirectoryRecord(Framework::CStream*);
+		CDirectoryRecord(uint32, uint32, uint8, const char*);
 		~CDirectoryRecord();
 
 		bool IsDirectory() const;
@@ -17,6 +18,7 @@ namespace ISO9660
 		const char* GetName() const;
 		uint32 GetPosition() const;
 		uint32 GetDataLength() const;
+		uint8 GetFlags() const;
 
 	private:
 		uint8 m_length = 0;
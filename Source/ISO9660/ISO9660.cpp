@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cctype>
 #include <string.h>
 #include <limits.h>
 #include "ISO9660.h"
@@ -29,8 +31,41 @@ void CISO9660::ReadBlock(uint32 address, void* data)
 	memcpy(data, m_blockBuffer, CBlockProvider::BLOCKSIZE);
 }
 
+void CISO9660::ReadBlocks(uint32 address, uint32 count, void* data)
+{
+	//Same as ReadBlock, go through the buffer, a few blocks at a time
+	auto output = reinterpret_cast<uint8*>(data);
+	while(count != 0)
+	{
+		uint32 blockCount = std::min<uint32>(count, BLOCK_BUFFER_COUNT);
+		m_blockProvider->ReadBlocks(address, blockCount, m_blockBuffer);
+		memcpy(output, m_blockBuffer, blockCount * CBlockProvider::BLOCKSIZE);
+		output += blockCount * CBlockProvider::BLOCKSIZE;
+		address += blockCount;
+		count -= blockCount;
+	}
+}
+
+void CISO9660::PrefetchBlocks(uint32 address, uint32 count)
+{
+	m_blockProvider->PrefetchBlocks(address, count);
+}
+
 bool CISO9660::GetFileRecord(CDirectoryRecord* record, const char* filename)
 {
+	if(!m_index.empty())
+	{
+		auto indexIterator = m_index.find(MakeIndexKey(filename));
+		if(indexIterator != std::end(m_index))
+		{
+			const auto& indexEntry = indexIterator->second;
+			(*record) = CDirectoryRecord(indexEntry.position, indexEntry.dataLength, indexEntry.flags, indexEntry.name.c_str());
+			return true;
+		}
+		//Not in the index, still go through the directories as paths that
+		//only match a record partially are accepted there
+	}
+
 	//Remove the first '/'
 	if(filename[0] == '/' || filename[0] == '\\') filename++;
 
@@ -75,6 +110,95 @@ bool CISO9660::GetFileRecordFromDirectory(CDirectoryRecord* record, uint32 addre
 	return false;
 }
 
+void CISO9660::BuildIndex()
+{
+	m_index.clear();
+	try
+	{
+		unsigned int rootIndex = m_pathTable.FindRoot();
+		if(rootIndex == 0) return;
+		uint32 rootAddress = m_pathTable.GetDirectoryAddress(rootIndex);
+		//The first record of a directory describes the directory itself
+		CFile rootDirectory(m_blockProvider.get(), static_cast<uint64>(rootAddress) * CBlockProvider::BLOCKSIZE);
+		CDirectoryRecord rootRecord(&rootDirectory);
+		IndexDirectory("", rootAddress, rootRecord.GetDataLength(), 0);
+	}
+	catch(...)
+	{
+		//Something's wrong with the directory structure, lookups will go through the directories
+		m_index.clear();
+	}
+}
+
+void CISO9660::IndexDirectory(const std::string& path, uint32 address, uint32 size, unsigned int depth)
+{
+	if(depth >= MAX_INDEX_DEPTH) return;
+
+	CFile directory(m_blockProvider.get(), static_cast<uint64>(address) * CBlockProvider::BLOCKSIZE, size);
+	while(1)
+	{
+		uint64 position = directory.Tell();
+		if(position >= size) break;
+
+		//Records don't cross block boundaries, the rest of a block is padded with 0s
+		uint8 length = directory.Read8();
+		if(length == 0)
+		{
+			uint64 nextBlockPosition = ((position / CBlockProvider::BLOCKSIZE) + 1) * CBlockProvider::BLOCKSIZE;
+			directory.Seek(nextBlockPosition, Framework::STREAM_SEEK_SET);
+			continue;
+		}
+		directory.Seek(position, Framework::STREAM_SEEK_SET);
+
+		CDirectoryRecord entry(&directory);
+		const char* name = entry.GetName();
+
+		//Skip records for the directory itself and its parent
+		if((name[0] == 0x00) || ((name[0] == 0x01) && (name[1] == 0x00))) continue;
+
+		auto key = MakeIndexKey(name);
+		if(!path.empty())
+		{
+			key = path + "/" + key;
+		}
+
+		INDEX_ENTRY indexEntry;
+		indexEntry.position = entry.GetPosition();
+		indexEntry.dataLength = entry.GetDataLength();
+		indexEntry.flags = entry.GetFlags();
+		indexEntry.name = name;
+		m_index.emplace(key, std::move(indexEntry));
+
+		if(entry.IsDirectory())
+		{
+			IndexDirectory(key, entry.GetPosition(), entry.GetDataLength(), depth + 1);
+		}
+	}
+}
+
+std::string CISO9660::MakeIndexKey(const char* path)
+{
+	//Remove the first '/'
+	if(path[0] == '/' || path[0] == '\\') path++;
+
+	std::string key(path);
+
+	//Version specifiers (ie.: ;1) and empty extensions are optional
+	auto versionPos = key.find(';');
+	if(versionPos != std::string::npos)
+	{
+		key.erase(versionPos);
+	}
+	while(!key.empty() && (key.back() == '.'))
+	{
+		key.pop_back();
+	}
+
+	std::transform(key.begin(), key.end(), key.begin(),
+	               [](char c) { return static_cast<char>(tolower(static_cast<unsigned char>(c))); });
+	return key;
+}
+
 Framework::CStream* CISO9660::Open(const char* filename)
 {
 	CDirectoryRecord record;
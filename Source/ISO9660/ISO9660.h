@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include "BlockProvider.h"
 #include "VolumeDescriptor.h"
 #include "PathTable.h"
@@ -15,17 +17,41 @@ public:
 	~CISO9660();
 
 	void ReadBlock(uint32, void*);
+	void ReadBlocks(uint32, uint32, void*);
+	void PrefetchBlocks(uint32, uint32);
 
 	Framework::CStream* Open(const char*);
 	Framework::CStream* OpenDirectory(const char*);
 	bool GetFileRecord(ISO9660::CDirectoryRecord*, const char*);
 
+	void BuildIndex();
+
 private:
+	enum
+	{
+		BLOCK_BUFFER_COUNT = 0x10,
+		MAX_INDEX_DEPTH = 0x20,
+	};
+
+	struct INDEX_ENTRY
+	{
+		uint32 position = 0;
+		uint32 dataLength = 0;
+		uint8 flags = 0;
+		std::string name;
+	};
+
+	typedef std::unordered_map<std::string, INDEX_ENTRY> IndexMap;
+
 	bool GetFileRecordFromDirectory(ISO9660::CDirectoryRecord*, uint32, const char*);
 
+	void IndexDirectory(const std::string&, uint32, uint32, unsigned int);
+	static std::string MakeIndexKey(const char*);
+
 	BlockProviderPtr m_blockProvider;
 	ISO9660::CVolumeDescriptor m_volumeDescriptor;
 	ISO9660::CPathTable m_pathTable;
+	IndexMap m_index;
 
-	uint8 m_blockBuffer[ISO9660::CBlockProvider::BLOCKSIZE];
+	uint8 m_blockBuffer[ISO9660::CBlockProvider::BLOCKSIZE * BLOCK_BUFFER_COUNT];
 };
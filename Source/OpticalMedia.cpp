@@ -1,6 +1,7 @@
 #include <cassert>
 #include <cstring>
 #include "OpticalMedia.h"
+#include "ISO9660/BlockProviderReadAhead.h"
 
 #define DVD_LAYER_MAX_BLOCKS 2295104
 
@@ -10,7 +11,7 @@ std::unique_ptr<COpticalMedia> COpticalMedia::CreateAuto(StreamPtr& stream, uint
 	//Simulate a disk with only one data track
 	try
 	{
-		auto blockProvider = std::make_shared<ISO9660::CBlockProvider2048>(stream);
+		auto blockProvider = result->CreateBlockProvider(std::make_shared<ISO9660::CBlockProvider2048>(stream));
 		result->m_fileSystem = std::make_unique<CISO9660>(blockProvider);
 		result->m_track0DataType = TRACK_DATA_TYPE_MODE1_2048;
 		result->m_track0BlockProvider = blockProvider;
@@ -18,7 +19,7 @@ std::unique_ptr<COpticalMedia> COpticalMedia::CreateAuto(StreamPtr& stream, uint
 	catch(...)
 	{
 		//Failed with block size 2048, try with CD-ROM XA
-		auto blockProvider = std::make_shared<ISO9660::CBlockProviderCDROMXA>(stream);
+		auto blockProvider = result->CreateBlockProvider(std::make_shared<ISO9660::CBlockProviderCDROMXA>(stream));
 		result->m_fileSystem = std::make_unique<CISO9660>(blockProvider);
 		result->m_track0DataType = TRACK_DATA_TYPE_MODE2_2352;
 		result->m_track0BlockProvider = blockProvider;
@@ -31,7 +32,7 @@ std::unique_ptr<COpticalMedia> COpticalMedia::CreateAuto(StreamPtr& stream, uint
 		try
 		{
 			result->CheckDualLayerDvd(stream);
-			result->SetupSecondLayer(stream);
+			result->SetupSecondLayer();
 		}
 		catch(...)
 		{
@@ -44,19 +45,20 @@ std::unique_ptr<COpticalMedia> COpticalMedia::CreateAuto(StreamPtr& stream, uint
 std::unique_ptr<COpticalMedia> COpticalMedia::CreateDvd(StreamPtr& stream, bool isDualLayer, uint32 secondLayerStart)
 {
 	auto result = std::make_unique<COpticalMedia>();
-	auto blockProvider = std::make_shared<ISO9660::CBlockProvider2048>(stream);
+	auto blockProvider = result->CreateBlockProvider(std::make_shared<ISO9660::CBlockProvider2048>(stream));
 	result->m_fileSystem = std::make_unique<CISO9660>(blockProvider);
 	result->m_track0DataType = TRACK_DATA_TYPE_MODE1_2048;
 	result->m_track0BlockProvider = blockProvider;
 	result->m_dvdIsDualLayer = isDualLayer;
 	result->m_dvdSecondLayerStart = secondLayerStart;
-	result->SetupSecondLayer(stream);
+	result->SetupSecondLayer();
 	return result;
 }
 
 std::unique_ptr<COpticalMedia> COpticalMedia::CreateCustomSingleTrack(BlockProviderPtr blockProvider, TRACK_DATA_TYPE trackDataType)
 {
 	auto result = std::make_unique<COpticalMedia>();
+	blockProvider = result->CreateBlockProvider(blockProvider);
 	result->m_fileSystem = std::make_unique<CISO9660>(blockProvider);
 	result->m_track0DataType = trackDataType;
 	result->m_track0BlockProvider = blockProvider;
@@ -97,6 +99,21 @@ uint32 COpticalMedia::GetDvdSecondLayerStart() const
 	return m_dvdSecondLayerStart - 0x10;
 }
 
+void COpticalMedia::SetBlockCacheSize(uint32 size)
+{
+	m_blockCache->SetMaxSize(size);
+}
+
+ISO9660::CBlockProviderCache::STATS COpticalMedia::GetBlockCacheStats() const
+{
+	return m_blockCache->GetStats();
+}
+
+void COpticalMedia::ClearBlockCacheStats()
+{
+	m_blockCache->ClearStats();
+}
+
 void COpticalMedia::CheckDualLayerDvd(const StreamPtr& stream)
 {
 	//Heuristic to detect dual layer DVD disc images
@@ -146,9 +163,17 @@ void COpticalMedia::CheckDualLayerDvd(const StreamPtr& stream)
 	assert(m_dvdSecondLayerStart != 0);
 }
 
-void COpticalMedia::SetupSecondLayer(const StreamPtr& stream)
+COpticalMedia::BlockProviderPtr COpticalMedia::CreateBlockProvider(const BlockProviderPtr& blockProvider)
+{
+	//The cache is disabled until a size is set
+	m_blockCache = std::make_shared<ISO9660::CBlockProviderCache>(blockProvider);
+	return std::make_shared<ISO9660::CBlockProviderReadAhead>(m_blockCache);
+}
+
+void COpticalMedia::SetupSecondLayer()
 {
 	if(!m_dvdIsDualLayer) return;
-	auto blockProvider = std::make_shared<ISO9660::CBlockProvider2048>(stream, GetDvdSecondLayerStart());
+	//Go through the first layer's provider, reads on both layers need to be serialized with its read ahead
+	auto blockProvider = std::make_shared<ISO9660::CBlockProviderOffset>(m_track0BlockProvider, GetDvdSecondLayerStart());
 	m_fileSystemL1 = std::make_unique<CISO9660>(blockProvider);
 }
@@ -2,6 +2,7 @@
 
 #include "Stream.h"
 #include "ISO9660/ISO9660.h"
+#include "ISO9660/BlockProviderCache.h"
 
 namespace ISO9660
 {
@@ -44,14 +45,21 @@ public:
 	bool GetDvdIsDualLayer() const;
 	uint32 GetDvdSecondLayerStart() const;
 
+	void SetBlockCacheSize(uint32);
+	ISO9660::CBlockProviderCache::STATS GetBlockCacheStats() const;
+	void ClearBlockCacheStats();
+
 private:
 	typedef std::unique_ptr<CISO9660> Iso9660Ptr;
 
+	BlockProviderPtr CreateBlockProvider(const BlockProviderPtr&);
+
 	void CheckDualLayerDvd(const StreamPtr&);
-	void SetupSecondLayer(const StreamPtr&);
+	void SetupSecondLayer();
 
 	TRACK_DATA_TYPE m_track0DataType = TRACK_DATA_TYPE_MODE1_2048;
 	BlockProviderPtr m_track0BlockProvider;
+	std::shared_ptr<ISO9660::CBlockProviderCache> m_blockCache;
 	bool m_dvdIsDualLayer = false;
 	uint32 m_dvdSecondLayerStart = 0;
 	Iso9660Ptr m_fileSystem;
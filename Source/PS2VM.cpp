@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdio>
 #include <exception>
 #include <memory>
@@ -30,6 +31,7 @@
 #include "iop/ioman/PreferenceDirectoryDevice.h"
 #include "Log.h"
 #include "DiskUtils.h"
+#include "SoundRingBuffer.h"
 #ifdef __ANDROID__
 #include "android/JavaVM.h"
 #endif
@@ -52,6 +54,9 @@
 #define PREF_PS2_HDD_DIRECTORY_DEFAULT ("vfs/hdd")
 #define PREF_PS2_ARCADEROMS_DIRECTORY_DEFAULT ("arcaderoms")
 
+//In megabytes, keeps the cache size in bytes within 32 bits
+#define CDROM0_CACHESIZE_MAX (1024)
+
 CPS2VM::CPS2VM()
     : m_eeProfilerZone(CProfiler::GetInstance().RegisterZone("EE"))
     , m_iopProfilerZone(CProfiler::GetInstance().RegisterZone("IOP"))
@@ -88,13 +93,20 @@ CPS2VM::CPS2VM()
 	}
 
 	CAppConfig::GetInstance().RegisterPreferencePath(PREF_PS2_CDROM0_PATH, "");
+	//In megabytes, 0 disables the cache
+	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_PS2_CDROM0_CACHESIZE, 8);
 
 	Framework::PathUtils::EnsurePathExists(GetStateDirectoryPath());
 
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE, true);
 	ReloadFrameRateLimit();
 
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_IPU_FASTIDCT, false);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_IPU_DECODEAHEAD, false);
+
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_AUDIO_SPUBLOCKCOUNT, 100);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_AUDIO_SPURENDERTHREAD, false);
+	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_AUDIO_SPUINTERPOLATION, Iop::SpuVoiceMixer::INTERPOLATION_LINEAR);
 	ReloadSpuBlockCountImpl();
 
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_ARCADE_IO_SERVER_ENABLED, false);
@@ -248,7 +260,7 @@ void CPS2VM::ReloadFrameRateLimit()
 	m_onScreenTicksTotal = frameTicks * 9 / 10;
 	m_vblankTicksTotal = frameTicks / 10;
 
-	m_spuUpdateTicksTotal = (static_cast<int64>(eeFreqScaled) << SPU_UPDATE_TICKS_PRECISION) / (static_cast<int64>(DST_SAMPLE_RATE));
+	m_spuUpdateTicksTotal = (static_cast<int64>(eeFreqScaled) << SPU_UPDATE_TICKS_PRECISION) / (static_cast<int64>(m_dstSampleRate));
 	m_spuUpdateTicksTotal *= static_cast<int64>(SAMPLES_PER_UPDATE);
 }
 
@@ -369,11 +381,69 @@ std::future<bool> CPS2VM::LoadState(const fs::path& statePath)
 	return future;
 }
 
+void CPS2VM::BeginIpuTrace()
+{
+	m_mailBox.SendCall(
+	    [this]() {
+		    m_ipuTrace = std::make_unique<CIpuTrace>();
+		    m_ee->m_ipu.SetTrace(m_ipuTrace.get());
+	    });
+}
+
+std::future<bool> CPS2VM::EndIpuTrace(const fs::path& tracePath)
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise, tracePath]() {
+		    auto result = SaveIpuTrace(tracePath);
+		    promise->set_value(result);
+	    });
+	return future;
+}
+
 CPS2VM::CPU_UTILISATION_INFO CPS2VM::GetCpuUtilisationInfo() const
 {
 	return m_cpuUtilisation;
 }
 
+CPS2VM::DMA_STATS_INFO CPS2VM::GetDmaStatsInfo() const
+{
+	//Counters are cleared after every frame, like CPU utilisation info
+	DMA_STATS_INFO result;
+	for(unsigned int i = 0; i < CDMAC::CHANNEL_COUNT; i++)
+	{
+		result.eeChannels[i] = m_ee->m_dmac.GetChannelStats(i);
+	}
+	for(unsigned int i = 0; i < Iop::CDmac::MAX_CHANNEL; i++)
+	{
+		result.iopChannels[i] = m_iop->m_dmac.GetChannelStats(i);
+	}
+	result.sif = m_ee->m_sif.GetStats();
+	return result;
+}
+
+CPS2VM::CDROM_CACHE_STATS CPS2VM::GetCdromCacheStats() const
+{
+	//Cleared after every frame, like DMA stats
+	if(!m_cdrom0) return CDROM_CACHE_STATS();
+	return m_cdrom0->GetBlockCacheStats();
+}
+
+CPS2VM::SOUND_STATS CPS2VM::GetSoundStats() const
+{
+	//Counters are cleared after every frame, only sound handlers with a ring buffer provide stats
+	auto ringBuffer = m_soundHandler ? m_soundHandler->GetRingBuffer() : nullptr;
+	if(!ringBuffer) return SOUND_STATS();
+	return ringBuffer->GetStats();
+}
+
+CPS2VM::SPU_SAMPLE_CACHE_STATS CPS2VM::GetSpuSampleCacheStats() const
+{
+	//Cleared after every frame, like DMA stats
+	return m_iop->m_spuSampleCache.GetStats();
+}
+
 #ifdef DEBUGGER_INCLUDED
 
 #define TAGS_SECTION_TAGS ("tags")
@@ -488,7 +558,15 @@ void CPS2VM::ResetVM()
 	assert(m_iopRamSize <= PS2::IOP_RAM_SIZE);
 
 	m_ee->Reset(m_eeRamSize);
+	m_ee->m_ipu.SetFastIdctEnabled(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_IPU_FASTIDCT));
+	m_ee->m_ipu.SetDecodeAheadEnabled(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_IPU_DECODEAHEAD));
 	m_iop->Reset();
+	m_iop->SetSpuRenderThreadEnabled(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_AUDIO_SPURENDERTHREAD));
+	{
+		auto interpolation = static_cast<Iop::SpuVoiceMixer::INTERPOLATION>(CAppConfig::GetInstance().GetPreferenceInteger(PREF_AUDIO_SPUINTERPOLATION));
+		m_iop->m_spuCore0.SetInterpolation(interpolation);
+		m_iop->m_spuCore1.SetInterpolation(interpolation);
+	}
 
 	if(m_ee->m_gs != NULL)
 	{
@@ -527,8 +605,8 @@ void CPS2VM::ResetVM()
 	m_iopExecutionTicks = 0;
 
 	m_currentSpuBlock = 0;
-	m_iop->m_spuCore0.SetDestinationSamplingRate(DST_SAMPLE_RATE);
-	m_iop->m_spuCore1.SetDestinationSamplingRate(DST_SAMPLE_RATE);
+	m_iop->m_spuCore0.SetDestinationSamplingRate(m_dstSampleRate);
+	m_iop->m_spuCore1.SetDestinationSamplingRate(m_dstSampleRate);
 
 	RegisterModulesInPadHandler();
 	m_gunListener = nullptr;
@@ -568,6 +646,29 @@ bool CPS2VM::SaveVMState(const fs::path& statePath)
 	return true;
 }
 
+bool CPS2VM::SaveIpuTrace(const fs::path& tracePath)
+{
+	if(!m_ipuTrace)
+	{
+		return false;
+	}
+
+	m_ee->m_ipu.SetTrace(nullptr);
+	auto trace = std::move(m_ipuTrace);
+
+	try
+	{
+		auto traceStream = Framework::CreateOutputStdStream(tracePath.native());
+		trace->Write(traceStream);
+	}
+	catch(...)
+	{
+		return false;
+	}
+
+	return true;
+}
+
 bool CPS2VM::LoadVMState(const fs::path& statePath)
 {
 	if(m_ee->m_gs == NULL)
@@ -692,6 +793,7 @@ void CPS2VM::DestroyPadHandlerImpl()
 void CPS2VM::CreateSoundHandlerImpl(const CSoundHandler::FactoryFunction& factoryFunction)
 {
 	m_soundHandler = factoryFunction();
+	UpdateDstSampleRate();
 }
 
 void CPS2VM::ReloadSpuBlockCountImpl()
@@ -704,9 +806,35 @@ void CPS2VM::ReloadSpuBlockCountImpl()
 	m_spuBlockCount = spuBlockCount;
 }
 
+void CPS2VM::UpdateDstSampleRate()
+{
+	//SPU voices are resampled straight to the device's rate, but envelopes and reverb advance
+	//once per output sample. Rates far from the SPU's own are left to the system's mixer.
+	uint32 sampleRate = m_soundHandler ? m_soundHandler->GetSampleRate() : DEFAULT_DST_SAMPLE_RATE;
+	if((sampleRate < DEFAULT_DST_SAMPLE_RATE) || (sampleRate > MAX_DST_SAMPLE_RATE))
+	{
+		sampleRate = DEFAULT_DST_SAMPLE_RATE;
+	}
+	if(sampleRate == m_dstSampleRate) return;
+	m_dstSampleRate = sampleRate;
+	if(m_iop)
+	{
+		m_iop->SyncSpu();
+		m_iop->m_spuCore0.SetDestinationSamplingRate(m_dstSampleRate);
+		m_iop->m_spuCore1.SetDestinationSamplingRate(m_dstSampleRate);
+	}
+	ReloadFrameRateLimit();
+}
+
 void CPS2VM::DestroySoundHandlerImpl()
 {
 	if(m_soundHandler == nullptr) return;
+	//Block pending in the handler's ring might still be rendering
+	if(m_spuRingBlockPending)
+	{
+		m_iop->SyncSpu();
+		m_spuRingBlockPending = false;
+	}
 	delete m_soundHandler;
 	m_soundHandler = nullptr;
 }
@@ -775,35 +903,35 @@ void CPS2VM::UpdateSpu()
 	CProfilerZone profilerZone(m_spuProfilerZone);
 #endif
 
-	unsigned int blockOffset = (BLOCK_SIZE * m_currentSpuBlock);
-	int16* samplesSpu0 = m_samples + blockOffset;
-
-	m_iop->m_spuCore0.Render(samplesSpu0, BLOCK_SIZE);
+	//Previous block might still be rendering on the SPU render thread
+	m_iop->SyncSpu();
 
-	if(m_iop->m_spuCore1.IsEnabled())
+	if(auto ringBuffer = m_soundHandler ? m_soundHandler->GetRingBuffer() : nullptr)
 	{
-		int16 samplesSpu1[BLOCK_SIZE];
-		m_iop->m_spuCore1.Render(samplesSpu1, BLOCK_SIZE);
-
-		for(unsigned int i = 0; i < BLOCK_SIZE; i++)
+		if(m_spuRingBlockPending)
 		{
-			int32 resultSample = static_cast<int32>(samplesSpu0[i]) + static_cast<int32>(samplesSpu1[i]);
-			resultSample = std::max<int32>(resultSample, SHRT_MIN);
-			resultSample = std::min<int32>(resultSample, SHRT_MAX);
-			samplesSpu0[i] = static_cast<int16>(resultSample);
+			ringBuffer->CommitWrite(BLOCK_SIZE);
 		}
+		//Render straight into the ring, samples are dropped if it's already filled enough
+		int16* samples = ringBuffer->GetWritePointer(BLOCK_SIZE);
+		m_spuRingBlockPending = (samples != nullptr);
+		m_iop->RenderSpu(samples ? samples : m_samples, BLOCK_SIZE);
+		return;
 	}
 
-	m_currentSpuBlock++;
 	if(m_currentSpuBlock == m_spuBlockCount)
 	{
 		if(m_soundHandler)
 		{
 			m_soundHandler->RecycleBuffers();
-			m_soundHandler->Write(m_samples, BLOCK_SIZE * m_spuBlockCount, DST_SAMPLE_RATE);
+			m_soundHandler->Write(m_samples, BLOCK_SIZE * m_spuBlockCount, m_dstSampleRate);
 		}
 		m_currentSpuBlock = 0;
 	}
+
+	unsigned int blockOffset = (BLOCK_SIZE * m_currentSpuBlock);
+	m_iop->RenderSpu(m_samples + blockOffset, BLOCK_SIZE);
+	m_currentSpuBlock++;
 }
 
 void CPS2VM::CDROM0_SyncPath()
@@ -819,6 +947,16 @@ void CPS2VM::CDROM0_SyncPath()
 		try
 		{
 			m_cdrom0 = DiskUtils::CreateOpticalMediaFromPath(path);
+			uint32 cacheSize = std::clamp(CAppConfig::GetInstance().GetPreferenceInteger(PREF_PS2_CDROM0_CACHESIZE), 0, CDROM0_CACHESIZE_MAX);
+			m_cdrom0->SetBlockCacheSize(cacheSize * 1024 * 1024);
+			if(auto fileSystem = m_cdrom0->GetFileSystem())
+			{
+				fileSystem->BuildIndex();
+			}
+			if(auto fileSystemL1 = m_cdrom0->GetFileSystemL1())
+			{
+				fileSystemL1->BuildIndex();
+			}
 			SetIopOpticalMedia(m_cdrom0.get());
 		}
 		catch(const std::exception& Exception)
@@ -866,6 +1004,8 @@ void CPS2VM::ReloadExecutable(const char* executablePath, const CPS2OS::Argument
 		//SPU RAM is not cleared by a LoadExecPS2 operation, we must keep its contents
 		//Deus Ex uses SPU RAM to keep game state in between executable reloads
 		auto savedSpuRam = std::vector<uint8>(PS2::SPU_RAM_SIZE);
+		//A block might still be rendering on the SPU render thread
+		m_iop->SyncSpu();
 		memcpy(savedSpuRam.data(), m_iop->m_spuRam, PS2::SPU_RAM_SIZE);
 		ResetVM();
 		memcpy(m_iop->m_spuRam, savedSpuRam.data(), PS2::SPU_RAM_SIZE);
@@ -961,6 +1101,18 @@ void CPS2VM::EmuThread()
 						CProfiler::GetInstance().Reset();
 #endif
 						m_cpuUtilisation = CPU_UTILISATION_INFO();
+						m_ee->m_dmac.ClearStats();
+						m_ee->m_sif.ClearStats();
+						m_iop->m_dmac.ClearStats();
+						if(m_cdrom0)
+						{
+							m_cdrom0->ClearBlockCacheStats();
+						}
+						if(auto ringBuffer = m_soundHandler ? m_soundHandler->GetRingBuffer() : nullptr)
+						{
+							ringBuffer->ClearStats();
+						}
+						m_iop->m_spuSampleCache.ClearStats();
 					}
 					else
 					{
@@ -13,6 +13,7 @@
 #include "ee/Ee_SubSystem.h"
 #include "iop/Iop_SubSystem.h"
 #include "../tools/PsfPlayer/Source/SoundHandler.h"
+#include "SoundRingBuffer.h"
 #include "FrameLimiter.h"
 #include "Profiler.h"
 
@@ -28,6 +29,17 @@ public:
 		int32 iopIdleTicks = 0;
 	};
 
+	struct DMA_STATS_INFO
+	{
+		DMA_CHANNEL_STATS eeChannels[CDMAC::CHANNEL_COUNT];
+		DMA_CHANNEL_STATS iopChannels[Iop::CDmac::MAX_CHANNEL];
+		CSIF::STATS sif;
+	};
+
+	typedef ISO9660::CBlockProviderCache::STATS CDROM_CACHE_STATS;
+	typedef CSoundRingBuffer::STATS SOUND_STATS;
+	typedef Iop::CSpuSampleCache::STATS SPU_SAMPLE_CACHE_STATS;
+
 	typedef std::unique_ptr<COpticalMedia> OpticalMediaPtr;
 	typedef std::unique_ptr<Ee::CSubSystem> EeSubSystemPtr;
 	typedef std::unique_ptr<Iop::CSubSystem> IopSubSystemPtr;
@@ -77,7 +89,14 @@ public:
 	std::future<bool> SaveState(const fs::path&);
 	std::future<bool> LoadState(const fs::path&);
 
+	void BeginIpuTrace();
+	std::future<bool> EndIpuTrace(const fs::path&);
+
 	CPU_UTILISATION_INFO GetCpuUtilisationInfo() const;
+	DMA_STATS_INFO GetDmaStatsInfo() const;
+	CDROM_CACHE_STATS GetCdromCacheStats() const;
+	SOUND_STATS GetSoundStats() const;
+	SPU_SAMPLE_CACHE_STATS GetSpuSampleCacheStats() const;
 
 #ifdef DEBUGGER_INCLUDED
 	fs::path MakeDebugTagsPackagePath(const char*);
@@ -118,6 +137,7 @@ private:
 	void DestroyVM();
 	bool SaveVMState(const fs::path&);
 	bool LoadVMState(const fs::path&);
+	bool SaveIpuTrace(const fs::path&);
 
 	void SaveVmTimingState(Framework::CZipArchiveWriter&);
 	void LoadVmTimingState(Framework::CZipArchiveReader&);
@@ -138,6 +158,7 @@ private:
 	void DestroySoundHandlerImpl();
 
 	void ReloadSpuBlockCountImpl();
+	void UpdateDstSampleRate();
 
 	void UpdateEe();
 	void UpdateIop();
@@ -181,21 +202,27 @@ private:
 	//SPU update parameters
 	enum
 	{
-		DST_SAMPLE_RATE = 44100,
+		DEFAULT_DST_SAMPLE_RATE = 44100,
+		MAX_DST_SAMPLE_RATE = 48000,
 		SAMPLES_PER_UPDATE = 45, //44100 / 45 -> 980 SPU updates per second
 		SPU_UPDATE_TICKS_PRECISION = 32,
 		BLOCK_SIZE = SAMPLES_PER_UPDATE * 2,
 		MAX_BLOCK_COUNT = 400,
 	};
 
+	uint32 m_dstSampleRate = DEFAULT_DST_SAMPLE_RATE;
 	int16 m_samples[BLOCK_SIZE * MAX_BLOCK_COUNT];
 	int m_currentSpuBlock = 0;
 	int m_spuBlockCount = 0;
+	//Block rendered in the sound handler's ring, committed once rendering is done
+	bool m_spuRingBlockPending = false;
 	CSoundHandler* m_soundHandler = nullptr;
 
 	CScreenPositionListener* m_gunListener = nullptr;
 	CScreenPositionListener* m_touchListener = nullptr;
 
+	std::unique_ptr<CIpuTrace> m_ipuTrace;
+
 	CProfiler::ZoneHandle m_eeProfilerZone = 0;
 	CProfiler::ZoneHandle m_iopProfilerZone = 0;
 	CProfiler::ZoneHandle m_spuProfilerZone = 0;
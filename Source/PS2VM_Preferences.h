@@ -1,6 +1,7 @@
 #pragma once
 
 #define PREF_PS2_CDROM0_PATH ("ps2.cdrom0.path.v2")
+#define PREF_PS2_CDROM0_CACHESIZE ("ps2.cdrom0.cachesize")
 
 #define PREF_PS2_ROM0_DIRECTORY ("ps2.rom0.directory.v2")
 #define PREF_PS2_HOST_DIRECTORY ("ps2.host.directory.v2")
@@ -14,6 +15,11 @@
 
 #define PREF_PS2_LIMIT_FRAMERATE ("ps2.limitframerate")
 
+#define PREF_PS2_IPU_FASTIDCT ("ps2.ipu.fastidct")
+#define PREF_PS2_IPU_DECODEAHEAD ("ps2.ipu.decodeahead")
+
 #define PREF_AUDIO_SPUBLOCKCOUNT ("audio.spublockcount")
+#define PREF_AUDIO_SPURENDERTHREAD ("audio.spurenderthread")
+#define PREF_AUDIO_SPUINTERPOLATION ("audio.spuinterpolation")
 
 #define PREF_SYSTEM_LANGUAGE ("system.language")
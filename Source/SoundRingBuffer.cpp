@@ -0,0 +1,146 @@
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include "SoundRingBuffer.h"
+
+//Target fill level is expressed in fractions of the ring's capacity
+#define TARGET_FILL_DIVISOR_MIN (16)
+#define TARGET_FILL_DIVISOR_INIT (8)
+#define TARGET_FILL_DIVISOR_MAX (2)
+//Reads without underruns needed before lowering the target fill level
+#define TARGET_FILL_DECAY_READS (2000)
+
+CSoundRingBuffer::CSoundRingBuffer(unsigned int capacity, unsigned int maxWriteSize)
+    : m_capacity(capacity)
+    , m_maxWriteSize(maxWriteSize)
+    , m_buffer(capacity + maxWriteSize)
+{
+	assert(maxWriteSize <= capacity);
+	assert((capacity % TARGET_FILL_DIVISOR_MIN) == 0);
+	Reset();
+}
+
+void CSoundRingBuffer::Reset()
+{
+	m_readPosition.store(m_writePosition.load(std::memory_order_acquire), std::memory_order_release);
+	m_targetFillLevel = m_capacity / TARGET_FILL_DIVISOR_INIT;
+	m_underrunCount = 0;
+	m_droppedWriteCount = 0;
+	m_started = false;
+	m_readsSinceUnderrun = 0;
+}
+
+int16* CSoundRingBuffer::GetWritePointer(unsigned int sampleCount)
+{
+	assert(sampleCount <= m_maxWriteSize);
+	if(!CanWrite(sampleCount))
+	{
+		return nullptr;
+	}
+	uint64 writePosition = m_writePosition.load(std::memory_order_relaxed);
+	return m_buffer.data() + (writePosition % m_capacity);
+}
+
+void CSoundRingBuffer::CommitWrite(unsigned int sampleCount)
+{
+	uint64 writePosition = m_writePosition.load(std::memory_order_relaxed);
+	unsigned int offset = static_cast<unsigned int>(writePosition % m_capacity);
+	if((offset + sampleCount) > m_capacity)
+	{
+		unsigned int overflow = (offset + sampleCount) - m_capacity;
+		memcpy(m_buffer.data(), m_buffer.data() + m_capacity, overflow * sizeof(int16));
+	}
+	m_writePosition.store(writePosition + sampleCount, std::memory_order_release);
+}
+
+bool CSoundRingBuffer::Write(const int16* samples, unsigned int sampleCount)
+{
+	while(sampleCount != 0)
+	{
+		unsigned int writeSize = std::min(sampleCount, m_maxWriteSize);
+		int16* dst = GetWritePointer(writeSize);
+		if(!dst)
+		{
+			return false;
+		}
+		memcpy(dst, samples, writeSize * sizeof(int16));
+		CommitWrite(writeSize);
+		samples += writeSize;
+		sampleCount -= writeSize;
+	}
+	return true;
+}
+
+void CSoundRingBuffer::Read(int16* samples, unsigned int sampleCount)
+{
+	uint64 readPosition = m_readPosition.load(std::memory_order_relaxed);
+	uint64 writePosition = m_writePosition.load(std::memory_order_acquire);
+	unsigned int available = static_cast<unsigned int>(std::min<uint64>(writePosition - readPosition, sampleCount));
+
+	unsigned int offset = static_cast<unsigned int>(readPosition % m_capacity);
+	unsigned int firstSize = std::min(available, m_capacity - offset);
+	memcpy(samples, m_buffer.data() + offset, firstSize * sizeof(int16));
+	memcpy(samples + firstSize, m_buffer.data(), (available - firstSize) * sizeof(int16));
+	memset(samples + available, 0, (sampleCount - available) * sizeof(int16));
+
+	m_readPosition.store(readPosition + available, std::memory_order_release);
+
+	//Ring is empty until the producer starts, that's not an underrun
+	if(available == sampleCount)
+	{
+		m_started = true;
+	}
+	if(!m_started)
+	{
+		return;
+	}
+
+	uint32 targetFillLevel = m_targetFillLevel.load(std::memory_order_relaxed);
+	if(available != sampleCount)
+	{
+		m_underrunCount.fetch_add(1, std::memory_order_relaxed);
+		m_readsSinceUnderrun = 0;
+		targetFillLevel = std::min(targetFillLevel + (m_capacity / TARGET_FILL_DIVISOR_MIN), m_capacity / TARGET_FILL_DIVISOR_MAX);
+	}
+	else if(++m_readsSinceUnderrun == TARGET_FILL_DECAY_READS)
+	{
+		m_readsSinceUnderrun = 0;
+		targetFillLevel = std::max(targetFillLevel - (m_capacity / (TARGET_FILL_DIVISOR_MIN * 4)), m_capacity / TARGET_FILL_DIVISOR_MIN);
+	}
+	m_targetFillLevel.store(targetFillLevel, std::memory_order_relaxed);
+}
+
+CSoundRingBuffer::STATS CSoundRingBuffer::GetStats() const
+{
+	STATS stats;
+	stats.fillLevel = GetFillLevel();
+	stats.targetFillLevel = m_targetFillLevel.load(std::memory_order_relaxed);
+	stats.underrunCount = m_underrunCount.load(std::memory_order_relaxed);
+	stats.droppedWriteCount = m_droppedWriteCount.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void CSoundRingBuffer::ClearStats()
+{
+	m_underrunCount.store(0, std::memory_order_relaxed);
+	m_droppedWriteCount.store(0, std::memory_order_relaxed);
+}
+
+uint32 CSoundRingBuffer::GetFillLevel() const
+{
+	uint64 writePosition = m_writePosition.load(std::memory_order_acquire);
+	uint64 readPosition = m_readPosition.load(std::memory_order_acquire);
+	return static_cast<uint32>(writePosition - readPosition);
+}
+
+bool CSoundRingBuffer::CanWrite(unsigned int sampleCount)
+{
+	uint32 fillLevel = GetFillLevel();
+	uint32 maxFillLevel = std::min(m_targetFillLevel.load(std::memory_order_relaxed) * 2, m_capacity);
+	if((fillLevel + sampleCount) > maxFillLevel)
+	{
+		m_droppedWriteCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include "Types.h"
+
+//Lock-free ring of interleaved stereo samples shared by a single producer (the emulator
+//thread rendering samples) and a single consumer (the audio device's callback pulling them).
+//The consumer adapts the fill level it wants to the underruns it sees and the producer drops
+//samples once the ring holds twice that amount, which bounds latency.
+class CSoundRingBuffer
+{
+public:
+	struct STATS
+	{
+		uint32 fillLevel = 0;
+		uint32 targetFillLevel = 0;
+		uint32 underrunCount = 0;
+		uint32 droppedWriteCount = 0;
+	};
+
+	CSoundRingBuffer(unsigned int, unsigned int);
+
+	//Must not be called while the consumer is reading
+	void Reset();
+
+	//Producer
+	int16* GetWritePointer(unsigned int);
+	void CommitWrite(unsigned int);
+	bool Write(const int16*, unsigned int);
+
+	//Consumer, missing samples are replaced by silence
+	void Read(int16*, unsigned int);
+
+	STATS GetStats() const;
+	//Clears underrun and dropped write counters, called by the producer
+	void ClearStats();
+
+private:
+	uint32 GetFillLevel() const;
+	bool CanWrite(unsigned int);
+
+	unsigned int m_capacity = 0;
+	unsigned int m_maxWriteSize = 0;
+	//Extra space after the ring lets writes be contiguous, it is copied back to the start when committed
+	std::vector<int16> m_buffer;
+
+	//Positions only ever increase, each one is written by one side only
+	std::atomic<uint64> m_writePosition = 0;
+	std::atomic<uint64> m_readPosition = 0;
+
+	std::atomic<uint32> m_targetFillLevel = 0;
+	std::atomic<uint32> m_underrunCount = 0;
+	std::atomic<uint32> m_droppedWriteCount = 0;
+
+	//Only used by the consumer
+	bool m_started = false;
+	uint32 m_readsSinceUnderrun = 0;
+};
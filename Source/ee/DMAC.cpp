@@ -135,6 +135,8 @@ void CDMAC::Reset()
 	//Reset Channel 9
 	m_D9.Reset();
 	m_D9_SADR = 0;
+
+	ClearStats();
 }
 
 void CDMAC::SetChannelTransferFunction(unsigned int channel, const DmaReceiveHandler& handler)
@@ -213,6 +215,7 @@ uint32 CDMAC::ResumeDMA3(const void* pBuffer, uint32 nSize)
 
 	m_D3_MADR += (nSize * 0x10);
 	m_D3_QWC -= nSize;
+	m_channelStats[CHANNEL_ID_FROM_IPU].qwordCount += nSize;
 
 	if(m_D_CTRL.sts == D_CTRL_STS_FROM_IPU)
 	{
@@ -244,6 +247,55 @@ bool CDMAC::IsDMA4Started() const
 	return (m_D4.m_CHCR.nSTR != 0) && ((m_D_ENABLE & CDMAC::ENABLE_CPND) == 0);
 }
 
+void CDMAC::GetDMA4PendingData(std::vector<uint8>& data) const
+{
+	//Appends the data the current DMA4 transfer (or chain tag) has yet to send
+	if(!IsDMA4Started()) return;
+	if(m_D4.m_nQWC == 0) return;
+
+	uint32 address = m_D4.m_nMADR;
+	uint32 size = m_D4.m_nQWC * 0x10;
+	const uint8* memory = nullptr;
+	uint32 memorySize = 0;
+	if(address & 0x80000000)
+	{
+		memory = m_spr;
+		memorySize = PS2::EE_SPR_SIZE;
+	}
+	else
+	{
+		memory = m_ram;
+		memorySize = PS2::EE_RAM_SIZE;
+	}
+	address &= (memorySize - 1);
+	size = std::min<uint32>(size, memorySize - address);
+	data.insert(data.end(), memory + address, memory + address + size);
+}
+
+void CDMAC::CountTicks(uint32 ticks)
+{
+	m_D0.CountTicks(ticks);
+	m_D1.CountTicks(ticks);
+	m_D2.CountTicks(ticks);
+	m_D4.CountTicks(ticks);
+	m_D8.CountTicks(ticks);
+	m_D9.CountTicks(ticks);
+}
+
+const DMA_CHANNEL_STATS& CDMAC::GetChannelStats(unsigned int channel) const
+{
+	assert(channel < CHANNEL_COUNT);
+	return m_channelStats[channel];
+}
+
+void CDMAC::ClearStats()
+{
+	for(auto& channelStats : m_channelStats)
+	{
+		channelStats = DMA_CHANNEL_STATS();
+	}
+}
+
 uint64 CDMAC::FetchDMATag(uint32 address)
 {
 	if(address & 0x80000000)
@@ -753,6 +805,7 @@ void CDMAC::SetRegister(uint32 nAddress, uint32 nData)
 		if(m_D5_CHCR & CHCR_STR)
 		{
 			m_receiveDma5(m_D5_MADR, m_D5_QWC * 0x10, 0, false);
+			m_channelStats[CHANNEL_ID_SIF0].qwordCount += m_D5_QWC;
 			m_D5_CHCR &= ~CHCR_STR;
 			m_D_STAT |= (1 << CHANNEL_ID_SIF0);
 		}
@@ -786,6 +839,7 @@ void CDMAC::SetRegister(uint32 nAddress, uint32 nData)
 		if(m_D6_CHCR & 0x100)
 		{
 			m_receiveDma6(m_D6_MADR, m_D6_QWC * 0x10, m_D6_TADR, false);
+			m_channelStats[CHANNEL_ID_SIF1].qwordCount += m_D6_QWC;
 			m_D6_CHCR &= ~0x100;
 		}
 		break;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <vector>
 #include "Types.h"
+#include "../DmaStats.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
 #include "Dmac_Channel.h"
@@ -26,6 +28,11 @@ public:
 		CHANNEL_ID_TO_SPR
 	};
 
+	enum
+	{
+		CHANNEL_COUNT = CHANNEL_ID_TO_SPR + 1,
+	};
+
 	enum REGISTER
 	{
 		D0_CHCR = 0x10008000,
@@ -131,6 +138,12 @@ public:
 	void ResumeDMA4();
 	void ResumeDMA8();
 	bool IsDMA4Started() const;
+	void GetDMA4PendingData(std::vector<uint8>&) const;
+
+	void CountTicks(uint32);
+	const DMA_CHANNEL_STATS& GetChannelStats(unsigned int) const;
+	void ClearStats();
+
 	static bool IsEndSrcTagId(uint32);
 	static bool IsEndDstTagId(uint32);
 
@@ -228,4 +241,6 @@ private:
 
 	Dmac::DmaReceiveHandler m_receiveDma5;
 	Dmac::DmaReceiveHandler m_receiveDma6;
+
+	DMA_CHANNEL_STATS m_channelStats[CHANNEL_COUNT];
 };
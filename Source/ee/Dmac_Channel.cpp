@@ -5,6 +5,7 @@
 #include "../Log.h"
 #include "Dmac_Channel.h"
 #include "DMAC.h"
+#include "../Ps2Const.h"
 
 #define LOG_NAME ("ee_dmac")
 #define STATE_REGS_XML_FORMAT ("dmac/channel_%d.xml")
@@ -38,6 +39,7 @@ void CChannel::Reset()
 	m_nSCCTRL = 0;
 	m_nASR[0] = 0;
 	m_nASR[1] = 0;
+	m_stalled = false;
 }
 
 void CChannel::SaveState(Framework::CZipArchiveWriter& archive)
@@ -110,6 +112,7 @@ void CChannel::Execute()
 		{
 			return;
 		}
+		uint32 qwordCount = m_dmac.m_channelStats[m_number].qwordCount;
 		switch(m_CHCR.nMOD)
 		{
 		case 0x00:
@@ -142,6 +145,7 @@ void CChannel::Execute()
 			assert(0);
 			break;
 		}
+		UpdateStallStats(qwordCount);
 	}
 }
 
@@ -191,6 +195,7 @@ void CChannel::ExecuteNormal()
 	}
 
 	uint32 nRecv = m_receive(m_nMADR, qwc, m_CHCR.nDIR, false);
+	m_dmac.m_channelStats[m_number].qwordCount += nRecv;
 
 	m_nMADR += nRecv * 0x10;
 	m_nQWC -= nRecv;
@@ -223,6 +228,7 @@ void CChannel::ExecuteInterleave()
 			uint32 qwc = m_dmac.m_D_SQWC.tqwc;
 			uint32 recv = m_receive(m_nMADR, qwc, CHCR_DIR_FROM, false);
 			assert(recv == qwc);
+			m_dmac.m_channelStats[m_number].qwordCount += recv;
 
 			m_nMADR += recv * 0x10;
 			m_nQWC -= recv;
@@ -317,6 +323,7 @@ void CChannel::ExecuteSourceChain()
 				m_CHCR.nReserved0 = 1;
 				break;
 			}
+			m_dmac.m_channelStats[m_number].qwordCount++;
 		}
 		else
 		{
@@ -357,6 +364,16 @@ void CChannel::ExecuteSourceChain()
 				break;
 			}
 
+			if(CanExecuteSourceChainSpans(isMfifo, isStallDrainChannel) && ExecuteSourceChainSpans())
+			{
+				if(m_CHCR.nReserved0)
+				{
+					//Device didn't receive DmaTag, break for now
+					break;
+				}
+				continue;
+			}
+
 			if(m_CHCR.nTTE == 1)
 			{
 				m_CHCR.nReserved0 = 0;
@@ -366,6 +383,7 @@ void CChannel::ExecuteSourceChain()
 					m_CHCR.nReserved0 = 1;
 					break;
 				}
+				m_dmac.m_channelStats[m_number].qwordCount++;
 			}
 		}
 
@@ -377,6 +395,7 @@ void CChannel::ExecuteSourceChain()
 		}
 
 		uint64 nTag = m_dmac.FetchDMATag(m_nTADR);
+		m_dmac.m_channelStats[m_number].tagCount++;
 
 		//Save higher 16 bits of tag into CHCR
 		m_CHCR.nTAG = static_cast<uint16>(nTag >> 16);
@@ -457,6 +476,212 @@ void CChannel::ExecuteSourceChain()
 	}
 }
 
+bool CChannel::CanExecuteSourceChainSpans(bool isMfifo, bool isStallDrainChannel) const
+{
+	//MFIFO and stall control need to be checked on every tag, leave them to the regular path
+	if(isMfifo || isStallDrainChannel) return false;
+	switch(m_number)
+	{
+	case CDMAC::CHANNEL_ID_VIF0:
+	case CDMAC::CHANNEL_ID_VIF1:
+	case CDMAC::CHANNEL_ID_GIF:
+		return true;
+	default:
+		return false;
+	}
+}
+
+//Resolves a run of tags ahead of time and hands the data to the device in as few
+//calls as possible, merging data blocks that follow each other in memory.
+//Returns false if no tag could be resolved, in which case the regular path must be used.
+bool CChannel::ExecuteSourceChainSpans()
+{
+	SPAN_TAG tags[MAX_SPAN_TAGS];
+	uint32 tagCount = GatherSourceChainSpanTags(tags);
+	if(tagCount == 0)
+	{
+		return false;
+	}
+
+	auto& stats = m_dmac.m_channelStats[m_number];
+
+	//With TTE, the device receives every tag before its data
+	bool tagTransfer = (m_CHCR.nTTE != 0);
+	SPAN_ITEM items[MAX_SPAN_TAGS * 2];
+	uint32 itemCount = 0;
+	for(uint32 tagIndex = 0; tagIndex < tagCount; tagIndex++)
+	{
+		const auto& tag = tags[tagIndex];
+		if(tagTransfer)
+		{
+			uint32 tagAddress = (tagIndex == 0) ? m_nTADR : tags[tagIndex - 1].tadr;
+			items[itemCount++] = {tagAddress, 1, tagIndex, true};
+		}
+		items[itemCount++] = {tag.madr, tag.qwc, tagIndex, false};
+	}
+
+	uint32 itemIndex = 0;
+	while(itemIndex < itemCount)
+	{
+		//A span starts on any item and continues with data items contiguous to it
+		uint32 spanAddress = 0;
+		uint32 spanQwc = 0;
+		uint32 spanItemCount = 0;
+		bool spanTagIncluded = false;
+		uint32 spanEnd = itemIndex;
+		for(; spanEnd < itemCount; spanEnd++)
+		{
+			const auto& item = items[spanEnd];
+			if(item.qwc == 0) continue;
+			if(spanItemCount == 0)
+			{
+				spanAddress = item.address;
+				spanTagIncluded = item.isTag;
+			}
+			else if(item.isTag || (item.address != (spanAddress + (spanQwc * 0x10))))
+			{
+				break;
+			}
+			spanQwc += item.qwc;
+			spanItemCount++;
+		}
+
+		uint32 recv = 0;
+		if(spanQwc != 0)
+		{
+			recv = m_receive(spanAddress, spanQwc, CHCR_DIR_FROM, spanTagIncluded);
+			stats.qwordCount += recv;
+		}
+
+		//Update registers as if the tags in the span had been processed one by one
+		for(; itemIndex < spanEnd; itemIndex++)
+		{
+			const auto& item = items[itemIndex];
+			const auto& tag = tags[item.tagIndex];
+			if((recv == 0) && (item.qwc != 0) && (spanItemCount > 1))
+			{
+				//Device took nothing from this item, but might take it by itself as it
+				//would on the regular path (ie.: GIF holding path 3 data in its FIFO)
+				recv = m_receive(item.address, item.qwc, CHCR_DIR_FROM, item.isTag);
+				stats.qwordCount += recv;
+				spanItemCount = 1;
+				spanEnd = itemIndex + 1;
+			}
+			if(item.isTag)
+			{
+				if(recv == 0)
+				{
+					//Device didn't receive DmaTag
+					m_CHCR.nReserved0 = 1;
+					return true;
+				}
+				recv--;
+			}
+			if(item.isTag || !tagTransfer)
+			{
+				stats.tagCount++;
+				m_CHCR.nTAG = tag.tag;
+				m_nMADR = tag.madr;
+				m_nQWC = tag.qwc;
+				m_nTADR = tag.tadr;
+			}
+			if(!item.isTag)
+			{
+				uint32 transferred = std::min(recv, m_nQWC);
+				m_nMADR += transferred * 0x10;
+				m_nQWC -= transferred;
+				recv -= transferred;
+				if(m_nQWC != 0)
+				{
+					//Transfer isn't finished, suspend for now
+					return true;
+				}
+			}
+		}
+		assert(recv == 0);
+	}
+
+	return true;
+}
+
+//Fetches tags starting at TADR until one needs the regular path (CALL, RET, data or tags
+//outside of RAM) or ends the transfer (END, REFE, IRQ with TIE). Tags ending the transfer
+//are part of the run, others are left for the regular path.
+uint32 CChannel::GatherSourceChainSpanTags(SPAN_TAG* tags) const
+{
+	uint32 tagCount = 0;
+	uint32 tadr = m_nTADR;
+	while(tagCount < MAX_SPAN_TAGS)
+	{
+		//TADR = 0 is handled by the regular path
+		if((tadr == 0) || !IsRamRange(tadr, 1))
+		{
+			break;
+		}
+
+		uint64 nTag = m_dmac.FetchDMATag(tadr);
+		uint8 nID = static_cast<uint8>((nTag >> 28) & 0x07);
+		uint32 tagAddr = static_cast<uint32>((nTag >> 32) & DMATAG_ADDR_MASK);
+		uint32 tagQwc = static_cast<uint32>(nTag & 0xFFFF);
+
+		SPAN_TAG spanTag;
+		spanTag.tag = static_cast<uint16>(nTag >> 16);
+		spanTag.qwc = tagQwc;
+		bool isLastTag = false;
+		switch(nID)
+		{
+		case DMATAG_SRC_REFE:
+			spanTag.madr = tagAddr;
+			spanTag.tadr = tadr + 0x10;
+			isLastTag = true;
+			break;
+		case DMATAG_SRC_CNT:
+			spanTag.madr = tadr + 0x10;
+			spanTag.tadr = spanTag.madr + (tagQwc * 0x10);
+			break;
+		case DMATAG_SRC_NEXT:
+			spanTag.madr = tadr + 0x10;
+			spanTag.tadr = tagAddr;
+			break;
+		case DMATAG_SRC_REF:
+		case DMATAG_SRC_REFS:
+			spanTag.madr = tagAddr;
+			spanTag.tadr = tadr + 0x10;
+			break;
+		case DMATAG_SRC_END:
+			spanTag.madr = tadr + 0x10;
+			spanTag.tadr = tadr;
+			isLastTag = true;
+			break;
+		default:
+			//CALL and RET, need to go through ASR
+			return tagCount;
+		}
+
+		if(!IsRamRange(spanTag.madr, tagQwc))
+		{
+			break;
+		}
+
+		tags[tagCount++] = spanTag;
+		tadr = spanTag.tadr;
+
+		if(isLastTag || ((m_CHCR.nTIE != 0) && ((spanTag.tag & DMATAG_IRQ) != 0)))
+		{
+			break;
+		}
+	}
+	return tagCount;
+}
+
+bool CChannel::IsRamRange(uint32 address, uint32 qwc)
+{
+	//Scratchpad and memory mapped sources go through the regular path
+	if(address & 0x80000000) return false;
+	if(address >= PS2::EE_RAM_SIZE) return false;
+	return (qwc * 0x10) <= (PS2::EE_RAM_SIZE - address);
+}
+
 void CChannel::ExecuteDestinationChain()
 {
 	assert(m_number == CDMAC::CHANNEL_ID_FROM_SPR);
@@ -472,6 +697,7 @@ void CChannel::ExecuteDestinationChain()
 		{
 			auto tag = make_convertible<DMAtag>(m_dmac.FetchDMATag(m_dmac.m_D8_SADR | 0x80000000));
 			m_dmac.m_D8_SADR += 0x10;
+			m_dmac.m_channelStats[m_number].tagCount++;
 
 			assert(tag.irq == 0);
 			assert(tag.pce == 0);
@@ -497,6 +723,7 @@ void CChannel::ExecuteDestinationChain()
 
 		uint32 recv = m_receive(m_nMADR, m_nQWC, m_CHCR.nDIR, false);
 		assert(recv == m_nQWC);
+		m_dmac.m_channelStats[m_number].qwordCount += recv;
 
 		m_nMADR += recv * 0x10;
 		m_nQWC -= recv;
@@ -513,6 +740,14 @@ void CChannel::SetReceiveHandler(const DmaReceiveHandler& handler)
 	m_receive = handler;
 }
 
+void CChannel::CountTicks(uint32 ticks)
+{
+	if(m_stalled && (m_CHCR.nSTR != 0))
+	{
+		m_dmac.m_channelStats[m_number].waitTicks += ticks;
+	}
+}
+
 void CChannel::ExecuteSourceChainTransfer(bool isMfifo)
 {
 	uint32 nID = m_CHCR.nTAG >> 12;
@@ -531,6 +766,7 @@ void CChannel::ExecuteSourceChainTransfer(bool isMfifo)
 	if(qwc != 0)
 	{
 		uint32 nRecv = m_receive(m_nMADR, qwc, CHCR_DIR_FROM, false);
+		m_dmac.m_channelStats[m_number].qwordCount += nRecv;
 
 		m_nMADR += nRecv * 0x10;
 		m_nQWC -= nRecv;
@@ -570,3 +806,20 @@ void CChannel::ClearSTR()
 
 	m_dmac.UpdateCpCond();
 }
+
+void CChannel::UpdateStallStats(uint32 prevQwordCount)
+{
+	//A transfer is stalled when it's still running after having been executed
+	auto& stats = m_dmac.m_channelStats[m_number];
+	bool progressed = (stats.qwordCount != prevQwordCount);
+	bool stalled = (m_CHCR.nSTR != 0);
+	if(m_stalled && progressed)
+	{
+		stats.resumeCount++;
+	}
+	if(stalled && (!m_stalled || progressed))
+	{
+		stats.stallCount++;
+	}
+	m_stalled = stalled;
+}
@@ -79,6 +79,7 @@ namespace Dmac
 		void ExecuteSourceChain();
 		void ExecuteDestinationChain();
 		void SetReceiveHandler(const DmaReceiveHandler&);
+		void CountTicks(uint32);
 
 		CHCR m_CHCR;
 		uint32 m_nMADR;
@@ -93,12 +94,39 @@ namespace Dmac
 			SCCTRL_INITXFER = 0x200,
 		};
 
+		enum
+		{
+			MAX_SPAN_TAGS = 32,
+		};
+
+		struct SPAN_TAG
+		{
+			uint16 tag;
+			uint32 madr;
+			uint32 qwc;
+			uint32 tadr;
+		};
+
+		struct SPAN_ITEM
+		{
+			uint32 address;
+			uint32 qwc;
+			uint32 tagIndex;
+			bool isTag;
+		};
+
+		bool CanExecuteSourceChainSpans(bool, bool) const;
+		bool ExecuteSourceChainSpans();
+		uint32 GatherSourceChainSpanTags(SPAN_TAG*) const;
+		static bool IsRamRange(uint32, uint32);
 		void ExecuteSourceChainTransfer(bool);
 		void ClearSTR();
+		void UpdateStallStats(uint32);
 
 		CDMAC& m_dmac;
 		unsigned int m_number = 0;
 		DmaReceiveHandler m_receive;
 		uint32 m_nSCCTRL;
+		bool m_stalled = false;
 	};
 };
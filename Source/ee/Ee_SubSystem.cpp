@@ -159,6 +159,7 @@ CSubSystem::CSubSystem(uint8* iopRam, CIopBios& iopBios)
 	m_dmac.SetChannelTransferFunction(CDMAC::CHANNEL_ID_SIF1, std::bind(&CSIF::ReceiveDMA6, &m_sif, PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
 
 	m_ipu.SetDMA3ReceiveHandler(std::bind(&CDMAC::ResumeDMA3, &m_dmac, PLACEHOLDER_1, PLACEHOLDER_2));
+	m_ipu.SetDMA4PendingDataHandler(std::bind(&CDMAC::GetDMA4PendingData, &m_dmac, PLACEHOLDER_1));
 
 	m_os = new CPS2OS(m_EE, m_ram, m_bios, m_spr, m_gs, m_sif, iopBios);
 	m_OnRequestInstructionCacheFlushConnection = m_os->OnRequestInstructionCacheFlush.Connect(std::bind(&CSubSystem::FlushInstructionCache, this));
@@ -316,6 +317,7 @@ void CSubSystem::CountTicks(int ticks)
 	}
 	m_dmac.ResumeDMA2();
 	m_dmac.ResumeDMA8();
+	m_dmac.CountTicks(ticks);
 	m_gif.CountTicks(ticks);
 	m_ipu.CountTicks(ticks);
 	m_vpu0->GetVif().CountTicks(ticks);
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <exception>
 #include <functional>
+#include <limits>
 #include "maybe_unused.h"
 #include "IPU_MacroblockAddressIncrementTable.h"
 #include "IPU_MacroblockTypeITable.h"
@@ -12,6 +13,7 @@
 #include "IPU_MacroblockTypeBTable.h"
 #include "IPU_MotionCodeTable.h"
 #include "IPU_DmVectorTable.h"
+#include "IPU_Csc.h"
 #include "mpeg2/DcSizeLuminanceTable.h"
 #include "mpeg2/DcSizeChrominanceTable.h"
 #include "mpeg2/DctCoefficientTable0.h"
@@ -19,8 +21,7 @@
 #include "mpeg2/CodedBlockPatternTable.h"
 #include "mpeg2/QuantiserScaleTable.h"
 #include "mpeg2/InverseScanTable.h"
-#include "idct/TrivialC.h"
-#include "idct/IEEE1180.h"
+#include "ThreadUtils.h"
 #include "../Log.h"
 #include "DMAC.h"
 #include "INTC.h"
@@ -236,6 +237,18 @@ void CIPU::SetRegister(uint32 nAddress, uint32 nValue)
 	DisassembleSet(nAddress, nValue);
 #endif
 
+	if(m_trace)
+	{
+		if(!m_trace->IsStarted() && (nAddress == IPU_CTRL) && (nValue & IPU_CTRL_RST))
+		{
+			m_trace->Start(m_nIntraIQ, m_nNonIntraIQ, m_nVQCLUT);
+		}
+		if(m_trace->IsStarted())
+		{
+			m_trace->AddRegisterWrite(nAddress, nValue);
+		}
+	}
+
 	switch(nAddress)
 	{
 	case IPU_CMD + 0x0:
@@ -381,6 +394,7 @@ void CIPU::ExecuteCommand()
 		//Clear BUSY states
 		m_isBusy = false;
 		m_intc.AssertLine(CINTC::INTC_LINE_IPU);
+		TraceCommandEnd();
 	}
 	catch(const Framework::CBitStream::CBitStreamException&)
 	{
@@ -391,6 +405,7 @@ void CIPU::ExecuteCommand()
 		m_isBusy = false;
 		m_IPU_CTRL |= IPU_CTRL_SCD;
 		CLog::GetInstance().Print(LOG_NAME, "Start code encountered.\r\n");
+		TraceCommandEnd();
 	}
 	catch(const CVLCTable::CVLCTableException&)
 	{
@@ -398,6 +413,7 @@ void CIPU::ExecuteCommand()
 		m_isBusy = false;
 		m_IPU_CTRL |= IPU_CTRL_ECD;
 		CLog::GetInstance().Warn(LOG_NAME, "VLC error encountered.\r\n");
+		TraceCommandEnd();
 	}
 }
 
@@ -460,7 +476,52 @@ void CIPU::InitializeCommand(uint32 value)
 
 void CIPU::SetDMA3ReceiveHandler(const Dma3ReceiveHandler& receiveHandler)
 {
-	m_OUT_FIFO.SetReceiveHandler(receiveHandler);
+	m_OUT_FIFO.SetReceiveHandler(
+	    [this, receiveHandler](const void* data, uint32 size) {
+		    uint32 result = receiveHandler(data, size);
+		    if(m_trace && m_trace->IsStarted())
+		    {
+			    m_trace->AddOutputData(data, result * 0x10);
+		    }
+		    return result;
+	    });
+}
+
+void CIPU::SetDMA4PendingDataHandler(const Dma4PendingDataHandler& handler)
+{
+	m_dma4PendingDataHandler = handler;
+}
+
+void CIPU::SetFastIdctEnabled(bool enabled)
+{
+	m_idctTransform = enabled ? &IpuIdct::Transform : &IpuIdct::TransformReference;
+}
+
+void CIPU::SetTrace(CIpuTrace* trace)
+{
+	m_trace = trace;
+}
+
+void CIPU::SetDecodeAheadEnabled(bool enabled)
+{
+	if(enabled == (m_decodeAheadWorker != nullptr))
+	{
+		return;
+	}
+	m_IDECCommand.SetDecodeAheadWorker(nullptr);
+	m_decodeAheadWorker.reset();
+	if(enabled)
+	{
+		//VLC tables are created on first use, make sure this doesn't happen on the worker thread
+		CMacroblockTypeITable::GetInstance();
+		CMacroblockAddressIncrementTable::GetInstance();
+		CDcSizeLuminanceTable::GetInstance();
+		CDcSizeChrominanceTable::GetInstance();
+		CDctCoefficientTable0::GetInstance();
+		CDctCoefficientTable1::GetInstance();
+		m_decodeAheadWorker = std::make_unique<CDecodeAheadWorker>(m_dma4PendingDataHandler);
+		m_IDECCommand.SetDecodeAheadWorker(m_decodeAheadWorker.get());
+	}
 }
 
 uint32 CIPU::ReceiveDMA4(uint32 address, uint32 nQWC, bool nTagIncluded, uint8* ram, uint8* spr)
@@ -487,6 +548,10 @@ uint32 CIPU::ReceiveDMA4(uint32 address, uint32 nQWC, bool nTagIncluded, uint8*
 	if(size != 0)
 	{
 		m_IN_FIFO.Write(memory + address, size);
+		if(m_trace && m_trace->IsStarted())
+		{
+			m_trace->AddDma4Data(memory + address, size);
+		}
 	}
 
 	return size / 0x10;
@@ -503,6 +568,7 @@ CIPU::DECODER_CONTEXT CIPU::GetDecoderContext()
 	context.intraIq = m_nIntraIQ;
 	context.nonIntraIq = m_nNonIntraIQ;
 	context.dcPredictor = m_nDcPredictor;
+	context.idctTransform = m_idctTransform;
 	return context;
 }
 
@@ -677,6 +743,16 @@ CIPU::FIFO_STATE CIPU::GetFifoState() const
 	return state;
 }
 
+void CIPU::TraceCommandEnd()
+{
+	if(m_trace && m_trace->IsStarted())
+	{
+		//Only VDEC and FDEC have a result, reading CMD otherwise depends on how much data DMA4 sent
+		bool hasResult = (m_lastCmdId == IPU_CMD_VDEC) || (m_lastCmdId == IPU_CMD_FDEC);
+		m_trace->AddCommandEnd(m_IPU_CTRL, hasResult ? m_IPU_CMD[0] : 0);
+	}
+}
+
 void CIPU::DisassembleGet(uint32 nAddress)
 {
 	switch(nAddress)
@@ -862,7 +938,9 @@ void CIPU::COUTFIFO::RequestGrow(unsigned int size)
 /////////////////////////////////////////////
 
 CIPU::CINFIFO::CINFIFO()
-    : m_size(0)
+    : m_lookupBits(0)
+    , m_lookupBitsDirty(true)
+    , m_size(0)
     , m_bitPosition(0)
 {
 }
@@ -912,6 +990,19 @@ bool CIPU::CINFIFO::TryPeekBits_MSBF(uint8 size, uint32& result)
 	return true;
 }
 
+uint32 CIPU::CINFIFO::PeekLookupBits()
+{
+	//Returns the next 32 bits without checking availability, bits past the end
+	//of the FIFO are undefined and callers must check GetAvailableBits
+	if(m_lookupBitsDirty)
+	{
+		SyncLookupBits();
+		m_lookupBitsDirty = false;
+	}
+
+	return static_cast<uint32>(m_lookupBits >> (32 - (m_bitPosition % 32)));
+}
+
 void CIPU::CINFIFO::Advance(uint8 bits)
 {
 	if(bits == 0) return;
@@ -946,6 +1037,7 @@ void CIPU::CINFIFO::Advance(uint8 bits)
 		m_size -= 16;
 		m_bitPosition -= 128;
 		m_lookupBitsDirty = true;
+		m_discardCount++;
 	}
 }
 
@@ -954,9 +1046,20 @@ uint8 CIPU::CINFIFO::GetBitIndex() const
 	return m_bitPosition;
 }
 
+uint32 CIPU::CINFIFO::GetDiscardCount() const
+{
+	return m_discardCount;
+}
+
 void CIPU::CINFIFO::SetBitPosition(unsigned int position)
 {
 	m_bitPosition = position;
+	m_lookupBitsDirty = true;
+}
+
+const uint8* CIPU::CINFIFO::GetBuffer() const
+{
+	return m_buffer;
 }
 
 unsigned int CIPU::CINFIFO::GetSize() const
@@ -975,6 +1078,7 @@ void CIPU::CINFIFO::Reset()
 	m_size = 0;
 	m_lookupBits = 0;
 	m_lookupBitsDirty = false;
+	m_discardCount = 0;
 }
 
 void CIPU::CINFIFO::SaveState(const char* regsFileName, Framework::CZipArchiveWriter& archive)
@@ -997,13 +1101,161 @@ void CIPU::CINFIFO::LoadState(const char* regsFileName, Framework::CZipArchiveRe
 
 void CIPU::CINFIFO::SyncLookupBits()
 {
+	//Lookup bits hold the 64-bit big endian word starting at the 32-bit word
+	//containing the current position, any peek of 32 bits or less fits in there
 	unsigned int lookupPosition = (m_bitPosition & ~0x1F) / 8;
-	uint8 lookupBytes[8];
+	assert((lookupPosition + 8) <= BUFFERSIZE);
+	uint64 lookupBits = 0;
 	for(unsigned int i = 0; i < 8; i++)
 	{
-		lookupBytes[7 - i] = m_buffer[lookupPosition + i];
+		lookupBits = (lookupBits << 8) | m_buffer[lookupPosition + i];
+	}
+	m_lookupBits = lookupBits;
+}
+
+/////////////////////////////////////////////
+//Decode ahead worker implementation
+/////////////////////////////////////////////
+
+CIPU::CDecodeAheadWorker::JOB::MACROBLOCK_STATUS CIPU::CDecodeAheadWorker::JOB::TryGetMacroblock(uint32 index, MACROBLOCK& macroblock)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if(index >= macroblocks.size())
+	{
+		return done ? MACROBLOCK_UNAVAILABLE : MACROBLOCK_PENDING;
+	}
+	macroblock = macroblocks[index];
+	return MACROBLOCK_READY;
+}
+
+CIPU::CDecodeAheadWorker::CDecodeAheadWorker(const Dma4PendingDataHandler& pendingDataHandler)
+    : m_pendingDataHandler(pendingDataHandler)
+{
+	m_thread = std::thread([this]() { ThreadProc(); });
+	Framework::ThreadUtils::SetThreadName(m_thread, "IPU Decode Ahead Thread");
+}
+
+CIPU::CDecodeAheadWorker::~CDecodeAheadWorker()
+{
+	m_mailBox.SendCall([this]() { m_threadDone = true; });
+	m_thread.join();
+}
+
+CIPU::CDecodeAheadWorker::JobPtr CIPU::CDecodeAheadWorker::StartJob(const CINFIFO& inFifo, uint32 commandCode, const DECODER_CONTEXT& context, uint16 TH0, uint16 TH1)
+{
+	auto job = std::make_shared<JOB>();
+
+	//Input is whatever is in the FIFO right now, followed by what DMA4 will send next
+	job->input.assign(inFifo.GetBuffer(), inFifo.GetBuffer() + inFifo.GetSize());
+	job->inputBitPosition = inFifo.GetBitIndex();
+	if(m_pendingDataHandler)
+	{
+		m_pendingDataHandler(job->input);
+	}
+
+	//Decoder state is copied since the worker must not touch the IPU's
+	job->commandCode = commandCode;
+	job->context = context;
+	memcpy(job->intraIq, context.intraIq, sizeof(job->intraIq));
+	memcpy(job->nonIntraIq, context.nonIntraIq, sizeof(job->nonIntraIq));
+	memcpy(job->dcPredictor, context.dcPredictor, sizeof(job->dcPredictor));
+	job->context.intraIq = job->intraIq;
+	job->context.nonIntraIq = job->nonIntraIq;
+	job->context.dcPredictor = job->dcPredictor;
+	job->TH0 = TH0;
+	job->TH1 = TH1;
+
+	m_mailBox.SendCall([job]() { DecodeJob(*job); });
+	return job;
+}
+
+void CIPU::CDecodeAheadWorker::DecodeJob(JOB& job)
+{
+	CINFIFO inFifo;
+	COUTFIFO outFifo;
+	CBDECCommand bdecCommand;
+	CCSCCommand cscCommand;
+	CIDECCommand idecCommand;
+
+	uint32 inputPosition = 0;
+	auto feedInput = [&]() {
+		uint32 size = std::min<uint32>(CINFIFO::BUFFERSIZE - inFifo.GetSize(), job.input.size() - inputPosition);
+		if(size != 0)
+		{
+			inFifo.Write(job.input.data() + inputPosition, size);
+			inputPosition += size;
+		}
+		return size;
+	};
+
+	//CSC flushes every macroblock to the OUT FIFO once converted, which is where we record it
+	outFifo.SetReceiveHandler(
+	    [&](const void* data, uint32 size) -> uint32 {
+		    //Leaving the macroblock in the OUT FIFO stalls the IDEC command, which brings us
+		    //back to the decoding loop without going through the rest of the picture
+		    if(job.cancelled) return 0;
+		    MACROBLOCK macroblock;
+		    macroblock.endBitPosition = (inputPosition * 8) - inFifo.GetAvailableBits();
+		    macroblock.qsc = idecCommand.GetQsc();
+		    memcpy(macroblock.dcPredictor, job.dcPredictor, sizeof(macroblock.dcPredictor));
+		    auto output = reinterpret_cast<const uint8*>(data);
+		    macroblock.output.assign(output, output + (size * 0x10));
+		    {
+			    std::lock_guard<std::mutex> lock(job.mutex);
+			    job.macroblocks.push_back(std::move(macroblock));
+		    }
+		    return size;
+	    });
+
+	feedInput();
+	inFifo.SetBitPosition(job.inputBitPosition);
+	idecCommand.Initialize(&bdecCommand, &cscCommand, &inFifo, &outFifo, job.commandCode, job.context, job.TH0, job.TH1);
+	//No need to wait for anything here
+	idecCommand.CountTicks(std::numeric_limits<int32>::max());
+
+	while(!job.cancelled)
+	{
+		try
+		{
+			if(idecCommand.Execute())
+			{
+				break;
+			}
+		}
+		catch(const Framework::CBitStream::CBitStreamException&)
+		{
+		}
+		catch(const CStartCodeException&)
+		{
+			break;
+		}
+		catch(const CVLCTable::CVLCTableException&)
+		{
+			break;
+		}
+		if(feedInput() == 0)
+		{
+			//Ran out of input, the IDEC command will continue from the last macroblock
+			break;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(job.mutex);
+		job.done = true;
+	}
+}
+
+void CIPU::CDecodeAheadWorker::ThreadProc()
+{
+	while(!m_threadDone)
+	{
+		m_mailBox.WaitForCall();
+		while(m_mailBox.IsPending())
+		{
+			m_mailBox.ReceiveCall();
+		}
 	}
-	m_lookupBits = *reinterpret_cast<uint64*>(lookupBytes);
 }
 
 /////////////////////////////////////////////
@@ -1062,6 +1314,12 @@ void CIPU::CIDECCommand::Initialize(CBDECCommand* BDECCommand, CCSCCommand* CSCC
 	m_TH1 = TH1;
 	m_mbCount = 0;
 	m_delayTicks = 1000;
+
+	if(m_decodeAheadJob)
+	{
+		m_decodeAheadJob->cancelled = true;
+		m_decodeAheadJob.reset();
+	}
 }
 
 bool CIPU::CIDECCommand::Execute()
@@ -1079,8 +1337,31 @@ bool CIPU::CIDECCommand::Execute()
 				return false;
 			}
 			m_state = STATE_ADVANCE;
+			if(m_decodeAheadWorker)
+			{
+				m_decodeAheadJob = m_decodeAheadWorker->StartJob(*m_IN_FIFO, m_command, m_context, m_TH0, m_TH1);
+				m_decodeAheadMbIndex = 0;
+				m_decodeAheadConsumedBits = m_IN_FIFO->GetBitIndex();
+				m_decodeAheadDiscardBase = m_IN_FIFO->GetDiscardCount();
+				m_decodeAheadResync = false;
+				m_state = STATE_DECODEAHEAD;
+			}
 		}
 		break;
+		case STATE_DECODEAHEAD:
+			if(!ReplayDecodeAheadMacroblock())
+			{
+				return false;
+			}
+			break;
+		case STATE_DECODEAHEADFLUSH:
+			m_OUT_FIFO->Flush();
+			if(m_OUT_FIFO->GetSize() != 0)
+			{
+				return false;
+			}
+			m_state = STATE_DECODEAHEAD;
+			break;
 		case STATE_ADVANCE:
 		{
 			m_IN_FIFO->Advance(m_command.fb);
@@ -1175,6 +1456,15 @@ bool CIPU::CIDECCommand::Execute()
 					FRAMEWORK_MAYBE_UNUSED uint32 remainLength = m_temp_IN_FIFO.GetAvailableBits() + (m_blockStream.GetRemainingLength() * 8);
 					assert(remainLength == 0);
 					m_state = STATE_CHECKSTARTCODE;
+					if(m_decodeAheadJob)
+					{
+						//Macroblock was decoded here while the worker was behind, go back to the worker's
+						//results if it got ahead of us
+						m_decodeAheadMbIndex++;
+						m_decodeAheadConsumedBits = GetDecodeAheadBitPosition();
+						m_decodeAheadResync = true;
+						m_state = STATE_DECODEAHEAD;
+					}
 					break;
 				}
 				if(m_OUT_FIFO->GetSize() != 0)
@@ -1260,6 +1550,106 @@ bool CIPU::CIDECCommand::IsDelayed() const
 	return (m_state == STATE_DELAY);
 }
 
+void CIPU::CIDECCommand::SetDecodeAheadWorker(CDecodeAheadWorker* worker)
+{
+	m_decodeAheadWorker = worker;
+}
+
+uint32 CIPU::CIDECCommand::GetQsc() const
+{
+	return m_qsc;
+}
+
+bool CIPU::CIDECCommand::ReplayDecodeAheadMacroblock()
+{
+	auto& macroblock = m_decodeAheadMacroblock;
+	auto status = m_decodeAheadJob->TryGetMacroblock(m_decodeAheadMbIndex, macroblock);
+	if(status == CDecodeAheadWorker::JOB::MACROBLOCK_UNAVAILABLE)
+	{
+		StopDecodeAhead();
+		return true;
+	}
+	if(status == CDecodeAheadWorker::JOB::MACROBLOCK_PENDING)
+	{
+		//Worker is behind, decode this macroblock here instead of waiting for it
+		m_state = (m_mbCount == 0) ? STATE_ADVANCE : STATE_CHECKSTARTCODE;
+		return true;
+	}
+
+	if(m_decodeAheadResync)
+	{
+		//Previous macroblock was decoded here, the worker's results are only usable
+		//if it ended up at the same position with the same decoder state
+		CDecodeAheadWorker::MACROBLOCK previous;
+		FRAMEWORK_MAYBE_UNUSED auto previousStatus = m_decodeAheadJob->TryGetMacroblock(m_decodeAheadMbIndex - 1, previous);
+		assert(previousStatus == CDecodeAheadWorker::JOB::MACROBLOCK_READY);
+		if((previous.endBitPosition != m_decodeAheadConsumedBits) || (previous.qsc != m_qsc) ||
+		   memcmp(previous.dcPredictor, m_context.dcPredictor, sizeof(previous.dcPredictor)))
+		{
+			StopDecodeAhead();
+			return true;
+		}
+		m_decodeAheadResync = false;
+	}
+
+	//Wait until all of the macroblock's data is in the FIFO, so that it can be checked before being consumed
+	uint32 bitIndex = m_IN_FIFO->GetBitIndex();
+	uint32 bitCount = macroblock.endBitPosition - m_decodeAheadConsumedBits;
+	if(m_IN_FIFO->GetAvailableBits() < bitCount)
+	{
+		if((bitIndex + bitCount) > (CINFIFO::BUFFERSIZE * 8))
+		{
+			//Will never fit, decode it normally
+			StopDecodeAhead();
+			return true;
+		}
+		return false;
+	}
+
+	//FIFO discards data in 16 bytes chunks, bits consumed before the FIFO's start are a multiple of that
+	uint32 fifoInputOffset = (m_decodeAheadConsumedBits - bitIndex) / 8;
+	uint32 firstByte = bitIndex / 8;
+	uint32 endByte = (bitIndex + bitCount + 7) / 8;
+	assert((fifoInputOffset + endByte) <= m_decodeAheadJob->input.size());
+	if(memcmp(m_IN_FIFO->GetBuffer() + firstByte, m_decodeAheadJob->input.data() + fifoInputOffset + firstByte, endByte - firstByte))
+	{
+		//Data is not what the worker decoded
+		StopDecodeAhead();
+		return true;
+	}
+
+	while(bitCount != 0)
+	{
+		uint32 advanceCount = std::min<uint32>(bitCount, 128);
+		m_IN_FIFO->Advance(static_cast<uint8>(advanceCount));
+		bitCount -= advanceCount;
+	}
+
+	//Keep decoder state in sync, regular decoding can take over after any macroblock
+	m_decodeAheadConsumedBits = macroblock.endBitPosition;
+	m_decodeAheadMbIndex++;
+	m_mbCount++;
+	m_qsc = macroblock.qsc;
+	memcpy(m_context.dcPredictor, macroblock.dcPredictor, sizeof(macroblock.dcPredictor));
+
+	m_OUT_FIFO->Write(macroblock.output.data(), macroblock.output.size());
+	m_state = STATE_DECODEAHEADFLUSH;
+	return true;
+}
+
+void CIPU::CIDECCommand::StopDecodeAhead()
+{
+	m_decodeAheadJob->cancelled = true;
+	m_decodeAheadJob.reset();
+	m_state = (m_mbCount == 0) ? STATE_ADVANCE : STATE_CHECKSTARTCODE;
+}
+
+uint32 CIPU::CIDECCommand::GetDecodeAheadBitPosition() const
+{
+	//Position in the decode ahead job's input
+	return ((m_IN_FIFO->GetDiscardCount() - m_decodeAheadDiscardBase) * 128) + m_IN_FIFO->GetBitIndex();
+}
+
 void CIPU::CIDECCommand::ConvertRawBlock()
 {
 	//Convert block from RAW16 to RAW8
@@ -1410,7 +1800,7 @@ bool CIPU::CBDECCommand::Execute()
 
 			memcpy(blockTemp, blockInfo.block, sizeof(int16) * 0x40);
 
-			IDCT::CIEEE1180::GetInstance()->Transform(blockTemp, blockInfo.block);
+			m_context.idctTransform(blockTemp, blockInfo.block);
 
 			m_state = STATE_DECODEBLOCK_GOTONEXT;
 		}
@@ -1488,10 +1878,12 @@ void CIPU::CBDECCommand_ReadDct::Initialize(CINFIFO* fifo, int16* block, unsigne
 	if(m_mbi && !m_isMpeg1CoeffVLCTable)
 	{
 		m_coeffTable = &CDctCoefficientTable1::GetInstance();
+		m_coeffLookupTable = IpuCoefficientVlc::TABLE_ONE;
 	}
 	else
 	{
 		m_coeffTable = &CDctCoefficientTable0::GetInstance();
+		m_coeffLookupTable = IpuCoefficientVlc::TABLE_ZERO;
 	}
 }
 
@@ -1536,6 +1928,26 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 		break;
 		case STATE_CHECKEOB:
 		{
+			//Decode whole codes with the lookup tables when possible, codes that are not
+			//entirely in the FIFO yet are handled by the bit by bit decoder below
+			IpuCoefficientVlc::COEFFICIENT coefficient;
+			auto decodeResult = IpuCoefficientVlc::Decode(m_coeffLookupTable, m_IN_FIFO->PeekLookupBits(), m_IN_FIFO->GetAvailableBits(),
+			                                              (m_blockIndex == 0), m_isMpeg2, coefficient);
+			if((decodeResult == IpuCoefficientVlc::DECODE_RESULT_ENDOFBLOCK) && (m_blockIndex != 0))
+			{
+				m_IN_FIFO->Advance(static_cast<uint8>(coefficient.length));
+#ifdef _DECODE_LOGGING
+				CLog::GetInstance().Print(DECODE_LOG_NAME, "\r\n");
+#endif
+				return true;
+			}
+			else if(decodeResult == IpuCoefficientVlc::DECODE_RESULT_COEFFICIENT)
+			{
+				m_IN_FIFO->Advance(static_cast<uint8>(coefficient.length));
+				StoreCoefficient(coefficient.run, coefficient.level);
+				break;
+			}
+
 			bool isEob = false;
 			if(m_coeffTable->TryIsEndOfBlock(m_IN_FIFO, isEob) != CVLCTable::DECODE_STATUS_SUCCESS)
 			{
@@ -1568,21 +1980,7 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 					return false;
 				}
 			}
-			m_blockIndex += runLevelPair.run;
-
-			if(m_blockIndex < 0x40)
-			{
-				m_block[m_blockIndex] = static_cast<int16>(runLevelPair.level);
-#ifdef _DECODE_LOGGING
-				CLog::GetInstance().Print(DECODE_LOG_NAME, "[%d]: %d ", m_blockIndex, runLevelPair.level);
-#endif
-			}
-			else
-			{
-				throw CVLCTable::CVLCTableException();
-			}
-
-			m_blockIndex++;
+			StoreCoefficient(runLevelPair.run, static_cast<int16>(runLevelPair.level));
 			m_state = STATE_CHECKEOB;
 		}
 		break;
@@ -1600,6 +1998,25 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 	}
 }
 
+void CIPU::CBDECCommand_ReadDct::StoreCoefficient(uint32 run, int16 level)
+{
+	m_blockIndex += run;
+
+	if(m_blockIndex < 0x40)
+	{
+		m_block[m_blockIndex] = level;
+#ifdef _DECODE_LOGGING
+		CLog::GetInstance().Print(DECODE_LOG_NAME, "[%d]: %d ", m_blockIndex, level);
+#endif
+	}
+	else
+	{
+		throw CVLCTable::CVLCTableException();
+	}
+
+	m_blockIndex++;
+}
+
 /////////////////////////////////////////////
 //BDEC ReadDcDiff subcommand implementation
 /////////////////////////////////////////////
@@ -1879,11 +2296,6 @@ bool CIPU::CSETVQCommand::Execute()
 //CSC command implementation
 /////////////////////////////////////////////
 
-CIPU::CCSCCommand::CCSCCommand()
-{
-	GenerateCbCrMap();
-}
-
 void CIPU::CCSCCommand::Initialize(CINFIFO* input, COUTFIFO* output, uint32 commandCode, uint16 TH0, uint16 TH1)
 {
 	m_command <<= commandCode;
@@ -1939,80 +2351,22 @@ bool CIPU::CCSCCommand::Execute()
 		break;
 		case STATE_CONVERTBLOCK:
 		{
-			uint32 nPixel[0x100];
-
-			uint8* pY = m_block;
-			uint8* nBlockCb = m_block + 0x100;
-			uint8* nBlockCr = m_block + 0x140;
-
-			uint32* pPixel = nPixel;
-			unsigned int* pCbCrMap = m_nCbCrMap;
-
 			uint16 alphaTh0 = (m_TH0 & 0x1FF);
 			uint16 alphaTh1 = (m_TH1 & 0x1FF);
 
-			for(unsigned int i = 0; i < 16; i++)
-			{
-				for(unsigned int j = 0; j < 16; j++)
-				{
-					float nY = pY[j];
-					float nCb = nBlockCb[pCbCrMap[j]];
-					float nCr = nBlockCr[pCbCrMap[j]];
-
-					float nR = nY + 1.402f * (nCr - 128);
-					float nG = nY - 0.34414f * (nCb - 128) - 0.71414f * (nCr - 128);
-					float nB = nY + 1.772f * (nCb - 128);
-
-					nR = std::clamp(nR, 0.f, 255.f);
-					nG = std::clamp(nG, 0.f, 255.f);
-					nB = std::clamp(nB, 0.f, 255.f);
-
-					uint8 a = 0;
-					uint8 r = static_cast<uint8>(nR);
-					uint8 g = static_cast<uint8>(nG);
-					uint8 b = static_cast<uint8>(nB);
-
-					if(r < alphaTh0 && g < alphaTh0 && b < alphaTh0)
-					{
-						a = 0;
-					}
-					else if(r < alphaTh1 && g < alphaTh1 && b < alphaTh1)
-					{
-						a = 0x40;
-					}
-					else
-					{
-						a = 0x80;
-					}
-
-					pPixel[j] = (a << 24) | (b << 16) | (g << 8) | (r << 0);
-				}
-
-				pY += 0x10;
-				pCbCrMap += 0x10;
-				pPixel += 0x10;
-			}
-
 			if(m_command.ofm == 1)
 			{
 				//RGBA16 output
-				uint16 cvtPixels[0x100];
-				for(uint32 i = 0; i < 0x100; i++)
-				{
-					uint32 pixel = nPixel[i];
-					uint16 result = 0;
-					result |= ((pixel & 0x000000F8) >> (0 + 3)) << 0;
-					result |= ((pixel & 0x0000F800) >> (8 + 3)) << 5;
-					result |= ((pixel & 0x00F80000) >> (16 + 3)) << 10;
-					result |= ((pixel & 0x80000000) >> 31) << 15;
-					cvtPixels[i] = result;
-				}
-				m_OUT_FIFO->Write(cvtPixels, sizeof(uint16) * 0x100);
+				uint16 cvtPixels[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+				IpuCsc::ConvertMacroblock16(m_block, cvtPixels, alphaTh0, alphaTh1, (m_command.dte != 0));
+				m_OUT_FIFO->Write(cvtPixels, sizeof(cvtPixels));
 			}
 			else
 			{
 				//RGBA32 output
-				m_OUT_FIFO->Write(nPixel, sizeof(uint32) * 0x100);
+				uint32 cvtPixels[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+				IpuCsc::ConvertMacroblock32(m_block, cvtPixels, alphaTh0, alphaTh1);
+				m_OUT_FIFO->Write(cvtPixels, sizeof(cvtPixels));
 			}
 
 			m_mbCount--;
@@ -2036,24 +2390,6 @@ bool CIPU::CCSCCommand::Execute()
 	}
 }
 
-void CIPU::CCSCCommand::GenerateCbCrMap()
-{
-	unsigned int* pCbCrMap = m_nCbCrMap;
-	for(unsigned int i = 0; i < 0x40; i += 0x8)
-	{
-		for(unsigned int j = 0; j < 0x10; j += 2)
-		{
-			pCbCrMap[j + 0x00] = (j / 2) + i;
-			pCbCrMap[j + 0x01] = (j / 2) + i;
-
-			pCbCrMap[j + 0x10] = (j / 2) + i;
-			pCbCrMap[j + 0x11] = (j / 2) + i;
-		}
-
-		pCbCrMap += 0x20;
-	}
-}
-
 /////////////////////////////////////////////
 //SETTH command implementation
 /////////////////////////////////////////////
@@ -2,7 +2,12 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "Types.h"
 #include "BitStream.h"
 #include "MemStream.h"
@@ -12,6 +17,9 @@
 #include "Convertible.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
+#include "IPU_Idct.h"
+#include "IPU_CoefficientVlc.h"
+#include "IPU_Trace.h"
 
 class CINTC;
 
@@ -19,6 +27,7 @@ class CIPU
 {
 public:
 	typedef std::function<uint32(const void*, uint32)> Dma3ReceiveHandler;
+	typedef std::function<void(std::vector<uint8>&)> Dma4PendingDataHandler;
 
 	CIPU(CINTC&);
 	virtual ~CIPU() = default;
@@ -41,6 +50,10 @@ public:
 	void LoadState(Framework::CZipArchiveReader&);
 
 	void SetDMA3ReceiveHandler(const Dma3ReceiveHandler&);
+	void SetDMA4PendingDataHandler(const Dma4PendingDataHandler&);
+	void SetFastIdctEnabled(bool);
+	void SetDecodeAheadEnabled(bool);
+	void SetTrace(CIpuTrace*);
 	uint32 ReceiveDMA4(uint32, uint32, bool, uint8*, uint8*);
 
 	void CountTicks(uint32);
@@ -128,6 +141,7 @@ private:
 		uint8* nonIntraIq = nullptr;
 		int16* dcPredictor = nullptr;
 		uint32 dcPrecision = 0;
+		IpuIdct::TransformFunction idctTransform = nullptr;
 	};
 
 	class COUTFIFO
@@ -166,11 +180,15 @@ private:
 
 		void Advance(uint8) override;
 		uint8 GetBitIndex() const override;
+		uint32 GetDiscardCount() const;
 
 		bool TryPeekBits_LSBF(uint8, uint32&) override;
 		bool TryPeekBits_MSBF(uint8, uint32&) override;
 
+		uint32 PeekLookupBits();
+
 		void SetBitPosition(unsigned int);
+		const uint8* GetBuffer() const;
 		unsigned int GetSize() const;
 		unsigned int GetAvailableBits() const;
 
@@ -191,6 +209,8 @@ private:
 		bool m_lookupBitsDirty;
 		unsigned int m_size;
 		unsigned int m_bitPosition;
+		//Number of 16 bytes chunks discarded since the last reset, not saved in states
+		uint32 m_discardCount = 0;
 	};
 
 	class CStartCodeException : public std::exception
@@ -226,6 +246,64 @@ private:
 		uint32 m_commandCode;
 	};
 
+	//Decodes IDEC pictures ahead of time on a worker thread, using the contents of the IN FIFO
+	//and the data DMA4 is about to transfer. The IDEC command then replays decoded macroblocks
+	//as long as the data it actually receives matches what the worker decoded. Macroblocks the
+	//worker hasn't reached yet are decoded by the IDEC command itself.
+	class CDecodeAheadWorker
+	{
+	public:
+		struct MACROBLOCK
+		{
+			uint32 endBitPosition = 0;
+			uint32 qsc = 0;
+			int16 dcPredictor[3] = {};
+			std::vector<uint8> output;
+		};
+
+		struct JOB
+		{
+			std::vector<uint8> input;
+			uint32 inputBitPosition = 0;
+			uint32 commandCode = 0;
+			DECODER_CONTEXT context;
+			uint8 intraIq[0x40] = {};
+			uint8 nonIntraIq[0x40] = {};
+			int16 dcPredictor[3] = {};
+			uint16 TH0 = 0;
+			uint16 TH1 = 0;
+
+			enum MACROBLOCK_STATUS
+			{
+				MACROBLOCK_READY,
+				MACROBLOCK_PENDING,
+				MACROBLOCK_UNAVAILABLE,
+			};
+
+			std::mutex mutex;
+			std::vector<MACROBLOCK> macroblocks;
+			bool done = false;
+			std::atomic<bool> cancelled{false};
+
+			MACROBLOCK_STATUS TryGetMacroblock(uint32, MACROBLOCK&);
+		};
+		typedef std::shared_ptr<JOB> JobPtr;
+
+		CDecodeAheadWorker(const Dma4PendingDataHandler&);
+		~CDecodeAheadWorker();
+
+		JobPtr StartJob(const CINFIFO&, uint32, const DECODER_CONTEXT&, uint16, uint16);
+
+	private:
+		static void DecodeJob(JOB&);
+		void ThreadProc();
+
+		const Dma4PendingDataHandler& m_pendingDataHandler;
+		CMailBox m_mailBox;
+		std::thread m_thread;
+		bool m_threadDone = false;
+	};
+
 	//0x01 ------------------------------------------------------------
 	class CBDECCommand;
 	class CCSCCommand;
@@ -240,6 +318,9 @@ private:
 		void CountTicks(uint32) override;
 		bool IsDelayed() const override;
 
+		void SetDecodeAheadWorker(CDecodeAheadWorker*);
+		uint32 GetQsc() const;
+
 	private:
 		enum STATE
 		{
@@ -255,10 +336,15 @@ private:
 			STATE_READMBINCREMENT,
 			STATE_CSCINIT,
 			STATE_CSC,
+			STATE_DECODEAHEAD,
+			STATE_DECODEAHEADFLUSH,
 			STATE_DONE
 		};
 
 		void ConvertRawBlock();
+		bool ReplayDecodeAheadMacroblock();
+		void StopDecodeAhead();
+		uint32 GetDecodeAheadBitPosition() const;
 
 		CMD_IDEC m_command = make_convertible<CMD_IDEC>(0);
 		STATE m_state = STATE_DONE;
@@ -281,6 +367,14 @@ private:
 		uint32 m_qsc = 0;
 		uint32 m_mbCount = 0;
 		int32 m_delayTicks = 0;
+
+		CDecodeAheadWorker* m_decodeAheadWorker = nullptr;
+		CDecodeAheadWorker::JobPtr m_decodeAheadJob;
+		CDecodeAheadWorker::MACROBLOCK m_decodeAheadMacroblock;
+		uint32 m_decodeAheadMbIndex = 0;
+		uint32 m_decodeAheadConsumedBits = 0;
+		uint32 m_decodeAheadDiscardBase = 0;
+		bool m_decodeAheadResync = false;
 	};
 
 	//0x02 ------------------------------------------------------------
@@ -312,6 +406,8 @@ private:
 		bool Execute() override;
 
 	private:
+		void StoreCoefficient(uint32, int16);
+
 		enum STATE
 		{
 			STATE_INIT,
@@ -330,6 +426,7 @@ private:
 		bool m_isMpeg2 = true;
 		unsigned int m_blockIndex = 0;
 		MPEG2::CDctCoefficientTable* m_coeffTable = nullptr;
+		IpuCoefficientVlc::TABLE m_coeffLookupTable = IpuCoefficientVlc::TABLE_ZERO;
 		int16* m_dcPredictor = nullptr;
 		int16 m_dcDiff = 0;
 		CBDECCommand_ReadDcDiff m_readDcDiffCommand;
@@ -464,8 +561,6 @@ private:
 			BLOCK_SIZE = 0x180,
 		};
 
-		CCSCCommand();
-
 		void Initialize(CINFIFO*, COUTFIFO*, uint32, uint16, uint16);
 		bool Execute() override;
 
@@ -479,8 +574,6 @@ private:
 			STATE_DONE,
 		};
 
-		void GenerateCbCrMap();
-
 		STATE m_state = STATE_DONE;
 		CMD_CSC m_command = make_convertible<CMD_CSC>(0);
 
@@ -492,8 +585,6 @@ private:
 		unsigned int m_currentIndex = 0;
 		unsigned int m_mbCount = 0;
 
-		unsigned int m_nCbCrMap[0x100];
-
 		uint8 m_block[BLOCK_SIZE];
 	};
 
@@ -528,6 +619,8 @@ private:
 	uint32 GetBusyBit(bool) const;
 	FIFO_STATE GetFifoState() const;
 
+	void TraceCommandEnd();
+
 	void DisassembleGet(uint32);
 	void DisassembleSet(uint32, uint32);
 	void DisassembleCommand(uint32);
@@ -542,6 +635,8 @@ private:
 
 	int16 m_nDcPredictor[3];
 
+	IpuIdct::TransformFunction m_idctTransform = &IpuIdct::TransformReference;
+
 	uint32 m_IPU_CMD[2];
 	uint32 m_IPU_CTRL;
 	COUTFIFO m_OUT_FIFO;
@@ -560,4 +655,8 @@ private:
 	CCSCCommand m_CSCCommand;
 	CSETTHCommand m_SETTHCommand;
 	std::array<CCommand*, IPU_CMD_MAX> m_commands;
+
+	Dma4PendingDataHandler m_dma4PendingDataHandler;
+	std::unique_ptr<CDecodeAheadWorker> m_decodeAheadWorker;
+	CIpuTrace* m_trace = nullptr;
 };
@@ -0,0 +1,270 @@
+#include "IPU_CoefficientVlc.h"
+#include <cassert>
+#include <iterator>
+
+using namespace IpuCoefficientVlc;
+
+//Codes starting with 6 zero bits (escape excluded) are longer than the primary lookup
+//and are resolved with the secondary table, indexed with the bits following those zeros.
+#define PRIMARY_BITS 9
+#define SECONDARY_PREFIX_BITS 6
+#define SECONDARY_BITS 11
+#define MAX_CODE_LENGTH (SECONDARY_PREFIX_BITS + SECONDARY_BITS)
+
+#define ESCAPE_CODE 0x01
+#define ESCAPE_CODE_LENGTH 6
+#define ESCAPE_RUN_BITS 6
+
+enum ENTRY_TYPE : uint8
+{
+	ENTRY_TYPE_INVALID,
+	ENTRY_TYPE_COEFFICIENT,
+	ENTRY_TYPE_ENDOFBLOCK,
+	ENTRY_TYPE_ESCAPE,
+	ENTRY_TYPE_SECONDARY,
+};
+
+struct CODE
+{
+	uint16 code;
+	uint8 length; //Without sign bit
+	uint8 run;
+	uint8 level;
+};
+
+struct LOOKUP_ENTRY
+{
+	ENTRY_TYPE type;
+	uint8 length; //With sign bit
+	uint8 run;
+	int16 level;
+};
+
+struct LOOKUP_TABLE
+{
+	LOOKUP_ENTRY primary[1 << PRIMARY_BITS];
+	LOOKUP_ENTRY secondary[1 << SECONDARY_BITS];
+};
+
+// clang-format off
+//Codes longer than 13 bits are the same in both tables
+#define LONG_CODES \
+	{0x1F, 14, 0, 16}, {0x1E, 14, 0, 17}, {0x1D, 14, 0, 18}, {0x1C, 14, 0, 19}, \
+	{0x1B, 14, 0, 20}, {0x1A, 14, 0, 21}, {0x19, 14, 0, 22}, {0x18, 14, 0, 23}, \
+	{0x17, 14, 0, 24}, {0x16, 14, 0, 25}, {0x15, 14, 0, 26}, {0x14, 14, 0, 27}, \
+	{0x13, 14, 0, 28}, {0x12, 14, 0, 29}, {0x11, 14, 0, 30}, {0x10, 14, 0, 31}, \
+	{0x18, 15, 0, 32}, {0x17, 15, 0, 33}, {0x16, 15, 0, 34}, {0x15, 15, 0, 35}, \
+	{0x14, 15, 0, 36}, {0x13, 15, 0, 37}, {0x12, 15, 0, 38}, {0x11, 15, 0, 39}, \
+	{0x10, 15, 0, 40}, \
+	{0x1F, 15, 1, 8}, {0x1E, 15, 1, 9}, {0x1D, 15, 1, 10}, {0x1C, 15, 1, 11}, \
+	{0x1B, 15, 1, 12}, {0x1A, 15, 1, 13}, {0x19, 15, 1, 14}, \
+	{0x13, 16, 1, 15}, {0x12, 16, 1, 16}, {0x11, 16, 1, 17}, {0x10, 16, 1, 18}, \
+	{0x14, 16, 6, 3}, \
+	{0x1A, 16, 11, 2}, {0x19, 16, 12, 2}, {0x18, 16, 13, 2}, {0x17, 16, 14, 2}, \
+	{0x16, 16, 15, 2}, {0x15, 16, 16, 2}, \
+	{0x1F, 16, 27, 1}, {0x1E, 16, 28, 1}, {0x1D, 16, 29, 1}, {0x1C, 16, 30, 1}, \
+	{0x1B, 16, 31, 1}
+
+//Run/level codes of table B-14 (EOB is '10', escape is '000001')
+static const CODE g_table0Codes[] =
+{
+	{0x03, 2, 0, 1}, {0x04, 4, 0, 2}, {0x05, 5, 0, 3}, {0x06, 7, 0, 4},
+	{0x26, 8, 0, 5}, {0x21, 8, 0, 6}, {0x0A, 10, 0, 7}, {0x1D, 12, 0, 8},
+	{0x18, 12, 0, 9}, {0x13, 12, 0, 10}, {0x10, 12, 0, 11}, {0x1A, 13, 0, 12},
+	{0x19, 13, 0, 13}, {0x18, 13, 0, 14}, {0x17, 13, 0, 15},
+	{0x03, 3, 1, 1}, {0x06, 6, 1, 2}, {0x25, 8, 1, 3}, {0x0C, 10, 1, 4},
+	{0x1B, 12, 1, 5}, {0x16, 13, 1, 6}, {0x15, 13, 1, 7},
+	{0x05, 4, 2, 1}, {0x04, 7, 2, 2}, {0x0B, 10, 2, 3}, {0x14, 12, 2, 4}, {0x14, 13, 2, 5},
+	{0x07, 5, 3, 1}, {0x24, 8, 3, 2}, {0x1C, 12, 3, 3}, {0x13, 13, 3, 4},
+	{0x06, 5, 4, 1}, {0x0F, 10, 4, 2}, {0x12, 12, 4, 3},
+	{0x07, 6, 5, 1}, {0x09, 10, 5, 2}, {0x12, 13, 5, 3},
+	{0x05, 6, 6, 1}, {0x1E, 12, 6, 2},
+	{0x04, 6, 7, 1}, {0x15, 12, 7, 2},
+	{0x07, 7, 8, 1}, {0x11, 12, 8, 2},
+	{0x05, 7, 9, 1}, {0x11, 13, 9, 2},
+	{0x27, 8, 10, 1}, {0x10, 13, 10, 2},
+	{0x23, 8, 11, 1}, {0x22, 8, 12, 1}, {0x20, 8, 13, 1},
+	{0x0E, 10, 14, 1}, {0x0D, 10, 15, 1}, {0x08, 10, 16, 1},
+	{0x1F, 12, 17, 1}, {0x1A, 12, 18, 1}, {0x19, 12, 19, 1}, {0x17, 12, 20, 1}, {0x16, 12, 21, 1},
+	{0x1F, 13, 22, 1}, {0x1E, 13, 23, 1}, {0x1D, 13, 24, 1}, {0x1C, 13, 25, 1}, {0x1B, 13, 26, 1},
+	LONG_CODES
+};
+
+//Run/level codes of table B-15 (EOB is '0110', escape is '000001')
+static const CODE g_table1Codes[] =
+{
+	{0x02, 2, 0, 1}, {0x06, 3, 0, 2}, {0x07, 4, 0, 3}, {0x1C, 5, 0, 4},
+	{0x1D, 5, 0, 5}, {0x05, 6, 0, 6}, {0x04, 6, 0, 7}, {0x7B, 7, 0, 8},
+	{0x7C, 7, 0, 9}, {0x23, 8, 0, 10}, {0x22, 8, 0, 11}, {0xFA, 8, 0, 12},
+	{0xFB, 8, 0, 13}, {0xFE, 8, 0, 14}, {0xFF, 8, 0, 15},
+	{0x02, 3, 1, 1}, {0x06, 5, 1, 2}, {0x79, 7, 1, 3}, {0x27, 8, 1, 4},
+	{0x20, 8, 1, 5}, {0x16, 13, 1, 6}, {0x15, 13, 1, 7},
+	{0x05, 5, 2, 1}, {0x07, 7, 2, 2}, {0xFC, 8, 2, 3}, {0x0C, 10, 2, 4}, {0x14, 13, 2, 5},
+	{0x07, 5, 3, 1}, {0x26, 8, 3, 2}, {0x1C, 12, 3, 3}, {0x13, 13, 3, 4},
+	{0x06, 6, 4, 1}, {0xFD, 8, 4, 2}, {0x12, 12, 4, 3},
+	{0x07, 6, 5, 1}, {0x04, 9, 5, 2}, {0x12, 13, 5, 3},
+	{0x06, 7, 6, 1}, {0x1E, 12, 6, 2},
+	{0x04, 7, 7, 1}, {0x15, 12, 7, 2},
+	{0x05, 7, 8, 1}, {0x11, 12, 8, 2},
+	{0x78, 7, 9, 1}, {0x11, 13, 9, 2},
+	{0x7A, 7, 10, 1}, {0x10, 13, 10, 2},
+	{0x21, 8, 11, 1}, {0x25, 8, 12, 1}, {0x24, 8, 13, 1},
+	{0x05, 9, 14, 1}, {0x07, 9, 15, 1}, {0x0D, 10, 16, 1},
+	{0x1F, 12, 17, 1}, {0x1A, 12, 18, 1}, {0x19, 12, 19, 1}, {0x17, 12, 20, 1}, {0x16, 12, 21, 1},
+	{0x1F, 13, 22, 1}, {0x1E, 13, 23, 1}, {0x1D, 13, 24, 1}, {0x1C, 13, 25, 1}, {0x1B, 13, 26, 1},
+	LONG_CODES
+};
+// clang-format on
+
+static void InsertEntry(LOOKUP_TABLE& table, uint32 code, uint32 length, const LOOKUP_ENTRY& entry)
+{
+	assert(length <= MAX_CODE_LENGTH);
+	LOOKUP_ENTRY* entries = table.primary;
+	uint32 tableBits = PRIMARY_BITS;
+	if(length > PRIMARY_BITS)
+	{
+		//All long codes start with the secondary prefix
+		assert((code >> (length - SECONDARY_PREFIX_BITS)) == 0);
+		entries = table.secondary;
+		tableBits = SECONDARY_BITS;
+		length -= SECONDARY_PREFIX_BITS;
+	}
+	uint32 fillBits = tableBits - length;
+	uint32 base = code << fillBits;
+	for(uint32 i = 0; i < (1U << fillBits); i++)
+	{
+		assert(entries[base + i].type == ENTRY_TYPE_INVALID);
+		entries[base + i] = entry;
+	}
+}
+
+template <size_t codeCount>
+static LOOKUP_TABLE BuildTable(const CODE (&codes)[codeCount], uint32 eobCode, uint32 eobLength)
+{
+	LOOKUP_TABLE table = {};
+	for(uint32 i = 0; i < (1U << (PRIMARY_BITS - SECONDARY_PREFIX_BITS)); i++)
+	{
+		table.primary[i].type = ENTRY_TYPE_SECONDARY;
+	}
+	for(const auto& code : codes)
+	{
+		for(uint32 sign = 0; sign < 2; sign++)
+		{
+			LOOKUP_ENTRY entry = {};
+			entry.type = ENTRY_TYPE_COEFFICIENT;
+			entry.length = code.length + 1;
+			entry.run = code.run;
+			entry.level = sign ? -code.level : code.level;
+			InsertEntry(table, (code.code << 1) | sign, code.length + 1, entry);
+		}
+	}
+	{
+		LOOKUP_ENTRY entry = {};
+		entry.type = ENTRY_TYPE_ENDOFBLOCK;
+		entry.length = eobLength;
+		InsertEntry(table, eobCode, eobLength, entry);
+	}
+	{
+		LOOKUP_ENTRY entry = {};
+		entry.type = ENTRY_TYPE_ESCAPE;
+		entry.length = ESCAPE_CODE_LENGTH;
+		InsertEntry(table, ESCAPE_CODE, ESCAPE_CODE_LENGTH, entry);
+	}
+	return table;
+}
+
+static const LOOKUP_TABLE g_lookupTables[TABLE_COUNT] =
+    {
+        BuildTable(g_table0Codes, 0x02, 2),
+        BuildTable(g_table1Codes, 0x06, 4),
+};
+
+static bool DecodeEscape(uint32 bits, uint32 availableBits, bool isMpeg2, COEFFICIENT& coefficient)
+{
+	//Escape code is followed by a 6-bit run and a fixed length level
+	uint32 levelPos = ESCAPE_CODE_LENGTH + ESCAPE_RUN_BITS;
+	uint32 run = (bits >> (32 - levelPos)) & 0x3F;
+	int32 level = 0;
+	uint32 length = 0;
+	if(isMpeg2)
+	{
+		//12-bit signed level
+		level = static_cast<int32>(bits << levelPos) >> 20;
+		length = levelPos + 12;
+	}
+	else
+	{
+		//8-bit signed level, 0x00 and 0x80 introduce a 16-bit level
+		uint32 level8 = (bits >> (32 - levelPos - 8)) & 0xFF;
+		uint32 ext8 = (bits >> (32 - levelPos - 16)) & 0xFF;
+		switch(level8)
+		{
+		case 0x00:
+			level = ext8;
+			length = levelPos + 16;
+			break;
+		case 0x80:
+			level = static_cast<int32>(ext8) - 0x100;
+			length = levelPos + 16;
+			break;
+		default:
+			level = static_cast<int8>(level8);
+			length = levelPos + 8;
+			break;
+		}
+	}
+	if(length > availableBits)
+	{
+		return false;
+	}
+	coefficient.run = run;
+	coefficient.level = static_cast<int16>(level);
+	coefficient.length = length;
+	return true;
+}
+
+DECODE_RESULT IpuCoefficientVlc::Decode(TABLE tableId, uint32 bits, uint32 availableBits, bool isFirstCoefficient, bool isMpeg2, COEFFICIENT& coefficient)
+{
+	assert(tableId < TABLE_COUNT);
+	if(isFirstCoefficient)
+	{
+		//First coefficient of non-intra blocks uses '1s' for run 0/level 1, only defined for table zero
+		if(tableId != TABLE_ZERO) return DECODE_RESULT_UNAVAILABLE;
+		if(bits & 0x80000000)
+		{
+			if(availableBits < 2) return DECODE_RESULT_UNAVAILABLE;
+			coefficient.run = 0;
+			coefficient.level = (bits & 0x40000000) ? -1 : 1;
+			coefficient.length = 2;
+			return DECODE_RESULT_COEFFICIENT;
+		}
+	}
+
+	const auto& table = g_lookupTables[tableId];
+	const auto* entry = &table.primary[bits >> (32 - PRIMARY_BITS)];
+	if(entry->type == ENTRY_TYPE_SECONDARY)
+	{
+		entry = &table.secondary[(bits << SECONDARY_PREFIX_BITS) >> (32 - SECONDARY_BITS)];
+	}
+
+	if(entry->length > availableBits)
+	{
+		return DECODE_RESULT_UNAVAILABLE;
+	}
+
+	switch(entry->type)
+	{
+	case ENTRY_TYPE_COEFFICIENT:
+		coefficient.run = entry->run;
+		coefficient.level = entry->level;
+		coefficient.length = entry->length;
+		return DECODE_RESULT_COEFFICIENT;
+	case ENTRY_TYPE_ENDOFBLOCK:
+		coefficient.length = entry->length;
+		return DECODE_RESULT_ENDOFBLOCK;
+	case ENTRY_TYPE_ESCAPE:
+		return DecodeEscape(bits, availableBits, isMpeg2, coefficient) ? DECODE_RESULT_COEFFICIENT : DECODE_RESULT_UNAVAILABLE;
+	default:
+		return DECODE_RESULT_UNAVAILABLE;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Types.h"
+
+//Table driven decoder for MPEG DCT coefficient VLCs (tables B-14 and B-15).
+//A whole code (including sign bit and escape sequence) is decoded from a single 32-bit
+//peek with a two-level lookup instead of bit by bit matching.
+
+namespace IpuCoefficientVlc
+{
+	enum TABLE
+	{
+		TABLE_ZERO,
+		TABLE_ONE,
+		TABLE_COUNT,
+	};
+
+	enum DECODE_RESULT
+	{
+		DECODE_RESULT_COEFFICIENT,
+		DECODE_RESULT_ENDOFBLOCK,
+		DECODE_RESULT_UNAVAILABLE,
+	};
+
+	struct COEFFICIENT
+	{
+		uint32 run = 0;
+		int16 level = 0;
+		uint32 length = 0;
+	};
+
+	//'bits' contains the next 32 bits of the stream (MSB first), only the first 'availableBits' are valid.
+	//DECODE_RESULT_UNAVAILABLE is returned if the code doesn't fit in the available bits or is invalid,
+	//callers need to fall back to the bit by bit decoder in that case.
+	DECODE_RESULT Decode(TABLE, uint32 bits, uint32 availableBits, bool isFirstCoefficient, bool isMpeg2, COEFFICIENT&);
+}
@@ -0,0 +1,362 @@
+#include "IPU_Csc.h"
+#include <algorithm>
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+#include <emmintrin.h>
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+#include <arm_neon.h>
+#endif
+
+//Y is 16x16, Cb and Cr are 8x8 and each chroma sample covers 2x2 luma samples
+#define BLOCK_CB_OFFSET 0x100
+#define BLOCK_CR_OFFSET 0x140
+
+#define CSC_CR_TO_R 1.402f
+#define CSC_CB_TO_G 0.34414f
+#define CSC_CR_TO_G 0.71414f
+#define CSC_CB_TO_B 1.772f
+
+//Applied to 8-bit components before truncating to 5 bits when dithering is enabled
+// clang-format off
+static const int16 g_ditherMatrix[4][4] =
+{
+	{-4,  0, -3,  1},
+	{ 2, -2,  3, -1},
+	{-3,  1, -4,  0},
+	{ 3, -1,  2, -2},
+};
+// clang-format on
+
+struct RGBA
+{
+	uint8 r, g, b, a;
+};
+
+static RGBA ConvertPixel(const uint8* block, unsigned int x, unsigned int y, uint16 alphaTh0, uint16 alphaTh1)
+{
+	unsigned int chromaIndex = (x / 2) + ((y / 2) * 8);
+
+	float nY = block[x + (y * 16)];
+	float nCb = block[BLOCK_CB_OFFSET + chromaIndex];
+	float nCr = block[BLOCK_CR_OFFSET + chromaIndex];
+
+	//Products are kept in separate statements to prevent compilers from fusing
+	//them with the additions, results need to match the SIMD versions
+	float crToR = CSC_CR_TO_R * (nCr - 128);
+	float cbToG = CSC_CB_TO_G * (nCb - 128);
+	float crToG = CSC_CR_TO_G * (nCr - 128);
+	float cbToB = CSC_CB_TO_B * (nCb - 128);
+
+	float nR = nY + crToR;
+	float nG = nY - cbToG - crToG;
+	float nB = nY + cbToB;
+
+	nR = std::clamp(nR, 0.f, 255.f);
+	nG = std::clamp(nG, 0.f, 255.f);
+	nB = std::clamp(nB, 0.f, 255.f);
+
+	RGBA result;
+	result.r = static_cast<uint8>(nR);
+	result.g = static_cast<uint8>(nG);
+	result.b = static_cast<uint8>(nB);
+
+	if(result.r < alphaTh0 && result.g < alphaTh0 && result.b < alphaTh0)
+	{
+		result.a = 0;
+	}
+	else if(result.r < alphaTh1 && result.g < alphaTh1 && result.b < alphaTh1)
+	{
+		result.a = 0x40;
+	}
+	else
+	{
+		result.a = 0x80;
+	}
+
+	return result;
+}
+
+void IpuCsc::ConvertMacroblock32Scalar(const uint8* block, uint32* output, uint16 alphaTh0, uint16 alphaTh1)
+{
+	for(unsigned int y = 0; y < 16; y++)
+	{
+		for(unsigned int x = 0; x < 16; x++)
+		{
+			auto pixel = ConvertPixel(block, x, y, alphaTh0, alphaTh1);
+			output[x + (y * 16)] = (pixel.a << 24) | (pixel.b << 16) | (pixel.g << 8) | (pixel.r << 0);
+		}
+	}
+}
+
+void IpuCsc::ConvertMacroblock16Scalar(const uint8* block, uint16* output, uint16 alphaTh0, uint16 alphaTh1, bool dither)
+{
+	for(unsigned int y = 0; y < 16; y++)
+	{
+		for(unsigned int x = 0; x < 16; x++)
+		{
+			auto pixel = ConvertPixel(block, x, y, alphaTh0, alphaTh1);
+			int32 r = pixel.r;
+			int32 g = pixel.g;
+			int32 b = pixel.b;
+			if(dither)
+			{
+				int32 ditherValue = g_ditherMatrix[y & 3][x & 3];
+				r = std::clamp<int32>(r + ditherValue, 0, 255);
+				g = std::clamp<int32>(g + ditherValue, 0, 255);
+				b = std::clamp<int32>(b + ditherValue, 0, 255);
+			}
+			uint16 result = 0;
+			result |= (r >> 3) << 0;
+			result |= (g >> 3) << 5;
+			result |= (b >> 3) << 10;
+			result |= (pixel.a >> 7) << 15;
+			output[x + (y * 16)] = result;
+		}
+	}
+}
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+
+struct PIXELS8
+{
+	__m128i r, g, b, a;
+};
+
+static inline __m128i ConvertComponents(__m128 value)
+{
+	value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.f));
+	return _mm_cvttps_epi32(value);
+}
+
+//Converts 8 pixels, Y, Cb and Cr are 16-bit lanes, Cb and Cr already expanded horizontally
+static inline PIXELS8 ConvertPixels8(__m128i y16, __m128i cb16, __m128i cr16, __m128i alphaTh0, __m128i alphaTh1)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 bias = _mm_set1_ps(128.f);
+
+	__m128i rgb[3][2];
+	for(unsigned int h = 0; h < 2; h++)
+	{
+		__m128 nY = _mm_cvtepi32_ps((h == 0) ? _mm_unpacklo_epi16(y16, zero) : _mm_unpackhi_epi16(y16, zero));
+		__m128 nCb = _mm_cvtepi32_ps((h == 0) ? _mm_unpacklo_epi16(cb16, zero) : _mm_unpackhi_epi16(cb16, zero));
+		__m128 nCr = _mm_cvtepi32_ps((h == 0) ? _mm_unpacklo_epi16(cr16, zero) : _mm_unpackhi_epi16(cr16, zero));
+
+		nCb = _mm_sub_ps(nCb, bias);
+		nCr = _mm_sub_ps(nCr, bias);
+
+		__m128 nR = _mm_add_ps(nY, _mm_mul_ps(_mm_set1_ps(CSC_CR_TO_R), nCr));
+		__m128 nG = _mm_sub_ps(_mm_sub_ps(nY, _mm_mul_ps(_mm_set1_ps(CSC_CB_TO_G), nCb)), _mm_mul_ps(_mm_set1_ps(CSC_CR_TO_G), nCr));
+		__m128 nB = _mm_add_ps(nY, _mm_mul_ps(_mm_set1_ps(CSC_CB_TO_B), nCb));
+
+		rgb[0][h] = ConvertComponents(nR);
+		rgb[1][h] = ConvertComponents(nG);
+		rgb[2][h] = ConvertComponents(nB);
+	}
+
+	PIXELS8 result;
+	result.r = _mm_packs_epi32(rgb[0][0], rgb[0][1]);
+	result.g = _mm_packs_epi32(rgb[1][0], rgb[1][1]);
+	result.b = _mm_packs_epi32(rgb[2][0], rgb[2][1]);
+
+	__m128i maxComponent = _mm_max_epi16(result.r, _mm_max_epi16(result.g, result.b));
+	__m128i belowTh0 = _mm_cmplt_epi16(maxComponent, alphaTh0);
+	__m128i belowTh1 = _mm_cmplt_epi16(maxComponent, alphaTh1);
+	__m128i alpha = _mm_sub_epi16(_mm_set1_epi16(0x80), _mm_and_si128(belowTh1, _mm_set1_epi16(0x40)));
+	result.a = _mm_andnot_si128(belowTh0, alpha);
+
+	return result;
+}
+
+template <typename RowFunction>
+static inline void ForEachRow(const uint8* block, uint16 alphaTh0, uint16 alphaTh1, const RowFunction& rowFunction)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i th0 = _mm_set1_epi16(alphaTh0);
+	const __m128i th1 = _mm_set1_epi16(alphaTh1);
+
+	for(unsigned int y = 0; y < 16; y++)
+	{
+		__m128i lumaRow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + (y * 16)));
+		__m128i cbRow = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block + BLOCK_CB_OFFSET + ((y / 2) * 8)));
+		__m128i crRow = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(block + BLOCK_CR_OFFSET + ((y / 2) * 8)));
+
+		//Each chroma sample covers two pixels
+		cbRow = _mm_unpacklo_epi8(cbRow, cbRow);
+		crRow = _mm_unpacklo_epi8(crRow, crRow);
+
+		for(unsigned int h = 0; h < 2; h++)
+		{
+			__m128i y16 = (h == 0) ? _mm_unpacklo_epi8(lumaRow, zero) : _mm_unpackhi_epi8(lumaRow, zero);
+			__m128i cb16 = (h == 0) ? _mm_unpacklo_epi8(cbRow, zero) : _mm_unpackhi_epi8(cbRow, zero);
+			__m128i cr16 = (h == 0) ? _mm_unpacklo_epi8(crRow, zero) : _mm_unpackhi_epi8(crRow, zero);
+			rowFunction(ConvertPixels8(y16, cb16, cr16, th0, th1), y, h * 8);
+		}
+	}
+}
+
+void IpuCsc::ConvertMacroblock32(const uint8* block, uint32* output, uint16 alphaTh0, uint16 alphaTh1)
+{
+	ForEachRow(block, alphaTh0, alphaTh1,
+	           [output](const PIXELS8& pixels, unsigned int y, unsigned int x) {
+		           __m128i rg = _mm_or_si128(pixels.r, _mm_slli_epi16(pixels.g, 8));
+		           __m128i ba = _mm_or_si128(pixels.b, _mm_slli_epi16(pixels.a, 8));
+		           auto dst = reinterpret_cast<__m128i*>(output + x + (y * 16));
+		           _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(rg, ba));
+		           _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rg, ba));
+	           });
+}
+
+void IpuCsc::ConvertMacroblock16(const uint8* block, uint16* output, uint16 alphaTh0, uint16 alphaTh1, bool dither)
+{
+	ForEachRow(block, alphaTh0, alphaTh1,
+	           [output, dither](const PIXELS8& pixels, unsigned int y, unsigned int x) {
+		           __m128i r = pixels.r;
+		           __m128i g = pixels.g;
+		           __m128i b = pixels.b;
+		           if(dither)
+		           {
+			           const auto& ditherRow = g_ditherMatrix[y & 3];
+			           const __m128i ditherValue = _mm_setr_epi16(ditherRow[0], ditherRow[1], ditherRow[2], ditherRow[3],
+			                                                      ditherRow[0], ditherRow[1], ditherRow[2], ditherRow[3]);
+			           const __m128i minValue = _mm_setzero_si128();
+			           const __m128i maxValue = _mm_set1_epi16(0xFF);
+			           r = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(r, ditherValue), minValue), maxValue);
+			           g = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(g, ditherValue), minValue), maxValue);
+			           b = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(b, ditherValue), minValue), maxValue);
+		           }
+		           __m128i result = _mm_srli_epi16(r, 3);
+		           result = _mm_or_si128(result, _mm_slli_epi16(_mm_srli_epi16(g, 3), 5));
+		           result = _mm_or_si128(result, _mm_slli_epi16(_mm_srli_epi16(b, 3), 10));
+		           result = _mm_or_si128(result, _mm_slli_epi16(_mm_srli_epi16(pixels.a, 7), 15));
+		           _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x + (y * 16)), result);
+	           });
+}
+
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+
+struct PIXELS8
+{
+	uint16x8_t r, g, b, a;
+};
+
+static inline uint32x4_t ConvertComponents(float32x4_t value)
+{
+	value = vminq_f32(vmaxq_f32(value, vdupq_n_f32(0.f)), vdupq_n_f32(255.f));
+	return vcvtq_u32_f32(value);
+}
+
+//Converts 8 pixels, Y, Cb and Cr are 16-bit lanes, Cb and Cr already expanded horizontally
+static inline PIXELS8 ConvertPixels8(uint16x8_t y16, uint16x8_t cb16, uint16x8_t cr16, uint16x8_t alphaTh0, uint16x8_t alphaTh1)
+{
+	const float32x4_t bias = vdupq_n_f32(128.f);
+
+	uint16x4_t rgb[3][2];
+	for(unsigned int h = 0; h < 2; h++)
+	{
+		float32x4_t nY = vcvtq_f32_u32(vmovl_u16((h == 0) ? vget_low_u16(y16) : vget_high_u16(y16)));
+		float32x4_t nCb = vcvtq_f32_u32(vmovl_u16((h == 0) ? vget_low_u16(cb16) : vget_high_u16(cb16)));
+		float32x4_t nCr = vcvtq_f32_u32(vmovl_u16((h == 0) ? vget_low_u16(cr16) : vget_high_u16(cr16)));
+
+		nCb = vsubq_f32(nCb, bias);
+		nCr = vsubq_f32(nCr, bias);
+
+		//Multiplies and adds are kept separate, fused operations would round differently
+		float32x4_t nR = vaddq_f32(nY, vmulq_n_f32(nCr, CSC_CR_TO_R));
+		float32x4_t nG = vsubq_f32(vsubq_f32(nY, vmulq_n_f32(nCb, CSC_CB_TO_G)), vmulq_n_f32(nCr, CSC_CR_TO_G));
+		float32x4_t nB = vaddq_f32(nY, vmulq_n_f32(nCb, CSC_CB_TO_B));
+
+		rgb[0][h] = vmovn_u32(ConvertComponents(nR));
+		rgb[1][h] = vmovn_u32(ConvertComponents(nG));
+		rgb[2][h] = vmovn_u32(ConvertComponents(nB));
+	}
+
+	PIXELS8 result;
+	result.r = vcombine_u16(rgb[0][0], rgb[0][1]);
+	result.g = vcombine_u16(rgb[1][0], rgb[1][1]);
+	result.b = vcombine_u16(rgb[2][0], rgb[2][1]);
+
+	uint16x8_t maxComponent = vmaxq_u16(result.r, vmaxq_u16(result.g, result.b));
+	uint16x8_t belowTh0 = vcltq_u16(maxComponent, alphaTh0);
+	uint16x8_t belowTh1 = vcltq_u16(maxComponent, alphaTh1);
+	uint16x8_t alpha = vsubq_u16(vdupq_n_u16(0x80), vandq_u16(belowTh1, vdupq_n_u16(0x40)));
+	result.a = vbicq_u16(alpha, belowTh0);
+
+	return result;
+}
+
+template <typename RowFunction>
+static inline void ForEachRow(const uint8* block, uint16 alphaTh0, uint16 alphaTh1, const RowFunction& rowFunction)
+{
+	const uint16x8_t th0 = vdupq_n_u16(alphaTh0);
+	const uint16x8_t th1 = vdupq_n_u16(alphaTh1);
+
+	for(unsigned int y = 0; y < 16; y++)
+	{
+		uint8x16_t lumaRow = vld1q_u8(block + (y * 16));
+		uint8x8_t cbRow = vld1_u8(block + BLOCK_CB_OFFSET + ((y / 2) * 8));
+		uint8x8_t crRow = vld1_u8(block + BLOCK_CR_OFFSET + ((y / 2) * 8));
+
+		//Each chroma sample covers two pixels
+		uint8x8x2_t cbPairs = vzip_u8(cbRow, cbRow);
+		uint8x8x2_t crPairs = vzip_u8(crRow, crRow);
+
+		for(unsigned int h = 0; h < 2; h++)
+		{
+			uint16x8_t y16 = vmovl_u8((h == 0) ? vget_low_u8(lumaRow) : vget_high_u8(lumaRow));
+			uint16x8_t cb16 = vmovl_u8(cbPairs.val[h]);
+			uint16x8_t cr16 = vmovl_u8(crPairs.val[h]);
+			rowFunction(ConvertPixels8(y16, cb16, cr16, th0, th1), y, h * 8);
+		}
+	}
+}
+
+void IpuCsc::ConvertMacroblock32(const uint8* block, uint32* output, uint16 alphaTh0, uint16 alphaTh1)
+{
+	ForEachRow(block, alphaTh0, alphaTh1,
+	           [output](const PIXELS8& pixels, unsigned int y, unsigned int x) {
+		           uint16x8x2_t pixelHalves;
+		           pixelHalves.val[0] = vorrq_u16(pixels.r, vshlq_n_u16(pixels.g, 8));
+		           pixelHalves.val[1] = vorrq_u16(pixels.b, vshlq_n_u16(pixels.a, 8));
+		           vst2q_u16(reinterpret_cast<uint16*>(output + x + (y * 16)), pixelHalves);
+	           });
+}
+
+void IpuCsc::ConvertMacroblock16(const uint8* block, uint16* output, uint16 alphaTh0, uint16 alphaTh1, bool dither)
+{
+	ForEachRow(block, alphaTh0, alphaTh1,
+	           [output, dither](const PIXELS8& pixels, unsigned int y, unsigned int x) {
+		           uint16x8_t r = pixels.r;
+		           uint16x8_t g = pixels.g;
+		           uint16x8_t b = pixels.b;
+		           if(dither)
+		           {
+			           const auto& ditherRow = g_ditherMatrix[y & 3];
+			           int16x4_t ditherHalf = vld1_s16(ditherRow);
+			           int16x8_t ditherValue = vcombine_s16(ditherHalf, ditherHalf);
+			           const int16x8_t minValue = vdupq_n_s16(0);
+			           const int16x8_t maxValue = vdupq_n_s16(0xFF);
+			           r = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(vaddq_s16(vreinterpretq_s16_u16(r), ditherValue), minValue), maxValue));
+			           g = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(vaddq_s16(vreinterpretq_s16_u16(g), ditherValue), minValue), maxValue));
+			           b = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(vaddq_s16(vreinterpretq_s16_u16(b), ditherValue), minValue), maxValue));
+		           }
+		           uint16x8_t result = vshrq_n_u16(r, 3);
+		           result = vorrq_u16(result, vshlq_n_u16(vshrq_n_u16(g, 3), 5));
+		           result = vorrq_u16(result, vshlq_n_u16(vshrq_n_u16(b, 3), 10));
+		           result = vorrq_u16(result, vshlq_n_u16(vshrq_n_u16(pixels.a, 7), 15));
+		           vst1q_u16(output + x + (y * 16), result);
+	           });
+}
+
+#else
+
+void IpuCsc::ConvertMacroblock32(const uint8* block, uint32* output, uint16 alphaTh0, uint16 alphaTh1)
+{
+	ConvertMacroblock32Scalar(block, output, alphaTh0, alphaTh1);
+}
+
+void IpuCsc::ConvertMacroblock16(const uint8* block, uint16* output, uint16 alphaTh0, uint16 alphaTh1, bool dither)
+{
+	ConvertMacroblock16Scalar(block, output, alphaTh0, alphaTh1, dither);
+}
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Types.h"
+
+//Colour space conversion of IPU macroblocks (16x16 Y, 8x8 Cb, 8x8 Cr in RAW8 format).
+//SIMD versions do the same single precision operations in the same order as the
+//scalar versions and produce exactly the same output.
+
+namespace IpuCsc
+{
+	enum
+	{
+		MACROBLOCK_PIXEL_COUNT = 0x100,
+	};
+
+	void ConvertMacroblock32(const uint8*, uint32*, uint16, uint16);
+	void ConvertMacroblock16(const uint8*, uint16*, uint16, uint16, bool);
+
+	void ConvertMacroblock32Scalar(const uint8*, uint32*, uint16, uint16);
+	void ConvertMacroblock16Scalar(const uint8*, uint16*, uint16, uint16, bool);
+}
@@ -0,0 +1,363 @@
+#include "IPU_Idct.h"
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include "idct/IEEE1180.h"
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+#include <emmintrin.h>
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+#include <arm_neon.h>
+#endif
+
+//Separable row/column IDCT. Each 1D pass splits the transform in even and odd parts:
+//  a0 = W4 * x0 + W4 * x4 + W2 * x2 + W6 * x6    b0 = W1 * x1 + W3 * x3 + W5 * x5 + W7 * x7
+//  a1 = W4 * x0 - W4 * x4 + W6 * x2 - W2 * x6    b1 = W3 * x1 - W7 * x3 - W1 * x5 - W5 * x7
+//  a2 = W4 * x0 - W4 * x4 - W6 * x2 + W2 * x6    b2 = W5 * x1 - W1 * x3 + W7 * x5 + W3 * x7
+//  a3 = W4 * x0 + W4 * x4 - W2 * x2 - W6 * x6    b3 = W7 * x1 - W5 * x3 + W3 * x5 - W1 * x7
+//  y[i] = (ai + bi) >> shift, y[7 - i] = (ai - bi) >> shift
+//Wn = round(cos(n * pi / 16) * sqrt(2) * 2^14), both passes together are scaled by 2^31.
+//Products and partial sums fit in 32 bits, (ai + bi) can wrap on garbage inputs,
+//the scalar version wraps the same way SIMD lanes do. Row pass results are saturated
+//to 16 bits to be used as inputs of the column pass.
+
+#define W1 22725
+#define W2 21407
+#define W3 19266
+#define W4 16383
+#define W5 12873
+#define W6 8867
+#define W7 4520
+
+enum
+{
+	ROW_SHIFT = 11,
+	COL_SHIFT = 20,
+	OUTPUT_MIN = -256,
+	OUTPUT_MAX = 255,
+};
+
+template <int SHIFT>
+static void Idct1D_Scalar(const int16* input, int16* output, unsigned int stride)
+{
+	int32 x0 = input[0 * stride];
+	int32 x1 = input[1 * stride];
+	int32 x2 = input[2 * stride];
+	int32 x3 = input[3 * stride];
+	int32 x4 = input[4 * stride];
+	int32 x5 = input[5 * stride];
+	int32 x6 = input[6 * stride];
+	int32 x7 = input[7 * stride];
+
+	uint32 round = 1 << (SHIFT - 1);
+
+	uint32 a0 = static_cast<uint32>(W4 * x0 + W4 * x4) + static_cast<uint32>(W2 * x2 + W6 * x6) + round;
+	uint32 a1 = static_cast<uint32>(W4 * x0 - W4 * x4) + static_cast<uint32>(W6 * x2 - W2 * x6) + round;
+	uint32 a2 = static_cast<uint32>(W4 * x0 - W4 * x4) + static_cast<uint32>(-W6 * x2 + W2 * x6) + round;
+	uint32 a3 = static_cast<uint32>(W4 * x0 + W4 * x4) + static_cast<uint32>(-W2 * x2 - W6 * x6) + round;
+
+	uint32 b0 = static_cast<uint32>(W1 * x1 + W3 * x3) + static_cast<uint32>(W5 * x5 + W7 * x7);
+	uint32 b1 = static_cast<uint32>(W3 * x1 - W7 * x3) + static_cast<uint32>(-W1 * x5 - W5 * x7);
+	uint32 b2 = static_cast<uint32>(W5 * x1 - W1 * x3) + static_cast<uint32>(W7 * x5 + W3 * x7);
+	uint32 b3 = static_cast<uint32>(W7 * x1 - W5 * x3) + static_cast<uint32>(W3 * x5 - W1 * x7);
+
+	int32 y[8] =
+	    {
+	        static_cast<int32>(a0 + b0) >> SHIFT,
+	        static_cast<int32>(a1 + b1) >> SHIFT,
+	        static_cast<int32>(a2 + b2) >> SHIFT,
+	        static_cast<int32>(a3 + b3) >> SHIFT,
+	        static_cast<int32>(a3 - b3) >> SHIFT,
+	        static_cast<int32>(a2 - b2) >> SHIFT,
+	        static_cast<int32>(a1 - b1) >> SHIFT,
+	        static_cast<int32>(a0 - b0) >> SHIFT,
+	    };
+
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		output[i * stride] = static_cast<int16>(std::clamp<int32>(y[i], INT16_MIN, INT16_MAX));
+	}
+}
+
+static bool IsDcOnly(const int16* input)
+{
+	for(unsigned int i = 1; i < 64; i++)
+	{
+		if(input[i] != 0) return false;
+	}
+	return true;
+}
+
+static void TransformDcOnly(const int16* input, int16* output)
+{
+	//All outputs are DC / 8, rounded the same way as the reference
+	int32 value = (static_cast<int32>(input[0]) + 4) >> 3;
+	std::fill(output, output + 64, static_cast<int16>(std::clamp<int32>(value, OUTPUT_MIN, OUTPUT_MAX)));
+}
+
+void IpuIdct::TransformScalar(const int16* input, int16* output)
+{
+	if(IsDcOnly(input))
+	{
+		TransformDcOnly(input, output);
+		return;
+	}
+
+	int16 temp[64];
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		Idct1D_Scalar<ROW_SHIFT>(input + (i * 8), temp + (i * 8), 1);
+	}
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		Idct1D_Scalar<COL_SHIFT>(temp + i, output + i, 8);
+	}
+	for(unsigned int i = 0; i < 64; i++)
+	{
+		output[i] = std::clamp<int16>(output[i], OUTPUT_MIN, OUTPUT_MAX);
+	}
+}
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+
+static inline __m128i MakeCoefPair(int16 c0, int16 c1)
+{
+	return _mm_set1_epi32(static_cast<uint16>(c0) | (static_cast<uint32>(static_cast<uint16>(c1)) << 16));
+}
+
+static inline __m128i MulAdd2(__m128i p0, __m128i c0, __m128i p1, __m128i c1)
+{
+	return _mm_add_epi32(_mm_madd_epi16(p0, c0), _mm_madd_epi16(p1, c1));
+}
+
+static inline void Transpose8x8(__m128i* r)
+{
+	__m128i t0 = _mm_unpacklo_epi16(r[0], r[1]);
+	__m128i t1 = _mm_unpackhi_epi16(r[0], r[1]);
+	__m128i t2 = _mm_unpacklo_epi16(r[2], r[3]);
+	__m128i t3 = _mm_unpackhi_epi16(r[2], r[3]);
+	__m128i t4 = _mm_unpacklo_epi16(r[4], r[5]);
+	__m128i t5 = _mm_unpackhi_epi16(r[4], r[5]);
+	__m128i t6 = _mm_unpacklo_epi16(r[6], r[7]);
+	__m128i t7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+	__m128i u0 = _mm_unpacklo_epi32(t0, t2);
+	__m128i u1 = _mm_unpackhi_epi32(t0, t2);
+	__m128i u2 = _mm_unpacklo_epi32(t1, t3);
+	__m128i u3 = _mm_unpackhi_epi32(t1, t3);
+	__m128i u4 = _mm_unpacklo_epi32(t4, t6);
+	__m128i u5 = _mm_unpackhi_epi32(t4, t6);
+	__m128i u6 = _mm_unpacklo_epi32(t5, t7);
+	__m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+	r[0] = _mm_unpacklo_epi64(u0, u4);
+	r[1] = _mm_unpackhi_epi64(u0, u4);
+	r[2] = _mm_unpacklo_epi64(u1, u5);
+	r[3] = _mm_unpackhi_epi64(u1, u5);
+	r[4] = _mm_unpacklo_epi64(u2, u6);
+	r[5] = _mm_unpackhi_epi64(u2, u6);
+	r[6] = _mm_unpacklo_epi64(u3, u7);
+	r[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+//Transforms the 8 columns held by the 8 row registers at once
+template <int SHIFT>
+static inline void Idct1D_Sse2(__m128i* x)
+{
+	const __m128i round = _mm_set1_epi32(1 << (SHIFT - 1));
+
+	const __m128i c04_p = MakeCoefPair(W4, W4);
+	const __m128i c04_m = MakeCoefPair(W4, -W4);
+	const __m128i c26_0 = MakeCoefPair(W2, W6);
+	const __m128i c26_1 = MakeCoefPair(W6, -W2);
+	const __m128i c26_2 = MakeCoefPair(-W6, W2);
+	const __m128i c26_3 = MakeCoefPair(-W2, -W6);
+	const __m128i c13_0 = MakeCoefPair(W1, W3);
+	const __m128i c57_0 = MakeCoefPair(W5, W7);
+	const __m128i c13_1 = MakeCoefPair(W3, -W7);
+	const __m128i c57_1 = MakeCoefPair(-W1, -W5);
+	const __m128i c13_2 = MakeCoefPair(W5, -W1);
+	const __m128i c57_2 = MakeCoefPair(W7, W3);
+	const __m128i c13_3 = MakeCoefPair(W7, -W5);
+	const __m128i c57_3 = MakeCoefPair(W3, -W1);
+
+	__m128i p04[2] = {_mm_unpacklo_epi16(x[0], x[4]), _mm_unpackhi_epi16(x[0], x[4])};
+	__m128i p26[2] = {_mm_unpacklo_epi16(x[2], x[6]), _mm_unpackhi_epi16(x[2], x[6])};
+	__m128i p13[2] = {_mm_unpacklo_epi16(x[1], x[3]), _mm_unpackhi_epi16(x[1], x[3])};
+	__m128i p57[2] = {_mm_unpacklo_epi16(x[5], x[7]), _mm_unpackhi_epi16(x[5], x[7])};
+
+	__m128i y[8][2];
+	for(unsigned int h = 0; h < 2; h++)
+	{
+		__m128i a0 = _mm_add_epi32(MulAdd2(p04[h], c04_p, p26[h], c26_0), round);
+		__m128i a1 = _mm_add_epi32(MulAdd2(p04[h], c04_m, p26[h], c26_1), round);
+		__m128i a2 = _mm_add_epi32(MulAdd2(p04[h], c04_m, p26[h], c26_2), round);
+		__m128i a3 = _mm_add_epi32(MulAdd2(p04[h], c04_p, p26[h], c26_3), round);
+
+		__m128i b0 = MulAdd2(p13[h], c13_0, p57[h], c57_0);
+		__m128i b1 = MulAdd2(p13[h], c13_1, p57[h], c57_1);
+		__m128i b2 = MulAdd2(p13[h], c13_2, p57[h], c57_2);
+		__m128i b3 = MulAdd2(p13[h], c13_3, p57[h], c57_3);
+
+		y[0][h] = _mm_srai_epi32(_mm_add_epi32(a0, b0), SHIFT);
+		y[1][h] = _mm_srai_epi32(_mm_add_epi32(a1, b1), SHIFT);
+		y[2][h] = _mm_srai_epi32(_mm_add_epi32(a2, b2), SHIFT);
+		y[3][h] = _mm_srai_epi32(_mm_add_epi32(a3, b3), SHIFT);
+		y[4][h] = _mm_srai_epi32(_mm_sub_epi32(a3, b3), SHIFT);
+		y[5][h] = _mm_srai_epi32(_mm_sub_epi32(a2, b2), SHIFT);
+		y[6][h] = _mm_srai_epi32(_mm_sub_epi32(a1, b1), SHIFT);
+		y[7][h] = _mm_srai_epi32(_mm_sub_epi32(a0, b0), SHIFT);
+	}
+
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		x[i] = _mm_packs_epi32(y[i][0], y[i][1]);
+	}
+}
+
+static void Transform_Sse2(const int16* input, int16* output)
+{
+	__m128i r[8];
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * 8)));
+	}
+
+	Transpose8x8(r);
+	Idct1D_Sse2<ROW_SHIFT>(r);
+	Transpose8x8(r);
+	Idct1D_Sse2<COL_SHIFT>(r);
+
+	const __m128i outputMin = _mm_set1_epi16(OUTPUT_MIN);
+	const __m128i outputMax = _mm_set1_epi16(OUTPUT_MAX);
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		__m128i value = _mm_min_epi16(_mm_max_epi16(r[i], outputMin), outputMax);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * 8)), value);
+	}
+}
+
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+
+static inline void Transpose8x8(int16x8_t* r)
+{
+	int16x8x2_t t0 = vtrnq_s16(r[0], r[1]);
+	int16x8x2_t t1 = vtrnq_s16(r[2], r[3]);
+	int16x8x2_t t2 = vtrnq_s16(r[4], r[5]);
+	int16x8x2_t t3 = vtrnq_s16(r[6], r[7]);
+
+	int32x4x2_t u0 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[0]), vreinterpretq_s32_s16(t1.val[0]));
+	int32x4x2_t u1 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[1]), vreinterpretq_s32_s16(t1.val[1]));
+	int32x4x2_t u2 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[0]), vreinterpretq_s32_s16(t3.val[0]));
+	int32x4x2_t u3 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[1]), vreinterpretq_s32_s16(t3.val[1]));
+
+	auto combineLow = [](int32x4_t a, int32x4_t b) { return vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(a), vget_low_s32(b))); };
+	auto combineHigh = [](int32x4_t a, int32x4_t b) { return vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(a), vget_high_s32(b))); };
+
+	r[0] = combineLow(u0.val[0], u2.val[0]);
+	r[1] = combineLow(u1.val[0], u3.val[0]);
+	r[2] = combineLow(u0.val[1], u2.val[1]);
+	r[3] = combineLow(u1.val[1], u3.val[1]);
+	r[4] = combineHigh(u0.val[0], u2.val[0]);
+	r[5] = combineHigh(u1.val[0], u3.val[0]);
+	r[6] = combineHigh(u0.val[1], u2.val[1]);
+	r[7] = combineHigh(u1.val[1], u3.val[1]);
+}
+
+static inline int32x4_t MulAdd4(int16x4_t x0, int16 c0, int16x4_t x1, int16 c1, int16x4_t x2, int16 c2, int16x4_t x3, int16 c3)
+{
+	int32x4_t result = vmull_n_s16(x0, c0);
+	result = vmlal_n_s16(result, x1, c1);
+	result = vmlal_n_s16(result, x2, c2);
+	result = vmlal_n_s16(result, x3, c3);
+	return result;
+}
+
+//Transforms the 8 columns held by the 8 row registers at once
+template <int SHIFT>
+static inline void Idct1D_Neon(int16x8_t* x)
+{
+	const int32x4_t round = vdupq_n_s32(1 << (SHIFT - 1));
+
+	int32x4_t y[8][2];
+	for(unsigned int h = 0; h < 2; h++)
+	{
+		int16x4_t v[8];
+		for(unsigned int i = 0; i < 8; i++)
+		{
+			v[i] = (h == 0) ? vget_low_s16(x[i]) : vget_high_s16(x[i]);
+		}
+
+		int32x4_t a0 = vaddq_s32(MulAdd4(v[0], W4, v[4], W4, v[2], W2, v[6], W6), round);
+		int32x4_t a1 = vaddq_s32(MulAdd4(v[0], W4, v[4], -W4, v[2], W6, v[6], -W2), round);
+		int32x4_t a2 = vaddq_s32(MulAdd4(v[0], W4, v[4], -W4, v[2], -W6, v[6], W2), round);
+		int32x4_t a3 = vaddq_s32(MulAdd4(v[0], W4, v[4], W4, v[2], -W2, v[6], -W6), round);
+
+		int32x4_t b0 = MulAdd4(v[1], W1, v[3], W3, v[5], W5, v[7], W7);
+		int32x4_t b1 = MulAdd4(v[1], W3, v[3], -W7, v[5], -W1, v[7], -W5);
+		int32x4_t b2 = MulAdd4(v[1], W5, v[3], -W1, v[5], W7, v[7], W3);
+		int32x4_t b3 = MulAdd4(v[1], W7, v[3], -W5, v[5], W3, v[7], -W1);
+
+		y[0][h] = vshrq_n_s32(vaddq_s32(a0, b0), SHIFT);
+		y[1][h] = vshrq_n_s32(vaddq_s32(a1, b1), SHIFT);
+		y[2][h] = vshrq_n_s32(vaddq_s32(a2, b2), SHIFT);
+		y[3][h] = vshrq_n_s32(vaddq_s32(a3, b3), SHIFT);
+		y[4][h] = vshrq_n_s32(vsubq_s32(a3, b3), SHIFT);
+		y[5][h] = vshrq_n_s32(vsubq_s32(a2, b2), SHIFT);
+		y[6][h] = vshrq_n_s32(vsubq_s32(a1, b1), SHIFT);
+		y[7][h] = vshrq_n_s32(vsubq_s32(a0, b0), SHIFT);
+	}
+
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		x[i] = vcombine_s16(vqmovn_s32(y[i][0]), vqmovn_s32(y[i][1]));
+	}
+}
+
+static void Transform_Neon(const int16* input, int16* output)
+{
+	int16x8_t r[8];
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		r[i] = vld1q_s16(input + (i * 8));
+	}
+
+	Transpose8x8(r);
+	Idct1D_Neon<ROW_SHIFT>(r);
+	Transpose8x8(r);
+	Idct1D_Neon<COL_SHIFT>(r);
+
+	const int16x8_t outputMin = vdupq_n_s16(OUTPUT_MIN);
+	const int16x8_t outputMax = vdupq_n_s16(OUTPUT_MAX);
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		vst1q_s16(output + (i * 8), vminq_s16(vmaxq_s16(r[i], outputMin), outputMax));
+	}
+}
+
+#endif
+
+void IpuIdct::Transform(const int16* input, int16* output)
+{
+	//Blocks with only a DC coefficient are very common in FMVs
+	if(IsDcOnly(input))
+	{
+		TransformDcOnly(input, output);
+		return;
+	}
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+	Transform_Sse2(input, output);
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+	Transform_Neon(input, output);
+#else
+	TransformScalar(input, output);
+#endif
+}
+
+void IpuIdct::TransformReference(const int16* input, int16* output)
+{
+	int16 temp[64];
+	memcpy(temp, input, sizeof(temp));
+	IDCT::CIEEE1180::GetInstance()->Transform(temp, output);
+}
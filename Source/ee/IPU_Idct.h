@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Types.h"
+
+//Fixed-point IDCT used by the IPU's block decoders.
+//Accuracy is within IEEE 1180 limits of the floating-point reference, but results aren't
+//bit-exact with it. Every implementation (SSE2, NEON, scalar) produces exactly the same output.
+//Outputs are saturated to [-256, 255] like the reference.
+
+namespace IpuIdct
+{
+	typedef void (*TransformFunction)(const int16*, int16*);
+
+	void Transform(const int16*, int16*);
+	void TransformScalar(const int16*, int16*);
+	void TransformReference(const int16*, int16*);
+}
@@ -0,0 +1,178 @@
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include "IPU_Trace.h"
+#include "xxhash.h"
+
+void CIpuTrace::Reset()
+{
+	m_started = false;
+	memset(m_intraIq, 0, sizeof(m_intraIq));
+	memset(m_nonIntraIq, 0, sizeof(m_nonIntraIq));
+	memset(m_vqClut, 0, sizeof(m_vqClut));
+	m_events.clear();
+	m_output.clear();
+}
+
+bool CIpuTrace::IsStarted() const
+{
+	return m_started;
+}
+
+void CIpuTrace::Start(const uint8* intraIq, const uint8* nonIntraIq, const uint16* vqClut)
+{
+	assert(!m_started);
+	m_started = true;
+	memcpy(m_intraIq, intraIq, sizeof(m_intraIq));
+	memcpy(m_nonIntraIq, nonIntraIq, sizeof(m_nonIntraIq));
+	memcpy(m_vqClut, vqClut, sizeof(m_vqClut));
+}
+
+const uint8* CIpuTrace::GetIntraIq() const
+{
+	return m_intraIq;
+}
+
+const uint8* CIpuTrace::GetNonIntraIq() const
+{
+	return m_nonIntraIq;
+}
+
+const uint16* CIpuTrace::GetVqClut() const
+{
+	return m_vqClut;
+}
+
+const CIpuTrace::EventArray& CIpuTrace::GetEvents() const
+{
+	return m_events;
+}
+
+void CIpuTrace::AddRegisterWrite(uint32 address, uint32 value)
+{
+	assert(m_started);
+	EVENT event;
+	event.type = EVENT_TYPE_REGISTERWRITE;
+	event.address = address;
+	event.value = value;
+	m_events.push_back(std::move(event));
+}
+
+void CIpuTrace::AddDma4Data(const void* data, uint32 size)
+{
+	assert(m_started);
+	//Consecutive transfers are merged, they're only split by the IN FIFO's size
+	if(!m_events.empty() && (m_events.back().type == EVENT_TYPE_DMA4DATA))
+	{
+		auto& eventData = m_events.back().data;
+		eventData.insert(eventData.end(), reinterpret_cast<const uint8*>(data), reinterpret_cast<const uint8*>(data) + size);
+		return;
+	}
+	EVENT event;
+	event.type = EVENT_TYPE_DMA4DATA;
+	event.data.assign(reinterpret_cast<const uint8*>(data), reinterpret_cast<const uint8*>(data) + size);
+	m_events.push_back(std::move(event));
+}
+
+void CIpuTrace::AddOutputData(const void* data, uint32 size)
+{
+	assert(m_started);
+	m_output.insert(m_output.end(), reinterpret_cast<const uint8*>(data), reinterpret_cast<const uint8*>(data) + size);
+}
+
+void CIpuTrace::AddCommandEnd(uint32 ctrl, uint32 cmd)
+{
+	assert(m_started);
+	EVENT event;
+	event.type = EVENT_TYPE_COMMANDEND;
+	event.address = ctrl;
+	event.value = cmd;
+	event.outputHash = ComputeOutputHash(m_output);
+	m_events.push_back(std::move(event));
+	m_output.clear();
+}
+
+void CIpuTrace::Read(Framework::CStream& input)
+{
+	Reset();
+
+	if(input.Read32() != FILE_MAGIC)
+	{
+		throw std::runtime_error("Not an IPU trace.");
+	}
+	if(input.Read32() != FILE_VERSION)
+	{
+		throw std::runtime_error("Unsupported IPU trace version.");
+	}
+
+	input.Read(m_intraIq, sizeof(m_intraIq));
+	input.Read(m_nonIntraIq, sizeof(m_nonIntraIq));
+	input.Read(m_vqClut, sizeof(m_vqClut));
+
+	uint32 eventCount = input.Read32();
+	m_events.resize(eventCount);
+	for(auto& event : m_events)
+	{
+		event.type = static_cast<EVENT_TYPE>(input.Read32());
+		switch(event.type)
+		{
+		case EVENT_TYPE_REGISTERWRITE:
+			event.address = input.Read32();
+			event.value = input.Read32();
+			break;
+		case EVENT_TYPE_DMA4DATA:
+			event.data.resize(input.Read32());
+			input.Read(event.data.data(), event.data.size());
+			break;
+		case EVENT_TYPE_COMMANDEND:
+			event.address = input.Read32();
+			event.value = input.Read32();
+			input.Read(&event.outputHash, sizeof(uint64));
+			break;
+		default:
+			throw std::runtime_error("Invalid IPU trace event.");
+			break;
+		}
+	}
+	m_started = true;
+}
+
+void CIpuTrace::Write(Framework::CStream& output) const
+{
+	output.Write32(FILE_MAGIC);
+	output.Write32(FILE_VERSION);
+
+	output.Write(m_intraIq, sizeof(m_intraIq));
+	output.Write(m_nonIntraIq, sizeof(m_nonIntraIq));
+	output.Write(m_vqClut, sizeof(m_vqClut));
+
+	output.Write32(static_cast<uint32>(m_events.size()));
+	for(const auto& event : m_events)
+	{
+		output.Write32(event.type);
+		switch(event.type)
+		{
+		case EVENT_TYPE_REGISTERWRITE:
+			output.Write32(event.address);
+			output.Write32(event.value);
+			break;
+		case EVENT_TYPE_DMA4DATA:
+			output.Write32(static_cast<uint32>(event.data.size()));
+			output.Write(event.data.data(), event.data.size());
+			break;
+		case EVENT_TYPE_COMMANDEND:
+			output.Write32(event.address);
+			output.Write32(event.value);
+			output.Write(&event.outputHash, sizeof(uint64));
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+}
+
+uint64 CIpuTrace::ComputeOutputHash(const std::vector<uint8>& output)
+{
+	return XXH3_64bits(output.data(), output.size());
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include "Types.h"
+#include "Stream.h"
+
+//Recording of everything the IPU receives (register writes and DMA4 data) while a game runs.
+//Recording starts on the first IPU reset (IPU_CTRL.RST) to make sure the FIFO and command
+//states are known, quantizer matrices and VQ CLUT are saved at that point since a reset
+//doesn't clear them. Each command completion is recorded with a hash of the data sent
+//through the OUT FIFO which allows checking a replay against the original run.
+
+class CIpuTrace
+{
+public:
+	enum
+	{
+		FILE_MAGIC = 0x54555049, //'IPUT'
+		FILE_VERSION = 1,
+	};
+
+	enum EVENT_TYPE
+	{
+		EVENT_TYPE_REGISTERWRITE = 1,
+		EVENT_TYPE_DMA4DATA = 2,
+		EVENT_TYPE_COMMANDEND = 3,
+	};
+
+	struct EVENT
+	{
+		EVENT_TYPE type = EVENT_TYPE_REGISTERWRITE;
+
+		//Register writes: register address and value
+		//Command end: IPU_CTRL and IPU_CMD register values once the command is done
+		uint32 address = 0;
+		uint32 value = 0;
+
+		//Command end: hash of the command's output
+		uint64 outputHash = 0;
+
+		//DMA4 data: data received by the IN FIFO
+		std::vector<uint8> data;
+	};
+	typedef std::vector<EVENT> EventArray;
+
+	void Reset();
+
+	bool IsStarted() const;
+	void Start(const uint8* intraIq, const uint8* nonIntraIq, const uint16* vqClut);
+
+	const uint8* GetIntraIq() const;
+	const uint8* GetNonIntraIq() const;
+	const uint16* GetVqClut() const;
+	const EventArray& GetEvents() const;
+
+	void AddRegisterWrite(uint32, uint32);
+	void AddDma4Data(const void*, uint32);
+	void AddOutputData(const void*, uint32);
+	void AddCommandEnd(uint32, uint32);
+
+	void Read(Framework::CStream&);
+	void Write(Framework::CStream&) const;
+
+	static uint64 ComputeOutputHash(const std::vector<uint8>&);
+
+private:
+	bool m_started = false;
+	uint8 m_intraIq[0x40] = {};
+	uint8 m_nonIntraIq[0x40] = {};
+	uint16 m_vqClut[0x10] = {};
+	EventArray m_events;
+	std::vector<uint8> m_output;
+};
@@ -14,6 +14,8 @@
 #define SIF_RESETADDR 0 //Only works if equals to 0
 
 #define SIF_BIND_TIMEOUT_TICKS 0x10000
+//Minimum amount of sent packet bytes before compacting a queue that isn't drained
+#define PACKET_QUEUE_COMPACT_SIZE 0x10000
 
 #define LOG_NAME ("sif")
 
@@ -81,11 +83,14 @@ void CSIF::Reset()
 	m_cmdBufferSize = 0;
 
 	m_packetQueue.clear();
+	m_packetQueuePosition = 0;
 	m_packetProcessed = true;
 
 	m_callReplies.clear();
 	m_bindReplies.clear();
 
+	m_stats = STATS();
+
 	DeleteModules();
 }
 
@@ -105,6 +110,7 @@ void CSIF::SetCmdBuffer(uint32 bufferAddress, uint32 size)
 void CSIF::RegisterModule(uint32 moduleId, CSifModule* module)
 {
 	m_modules[moduleId] = module;
+	m_lastCallModule = nullptr;
 
 	auto replyIterator(m_bindReplies.find(moduleId));
 	if(replyIterator != m_bindReplies.end())
@@ -144,11 +150,29 @@ bool CSIF::IsModuleRegistered(uint32 moduleId) const
 void CSIF::UnregisterModule(uint32 moduleId)
 {
 	m_modules.erase(moduleId);
+	m_lastCallModule = nullptr;
 }
 
 void CSIF::DeleteModules()
 {
 	m_modules.clear();
+	m_lastCallModule = nullptr;
+}
+
+CSifModule* CSIF::FindModule(uint32 serverId)
+{
+	if(m_lastCallModule && (m_lastCallServerId == serverId))
+	{
+		return m_lastCallModule;
+	}
+	auto moduleIterator = m_modules.find(serverId);
+	if(moduleIterator == std::end(m_modules))
+	{
+		return nullptr;
+	}
+	m_lastCallServerId = serverId;
+	m_lastCallModule = moduleIterator->second;
+	return m_lastCallModule;
 }
 
 uint32 CSIF::ReceiveDMA5(uint32 srcAddress, uint32 size, uint32 unused, bool isTagIncluded)
@@ -264,13 +288,32 @@ void CSIF::CountTicks(uint32 ticks)
 {
 	CheckPendingBindRequests(ticks);
 
-	if(m_packetProcessed && !m_packetQueue.empty())
+	bool hasPendingPackets = (m_packetQueuePosition != m_packetQueue.size());
+
+	if(!m_packetProcessed && hasPendingPackets)
+	{
+		m_stats.waitTicks += ticks;
+	}
+
+	if(m_packetProcessed && hasPendingPackets)
 	{
-		assert(m_packetQueue.size() > 8);
-		uint32 size = *reinterpret_cast<uint32*>(&m_packetQueue[0]);
-		uint32 dstAddr = *reinterpret_cast<uint32*>(&m_packetQueue[4]);
-		SendDMA(&m_packetQueue[8], dstAddr, size);
-		m_packetQueue.erase(m_packetQueue.begin(), m_packetQueue.begin() + 8 + size);
+		assert((m_packetQueue.size() - m_packetQueuePosition) > 8);
+		auto packet = m_packetQueue.data() + m_packetQueuePosition;
+		uint32 size = *reinterpret_cast<const uint32*>(packet + 0);
+		uint32 dstAddr = *reinterpret_cast<const uint32*>(packet + 4);
+		SendDMA(packet + 8, dstAddr, size);
+		m_packetQueuePosition += 8 + size;
+		if(m_packetQueuePosition == m_packetQueue.size())
+		{
+			m_packetQueue.clear();
+			m_packetQueuePosition = 0;
+		}
+		else if((m_packetQueuePosition >= PACKET_QUEUE_COMPACT_SIZE) && (m_packetQueuePosition >= (m_packetQueue.size() / 2)))
+		{
+			//Queue might never be drained if replies keep coming in, don't let it grow forever
+			m_packetQueue.erase(m_packetQueue.begin(), m_packetQueue.begin() + m_packetQueuePosition);
+			m_packetQueuePosition = 0;
+		}
 		m_packetProcessed = false;
 	}
 }
@@ -286,6 +329,8 @@ void CSIF::SendDMA(const void* data, uint32 dstAddr, uint32 size)
 	memcpy(m_eeRam + dstAddr, data, size);
 
 	uint32 qwc = (size + 0x0F) / 0x10;
+	m_stats.packetCount++;
+	m_stats.qwordCount += qwc;
 	m_dmac.SetRegister(CDMAC::D5_MADR, dstAddr);
 	m_dmac.SetRegister(CDMAC::D5_QWC, qwc);
 	m_dmac.SetRegister(CDMAC::D5_CHCR, CDMAC::CHCR_STR);
@@ -305,6 +350,7 @@ void CSIF::LoadState(Framework::CZipArchiveReader& archive)
 	}
 
 	m_packetQueue = LoadPacketQueue(archive);
+	m_packetQueuePosition = 0;
 
 	m_callReplies = LoadCallReplies(archive);
 	m_bindReplies = LoadBindReplies(archive);
@@ -324,12 +370,23 @@ void CSIF::SaveState(Framework::CZipArchiveWriter& archive)
 		archive.InsertFile(std::move(registerFile));
 	}
 
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_PACKETQUEUE, m_packetQueue.data(), m_packetQueue.size()));
+	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_PACKETQUEUE, m_packetQueue.data() + m_packetQueuePosition,
+	                                                      m_packetQueue.size() - m_packetQueuePosition));
 
 	SaveCallReplies(archive);
 	SaveBindReplies(archive);
 }
 
+const CSIF::STATS& CSIF::GetStats() const
+{
+	return m_stats;
+}
+
+void CSIF::ClearStats()
+{
+	m_stats = STATS();
+}
+
 void CSIF::SaveCallReplies(Framework::CZipArchiveWriter& archive)
 {
 	auto callRepliesFile = std::make_unique<CRegisterStateCollectionFile>(STATE_CALL_REPLIES_XML);
@@ -571,15 +628,16 @@ void CSIF::Cmd_Call(const SIFCMDHEADER* hdr)
 	auto call = reinterpret_cast<const SIFRPCCALL*>(hdr);
 	uint32 serverId = call->serverDataAddr ^ RPC_SERVERID_XOR;
 	bool sendReply = true;
+	m_stats.callCount++;
 
 	CLog::GetInstance().Print(LOG_NAME, "Calling function 0x%08X of module 0x%08X.\r\n", call->rpcNumber, serverId);
 
 	uint32 recvAddr = (call->recv & (PS2::EE_RAM_SIZE - 1));
 
-	auto moduleIterator(m_modules.find(serverId));
-	if(moduleIterator != std::end(m_modules))
+	//HLE servers are invoked right away with their buffers mapped from EE RAM,
+	//the reply still goes through the packet queue to keep the same completion timing
+	if(auto module = FindModule(serverId))
 	{
-		auto module = moduleIterator->second;
 		sendReply = module->Invoke(call->rpcNumber,
 		                           reinterpret_cast<uint32*>(m_eeRam + m_nDataAddr), call->sendSize,
 		                           reinterpret_cast<uint32*>(m_eeRam + recvAddr), call->recvSize,
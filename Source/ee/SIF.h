@@ -15,6 +15,17 @@ public:
 	typedef std::function<void(const std::string&)> ModuleResetHandler;
 	typedef std::function<void(uint32)> CustomCommandHandler;
 
+	struct STATS
+	{
+		//Packets sent to the EE and their total size
+		uint32 packetCount = 0;
+		uint32 qwordCount = 0;
+		//RPC calls received from the EE
+		uint32 callCount = 0;
+		//Ticks spent with packets queued while the EE was processing a previous one
+		uint32 waitTicks = 0;
+	};
+
 	CSIF(CDMAC&, uint8*, uint8*);
 	virtual ~CSIF() = default;
 
@@ -46,6 +57,9 @@ public:
 	void LoadState(Framework::CZipArchiveReader&);
 	void SaveState(Framework::CZipArchiveWriter&);
 
+	const STATS& GetStats() const;
+	void ClearStats();
+
 private:
 	struct CALLREQUESTINFO
 	{
@@ -65,6 +79,7 @@ private:
 	typedef std::map<uint32, BINDREQUESTINFO> BindReplyMap;
 
 	void CheckPendingBindRequests(uint32);
+	CSifModule* FindModule(uint32);
 
 	void DeleteModules();
 
@@ -107,7 +122,14 @@ private:
 
 	ModuleMap m_modules;
 
+	//Last server resolved by a call, games tend to call the same HLE server in bursts
+	uint32 m_lastCallServerId = 0;
+	CSifModule* m_lastCallModule = nullptr;
+
+	//Packets before the read position have been sent already, the queue is compacted
+	//once it's been drained or once sent packets take up most of it
 	PacketQueue m_packetQueue;
+	uint32 m_packetQueuePosition = 0;
 	bool m_packetProcessed;
 
 	CallReplyMap m_callReplies;
@@ -115,4 +137,6 @@ private:
 
 	ModuleResetHandler m_moduleResetHandler;
 	CustomCommandHandler m_customCommandHandler;
+
+	STATS m_stats;
 };
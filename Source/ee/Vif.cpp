@@ -50,6 +50,9 @@ CVif::CVif(unsigned int number, CVpu& vpu, CINTC& intc, uint8* ram, uint8* spr)
     , m_ram(ram)
     , m_spr(spr)
     , m_stream(ram, spr)
+#ifndef AOT_USE_CACHE
+    , m_unpackCache((number == 0) ? PS2::VUMEM0SIZE : PS2::VUMEM1SIZE)
+#endif
     , m_vifProfilerZone(CProfiler::GetInstance().RegisterZone(string_format("VIF%d", number).c_str()))
 {
 	static_loop<int, MAX_UNPACKERS>(
@@ -695,6 +698,18 @@ void CVif::Cmd_STMASK(StreamType& stream, CODE command)
 }
 
 void CVif::Cmd_UNPACK(StreamType& stream, CODE nCommand, uint32 nDstAddr)
+{
+	auto unpackFct = GetUnpacker(nCommand);
+#ifndef AOT_USE_CACHE
+	if(Unpack_Compiled(stream, nCommand, nDstAddr, unpackFct))
+	{
+		return;
+	}
+#endif
+	((*this).*(unpackFct))(stream, nCommand, nDstAddr, 0);
+}
+
+CVif::Unpacker CVif::GetUnpacker(CODE nCommand) const
 {
 	uint32 cl = m_CYCLE.nCL;
 	uint32 wl = m_CYCLE.nWL;
@@ -707,10 +722,136 @@ void CVif::Cmd_UNPACK(StreamType& stream, CODE nCommand, uint32 nDstAddr)
 	bool useMask = (nCommand.nCMD & 0x10) != 0;
 	bool usn = (m_CODE.nIMM & 0x4000) != 0;
 	uint8 mode = m_MODE & 0x3;
-	auto unpackFct = m_unpacker[(nCommand.nCMD & 0x0F) | ((clGreaterEqualWl ? 1 : 0) << 4) | ((useMask ? 1 : 0) << 5) | (mode << 6) | (usn << 8)];
-	((*this).*(unpackFct))(stream, nCommand, nDstAddr);
+	return m_unpacker[(nCommand.nCMD & 0x0F) | ((clGreaterEqualWl ? 1 : 0) << 4) | ((useMask ? 1 : 0) << 5) | (mode << 6) | (usn << 8)];
+}
+
+#ifndef AOT_USE_CACHE
+
+bool CVif::Unpack_Compiled(StreamType& stream, CODE command, uint32 dstAddr, Unpacker unpackFct)
+{
+	//Processes as many complete cycles as possible with a compiled routine, returns true
+	//if the whole command was processed, otherwise, the generic unpacker takes over.
+	CVifUnpackCache::CONFIG config;
+	config.dataType = command.nCMD & 0x0F;
+	config.usn = (m_CODE.nIMM & 0x4000) != 0;
+	config.mode = m_MODE & 0x3;
+	config.useMask = (command.nCMD & 0x10) != 0;
+	config.mask = config.useMask ? m_MASK : 0;
+	config.cl = m_CYCLE.nCL;
+	config.wl = m_CYCLE.nWL;
+
+	if(!CVifUnpackCache::IsSupported(config)) return false;
+	if(stream.IsTagPending()) return false;
+
+	if(m_NUM == command.nNUM)
+	{
+		m_readTick = 0;
+		m_writeTick = 0;
+	}
+
+	//The generic unpacker finishes the current cycle and goes through the bytes left
+	//from a previous source, after that, the data can be read directly.
+	uint32 codeNum = (m_CODE.nNUM == 0) ? 256 : m_CODE.nNUM;
+	while(true)
+	{
+		uint32 currentNum = (m_NUM == 0) ? 256 : m_NUM;
+		uint32 cycleWrites = (codeNum - currentNum) % config.wl;
+		uint32 leadNum = 0;
+		if(cycleWrites != 0)
+		{
+			leadNum = config.wl - cycleWrites;
+		}
+		else if(stream.HasPreviousSourceBytes())
+		{
+			leadNum = config.wl;
+		}
+		else
+		{
+			break;
+		}
+		if(leadNum >= currentNum) return false;
+		uint32 endNum = currentNum - leadNum;
+		((*this).*(unpackFct))(stream, command, dstAddr, endNum);
+		//Ran out of data, we'll be back when more is available
+		if(m_NUM != endNum) return true;
+	}
+
+	//We're at the beginning of a cycle, transfered is a multiple of WL. The generic unpacker
+	//might have stopped before skipping the end of the last cycle, which doesn't hold any data.
+	m_readTick = 0;
+	m_writeTick = 0;
+
+	uint32 writeCount = CVifUnpackCache::GetWriteCount(config);
+	uint32 readSize = CVifUnpackCache::GetReadSize(config);
+	uint32 dstSize = CVifUnpackCache::GetDestinationSize(config);
+
+	uint32 currentNum = (m_NUM == 0) ? 256 : m_NUM;
+	uint32 callCount = std::min<uint32>(currentNum / writeCount, stream.GetAvailableReadBytes() / readSize);
+	if(callCount == 0) return false;
+
+	const auto vuMemSize = m_vpu.GetVuMemorySize();
+
+	uint32 transfered = codeNum - currentNum;
+	if(config.cl > config.wl)
+	{
+		dstAddr += config.cl * (transfered / config.wl);
+	}
+	else
+	{
+		dstAddr += transfered;
+	}
+	dstAddr *= 0x10;
+	dstAddr &= (vuMemSize - 1);
+
+	CVifUnpackCache::CONTEXT context;
+	memcpy(&context.row, m_R, sizeof(m_R));
+	memcpy(context.col, m_C, sizeof(m_C));
+	context.src = stream.GetDirectPointer();
+	context.vuMem = m_vpu.GetVuMemory();
+
+	auto& function = m_unpackCache.GetFunction(config);
+	config.wrap = true;
+	auto& wrapFunction = m_unpackCache.GetFunction(config);
+
+	for(uint32 i = 0; i < callCount; i++)
+	{
+		context.dstAddr = dstAddr;
+		if((dstAddr + dstSize) > vuMemSize)
+		{
+			wrapFunction(&context);
+		}
+		else
+		{
+			function(&context);
+		}
+		context.src += readSize;
+		dstAddr = (dstAddr + dstSize) & (vuMemSize - 1);
+	}
+
+	memcpy(m_R, &context.row, sizeof(m_R));
+	stream.Skip(callCount * readSize);
+	currentNum -= callCount * writeCount;
+
+	if(currentNum == 0)
+	{
+		//Generic unpacker stops right after the last write, before skipping the end of the cycle
+		if(config.cl > config.wl)
+		{
+			m_readTick = config.wl;
+			m_writeTick = config.wl;
+		}
+		stream.Align32();
+		m_STAT.nVPS = 0;
+		m_NUM = 0;
+		return true;
+	}
+
+	m_NUM = static_cast<uint8>(currentNum);
+	return false;
 }
 
+#endif
+
 uint32 CVif::GetColMaskOp(unsigned int col) const
 {
 	assert(col < 4);
@@ -1051,6 +1192,28 @@ void CVif::CFifoStream::Advance(uint32 size)
 	}
 }
 
+void CVif::CFifoStream::Skip(uint32 size)
+{
+	//Moves the read position forward by any number of bytes, reloading the buffer
+	//if the new position lands in the middle of a qword
+	assert(!m_tagIncluded);
+	assert(size <= GetAvailableReadBytes());
+	uint32 position = m_nextAddress - BUFFERSIZE + m_bufferPosition + size;
+	uint32 bufferPosition = (position - m_startAddress) & (BUFFERSIZE - 1);
+	if(bufferPosition == 0)
+	{
+		m_nextAddress = position;
+		m_bufferPosition = BUFFERSIZE;
+	}
+	else
+	{
+		m_nextAddress = position - bufferPosition + BUFFERSIZE;
+		assert(m_nextAddress <= m_endAddress);
+		m_buffer = *reinterpret_cast<uint128*>(&m_source[m_nextAddress - BUFFERSIZE]);
+		m_bufferPosition = bufferPosition;
+	}
+}
+
 uint128 CVif::CFifoStream::GetBuffer() const
 {
 	return m_buffer;
@@ -10,6 +10,9 @@
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
 #include "SimdDefs.h"
+#ifndef AOT_USE_CACHE
+#include "VifUnpackCache.h"
+#endif
 
 #ifdef FRAMEWORK_SIMD_USE_SSE
 #include <emmintrin.h>
@@ -142,7 +145,9 @@ protected:
 
 		inline uint32 GetAvailableReadBytes() const
 		{
-			return GetRemainingDmaTransferSize() + (BUFFERSIZE - m_bufferPosition);
+			//A pending DMA tag only provides its upper 8 bytes
+			uint32 tagSize = m_tagIncluded ? 8 : 0;
+			return GetRemainingDmaTransferSize() + (BUFFERSIZE - m_bufferPosition) - tagSize;
 		}
 
 		inline uint32 GetRemainingDmaTransferSize() const
@@ -210,6 +215,18 @@ protected:
 
 		uint8* GetDirectPointer() const;
 		void Advance(uint32);
+		void Skip(uint32);
+
+		inline bool IsTagPending() const
+		{
+			return m_tagIncluded;
+		}
+
+		inline bool HasPreviousSourceBytes() const
+		{
+			//Bytes left in the buffer when the source was changed, they can't be reached through GetDirectPointer
+			return (m_bufferPosition != BUFFERSIZE) && (m_nextAddress == m_startAddress);
+		}
 
 		uint128 GetBuffer() const;
 		void SetBuffer(uint128);
@@ -522,7 +539,7 @@ protected:
 	}
 
 	template <uint8 dataType, bool clGreaterEqualWl, bool useMask, uint8 mode, bool usn>
-	void Unpack(StreamType& stream, CODE nCommand, uint32 nDstAddr)
+	void Unpack(StreamType& stream, CODE nCommand, uint32 nDstAddr, uint32 endNum)
 	{
 		assert((nCommand.nCMD & 0x60) == 0x60);
 
@@ -556,10 +573,9 @@ protected:
 		}
 
 		nDstAddr *= 0x10;
-		assert(nDstAddr < vuMemSize);
 		nDstAddr &= (vuMemSize - 1);
 
-		while(currentNum != 0)
+		while(currentNum != endNum)
 		{
 			bool mustWrite = false;
 			uint128 writeValue;
@@ -683,7 +699,12 @@ protected:
 		m_NUM = static_cast<uint8>(currentNum);
 	}
 
-	typedef void (CVif::*Unpacker)(StreamType&, CODE, uint32);
+	typedef void (CVif::*Unpacker)(StreamType&, CODE, uint32, uint32);
+
+	Unpacker GetUnpacker(CODE) const;
+#ifndef AOT_USE_CACHE
+	bool Unpack_Compiled(StreamType&, CODE, uint32, Unpacker);
+#endif
 
 	enum
 	{
@@ -706,6 +727,9 @@ protected:
 	uint8* m_spr = nullptr;
 	CFifoStream m_stream;
 	Unpacker m_unpacker[MAX_UNPACKERS];
+#ifndef AOT_USE_CACHE
+	CVifUnpackCache m_unpackCache;
+#endif
 
 	uint8 m_fifoBuffer[FIFO_SIZE];
 	uint32 m_fifoIndex = 0;
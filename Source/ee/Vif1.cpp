@@ -162,7 +162,8 @@ void CVif1::Cmd_DIRECT(StreamType& stream, CODE nCommand)
 	{
 		//Check if we have data but less than a qword
 		//If we do, we have to go inside a different path to complete a full qword
-		bool hasPartialQword = (m_directQwordBufferIndex != 0) || (nSize < QWORD_SIZE);
+		//A DMA tag still in the stream can't be read through a direct pointer either
+		bool hasPartialQword = (m_directQwordBufferIndex != 0) || (nSize < QWORD_SIZE) || stream.IsTagPending();
 		if(hasPartialQword)
 		{
 			//Read enough bytes to try to complete our qword
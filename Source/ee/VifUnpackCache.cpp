@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <cassert>
+#include "VifUnpackCache.h"
+#include "MemStream.h"
+#include "offsetof_def.h"
+#include "Jitter.h"
+#include "Jitter_CodeGenFactory.h"
+
+//Same values as the VIF's addition modes and mask operations
+enum
+{
+	UNPACK_MODE_OFFSET = 1,
+	UNPACK_MODE_DIFFERENCE = 2,
+};
+
+enum
+{
+	UNPACK_MASK_DATA = 0,
+	UNPACK_MASK_ROW = 1,
+	UNPACK_MASK_COL = 2,
+	UNPACK_MASK_MASK = 3,
+};
+
+CVifUnpackCache::CVifUnpackCache(uint32 vuMemSize)
+    : m_vuMemSize(vuMemSize)
+    , m_jitter(std::make_unique<Jitter::CJitter>(Jitter::CreateCodeGen()))
+{
+	assert((m_vuMemSize & (m_vuMemSize - 1)) == 0);
+}
+
+CVifUnpackCache::~CVifUnpackCache()
+{
+}
+
+bool CVifUnpackCache::IsSupported(const CONFIG& config)
+{
+	//WL = 0 and CL = 0 are odd configurations, leave them to the generic unpackers
+	if(GetElementSize(config.dataType) == 0) return false;
+	if((config.wl == 0) || (config.wl > MAX_CYCLE_WRITES)) return false;
+	if(config.cl == 0) return false;
+	return true;
+}
+
+uint32 CVifUnpackCache::GetWriteCount(const CONFIG& config)
+{
+	return GetCycleCount(config) * config.wl;
+}
+
+uint32 CVifUnpackCache::GetReadSize(const CONFIG& config)
+{
+	return GetCycleCount(config) * std::min(config.cl, config.wl) * GetElementSize(config.dataType);
+}
+
+uint32 CVifUnpackCache::GetDestinationSize(const CONFIG& config)
+{
+	return GetCycleCount(config) * std::max(config.cl, config.wl) * 0x10;
+}
+
+CMemoryFunction& CVifUnpackCache::GetFunction(const CONFIG& config)
+{
+	assert(IsSupported(config));
+	auto key = MakeKey(config);
+	auto functionIterator = m_functions.find(key);
+	if(functionIterator == std::end(m_functions))
+	{
+		functionIterator = m_functions.emplace(key, Compile(config)).first;
+	}
+	return functionIterator->second;
+}
+
+uint64 CVifUnpackCache::MakeKey(const CONFIG& config)
+{
+	uint64 mask = config.useMask ? config.mask : 0;
+	return (mask << 32) |
+	       (static_cast<uint64>(config.cl & 0xFF) << 24) |
+	       (static_cast<uint64>(config.wl & 0xFF) << 16) |
+	       (static_cast<uint64>(config.dataType & 0x0F) << 8) |
+	       ((config.usn ? 1 : 0) << 7) |
+	       ((config.mode & 0x03) << 5) |
+	       ((config.useMask ? 1 : 0) << 4) |
+	       (config.wrap ? 1 : 0);
+}
+
+uint32 CVifUnpackCache::GetElementSize(uint8 dataType)
+{
+	switch(dataType)
+	{
+	case 0x0F:
+		//V4-5
+		return 2;
+	case 0x03:
+	case 0x07:
+	case 0x0B:
+		//Invalid
+		return 0;
+	default:
+	{
+		uint32 fields = ((dataType >> 2) & 0x03) + 1;
+		uint32 fieldSize = 4 >> (dataType & 0x03);
+		return fields * fieldSize;
+	}
+	}
+}
+
+uint32 CVifUnpackCache::GetCycleCount(const CONFIG& config)
+{
+	//Unroll enough cycles to make calls worthwhile when cycles are short
+	assert((config.wl != 0) && (config.wl <= BATCH_WRITES));
+	return BATCH_WRITES / config.wl;
+}
+
+CMemoryFunction CVifUnpackCache::Compile(const CONFIG& config)
+{
+	uint32 cycleCount = GetCycleCount(config);
+	uint32 readsPerCycle = std::min(config.cl, config.wl);
+	uint32 qwordsPerCycle = std::max(config.cl, config.wl);
+	uint32 elementSize = GetElementSize(config.dataType);
+
+	Framework::CMemStream stream;
+	m_jitter->SetStream(&stream);
+	m_jitter->Begin();
+
+	for(uint32 cycle = 0; cycle < cycleCount; cycle++)
+	{
+		for(uint32 writeTick = 0; writeTick < config.wl; writeTick++)
+		{
+			//When CL < WL, the writes past CL in a cycle don't read anything
+			if(writeTick < readsPerCycle)
+			{
+				uint32 srcOffset = ((cycle * readsPerCycle) + writeTick) * elementSize;
+				EmitReadValue(config, srcOffset);
+			}
+			else
+			{
+				EmitClearValue();
+			}
+
+			//When CL > WL, the last CL - WL qwords of a cycle are skipped
+			uint32 dstOffset = ((cycle * qwordsPerCycle) + writeTick) * 0x10;
+			EmitWriteValue(config, writeTick, dstOffset);
+		}
+	}
+
+	m_jitter->End();
+
+	return CMemoryFunction(stream.GetBuffer(), stream.GetSize());
+}
+
+void CVifUnpackCache::EmitReadValue(const CONFIG& config, uint32 srcOffset)
+{
+	auto jitter = m_jitter.get();
+
+	if(config.dataType == 0x0F)
+	{
+		//V4-5
+		jitter->PushRelRef(offsetof(CONTEXT, src));
+		jitter->PushCst(srcOffset);
+		jitter->Load16FromRefIdx(1);
+		jitter->PullRel(offsetof(CONTEXT, scratch));
+
+		for(uint32 i = 0; i < 4; i++)
+		{
+			jitter->PushRel(offsetof(CONTEXT, scratch));
+			if(i != 0)
+			{
+				jitter->Srl(i * 5);
+			}
+			jitter->PushCst((i == 3) ? 0x01 : 0x1F);
+			jitter->And();
+			jitter->Shl((i == 3) ? 7 : 3);
+			jitter->PullRel(offsetof(CONTEXT, value.nV[i]));
+		}
+		return;
+	}
+
+	bool isScalar = (config.dataType & 0x0C) == 0;
+	uint32 fields = ((config.dataType >> 2) & 0x03) + 1;
+	uint32 fieldSize = 4 >> (config.dataType & 0x03);
+
+	for(uint32 i = 0; i < fields; i++)
+	{
+		jitter->PushRelRef(offsetof(CONTEXT, src));
+		jitter->PushCst(srcOffset + (i * fieldSize));
+		switch(fieldSize)
+		{
+		case 4:
+			jitter->LoadFromRefIdx(1);
+			break;
+		case 2:
+			jitter->Load16FromRefIdx(1);
+			if(!config.usn)
+			{
+				jitter->SignExt16();
+			}
+			break;
+		case 1:
+			jitter->Load8FromRefIdx(1);
+			if(!config.usn)
+			{
+				jitter->SignExt8();
+			}
+			break;
+		default:
+			assert(false);
+			break;
+		}
+
+		if(isScalar)
+		{
+			//Scalar formats are replicated in all fields
+			for(uint32 j = 0; j < 3; j++)
+			{
+				jitter->PushTop();
+				jitter->PullRel(offsetof(CONTEXT, value.nV[j]));
+			}
+			jitter->PullRel(offsetof(CONTEXT, value.nV[3]));
+			return;
+		}
+
+		jitter->PullRel(offsetof(CONTEXT, value.nV[i]));
+	}
+
+	//Fields that aren't part of the format are cleared
+	for(uint32 i = fields; i < 4; i++)
+	{
+		jitter->PushCst(0);
+		jitter->PullRel(offsetof(CONTEXT, value.nV[i]));
+	}
+}
+
+void CVifUnpackCache::EmitClearValue()
+{
+	auto jitter = m_jitter.get();
+	for(uint32 i = 0; i < 4; i++)
+	{
+		jitter->PushCst(0);
+		jitter->PullRel(offsetof(CONTEXT, value.nV[i]));
+	}
+}
+
+void CVifUnpackCache::EmitWriteValue(const CONFIG& config, uint32 writeTick, uint32 dstOffset)
+{
+	auto jitter = m_jitter.get();
+
+	uint32 col = std::min<uint32>(writeTick, 3);
+	uint32 colMask = config.useMask ? ((config.mask >> (col * 8)) & 0xFF) : 0;
+
+	if(colMask == 0)
+	{
+		if(config.mode == UNPACK_MODE_DIFFERENCE)
+		{
+			jitter->MD_PushRel(offsetof(CONTEXT, value));
+			jitter->MD_PushRel(offsetof(CONTEXT, row));
+			jitter->MD_AddW();
+			jitter->MD_PullRel(offsetof(CONTEXT, row));
+		}
+
+		jitter->PushRelRef(offsetof(CONTEXT, vuMem));
+		EmitDestinationIndex(config, dstOffset);
+
+		switch(config.mode)
+		{
+		case UNPACK_MODE_OFFSET:
+			jitter->MD_PushRel(offsetof(CONTEXT, value));
+			jitter->MD_PushRel(offsetof(CONTEXT, row));
+			jitter->MD_AddW();
+			break;
+		case UNPACK_MODE_DIFFERENCE:
+			jitter->MD_PushRel(offsetof(CONTEXT, row));
+			break;
+		default:
+			jitter->MD_PushRel(offsetof(CONTEXT, value));
+			break;
+		}
+
+		jitter->MD_StoreAtRefIdx(1);
+		return;
+	}
+
+	for(uint32 i = 0; i < 4; i++)
+	{
+		uint32 maskOp = (colMask >> (i * 2)) & 0x03;
+		if(maskOp == UNPACK_MASK_MASK) continue;
+
+		bool isData = (maskOp == UNPACK_MASK_DATA);
+		if(isData && (config.mode == UNPACK_MODE_DIFFERENCE))
+		{
+			jitter->PushRel(offsetof(CONTEXT, value.nV[i]));
+			jitter->PushRel(offsetof(CONTEXT, row.nV[i]));
+			jitter->Add();
+			jitter->PullRel(offsetof(CONTEXT, row.nV[i]));
+		}
+
+		jitter->PushRelRef(offsetof(CONTEXT, vuMem));
+		EmitDestinationIndex(config, dstOffset + (i * 4));
+
+		if(maskOp == UNPACK_MASK_ROW)
+		{
+			jitter->PushRel(offsetof(CONTEXT, row.nV[i]));
+		}
+		else if(maskOp == UNPACK_MASK_COL)
+		{
+			jitter->PushRel(offsetof(CONTEXT, col[col]));
+		}
+		else if(config.mode == UNPACK_MODE_OFFSET)
+		{
+			jitter->PushRel(offsetof(CONTEXT, value.nV[i]));
+			jitter->PushRel(offsetof(CONTEXT, row.nV[i]));
+			jitter->Add();
+		}
+		else if(config.mode == UNPACK_MODE_DIFFERENCE)
+		{
+			jitter->PushRel(offsetof(CONTEXT, row.nV[i]));
+		}
+		else
+		{
+			jitter->PushRel(offsetof(CONTEXT, value.nV[i]));
+		}
+
+		jitter->StoreAtRefIdx(1);
+	}
+}
+
+void CVifUnpackCache::EmitDestinationIndex(const CONFIG& config, uint32 dstOffset)
+{
+	auto jitter = m_jitter.get();
+	jitter->PushRel(offsetof(CONTEXT, dstAddr));
+	if(dstOffset != 0)
+	{
+		jitter->PushCst(dstOffset);
+		jitter->Add();
+	}
+	if(config.wrap)
+	{
+		jitter->PushCst(m_vuMemSize - 1);
+		jitter->And();
+	}
+}
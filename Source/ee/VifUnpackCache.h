@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include "Types.h"
+#include "MemoryFunction.h"
+#include "../uint128.h"
+
+namespace Jitter
+{
+	class CJitter;
+};
+
+//Compiles UNPACK routines specialized for a format, addition mode, write mask, cycle
+//configuration and destination wrapping. A routine processes a fixed number of complete
+//write cycles from contiguous source data, leaving partial cycles to the generic unpackers.
+class CVifUnpackCache
+{
+public:
+	struct CONFIG
+	{
+		uint8 dataType = 0;
+		bool usn = false;
+		uint8 mode = 0;
+		bool useMask = false;
+		uint32 mask = 0;
+		uint32 cl = 0;
+		uint32 wl = 0;
+		bool wrap = false;
+	};
+
+	struct CONTEXT
+	{
+		alignas(16) uint128 row;
+		alignas(16) uint128 value;
+		uint32 col[4];
+		uint32 dstAddr;
+		uint32 scratch;
+		uint8* src;
+		uint8* vuMem;
+	};
+
+	CVifUnpackCache(uint32);
+	virtual ~CVifUnpackCache();
+
+	static bool IsSupported(const CONFIG&);
+
+	static uint32 GetWriteCount(const CONFIG&);
+	static uint32 GetReadSize(const CONFIG&);
+	static uint32 GetDestinationSize(const CONFIG&);
+
+	CMemoryFunction& GetFunction(const CONFIG&);
+
+private:
+	enum
+	{
+		MAX_CYCLE_WRITES = 16,
+		BATCH_WRITES = 16,
+	};
+
+	typedef std::unordered_map<uint64, CMemoryFunction> FunctionMap;
+
+	static uint64 MakeKey(const CONFIG&);
+	static uint32 GetElementSize(uint8);
+	static uint32 GetCycleCount(const CONFIG&);
+
+	CMemoryFunction Compile(const CONFIG&);
+	void EmitReadValue(const CONFIG&, uint32);
+	void EmitClearValue();
+	void EmitWriteValue(const CONFIG&, uint32, uint32);
+	void EmitDestinationIndex(const CONFIG&, uint32);
+
+	uint32 m_vuMemSize = 0;
+	std::unique_ptr<Jitter::CJitter> m_jitter;
+	FunctionMap m_functions;
+};
@@ -307,17 +307,7 @@ void CGSH_OpenGL::TexUpdater_Invalid(uint32 bufPtr, uint32 bufWidth, unsigned in
 void CGSH_OpenGL::TexUpdater_Psm32(uint32 bufPtr, uint32 bufWidth, unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight)
 {
 	CGsPixelFormats::CPixelIndexorPSMCT32 indexor(m_pRAM, bufPtr, bufWidth);
-
-	uint32* dst = reinterpret_cast<uint32*>(m_pCvtBuffer);
-	for(unsigned int y = 0; y < texHeight; y++)
-	{
-		for(unsigned int x = 0; x < texWidth; x++)
-		{
-			dst[x] = indexor.GetPixel(texX + x, texY + y);
-		}
-
-		dst += texWidth;
-	}
+	indexor.ReadRect(reinterpret_cast<uint32*>(m_pCvtBuffer), texWidth, texX, texY, texWidth, texHeight);
 
 	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RGBA, GL_UNSIGNED_BYTE, m_pCvtBuffer);
 	CHECKGLERROR();
@@ -329,20 +319,16 @@ void CGSH_OpenGL::TexUpdater_Psm16(uint32 bufPtr, uint32 bufWidth, unsigned int
 	IndexorType indexor(m_pRAM, bufPtr, bufWidth);
 
 	auto dst = reinterpret_cast<uint16*>(m_pCvtBuffer);
-	for(unsigned int y = 0; y < texHeight; y++)
-	{
-		for(unsigned int x = 0; x < texWidth; x++)
-		{
-			auto pixel = indexor.GetPixel(texX + x, texY + y);
-			auto cvtPixel =
-			    (((pixel & 0x001F) >> 0) << 11) | //R
-			    (((pixel & 0x03E0) >> 5) << 6) |  //G
-			    (((pixel & 0x7C00) >> 10) << 1) | //B
-			    (pixel >> 15);                    //A
-			dst[x] = cvtPixel;
-		}
-
-		dst += texWidth;
+	indexor.ReadRect(dst, texWidth, texX, texY, texWidth, texHeight);
+	for(unsigned int i = 0; i < (texWidth * texHeight); i++)
+	{
+		auto pixel = dst[i];
+		auto cvtPixel =
+		    (((pixel & 0x001F) >> 0) << 11) | //R
+		    (((pixel & 0x03E0) >> 5) << 6) |  //G
+		    (((pixel & 0x7C00) >> 10) << 1) | //B
+		    (pixel >> 15);                    //A
+		dst[i] = cvtPixel;
 	}
 
 	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, m_pCvtBuffer);
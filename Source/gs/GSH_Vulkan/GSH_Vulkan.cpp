@@ -146,6 +146,7 @@ void CGSH_Vulkan::InitializeImpl()
 	CreateDevice(m_context->physicalDevice);
 	m_context->device.vkGetDeviceQueue(m_context->device, renderQueueFamily, 0, &m_context->queue);
 	m_context->commandBufferPool = Framework::Vulkan::CCommandBufferPool(m_context->device, renderQueueFamily);
+	m_submitQueue = std::make_shared<CSubmitQueue>(m_context);
 
 	CreateDescriptorPool();
 	CreateMemoryBuffer();
@@ -187,7 +188,7 @@ void CGSH_Vulkan::InitializeImpl()
 	m_context->annotations.SetImageViewName(m_context->swizzleTablePSMZ16View, "Swizzle Table View PSMZ16");
 	m_context->annotations.SetImageViewName(m_context->swizzleTablePSMZ16SView, "Swizzle Table View PSMZ16S");
 
-	m_frameCommandBuffer = std::make_shared<CFrameCommandBuffer>(m_context);
+	m_frameCommandBuffer = std::make_shared<CFrameCommandBuffer>(m_context, m_submitQueue);
 	m_clutLoad = std::make_shared<CClutLoad>(m_context, m_frameCommandBuffer);
 #if GSH_VULKAN_IS_DESKTOP
 	m_draw = std::make_shared<CDrawDesktop>(m_context, m_frameCommandBuffer);
@@ -198,7 +199,7 @@ void CGSH_Vulkan::InitializeImpl()
 #endif
 	if(m_context->surface)
 	{
-		m_present = std::make_shared<CPresent>(m_context);
+		m_present = std::make_shared<CPresent>(m_context, m_submitQueue);
 	}
 	m_transferHost = std::make_shared<CTransferHost>(m_context, m_frameCommandBuffer);
 	m_transferLocal = std::make_shared<CTransferLocal>(m_context, m_frameCommandBuffer);
@@ -213,7 +214,7 @@ void CGSH_Vulkan::ReleaseImpl()
 	ResetImpl();
 
 	//Flush any pending rendering commands
-	m_context->device.vkQueueWaitIdle(m_context->queue);
+	m_submitQueue->WaitIdle();
 
 	m_clutLoad.reset();
 	m_draw.reset();
@@ -221,6 +222,7 @@ void CGSH_Vulkan::ReleaseImpl()
 	m_transferHost.reset();
 	m_transferLocal.reset();
 	m_frameCommandBuffer.reset();
+	m_submitQueue.reset();
 
 	m_context->device.vkDestroyImageView(m_context->device, m_context->swizzleTablePSMCT32View, nullptr);
 	m_context->device.vkDestroyImageView(m_context->device, m_context->swizzleTablePSMCT16View, nullptr);
@@ -259,6 +261,7 @@ void CGSH_Vulkan::ResetImpl()
 	m_pendingPrim = false;
 	m_pendingPrimValue = 0;
 	m_regState.isValid = false;
+	m_transferHazardState.isValid = false;
 	memset(&m_clutStates, 0, sizeof(m_clutStates));
 	memset(m_memoryCache, 0, RAMSIZE);
 	WriteBackMemoryCache();
@@ -729,6 +732,14 @@ static std::pair<uint32, uint32> GetMipLevelInfo(uint32 level, const CGSHandler:
 	}
 }
 
+static uint32 GetPsmAreaSize(uint32 psm, uint32 bufWidth, uint32 height)
+{
+	auto pageSize = CGsPixelFormats::GetPsmPageSize(psm);
+	uint32 pageCountX = (std::max<uint32>(bufWidth, 1) + pageSize.first - 1) / pageSize.first;
+	uint32 pageCountY = (height + pageSize.second - 1) / pageSize.second;
+	return pageCountX * pageCountY * CGsPixelFormats::PAGESIZE;
+}
+
 void CGSH_Vulkan::SetRenderingContext(uint64 primReg)
 {
 	auto prim = make_convertible<PRMODE>(primReg);
@@ -958,6 +969,12 @@ void CGSH_Vulkan::SetRenderingContext(uint64 primReg)
 	}
 	pipelineCaps.textureUseMemoryCopy = needsTextureCopy;
 
+	if(m_transferHost->HasPendingTransfers())
+	{
+		CheckPendingTransferHazards(prim, frame, zbuf, tex0, scissor, test, texBufPtr, texBufWidth,
+		                            pipelineCaps.textureUseDynamicMipLOD || (texMipLevel != 0));
+	}
+
 	m_draw->SetPipelineCaps(pipelineCaps);
 	m_draw->SetFramebufferParams(frame.GetBasePtr(), frame.GetWidth(), fbWriteMask);
 	m_draw->SetDepthbufferParams(zbuf.GetBasePtr(), frame.GetWidth());
@@ -1403,16 +1420,84 @@ void CGSH_Vulkan::WriteRegisterImpl(uint8 registerId, uint64 data)
 	}
 }
 
+void CGSH_Vulkan::CheckPendingTransferHazards(const PRMODE& prim, const FRAME& frame, const ZBUF& zbuf, const TEX0& tex0,
+                                              const SCISSOR& scissor, const TEST& test, uint32 texBufPtr, uint32 texBufWidth, bool texUsesMips)
+{
+	//Primitives usually come in long runs with the same context, don't go through
+	//the pending page mask again if nothing changed since the last check
+	uint32 pendingSerial = m_transferHost->GetPendingSerial();
+	if(
+	    m_transferHazardState.isValid &&
+	    (m_transferHazardState.pendingSerial == pendingSerial) &&
+	    (m_transferHazardState.prim == prim) &&
+	    (m_transferHazardState.frame == frame) &&
+	    (m_transferHazardState.zbuf == zbuf) &&
+	    (m_transferHazardState.tex0 == tex0) &&
+	    (m_transferHazardState.scissor == scissor) &&
+	    (m_transferHazardState.test == test) &&
+	    (m_transferHazardState.texBufPtr == texBufPtr) &&
+	    (m_transferHazardState.texBufWidth == texBufWidth) &&
+	    !texUsesMips)
+	{
+		return;
+	}
+
+	bool hazard = false;
+	{
+		uint32 frameHeight = scissor.scay1 + 1;
+		hazard |= m_transferHost->IsRangePending(frame.GetBasePtr(), GetPsmAreaSize(frame.nPsm, frame.GetWidth(), frameHeight));
+		if(test.nDepthEnabled)
+		{
+			hazard |= m_transferHost->IsRangePending(zbuf.GetBasePtr(), GetPsmAreaSize(zbuf.nPsm | 0x30, frame.GetWidth(), frameHeight));
+		}
+	}
+	if(prim.nTexture)
+	{
+		//Mip levels can be anywhere in memory, just be conservative
+		hazard |= texUsesMips;
+		uint32 texAreaWidth = std::max<uint32>(texBufWidth, tex0.GetWidth());
+		hazard |= m_transferHost->IsRangePending(texBufPtr, GetPsmAreaSize(tex0.nPsm, texAreaWidth, tex0.GetHeight()));
+	}
+
+	if(hazard)
+	{
+		FlushPendingHostToLocalTransfers();
+		m_transferHazardState.isValid = false;
+		return;
+	}
+
+	m_transferHazardState.isValid = true;
+	m_transferHazardState.pendingSerial = pendingSerial;
+	m_transferHazardState.prim = prim;
+	m_transferHazardState.frame = frame;
+	m_transferHazardState.zbuf = zbuf;
+	m_transferHazardState.tex0 = tex0;
+	m_transferHazardState.scissor = scissor;
+	m_transferHazardState.test = test;
+	m_transferHazardState.texBufPtr = texBufPtr;
+	m_transferHazardState.texBufWidth = texBufWidth;
+}
+
+void CGSH_Vulkan::FlushPendingHostToLocalTransfers()
+{
+	if(!m_transferHost->HasPendingTransfers()) return;
+	m_draw->FlushRenderPass();
+	m_transferHost->FlushTransfers();
+}
+
 void CGSH_Vulkan::ProcessHostToLocalTransfer()
 {
 	//Flush previous cached info
 	memset(&m_clutStates, 0, sizeof(m_clutStates));
-	m_draw->FlushRenderPass();
 
 	auto bltBuf = make_convertible<BITBLTBUF>(m_nReg[GS_REG_BITBLTBUF]);
 	auto trxReg = make_convertible<TRXREG>(m_nReg[GS_REG_TRXREG]);
 	auto trxPos = make_convertible<TRXPOS>(m_nReg[GS_REG_TRXPOS]);
 
+	//Transfers are accumulated and executed together, previous draws are ordered
+	//before the batch since the render pass is always closed before executing it.
+	//Draws, CLUT loads and transfers touching pending areas flush the batch.
+
 	m_transferHost->Params.bufAddress = bltBuf.GetDstPtr();
 	m_transferHost->Params.bufWidth = bltBuf.GetDstWidth();
 	m_transferHost->Params.rrw = trxReg.nRRW;
@@ -1422,8 +1507,16 @@ void CGSH_Vulkan::ProcessHostToLocalTransfer()
 	auto pipelineCaps = make_convertible<CTransferHost::PIPELINE_CAPS>(0);
 	pipelineCaps.dstFormat = bltBuf.nDstPsm;
 
+	auto [transferAddress, transferSize] = GsTransfer::GetDstRange(bltBuf, trxReg, trxPos);
+
 	m_transferHost->SetPipelineCaps(pipelineCaps);
-	m_transferHost->DoTransfer(m_xferBuffer);
+	//Transfers within a batch run concurrently, overlapping ones need to execute in order
+	if(!m_transferHost->CanBatchTransfer(m_xferBuffer) || m_transferHost->IsRangePending(transferAddress, transferSize))
+	{
+		FlushPendingHostToLocalTransfers();
+	}
+
+	m_transferHost->DoTransfer(m_xferBuffer, transferAddress, transferSize);
 
 	m_xferBuffer.clear();
 }
@@ -1433,6 +1526,7 @@ void CGSH_Vulkan::ProcessLocalToHostTransfer()
 	bool readsEnabled = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_CGSHANDLER_GS_RAM_READS_ENABLED);
 	if(readsEnabled)
 	{
+		FlushPendingHostToLocalTransfers();
 		m_draw->FlushRenderPass();
 
 		auto bltBuf = make_convertible<BITBLTBUF>(m_nReg[GS_REG_BITBLTBUF]);
@@ -1482,7 +1576,7 @@ void CGSH_Vulkan::ProcessLocalToHostTransfer()
 		if(!transfer->second.IsRecurring())
 		{
 			m_frameCommandBuffer->Flush();
-			m_context->device.vkQueueWaitIdle(m_context->queue);
+			m_submitQueue->WaitIdle();
 		}
 
 		void* bufferPtr = nullptr;
@@ -1499,6 +1593,7 @@ void CGSH_Vulkan::ProcessLocalToLocalTransfer()
 {
 	//Flush previous cached info
 	memset(&m_clutStates, 0, sizeof(m_clutStates));
+	FlushPendingHostToLocalTransfers();
 	m_draw->FlushRenderPass();
 
 	auto bltBuf = make_convertible<BITBLTBUF>(m_nReg[GS_REG_BITBLTBUF]);
@@ -1564,7 +1659,7 @@ void CGSH_Vulkan::TransferWrite(const uint8* imageData, uint32 length)
 void CGSH_Vulkan::WriteBackMemoryCache()
 {
 	m_frameCommandBuffer->Flush();
-	m_context->device.vkQueueWaitIdle(m_context->queue);
+	m_submitQueue->WaitIdle();
 
 	m_context->memoryBuffer.Write(m_context->queue, m_context->commandBufferPool,
 	                              m_context->physicalDeviceMemoryProperties, m_memoryCache);
@@ -1573,7 +1668,7 @@ void CGSH_Vulkan::WriteBackMemoryCache()
 void CGSH_Vulkan::SyncMemoryCache()
 {
 	m_frameCommandBuffer->Flush();
-	m_context->device.vkQueueWaitIdle(m_context->queue);
+	m_submitQueue->WaitIdle();
 
 	m_context->memoryBuffer.Read(m_context->queue, m_context->commandBufferPool,
 	                             m_context->physicalDeviceMemoryProperties, m_memoryCache);
@@ -1594,6 +1689,11 @@ void CGSH_Vulkan::SyncCLUT(const TEX0& tex0)
 		m_nextClutCacheIndex %= CLUT_CACHE_SIZE;
 		m_clutStates[clutCacheIndex] = clutKey;
 
+		if(m_transferHost->IsRangePending(tex0.GetCLUTPtr(), CGsPixelFormats::PAGESIZE))
+		{
+			FlushPendingHostToLocalTransfers();
+		}
+
 		m_draw->FlushRenderPass();
 		uint32 clutBufferOffset = sizeof(uint32) * CLUTENTRYCOUNT * clutCacheIndex;
 		m_clutLoad->DoClutLoad(clutBufferOffset, tex0, texClut);
@@ -98,6 +98,20 @@ private:
 		uint64 miptbp2 = 0;
 	};
 
+	struct TRANSFER_HAZARD_STATE
+	{
+		bool isValid = false;
+		uint32 pendingSerial = 0;
+		uint64 prim = 0;
+		uint64 frame = 0;
+		uint64 zbuf = 0;
+		uint64 tex0 = 0;
+		uint64 scissor = 0;
+		uint64 test = 0;
+		uint32 texBufPtr = 0;
+		uint32 texBufWidth = 0;
+	};
+
 	struct LOCAL_TO_HOST_XFER_HISTORY
 	{
 		static constexpr int MAX_FRAME_COUNT = 16;
@@ -152,6 +166,8 @@ private:
 	void ProcessPrim(uint64);
 	void VertexKick(uint8, uint64);
 	void SetRenderingContext(uint64);
+	void CheckPendingTransferHazards(const PRMODE&, const FRAME&, const ZBUF&, const TEX0&, const SCISSOR&, const TEST&, uint32, uint32, bool);
+	void FlushPendingHostToLocalTransfers();
 
 	void Prim_Point();
 	void Prim_Line();
@@ -172,18 +188,15 @@ private:
 		auto bitmap = Framework::CBitmap(width, height, 32);
 		auto bitmapPixels = reinterpret_cast<uint32*>(bitmap.GetPixels());
 		PixelIndexor indexor(ram, bufferPtr, bufferWidth);
-		for(unsigned int y = 0; y < height; y++)
+		indexor.ReadRect(bitmapPixels, width, 0, 0, width, height);
+		for(unsigned int i = 0; i < (width * height); i++)
 		{
-			for(unsigned int x = 0; x < width; x++)
-			{
-				uint32 pixel = indexor.GetPixel(x, y) & mask;
-				uint32 r = (pixel & 0x000000FF) >> 0;
-				uint32 g = (pixel & 0x0000FF00) >> 8;
-				uint32 b = (pixel & 0x00FF0000) >> 16;
-				uint32 a = (pixel & 0xFF000000) >> 24;
-				(*bitmapPixels) = b | (g << 8) | (r << 16) | (a << 24);
-				bitmapPixels++;
-			}
+			uint32 pixel = bitmapPixels[i] & mask;
+			uint32 r = (pixel & 0x000000FF) >> 0;
+			uint32 g = (pixel & 0x0000FF00) >> 8;
+			uint32 b = (pixel & 0x00FF0000) >> 16;
+			uint32 a = (pixel & 0xFF000000) >> 24;
+			bitmapPixels[i] = b | (g << 8) | (r << 16) | (a << 24);
 		}
 		return bitmap;
 	}
@@ -193,19 +206,17 @@ private:
 	{
 		auto bitmap = Framework::CBitmap(width, height, 32);
 		auto bitmapPixels = reinterpret_cast<uint32*>(bitmap.GetPixels());
+		auto pixels = std::vector<uint16>(width * height);
 		PixelIndexor indexor(ram, bufferPtr, bufferWidth);
-		for(unsigned int y = 0; y < height; y++)
+		indexor.ReadRect(pixels.data(), width, 0, 0, width, height);
+		for(unsigned int i = 0; i < (width * height); i++)
 		{
-			for(unsigned int x = 0; x < width; x++)
-			{
-				uint16 pixel = indexor.GetPixel(x, y);
-				uint32 r = ((pixel & 0x001F) >> 0) << 3;
-				uint32 g = ((pixel & 0x03E0) >> 5) << 3;
-				uint32 b = ((pixel & 0x7C00) >> 10) << 3;
-				uint32 a = (((pixel & 0x8000) >> 15) != 0) ? 0xFF : 0;
-				(*bitmapPixels) = b | (g << 8) | (r << 16) | (a << 24);
-				bitmapPixels++;
-			}
+			uint16 pixel = pixels[i];
+			uint32 r = ((pixel & 0x001F) >> 0) << 3;
+			uint32 g = ((pixel & 0x03E0) >> 5) << 3;
+			uint32 b = ((pixel & 0x7C00) >> 10) << 3;
+			uint32 a = (((pixel & 0x8000) >> 15) != 0) ? 0xFF : 0;
+			bitmapPixels[i] = b | (g << 8) | (r << 16) | (a << 24);
 		}
 		return bitmap;
 	}
@@ -216,18 +227,11 @@ private:
 		auto bitmap = Framework::CBitmap(width, height, 8);
 		auto bitmapPixels = reinterpret_cast<uint8*>(bitmap.GetPixels());
 		PixelIndexor indexor(ram, bufferPtr, bufferWidth);
-		for(unsigned int y = 0; y < height; y++)
-		{
-			for(unsigned int x = 0; x < width; x++)
-			{
-				uint8 pixel = indexor.GetPixel(x, y);
-				(*bitmapPixels) = pixel;
-				bitmapPixels++;
-			}
-		}
+		indexor.ReadRect(bitmapPixels, width, 0, 0, width, height);
 		return bitmap;
 	}
 
+	GSH_Vulkan::SubmitQueuePtr m_submitQueue;
 	GSH_Vulkan::FrameCommandBufferPtr m_frameCommandBuffer;
 	GSH_Vulkan::ClutLoadPtr m_clutLoad;
 	GSH_Vulkan::DrawPtr m_draw;
@@ -245,6 +249,7 @@ private:
 	uint32 m_primitiveType = 0;
 	PRMODE m_primitiveMode;
 	REG_STATE m_regState;
+	TRANSFER_HAZARD_STATE m_transferHazardState;
 	uint32 m_fbBasePtr = 0;
 	float m_primOfsX = 0;
 	float m_primOfsY = 0;
@@ -3,8 +3,9 @@
 
 using namespace GSH_Vulkan;
 
-CFrameCommandBuffer::CFrameCommandBuffer(const ContextPtr& context)
+CFrameCommandBuffer::CFrameCommandBuffer(const ContextPtr& context, const SubmitQueuePtr& submitQueue)
     : m_context(context)
+    , m_submitQueue(submitQueue)
 {
 	auto result = VK_SUCCESS;
 
@@ -68,14 +69,9 @@ void CFrameCommandBuffer::EndFrame()
 	result = m_context->device.vkEndCommandBuffer(frame.commandBuffer);
 	CHECKVULKANERROR(result);
 
-	//Submit command buffer
-	{
-		auto submitInfo = Framework::Vulkan::SubmitInfo();
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &frame.commandBuffer;
-		result = m_context->device.vkQueueSubmit(m_context->queue, 1, &submitInfo, frame.execCompleteFence);
-		CHECKVULKANERROR(result);
-	}
+	//Submission happens on the submit thread, BeginFrame will wait for the fence
+	//before this command buffer gets reused
+	m_submitQueue->Submit(frame.commandBuffer, frame.execCompleteFence);
 
 	for(const auto& writer : m_writers)
 	{
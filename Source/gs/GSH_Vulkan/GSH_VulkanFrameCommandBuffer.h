@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GSH_VulkanContext.h"
+#include "GSH_VulkanSubmitQueue.h"
 
 namespace GSH_Vulkan
 {
@@ -20,7 +21,7 @@ namespace GSH_Vulkan
 			MAX_FRAMES = 3,
 		};
 
-		CFrameCommandBuffer(const ContextPtr&);
+		CFrameCommandBuffer(const ContextPtr&, const SubmitQueuePtr&);
 		~CFrameCommandBuffer();
 
 		void RegisterWriter(IFrameCommandBufferWriter*);
@@ -43,6 +44,7 @@ namespace GSH_Vulkan
 		};
 
 		ContextPtr m_context;
+		SubmitQueuePtr m_submitQueue;
 
 		std::vector<IFrameCommandBufferWriter*> m_writers;
 
@@ -23,8 +23,9 @@ const CPresent::PRESENT_VERTEX CPresent::g_vertexBufferContents[4] =
 };
 // clang-format on
 
-CPresent::CPresent(const ContextPtr& context)
+CPresent::CPresent(const ContextPtr& context, const SubmitQueuePtr& submitQueue)
     : m_context(context)
+    , m_submitQueue(submitQueue)
     , m_pipelineCache(context->device)
 {
 	CreateRenderPass();
@@ -38,7 +39,9 @@ CPresent::~CPresent()
 	DestroySwapChain();
 	for(const auto& presentCommandBuffer : m_presentCommandBuffers)
 	{
-		m_context->device.vkDestroyFence(m_context->device, presentCommandBuffer.execCompleteFence, nullptr);
+		m_context->device.vkDestroyFence(m_context->device, presentCommandBuffer->execCompleteFence, nullptr);
+		m_context->device.vkDestroySemaphore(m_context->device, presentCommandBuffer->imageAcquireSemaphore, nullptr);
+		m_context->device.vkDestroySemaphore(m_context->device, presentCommandBuffer->renderCompleteSemaphore, nullptr);
 	}
 	m_context->device.vkDestroyRenderPass(m_context->device, m_renderPass, nullptr);
 }
@@ -59,9 +62,22 @@ void CPresent::DoPresent(const CGSHandler::DISPLAY_INFO& dispInfo)
 {
 	auto result = VK_SUCCESS;
 
+	//Swap chain can't be used by image acquisition and presentation at the same time. The previous
+	//frame's present was queued a whole frame ago, the submit queue is usually done with it.
+	if(IsPresentPending())
+	{
+		m_submitQueue->Execute([]() {});
+	}
+
+	//Previous present was performed asynchronously, it's only now that we can act on its outcome
+	if(m_swapChainOutOfDate.exchange(false))
+	{
+		m_swapChainValid = false;
+	}
+
 	if(!m_swapChainValid && (m_swapChain != VK_NULL_HANDLE))
 	{
-		m_context->device.vkQueueWaitIdle(m_context->queue);
+		m_submitQueue->WaitIdle();
 		DestroySwapChain();
 	}
 
@@ -74,46 +90,33 @@ void CPresent::DoPresent(const CGSHandler::DISPLAY_INFO& dispInfo)
 		assert(m_swapChainValid);
 	}
 
+	auto presentCommandBuffer = PrepareCommandBuffer();
+
 	uint32_t imageIndex = 0;
-	result = m_context->device.vkAcquireNextImageKHR(m_context->device, m_swapChain, UINT64_MAX, m_imageAcquireSemaphore, VK_NULL_HANDLE, &imageIndex);
+	result = m_context->device.vkAcquireNextImageKHR(m_context->device, m_swapChain, UINT64_MAX, presentCommandBuffer->imageAcquireSemaphore, VK_NULL_HANDLE, &imageIndex);
 	if((result == VK_ERROR_OUT_OF_DATE_KHR) || (result == VK_ERROR_SURFACE_LOST_KHR))
 	{
-		m_context->device.vkQueueWaitIdle(m_context->queue);
+		m_submitQueue->WaitIdle();
 		DestroySwapChain();
 		return;
 	}
 	if(result != VK_SUBOPTIMAL_KHR) CHECKVULKANERROR(result);
 
-	UpdateBackbuffer(imageIndex, dispInfo);
-
-	//Queue present
-	{
-		auto presentInfo = Framework::Vulkan::PresentInfoKHR();
-		presentInfo.swapchainCount = 1;
-		presentInfo.pSwapchains = &m_swapChain;
-		presentInfo.pImageIndices = &imageIndex;
-		presentInfo.waitSemaphoreCount = 1;
-		presentInfo.pWaitSemaphores = &m_renderCompleteSemaphore;
-		result = m_context->device.vkQueuePresentKHR(m_context->queue, &presentInfo);
-		if(result == VK_ERROR_OUT_OF_DATE_KHR)
-		{
-			m_context->device.vkQueueWaitIdle(m_context->queue);
-			DestroySwapChain();
-			return;
-		}
-		if(result != VK_SUBOPTIMAL_KHR) CHECKVULKANERROR(result);
-	}
+	UpdateBackbuffer(presentCommandBuffer, imageIndex, dispInfo);
+	QueuePresent(presentCommandBuffer, imageIndex);
 }
 
-void CPresent::UpdateBackbuffer(uint32 imageIndex, const CGSHandler::DISPLAY_INFO& dispInfo)
+void CPresent::UpdateBackbuffer(PRESENT_COMMANDBUFFER* presentCommandBuffer, uint32 imageIndex, const CGSHandler::DISPLAY_INFO& dispInfo)
 {
 	auto result = VK_SUCCESS;
 
 	auto swapChainImage = m_swapChainImages[imageIndex];
 	auto framebuffer = m_swapChainFramebuffers[imageIndex];
 
-	auto frameCommandBuffer = PrepareCommandBuffer();
-	auto commandBuffer = frameCommandBuffer.commandBuffer;
+	auto commandBuffer = presentCommandBuffer->commandBuffer;
+
+	result = m_context->device.vkResetCommandBuffer(commandBuffer, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
+	CHECKVULKANERROR(result);
 
 	auto commandBufferBeginInfo = Framework::Vulkan::CommandBufferBeginInfo();
 	commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
@@ -238,54 +241,100 @@ void CPresent::UpdateBackbuffer(uint32 imageIndex, const CGSHandler::DISPLAY_INF
 	m_context->annotations.PopCommandLabel(commandBuffer);
 
 	m_context->device.vkEndCommandBuffer(commandBuffer);
+}
+
+void CPresent::QueuePresent(PRESENT_COMMANDBUFFER* presentCommandBuffer, uint32 imageIndex)
+{
+	auto result = m_context->device.vkResetFences(m_context->device, 1, &presentCommandBuffer->execCompleteFence);
+	CHECKVULKANERROR(result);
+
+	//Swap chain is only destroyed after waiting for the submit queue to be idle
+	presentCommandBuffer->presentPending = true;
+	m_submitQueue->Post(
+	    [this, presentCommandBuffer, imageIndex, swapChain = m_swapChain]() {
+		    {
+			    VkPipelineStageFlags pipelineStageFlags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			    auto submitInfo = Framework::Vulkan::SubmitInfo();
+			    submitInfo.waitSemaphoreCount = 1;
+			    submitInfo.pWaitSemaphores = &presentCommandBuffer->imageAcquireSemaphore;
+			    submitInfo.pWaitDstStageMask = &pipelineStageFlags;
+			    submitInfo.commandBufferCount = 1;
+			    submitInfo.pCommandBuffers = &presentCommandBuffer->commandBuffer;
+			    submitInfo.signalSemaphoreCount = 1;
+			    submitInfo.pSignalSemaphores = &presentCommandBuffer->renderCompleteSemaphore;
+			    auto result = m_context->device.vkQueueSubmit(m_context->queue, 1, &submitInfo, presentCommandBuffer->execCompleteFence);
+			    if(result != VK_SUCCESS)
+			    {
+				    presentCommandBuffer->presentPending = false;
+				    CHECKVULKANERROR(result);
+			    }
+		    }
+
+		    {
+			    auto presentInfo = Framework::Vulkan::PresentInfoKHR();
+			    presentInfo.swapchainCount = 1;
+			    presentInfo.pSwapchains = &swapChain;
+			    presentInfo.pImageIndices = &imageIndex;
+			    presentInfo.waitSemaphoreCount = 1;
+			    presentInfo.pWaitSemaphores = &presentCommandBuffer->renderCompleteSemaphore;
+			    auto result = m_context->device.vkQueuePresentKHR(m_context->queue, &presentInfo);
+			    presentCommandBuffer->presentPending = false;
+			    if(result == VK_ERROR_OUT_OF_DATE_KHR)
+			    {
+				    m_swapChainOutOfDate = true;
+				    return;
+			    }
+			    if(result != VK_SUBOPTIMAL_KHR) CHECKVULKANERROR(result);
+		    }
+	    });
+}
 
-	//Submit command buffer
+bool CPresent::IsPresentPending() const
+{
+	for(const auto& presentCommandBuffer : m_presentCommandBuffers)
 	{
-		VkPipelineStageFlags pipelineStageFlags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		auto submitInfo = Framework::Vulkan::SubmitInfo();
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = &m_imageAcquireSemaphore;
-		submitInfo.pWaitDstStageMask = &pipelineStageFlags;
-		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &commandBuffer;
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = &m_renderCompleteSemaphore;
-		result = m_context->device.vkQueueSubmit(m_context->queue, 1, &submitInfo, frameCommandBuffer.execCompleteFence);
-		CHECKVULKANERROR(result);
+		if(presentCommandBuffer->presentPending) return true;
 	}
+	return false;
 }
 
-CPresent::PRESENT_COMMANDBUFFER CPresent::PrepareCommandBuffer()
+CPresent::PRESENT_COMMANDBUFFER* CPresent::PrepareCommandBuffer()
 {
 	auto result = VK_SUCCESS;
 
-	//Find an available command buffer
+	//Find an available command buffer, fences are created signaled and only reset when submitting
 	for(const auto& presentCommandBuffer : m_presentCommandBuffers)
 	{
-		result = m_context->device.vkGetFenceStatus(m_context->device, presentCommandBuffer.execCompleteFence);
+		if(presentCommandBuffer->presentPending) continue;
+		result = m_context->device.vkGetFenceStatus(m_context->device, presentCommandBuffer->execCompleteFence);
 		if(result == VK_SUCCESS)
 		{
-			result = m_context->device.vkResetFences(m_context->device, 1, &presentCommandBuffer.execCompleteFence);
-			CHECKVULKANERROR(result);
-
-			result = m_context->device.vkResetCommandBuffer(presentCommandBuffer.commandBuffer, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
-			CHECKVULKANERROR(result);
-
-			return presentCommandBuffer;
+			return presentCommandBuffer.get();
 		}
 	}
 
-	auto presentCommandBuffer = PRESENT_COMMANDBUFFER();
-	presentCommandBuffer.commandBuffer = m_context->commandBufferPool.AllocateBuffer();
+	auto presentCommandBuffer = std::make_unique<PRESENT_COMMANDBUFFER>();
+	presentCommandBuffer->commandBuffer = m_context->commandBufferPool.AllocateBuffer();
 
 	{
 		auto fenceCreateInfo = Framework::Vulkan::FenceCreateInfo();
-		result = m_context->device.vkCreateFence(m_context->device, &fenceCreateInfo, nullptr, &presentCommandBuffer.execCompleteFence);
+		fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+		result = m_context->device.vkCreateFence(m_context->device, &fenceCreateInfo, nullptr, &presentCommandBuffer->execCompleteFence);
+		CHECKVULKANERROR(result);
+	}
+
+	//Used to prevent submit from rendering before getting the image and present from happening before rendering is done
+	{
+		auto semaphoreCreateInfo = Framework::Vulkan::SemaphoreCreateInfo();
+		result = m_context->device.vkCreateSemaphore(m_context->device, &semaphoreCreateInfo, nullptr, &presentCommandBuffer->imageAcquireSemaphore);
+		CHECKVULKANERROR(result);
+		result = m_context->device.vkCreateSemaphore(m_context->device, &semaphoreCreateInfo, nullptr, &presentCommandBuffer->renderCompleteSemaphore);
 		CHECKVULKANERROR(result);
 	}
 
-	m_presentCommandBuffers.push_back(presentCommandBuffer);
-	return presentCommandBuffer;
+	auto presentCommandBufferPtr = presentCommandBuffer.get();
+	m_presentCommandBuffers.push_back(std::move(presentCommandBuffer));
+	return presentCommandBufferPtr;
 }
 
 VkDescriptorSet CPresent::PrepareDescriptorSet(VkDescriptorSetLayout descriptorSetLayout, uint32 bufPsm)
@@ -355,8 +404,6 @@ void CPresent::CreateSwapChain()
 	assert(!m_context->device.IsEmpty());
 	assert(m_swapChain == VK_NULL_HANDLE);
 	assert(m_swapChainImages.empty());
-	assert(m_imageAcquireSemaphore == VK_NULL_HANDLE);
-	assert(m_renderCompleteSemaphore == VK_NULL_HANDLE);
 
 	auto result = VK_SUCCESS;
 
@@ -393,19 +440,6 @@ void CPresent::CreateSwapChain()
 	}
 	CHECKVULKANERROR(result);
 
-	//Create the semaphore that will be used to prevent submit from rendering before getting the image
-	{
-		auto semaphoreCreateInfo = Framework::Vulkan::SemaphoreCreateInfo();
-		auto result = m_context->device.vkCreateSemaphore(m_context->device, &semaphoreCreateInfo, nullptr, &m_imageAcquireSemaphore);
-		CHECKVULKANERROR(result);
-	}
-
-	{
-		auto semaphoreCreateInfo = Framework::Vulkan::SemaphoreCreateInfo();
-		auto result = m_context->device.vkCreateSemaphore(m_context->device, &semaphoreCreateInfo, nullptr, &m_renderCompleteSemaphore);
-		CHECKVULKANERROR(result);
-	}
-
 	uint32_t imageCount = 0;
 	result = m_context->device.vkGetSwapchainImagesKHR(m_context->device, m_swapChain, &imageCount, nullptr);
 	CHECKVULKANERROR(result);
@@ -478,15 +512,10 @@ void CPresent::DestroySwapChain()
 	}
 	m_context->device.vkDestroySwapchainKHR(m_context->device, m_swapChain, nullptr);
 
-	m_context->device.vkDestroySemaphore(m_context->device, m_imageAcquireSemaphore, nullptr);
-	m_context->device.vkDestroySemaphore(m_context->device, m_renderCompleteSemaphore, nullptr);
-
 	m_swapChainImages.clear();
 	m_swapChainImageViews.clear();
 	m_swapChainFramebuffers.clear();
 	m_swapChain = VK_NULL_HANDLE;
-	m_imageAcquireSemaphore = VK_NULL_HANDLE;
-	m_renderCompleteSemaphore = VK_NULL_HANDLE;
 }
 
 void CPresent::CreateRenderPass()
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include "GSH_VulkanContext.h"
+#include "GSH_VulkanSubmitQueue.h"
 #include "GSH_VulkanPipelineCache.h"
 #include "vulkan/ShaderModule.h"
 #include "vulkan/Buffer.h"
@@ -11,7 +13,7 @@ namespace GSH_Vulkan
 	class CPresent
 	{
 	public:
-		CPresent(const ContextPtr&);
+		CPresent(const ContextPtr&, const SubmitQueuePtr&);
 		virtual ~CPresent();
 
 		void ValidateSwapChain(const CGSHandler::PRESENTATION_PARAMS&);
@@ -37,12 +39,17 @@ namespace GSH_Vulkan
 		typedef CPipelineCache<PipelineCapsInt> PipelineCache;
 		typedef std::unordered_map<uint32, VkDescriptorSet> DescriptorSetCache;
 
+		//Presentation is performed asynchronously by the submit queue, semaphores are kept
+		//with the command buffer and can't be reused before the present went through
 		struct PRESENT_COMMANDBUFFER
 		{
 			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
 			VkFence execCompleteFence = VK_NULL_HANDLE;
+			VkSemaphore imageAcquireSemaphore = VK_NULL_HANDLE;
+			VkSemaphore renderCompleteSemaphore = VK_NULL_HANDLE;
+			std::atomic<bool> presentPending{false};
 		};
-		typedef std::vector<PRESENT_COMMANDBUFFER> PresentCommandBufferArray;
+		typedef std::vector<std::unique_ptr<PRESENT_COMMANDBUFFER>> PresentCommandBufferArray;
 
 		struct PRESENT_VERTEX
 		{
@@ -62,8 +69,10 @@ namespace GSH_Vulkan
 			uint32 layerHeight;
 		};
 
-		void UpdateBackbuffer(uint32, const CGSHandler::DISPLAY_INFO&);
-		PRESENT_COMMANDBUFFER PrepareCommandBuffer();
+		void UpdateBackbuffer(PRESENT_COMMANDBUFFER*, uint32, const CGSHandler::DISPLAY_INFO&);
+		void QueuePresent(PRESENT_COMMANDBUFFER*, uint32);
+		bool IsPresentPending() const;
+		PRESENT_COMMANDBUFFER* PrepareCommandBuffer();
 		VkDescriptorSet PrepareDescriptorSet(VkDescriptorSetLayout, uint32);
 
 		void CreateSwapChain();
@@ -81,6 +90,7 @@ namespace GSH_Vulkan
 		static const PRESENT_VERTEX g_vertexBufferContents[4];
 
 		ContextPtr m_context;
+		SubmitQueuePtr m_submitQueue;
 
 		VkExtent2D m_surfaceExtents;
 		VkSwapchainKHR m_swapChain = VK_NULL_HANDLE;
@@ -89,8 +99,8 @@ namespace GSH_Vulkan
 		std::vector<VkFramebuffer> m_swapChainFramebuffers;
 		bool m_swapChainValid = false;
 		CGSHandler::PRESENTATION_VIEWPORT m_presentationViewport;
-		VkSemaphore m_imageAcquireSemaphore = VK_NULL_HANDLE;
-		VkSemaphore m_renderCompleteSemaphore = VK_NULL_HANDLE;
+		//Set by the submit queue when a present finds out the swap chain is out of date
+		std::atomic<bool> m_swapChainOutOfDate{false};
 		VkRenderPass m_renderPass = VK_NULL_HANDLE;
 		Framework::Vulkan::CBuffer m_vertexBuffer;
 		PresentCommandBufferArray m_presentCommandBuffers;
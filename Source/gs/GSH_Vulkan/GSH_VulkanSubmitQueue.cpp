@@ -0,0 +1,94 @@
+#include "GSH_VulkanSubmitQueue.h"
+#include "ThreadUtils.h"
+
+using namespace GSH_Vulkan;
+
+CSubmitQueue::CSubmitQueue(const ContextPtr& context)
+    : m_context(context)
+{
+	m_thread = std::thread([this]() { ThreadProc(); });
+	Framework::ThreadUtils::SetThreadName(m_thread, "GS Submit Thread");
+}
+
+CSubmitQueue::~CSubmitQueue()
+{
+	m_mailBox.SendCall([this]() { m_threadDone = true; });
+	m_thread.join();
+}
+
+void CSubmitQueue::Submit(VkCommandBuffer commandBuffer, VkFence fence)
+{
+	//Command buffer must not be touched by the caller until the fence is signaled
+	Post(
+	    [this, commandBuffer, fence]() {
+		    auto submitInfo = Framework::Vulkan::SubmitInfo();
+		    submitInfo.commandBufferCount = 1;
+		    submitInfo.pCommandBuffers = &commandBuffer;
+		    auto result = m_context->device.vkQueueSubmit(m_context->queue, 1, &submitInfo, fence);
+		    CHECKVULKANERROR(result);
+	    });
+}
+
+void CSubmitQueue::Post(const QueueFunction& function)
+{
+	CheckError();
+	m_mailBox.SendCall([this, function]() { RunFunction(function); });
+}
+
+void CSubmitQueue::Execute(const QueueFunction& function)
+{
+	//Runs after every previously queued submission and blocks until done
+	CheckError();
+	m_mailBox.SendCall([this, function]() { RunFunction(function); }, true);
+	CheckError();
+}
+
+void CSubmitQueue::WaitIdle()
+{
+	Execute(
+	    [this]() {
+		    m_context->device.vkQueueWaitIdle(m_context->queue);
+	    });
+}
+
+void CSubmitQueue::RunFunction(const QueueFunction& function)
+{
+	//Nothing can handle errors on this thread, keep them for the caller
+	try
+	{
+		function();
+	}
+	catch(...)
+	{
+		std::lock_guard<std::mutex> errorLock(m_errorMutex);
+		if(!m_error)
+		{
+			m_error = std::current_exception();
+		}
+	}
+}
+
+void CSubmitQueue::CheckError()
+{
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> errorLock(m_errorMutex);
+		std::swap(error, m_error);
+	}
+	if(error)
+	{
+		std::rethrow_exception(error);
+	}
+}
+
+void CSubmitQueue::ThreadProc()
+{
+	while(!m_threadDone)
+	{
+		m_mailBox.WaitForCall();
+		while(m_mailBox.IsPending())
+		{
+			m_mailBox.ReceiveCall();
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "GSH_VulkanContext.h"
+#include "../../MailBox.h"
+
+namespace GSH_Vulkan
+{
+	//Second stage of the GS pipeline: the GS thread processes register writes, sets up
+	//primitives and records command buffers, while this thread owns the device queue and
+	//performs submissions and presentation. This allows the GS thread to carry on with the
+	//next batch of work while the driver processes the submission.
+	class CSubmitQueue
+	{
+	public:
+		typedef std::function<void()> QueueFunction;
+
+		CSubmitQueue(const ContextPtr&);
+		~CSubmitQueue();
+
+		//Errors raised by queued functions are kept and rethrown by
+		//the next call to any of these on the caller's thread.
+		void Submit(VkCommandBuffer, VkFence);
+		void Post(const QueueFunction&);
+		void Execute(const QueueFunction&);
+		void WaitIdle();
+
+	private:
+		void RunFunction(const QueueFunction&);
+		void CheckError();
+		void ThreadProc();
+
+		ContextPtr m_context;
+		CMailBox m_mailBox;
+		std::thread m_thread;
+		bool m_threadDone = false;
+
+		std::mutex m_errorMutex;
+		std::exception_ptr m_error;
+	};
+
+	typedef std::shared_ptr<CSubmitQueue> SubmitQueuePtr;
+}
@@ -16,6 +16,9 @@ using namespace GSH_Vulkan;
 #define DESCRIPTOR_LOCATION_SWIZZLETABLE_DST 2
 #define DESCRIPTOR_LOCATION_MEMORY_8BIT 3
 #define DESCRIPTOR_LOCATION_MEMORY_16BIT 4
+#define DESCRIPTOR_LOCATION_XFERPARAMS 5
+
+#define XFERPARAMS_WORD_COUNT (sizeof(CTransferHost::XFERPARAMS) / sizeof(uint32))
 
 #define TRANSFER_USE_8_16_BIT GSH_VULKAN_IS_DESKTOP
 
@@ -31,13 +34,23 @@ CTransferHost::CTransferHost(const ContextPtr& context, const FrameCommandBuffer
 		    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
 		    XFER_BUFFER_SIZE);
 
+		frame.xferParamsBuffer = Framework::Vulkan::CBuffer(
+		    m_context->device, m_context->physicalDeviceMemoryProperties,
+		    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		    sizeof(XFERPARAMS) * MAX_XFERPARAMS_COUNT);
+
 		auto result = m_context->device.vkMapMemory(m_context->device, frame.xferBuffer.GetMemory(),
 		                                            0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&frame.xferBufferPtr));
 		CHECKVULKANERROR(result);
+
+		result = m_context->device.vkMapMemory(m_context->device, frame.xferParamsBuffer.GetMemory(),
+		                                       0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&frame.xferParamsBufferPtr));
+		CHECKVULKANERROR(result);
 	}
 
 	m_localSize = std::min<uint32>(context->computeWorkgroupInvocations, 1024);
 	m_pipelineCaps <<= 0;
+	m_batchPipelineCaps <<= 0;
 }
 
 CTransferHost::~CTransferHost()
@@ -45,6 +58,7 @@ CTransferHost::~CTransferHost()
 	for(auto& frame : m_frames)
 	{
 		m_context->device.vkUnmapMemory(m_context->device, frame.xferBuffer.GetMemory());
+		m_context->device.vkUnmapMemory(m_context->device, frame.xferParamsBuffer.GetMemory());
 	}
 }
 
@@ -53,15 +67,31 @@ void CTransferHost::SetPipelineCaps(const PIPELINE_CAPS& pipelineCaps)
 	m_pipelineCaps = pipelineCaps;
 }
 
-void CTransferHost::DoTransfer(const XferBuffer& inputData)
+bool CTransferHost::CanBatchTransfer(const XferBuffer& inputData) const
 {
-	auto result = VK_SUCCESS;
+	if(m_batchXferCount == 0) return true;
+	if(m_batchPipelineCaps != m_pipelineCaps) return false;
+
+	//Every transfer in the batch gets as many work groups as the largest one,
+	//don't let the batch grow if more than half of the dispatched work would be wasted
+	uint32 workGroupCount = GetWorkGroupCount(GetPixelCount(inputData.size()));
+	uint32 maxWorkGroupCount = std::max<uint32>(m_batchMaxWorkGroupCount, workGroupCount);
+	uint32 dispatchedWorkGroupCount = maxWorkGroupCount * (m_batchXferCount + 1);
+	uint32 usedWorkGroupCount = m_batchWorkGroupCount + workGroupCount;
+	return dispatchedWorkGroupCount <= (usedWorkGroupCount * 2);
+}
+
+void CTransferHost::DoTransfer(const XferBuffer& inputData, uint32 dstAddress, uint32 dstSize)
+{
+	assert(CanBatchTransfer(inputData));
 
 	uint32 xferBufferRemainSize = XFER_BUFFER_SIZE - m_xferBufferOffset;
-	if(xferBufferRemainSize < inputData.size())
+	if((xferBufferRemainSize < inputData.size()) || (m_xferParamsIndex == MAX_XFERPARAMS_COUNT))
 	{
+		//This will also execute the current batch
 		m_frameCommandBuffer->Flush();
 		assert((XFER_BUFFER_SIZE - m_xferBufferOffset) >= inputData.size());
+		assert(m_batchXferCount == 0);
 	}
 
 	auto& frame = m_frames[m_frameCommandBuffer->GetCurrentFrame()];
@@ -70,48 +100,49 @@ void CTransferHost::DoTransfer(const XferBuffer& inputData)
 	memcpy(frame.xferBufferPtr + m_xferBufferOffset, inputData.data(), inputData.size());
 	assert((m_xferBufferOffset & 0x03) == 0);
 	Params.xferBufferOffset = m_xferBufferOffset / 4;
+	Params.pixelCount = GetPixelCount(inputData.size());
 
-	//Find pipeline and create it if we've never encountered it before
-	auto xferPipeline = m_pipelineCache.TryGetPipeline(m_pipelineCaps);
-	if(!xferPipeline)
+	if(m_batchXferCount == 0)
 	{
-		xferPipeline = m_pipelineCache.RegisterPipeline(m_pipelineCaps, CreateXferPipeline(m_pipelineCaps));
+		m_batchPipelineCaps = m_pipelineCaps;
+		m_batchXferParamsIndex = m_xferParamsIndex;
 	}
 
-	uint32 pixelCount = 0;
-	switch(m_pipelineCaps.dstFormat)
+	uint32 workGroupCount = GetWorkGroupCount(Params.pixelCount);
+	frame.xferParamsBufferPtr[m_xferParamsIndex++] = Params;
+	m_batchXferCount++;
+	m_batchMaxWorkGroupCount = std::max<uint32>(m_batchMaxWorkGroupCount, workGroupCount);
+	m_batchWorkGroupCount += workGroupCount;
+
+	if(dstSize != 0)
 	{
-	default:
-		assert(false);
-	case CGSHandler::PSMCT32:
-	case CGSHandler::PSMZ32:
-		pixelCount = inputData.size() / 4;
-		break;
-	case CGSHandler::PSMCT24:
-	case CGSHandler::PSMZ24:
-		pixelCount = inputData.size() / 3;
-		break;
-	case CGSHandler::PSMCT16S:
-	case CGSHandler::PSMCT16:
-	case CGSHandler::PSMZ16S:
-		pixelCount = inputData.size() / 2;
-		break;
-	case CGSHandler::PSMT8:
-	case CGSHandler::PSMT8H:
-		pixelCount = inputData.size();
-		break;
-	case CGSHandler::PSMT4:
-	case CGSHandler::PSMT4HL:
-	case CGSHandler::PSMT4HH:
-		pixelCount = inputData.size() * 2;
-		break;
+		uint32 startPage = dstAddress / CGsPixelFormats::PAGESIZE;
+		uint32 endPage = (dstAddress + dstSize + CGsPixelFormats::PAGESIZE - 1) / CGsPixelFormats::PAGESIZE;
+		endPage = std::min<uint32>(endPage, startPage + PAGE_COUNT);
+		for(uint32 page = startPage; page < endPage; page++)
+		{
+			m_batchPendingPages.set(page % PAGE_COUNT);
+		}
 	}
+	m_pendingSerial++;
 
-	Params.pixelCount = pixelCount;
-	uint32 workUnits = (pixelCount + m_localSize - 1) / m_localSize;
+	m_xferBufferOffset += inputData.size();
+	m_xferBufferOffset = (m_xferBufferOffset + (m_context->storageBufferAlignment - 1)) & -m_context->storageBufferAlignment;
+}
+
+void CTransferHost::FlushTransfers()
+{
+	if(m_batchXferCount == 0) return;
+
+	//Find pipeline and create it if we've never encountered it before
+	auto xferPipeline = m_pipelineCache.TryGetPipeline(m_batchPipelineCaps);
+	if(!xferPipeline)
+	{
+		xferPipeline = m_pipelineCache.RegisterPipeline(m_batchPipelineCaps, CreateXferPipeline(m_batchPipelineCaps));
+	}
 
 	auto descriptorSetCaps = make_convertible<DESCRIPTORSET_CAPS>(0);
-	descriptorSetCaps.dstPsm = m_pipelineCaps.dstFormat;
+	descriptorSetCaps.dstPsm = m_batchPipelineCaps.dstFormat;
 	descriptorSetCaps.frameIdx = m_frameCommandBuffer->GetCurrentFrame();
 
 	auto descriptorSet = PrepareDescriptorSet(xferPipeline->descriptorSetLayout, descriptorSetCaps);
@@ -127,13 +158,78 @@ void CTransferHost::DoTransfer(const XferBuffer& inputData)
 		                                       0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
 	}
 
+	BATCHPARAMS batchParams;
+	batchParams.xferParamsIndex = m_batchXferParamsIndex;
+	batchParams.xferCount = m_batchXferCount;
+
+	//One row of work groups per transfer, transfers in a batch never overlap
 	m_context->device.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, xferPipeline->pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
 	m_context->device.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, xferPipeline->pipeline);
-	m_context->device.vkCmdPushConstants(commandBuffer, xferPipeline->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(XFERPARAMS), &Params);
-	m_context->device.vkCmdDispatch(commandBuffer, workUnits, 1, 1);
+	m_context->device.vkCmdPushConstants(commandBuffer, xferPipeline->pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(BATCHPARAMS), &batchParams);
+	m_context->device.vkCmdDispatch(commandBuffer, m_batchMaxWorkGroupCount, m_batchXferCount, 1);
+
+	m_batchXferCount = 0;
+	m_batchMaxWorkGroupCount = 0;
+	m_batchWorkGroupCount = 0;
+	m_batchPendingPages.reset();
+	m_pendingSerial++;
+}
 
-	m_xferBufferOffset += inputData.size();
-	m_xferBufferOffset = (m_xferBufferOffset + (m_context->storageBufferAlignment - 1)) & -m_context->storageBufferAlignment;
+bool CTransferHost::HasPendingTransfers() const
+{
+	return m_batchXferCount != 0;
+}
+
+bool CTransferHost::IsRangePending(uint32 address, uint32 size) const
+{
+	if(m_batchXferCount == 0) return false;
+	if(size == 0) return false;
+
+	uint32 startPage = address / CGsPixelFormats::PAGESIZE;
+	uint32 endPage = (address + size + CGsPixelFormats::PAGESIZE - 1) / CGsPixelFormats::PAGESIZE;
+	endPage = std::min<uint32>(endPage, startPage + PAGE_COUNT);
+	for(uint32 page = startPage; page < endPage; page++)
+	{
+		if(m_batchPendingPages.test(page % PAGE_COUNT)) return true;
+	}
+	return false;
+}
+
+uint32 CTransferHost::GetPendingSerial() const
+{
+	return m_pendingSerial;
+}
+
+uint32 CTransferHost::GetPixelCount(uint32 dataSize) const
+{
+	switch(m_pipelineCaps.dstFormat)
+	{
+	default:
+		assert(false);
+		[[fallthrough]];
+	case CGSHandler::PSMCT32:
+	case CGSHandler::PSMZ32:
+		return dataSize / 4;
+	case CGSHandler::PSMCT24:
+	case CGSHandler::PSMZ24:
+		return dataSize / 3;
+	case CGSHandler::PSMCT16S:
+	case CGSHandler::PSMCT16:
+	case CGSHandler::PSMZ16S:
+		return dataSize / 2;
+	case CGSHandler::PSMT8:
+	case CGSHandler::PSMT8H:
+		return dataSize;
+	case CGSHandler::PSMT4:
+	case CGSHandler::PSMT4HL:
+	case CGSHandler::PSMT4HH:
+		return dataSize * 2;
+	}
+}
+
+uint32 CTransferHost::GetWorkGroupCount(uint32 pixelCount) const
+{
+	return (pixelCount + m_localSize - 1) / m_localSize;
 }
 
 VkDescriptorSet CTransferHost::PrepareDescriptorSet(VkDescriptorSetLayout descriptorSetLayout, const DESCRIPTORSET_CAPS& caps)
@@ -170,6 +266,10 @@ VkDescriptorSet CTransferHost::PrepareDescriptorSet(VkDescriptorSetLayout descri
 		descriptorBufferInfo.buffer = m_frames[caps.frameIdx].xferBuffer;
 		descriptorBufferInfo.range = VK_WHOLE_SIZE;
 
+		VkDescriptorBufferInfo descriptorParamsBufferInfo = {};
+		descriptorParamsBufferInfo.buffer = m_frames[caps.frameIdx].xferParamsBuffer;
+		descriptorParamsBufferInfo.range = VK_WHOLE_SIZE;
+
 		VkDescriptorImageInfo descriptorDstSwizzleTableInfo = {};
 		descriptorDstSwizzleTableInfo.imageView = m_context->GetSwizzleTable(caps.dstPsm);
 		descriptorDstSwizzleTableInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
@@ -220,6 +320,17 @@ VkDescriptorSet CTransferHost::PrepareDescriptorSet(VkDescriptorSetLayout descri
 			writes.push_back(writeSet);
 		}
 
+		//Xfer Params Descriptor
+		{
+			auto writeSet = Framework::Vulkan::WriteDescriptorSet();
+			writeSet.dstSet = descriptorSet;
+			writeSet.dstBinding = DESCRIPTOR_LOCATION_XFERPARAMS;
+			writeSet.descriptorCount = 1;
+			writeSet.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writeSet.pBufferInfo = &descriptorParamsBufferInfo;
+			writes.push_back(writeSet);
+		}
+
 		//Dst Swizzle Table
 		{
 			auto writeSet = Framework::Vulkan::WriteDescriptorSet();
@@ -241,11 +352,13 @@ VkDescriptorSet CTransferHost::PrepareDescriptorSet(VkDescriptorSetLayout descri
 
 void CTransferHost::PreFlushFrameCommandBuffer()
 {
+	FlushTransfers();
 }
 
 void CTransferHost::PostFlushFrameCommandBuffer()
 {
 	m_xferBufferOffset = 0;
+	m_xferParamsIndex = 0;
 }
 
 Framework::Vulkan::CShaderModule CTransferHost::CreateXferShader(const PIPELINE_CAPS& caps)
@@ -264,18 +377,22 @@ Framework::Vulkan::CShaderModule CTransferHost::CreateXferShader(const PIPELINE_
 		auto memoryBuffer16 = CArrayUshortValue(b.CreateUniformArrayUshort("memoryBuffer16", DESCRIPTOR_LOCATION_MEMORY_16BIT));
 #endif
 		auto xferBuffer = CArrayUintValue(b.CreateUniformArrayUint("xferBuffer", DESCRIPTOR_LOCATION_XFERBUFFER));
+		auto xferParamsBuffer = CArrayUintValue(b.CreateUniformArrayUint("xferParamsBuffer", DESCRIPTOR_LOCATION_XFERPARAMS));
 		auto dstSwizzleTable = CImageUint2DValue(b.CreateImage2DUint(DESCRIPTOR_LOCATION_SWIZZLETABLE_DST));
 
-		auto xferParams0 = CInt4Lvalue(b.CreateUniformInt4("xferParams0", Nuanceur::UNIFORM_UNIT_PUSHCONSTANT));
-		auto xferParams1 = CInt4Lvalue(b.CreateUniformInt4("xferParams1", Nuanceur::UNIFORM_UNIT_PUSHCONSTANT));
+		auto batchParams = CInt4Lvalue(b.CreateUniformInt4("batchParams", Nuanceur::UNIFORM_UNIT_PUSHCONSTANT));
 
-		auto bufAddress = xferParams0->x();
-		auto bufWidth = xferParams0->y();
-		auto rrw = xferParams0->z();
-		auto dsax = xferParams0->w();
-		auto dsay = xferParams1->x();
-		auto xferBufferOffset = xferParams1->y();
-		auto pixelCount = xferParams1->z();
+		//Each row of work groups handles one transfer of the batch
+		auto xferParamsIndex = CIntLvalue(b.CreateTemporaryInt());
+		xferParamsIndex = (batchParams->x() + inputInvocationId->y()) * NewInt(b, XFERPARAMS_WORD_COUNT);
+
+		auto bufAddress = ToInt(Load(xferParamsBuffer, xferParamsIndex + NewInt(b, 0)));
+		auto bufWidth = ToInt(Load(xferParamsBuffer, xferParamsIndex + NewInt(b, 1)));
+		auto rrw = ToInt(Load(xferParamsBuffer, xferParamsIndex + NewInt(b, 2)));
+		auto dsax = ToInt(Load(xferParamsBuffer, xferParamsIndex + NewInt(b, 3)));
+		auto dsay = ToInt(Load(xferParamsBuffer, xferParamsIndex + NewInt(b, 4)));
+		auto xferBufferOffset = ToInt(Load(xferParamsBuffer, xferParamsIndex + NewInt(b, 5)));
+		auto pixelCount = ToInt(Load(xferParamsBuffer, xferParamsIndex + NewInt(b, 6)));
 
 		auto rrx = inputInvocationId->x() % rrw;
 		auto rry = inputInvocationId->x() / rrw;
@@ -479,6 +596,16 @@ PIPELINE CTransferHost::CreateXferPipeline(const PIPELINE_CAPS& caps)
 			bindings.push_back(binding);
 		}
 
+		//Xfer params
+		{
+			VkDescriptorSetLayoutBinding binding = {};
+			binding.binding = DESCRIPTOR_LOCATION_XFERPARAMS;
+			binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			binding.descriptorCount = 1;
+			binding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+			bindings.push_back(binding);
+		}
+
 		//Dst Swizzle Table
 		{
 			VkDescriptorSetLayoutBinding binding = {};
@@ -500,7 +627,7 @@ PIPELINE CTransferHost::CreateXferPipeline(const PIPELINE_CAPS& caps)
 		VkPushConstantRange pushConstantInfo = {};
 		pushConstantInfo.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 		pushConstantInfo.offset = 0;
-		pushConstantInfo.size = sizeof(XFERPARAMS);
+		pushConstantInfo.size = sizeof(BATCHPARAMS);
 
 		auto pipelineLayoutCreateInfo = Framework::Vulkan::PipelineLayoutCreateInfo();
 		pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <bitset>
 #include "GSH_VulkanContext.h"
 #include "GSH_VulkanFrameCommandBuffer.h"
 #include "GSH_VulkanPipelineCache.h"
 #include "Convertible.h"
 #include "vulkan/ShaderModule.h"
 #include "nuanceur/Builder.h"
+#include "../GSHandler.h"
+#include "../GsPixelFormats.h"
 
 namespace GSH_Vulkan
 {
@@ -39,12 +42,31 @@ namespace GSH_Vulkan
 		};
 		static_assert(sizeof(XFERPARAMS) == 0x20, "XFERPARAMS must be 32 bytes large.");
 
+		struct BATCHPARAMS
+		{
+			uint32 xferParamsIndex = 0;
+			uint32 xferCount = 0;
+			uint32 padding0 = 0;
+			uint32 padding1 = 0;
+		};
+		static_assert(sizeof(BATCHPARAMS) == 0x10, "BATCHPARAMS must be 16 bytes large.");
+
 		CTransferHost(const ContextPtr&, const FrameCommandBufferPtr&);
 		virtual ~CTransferHost();
 
 		void SetPipelineCaps(const PIPELINE_CAPS&);
 
-		void DoTransfer(const XferBuffer&);
+		//Transfers are queued and executed in batches with a single dispatch.
+		//Caller needs to make sure no render pass is active before calling FlushTransfers
+		//and must flush pending transfers before anything reads or writes GS memory
+		//ranges returned as pending by IsRangePending. This includes other transfers.
+		bool CanBatchTransfer(const XferBuffer&) const;
+		void DoTransfer(const XferBuffer&, uint32, uint32);
+		void FlushTransfers();
+
+		bool HasPendingTransfers() const;
+		bool IsRangePending(uint32, uint32) const;
+		uint32 GetPendingSerial() const;
 
 		void PreFlushFrameCommandBuffer() override;
 		void PostFlushFrameCommandBuffer() override;
@@ -52,10 +74,20 @@ namespace GSH_Vulkan
 		XFERPARAMS Params;
 
 	private:
+		enum
+		{
+			MAX_XFERPARAMS_COUNT = 0x1000,
+			PAGE_COUNT = CGSHandler::RAMSIZE / CGsPixelFormats::PAGESIZE,
+		};
+
+		typedef std::bitset<PAGE_COUNT> PageMask;
+
 		struct FRAMECONTEXT
 		{
 			Framework::Vulkan::CBuffer xferBuffer;
 			uint8* xferBufferPtr = nullptr;
+			Framework::Vulkan::CBuffer xferParamsBuffer;
+			XFERPARAMS* xferParamsBufferPtr = nullptr;
 		};
 
 		typedef CPipelineCache<PipelineCapsInt> PipelineCache;
@@ -72,6 +104,9 @@ namespace GSH_Vulkan
 
 		VkDescriptorSet PrepareDescriptorSet(VkDescriptorSetLayout, const DESCRIPTORSET_CAPS&);
 
+		uint32 GetPixelCount(uint32) const;
+		uint32 GetWorkGroupCount(uint32) const;
+
 		Framework::Vulkan::CShaderModule CreateXferShader(const PIPELINE_CAPS&);
 		PIPELINE CreateXferPipeline(const PIPELINE_CAPS&);
 
@@ -90,8 +125,18 @@ namespace GSH_Vulkan
 		FRAMECONTEXT m_frames[MAX_FRAMES];
 
 		uint32 m_xferBufferOffset = 0;
+		uint32 m_xferParamsIndex = 0;
 
 		PIPELINE_CAPS m_pipelineCaps;
+
+		//Current batch
+		PIPELINE_CAPS m_batchPipelineCaps;
+		uint32 m_batchXferParamsIndex = 0;
+		uint32 m_batchXferCount = 0;
+		uint32 m_batchMaxWorkGroupCount = 0;
+		uint32 m_batchWorkGroupCount = 0;
+		PageMask m_batchPendingPages;
+		uint32 m_pendingSerial = 0;
 	};
 
 	typedef std::shared_ptr<CTransferHost> TransferHostPtr;
@@ -6,6 +6,7 @@
 #include "../states/MemoryStateFile.h"
 #include "../states/RegisterStateFile.h"
 #include "../FrameDump.h"
+#include "../FrameDumpStream.h"
 #include "../ee/INTC.h"
 #include "GSHandler.h"
 #include "GsPixelFormats.h"
@@ -347,9 +348,41 @@ void CGSHandler::TriggerFrameDump(const FrameDumpCallback& frameDumpCallback)
 #endif
 }
 
+void CGSHandler::TriggerFrameDumpStream(const std::shared_ptr<Framework::CStream>& stream, uint32 frameCount, const FrameDumpStreamCallback& frameDumpStreamCallback)
+{
+#ifdef DEBUGGER_INCLUDED
+	assert(frameCount != 0);
+	m_mailBox.SendCall(
+	    [=]() {
+		    if(m_frameDumpStreamCallback)
+		    {
+			    //Another dump is in progress, let the caller know nothing will be written to its stream
+			    frameDumpStreamCallback(false);
+			    return;
+		    }
+		    m_frameDumpStream = stream;
+		    m_frameDumpStreamFrameCount = frameCount;
+		    m_frameDumpStreamCallback = frameDumpStreamCallback;
+	    });
+#endif
+}
+
 void CGSHandler::UpdateFrameDumpState()
 {
 #ifdef DEBUGGER_INCLUDED
+	if(m_frameDumpStreamWriter)
+	{
+		assert(m_frameDumpStreamFrameCount != 0);
+		if((m_frameDumpStreamWriter->GetPacketCount() != 0) && (--m_frameDumpStreamFrameCount == 0))
+		{
+			EndFrameDumpStream(true);
+		}
+	}
+	else if(m_frameDumpStreamCallback)
+	{
+		BeginFrameDumpStream();
+	}
+
 	if(m_frameDump && !m_frameDump->GetPackets().empty())
 	{
 		m_frameDumpCallback(*m_frameDump.get());
@@ -370,6 +403,49 @@ void CGSHandler::UpdateFrameDumpState()
 #endif
 }
 
+void CGSHandler::BeginFrameDumpStream()
+{
+#ifdef DEBUGGER_INCLUDED
+	//This is expected to be called from the GS thread
+	SyncMemoryCache();
+
+	try
+	{
+		m_frameDumpStreamWriter = std::make_unique<CFrameDumpStreamWriter>(*m_frameDumpStream);
+		m_frameDumpStreamWriter->WriteInitialState(GetRam(), GetRegisters(), GetSMODE2());
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to begin frame dump stream: %s\r\n", exception.what());
+		EndFrameDumpStream(false);
+	}
+#endif
+}
+
+void CGSHandler::EndFrameDumpStream(bool success)
+{
+#ifdef DEBUGGER_INCLUDED
+	if(success)
+	{
+		try
+		{
+			m_frameDumpStreamWriter->Finish();
+		}
+		catch(const std::exception& exception)
+		{
+			CLog::GetInstance().Warn(LOG_NAME, "Failed to finish frame dump stream: %s\r\n", exception.what());
+			success = false;
+		}
+	}
+	auto callback = std::move(m_frameDumpStreamCallback);
+	m_frameDumpStreamCallback = FrameDumpStreamCallback();
+	m_frameDumpStreamWriter.reset();
+	m_frameDumpStream.reset();
+	m_frameDumpStreamFrameCount = 0;
+	callback(success);
+#endif
+}
+
 void CGSHandler::InitFromFrameDump(CFrameDump* frameDump)
 {
 	//This is expected to be called from outside the GS thread
@@ -640,6 +716,17 @@ void CGSHandler::FeedImageData(const void* data, uint32 length)
 		    {
 			    m_frameDump->AddImagePacket(imageData, length);
 		    }
+		    if(m_frameDumpStreamWriter)
+		    {
+			    try
+			    {
+				    m_frameDumpStreamWriter->AddImagePacket(imageData, length);
+			    }
+			    catch(const std::exception&)
+			    {
+				    EndFrameDumpStream(false);
+			    }
+		    }
 #endif
 		    FeedImageDataImpl(imageData, length);
 		    delete[] imageData;
@@ -669,6 +756,17 @@ void CGSHandler::ProcessWriteBuffer(const CGsPacketMetadata* metadata)
 			    {
 				    m_frameDump->AddRegisterPacket(packet, packetSize, &metadata);
 			    }
+			    if(m_frameDumpStreamWriter)
+			    {
+				    try
+				    {
+					    m_frameDumpStreamWriter->AddRegisterPacket(packet, packetSize, &metadata);
+				    }
+				    catch(const std::exception&)
+				    {
+					    EndFrameDumpStream(false);
+				    }
+			    }
 		    });
 	}
 #endif
@@ -16,6 +16,7 @@
 #include "zip/ZipArchiveReader.h"
 
 class CFrameDump;
+class CFrameDumpStreamWriter;
 class CGsPacketMetadata;
 class CINTC;
 
@@ -814,6 +815,7 @@ public:
 	typedef std::function<CGSHandler*()> FactoryFunction;
 
 	typedef std::function<void(const CFrameDump&)> FrameDumpCallback;
+	typedef std::function<void(bool)> FrameDumpStreamCallback;
 
 	typedef Framework::CSignal<void()> FlipCompleteEvent;
 	typedef Framework::CSignal<void(uint32)> NewFrameEvent;
@@ -834,6 +836,7 @@ public:
 	void Copy(CGSHandler*);
 
 	void TriggerFrameDump(const FrameDumpCallback&);
+	void TriggerFrameDumpStream(const std::shared_ptr<Framework::CStream>&, uint32, const FrameDumpStreamCallback&);
 
 	void InitFromFrameDump(CFrameDump*);
 
@@ -1044,6 +1047,8 @@ protected:
 	void SubmitWriteBufferImpl(const RegisterWrite*, const RegisterWrite*);
 
 	void UpdateFrameDumpState();
+	void BeginFrameDumpStream();
+	void EndFrameDumpStream(bool);
 
 	void BeginTransfer();
 
@@ -1129,6 +1134,10 @@ protected:
 	bool m_threadDone = false;
 	std::unique_ptr<CFrameDump> m_frameDump;
 	FrameDumpCallback m_frameDumpCallback;
+	std::shared_ptr<Framework::CStream> m_frameDumpStream;
+	std::unique_ptr<CFrameDumpStreamWriter> m_frameDumpStreamWriter;
+	uint32 m_frameDumpStreamFrameCount = 0;
+	FrameDumpStreamCallback m_frameDumpStreamCallback;
 	bool m_regsDirty = false;
 	bool m_drawEnabled = true;
 	CINTC* m_intc = nullptr;
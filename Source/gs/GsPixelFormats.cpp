@@ -1,151 +1,11 @@
 #include <cassert>
 #include "GsPixelFormats.h"
 
-// clang-format off
-const int CGsPixelFormats::STORAGEPSMCT32::m_nBlockSwizzleTable[4][8] =
-{
-	{	0,	1,	4,	5,	16,	17,	20,	21	},
-	{	2,	3,	6,	7,	18,	19,	22,	23	},
-	{	8,	9,	12,	13,	24,	25,	28,	29	},
-	{	10,	11,	14,	15,	26,	27,	30,	31	},
-};
-
-const int CGsPixelFormats::STORAGEPSMCT32::m_nColumnSwizzleTable[2][8] =
-{
-	{	0,	1,	4,	5,	8,	9,	12,	13,	},
-	{	2,	3,	6,	7,	10,	11,	14,	15,	},
-};
-
-const int CGsPixelFormats::STORAGEPSMZ32::m_nBlockSwizzleTable[4][8] =
-{
-	{	24,	25,	28,	29,	8,	9,	12,	13	},
-	{	26,	27,	30,	31,	10,	11,	14,	15	},
-	{	16,	17,	20,	21,	0,	1,	4,	5	},
-	{	18,	19,	22,	23,	2,	3,	6,	7	},
-};
-
-const int CGsPixelFormats::STORAGEPSMZ32::m_nColumnSwizzleTable[2][8] =
-{
-	{	0,	1,	4,	5,	8,	9,	12,	13,	},
-	{	2,	3,	6,	7,	10,	11,	14,	15,	},
-};
-
-const int CGsPixelFormats::STORAGEPSMCT16::m_nBlockSwizzleTable[8][4] =
-{
-	{	0,	2,	8,	10,	},
-	{	1,	3,	9,	11,	},
-	{	4,	6,	12,	14,	},
-	{	5,	7,	13,	15,	},
-	{	16,	18,	24,	26,	},
-	{	17,	19,	25,	27,	},
-	{	20,	22,	28,	30,	},
-	{	21,	23,	29,	31,	},
-};
-
-const int CGsPixelFormats::STORAGEPSMCT16::m_nColumnSwizzleTable[2][16] =
-{
-	{	0,	2,	8,	10,	16,	18,	24,	26,	1,	3,	9,	11,	17,	19,	25,	27,	},
-	{	4,	6,	12,	14,	20,	22,	28,	30,	5,	7,	13,	15,	21,	23,	29,	31,	},
-};
-
-const int CGsPixelFormats::STORAGEPSMCT16S::m_nBlockSwizzleTable[8][4] =
-{
-	{	0,	2,	16,	18,	},
-	{	1,	3,	17,	19,	},
-	{	8,	10,	24,	26,	},
-	{	9,	11,	25,	27,	},
-	{	4,	6,	20,	22,	},
-	{	5,	7,	21,	23,	},
-	{	12,	14,	28,	30,	},
-	{	13,	15,	29,	31,	},
-};
-
-const int CGsPixelFormats::STORAGEPSMCT16S::m_nColumnSwizzleTable[2][16] =
-{
-	{	0,	2,	8,	10,	16,	18,	24,	26,	1,	3,	9,	11,	17,	19,	25,	27,	},
-	{	4,	6,	12,	14,	20,	22,	28,	30,	5,	7,	13,	15,	21,	23,	29,	31,	},
-};
-
-const int CGsPixelFormats::STORAGEPSMZ16::m_nBlockSwizzleTable[8][4] =
-{
-	{ 24, 26, 16, 18, },
-	{ 25, 27, 17, 19, },
-	{ 28, 30, 20, 22, },
-	{ 29, 31, 21, 23, },
-	{ 8,  10, 0,  2,  },
-	{ 9,  11, 1,  3,  },
-	{ 12, 14, 4,  6,  },
-	{ 13, 15, 5,  7,  },
-};
-
-const int CGsPixelFormats::STORAGEPSMZ16::m_nColumnSwizzleTable[2][16] =
-{
-	{ 0, 2, 8,  10, 16, 18, 24, 26, 1, 3, 9,  11, 17, 19, 25, 27, },
-	{ 4, 6, 12, 14, 20, 22, 28, 30, 5, 7, 13, 15, 21, 23, 29, 31, },
-};
-
-const int CGsPixelFormats::STORAGEPSMZ16S::m_nBlockSwizzleTable[8][4] =
-{
-	{ 24, 26, 8,  10, },
-	{ 25, 27, 9,  11, },
-	{ 16, 18, 0,  2,  },
-	{ 17, 19, 1,  3,  },
-	{ 28, 30, 12, 14, },
-	{ 29, 31, 13, 15, },
-	{ 20, 22, 4,  6,  },
-	{ 21, 23, 5,  7,  },
-};
-
-const int CGsPixelFormats::STORAGEPSMZ16S::m_nColumnSwizzleTable[2][16] =
-{
-	{ 0, 2, 8,  10, 16, 18, 24, 26, 1, 3, 9,  11, 17, 19, 25, 27, },
-	{ 4, 6, 12, 14, 20, 22, 28, 30, 5, 7, 13, 15, 21, 23, 29, 31, },
-};
-
-const int CGsPixelFormats::STORAGEPSMT8::m_nBlockSwizzleTable[4][8] =
-{
-	{	0,	1,	4,	5,	16,	17,	20,	21	},
-	{	2,	3,	6,	7,	18,	19,	22,	23	},
-	{	8,	9,	12,	13,	24,	25,	28,	29	},
-	{	10,	11,	14,	15,	26,	27,	30,	31	},
-};
-
-const int CGsPixelFormats::STORAGEPSMT8::m_nColumnWordTable[2][2][8] =
-{
-	{
-		{	0,	1,	4,	5,	8,	9,	12,	13,	},
-		{	2,	3,	6,	7,	10,	11,	14,	15,	},
-	},
-	{
-		{	8,	9,	12,	13,	0,	1,	4,	5,	},
-		{	10,	11,	14,	15,	2,	3,	6,	7,	},
-	},
-};
-
-const int CGsPixelFormats::STORAGEPSMT4::m_nBlockSwizzleTable[8][4] =
-{
-	{	0,	2,	8,	10,	},
-	{	1,	3,	9,	11,	},
-	{	4,	6,	12,	14,	},
-	{	5,	7,	13,	15,	},
-	{	16,	18,	24,	26,	},
-	{	17,	19,	25,	27,	},
-	{	20,	22,	28,	30,	},
-	{	21,	23,	29,	31,	}
-};
-
-const int CGsPixelFormats::STORAGEPSMT4::m_nColumnWordTable[2][2][8] =
-{
-	{
-		{	0,	1,	4,	5,	8,	9,	12,	13,	},
-		{	2,	3,	6,	7,	10,	11,	14,	15,	},
-	},
-	{
-		{	8,	9,	12,	13,	0,	1,	4,	5,	},
-		{	10,	11,	14,	15,	2,	3,	6,	7,	},
-	},
-};
-// clang-format on
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+#include <emmintrin.h>
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+#include <arm_neon.h>
+#endif
 
 unsigned int CGsPixelFormats::GetPsmPixelSize(unsigned int psm)
 {
@@ -236,3 +96,293 @@ bool CGsPixelFormats::IsPsm24Bits(unsigned int psm)
 {
 	return psm == CGSHandler::PSMZ24 || psm == CGSHandler::PSMCT24;
 }
+
+//Column conversion
+//-----------------
+//32-bit columns are 8x2 pixels, each row is made of alternating pairs of pixels in the 4 qwords of the column.
+//16-bit columns are 16x2 pixels and follow the same layout when seen as 32-bit words, the low halves of
+//the words holding the first 8 pixels of a row and the high halves the last 8.
+
+static void ConvertColumn32ToLinear(uint32* dst, uint32 pitch, const uint8* column)
+{
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+	auto src = reinterpret_cast<const __m128i*>(column);
+	__m128i q0 = _mm_loadu_si128(src + 0);
+	__m128i q1 = _mm_loadu_si128(src + 1);
+	__m128i q2 = _mm_loadu_si128(src + 2);
+	__m128i q3 = _mm_loadu_si128(src + 3);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi64(q0, q1));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpacklo_epi64(q2, q3));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch + 0), _mm_unpackhi_epi64(q0, q1));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pitch + 4), _mm_unpackhi_epi64(q2, q3));
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+	auto src = reinterpret_cast<const uint32*>(column);
+	uint32x4_t q0 = vld1q_u32(src + 0);
+	uint32x4_t q1 = vld1q_u32(src + 4);
+	uint32x4_t q2 = vld1q_u32(src + 8);
+	uint32x4_t q3 = vld1q_u32(src + 12);
+	vst1q_u32(dst + 0, vcombine_u32(vget_low_u32(q0), vget_low_u32(q1)));
+	vst1q_u32(dst + 4, vcombine_u32(vget_low_u32(q2), vget_low_u32(q3)));
+	vst1q_u32(dst + pitch + 0, vcombine_u32(vget_high_u32(q0), vget_high_u32(q1)));
+	vst1q_u32(dst + pitch + 4, vcombine_u32(vget_high_u32(q2), vget_high_u32(q3)));
+#else
+	typedef CGsPixelFormats::STORAGEPSMCT32 Storage;
+	auto src = reinterpret_cast<const uint32*>(column);
+	for(uint32 y = 0; y < Storage::COLUMNHEIGHT; y++)
+	{
+		for(uint32 x = 0; x < Storage::COLUMNWIDTH; x++)
+		{
+			dst[x] = src[Storage::m_nColumnSwizzleTable[y][x]];
+		}
+		dst += pitch;
+	}
+#endif
+}
+
+static void ConvertLinearToColumn32(uint8* column, const uint32* src, uint32 pitch)
+{
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+	__m128i row0a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0));
+	__m128i row0b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+	__m128i row1a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pitch + 0));
+	__m128i row1b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pitch + 4));
+	auto dst = reinterpret_cast<__m128i*>(column);
+	_mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(row0a, row1a));
+	_mm_storeu_si128(dst + 1, _mm_unpackhi_epi64(row0a, row1a));
+	_mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(row0b, row1b));
+	_mm_storeu_si128(dst + 3, _mm_unpackhi_epi64(row0b, row1b));
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+	uint32x4_t row0a = vld1q_u32(src + 0);
+	uint32x4_t row0b = vld1q_u32(src + 4);
+	uint32x4_t row1a = vld1q_u32(src + pitch + 0);
+	uint32x4_t row1b = vld1q_u32(src + pitch + 4);
+	auto dst = reinterpret_cast<uint32*>(column);
+	vst1q_u32(dst + 0, vcombine_u32(vget_low_u32(row0a), vget_low_u32(row1a)));
+	vst1q_u32(dst + 4, vcombine_u32(vget_high_u32(row0a), vget_high_u32(row1a)));
+	vst1q_u32(dst + 8, vcombine_u32(vget_low_u32(row0b), vget_low_u32(row1b)));
+	vst1q_u32(dst + 12, vcombine_u32(vget_high_u32(row0b), vget_high_u32(row1b)));
+#else
+	typedef CGsPixelFormats::STORAGEPSMCT32 Storage;
+	auto dst = reinterpret_cast<uint32*>(column);
+	for(uint32 y = 0; y < Storage::COLUMNHEIGHT; y++)
+	{
+		for(uint32 x = 0; x < Storage::COLUMNWIDTH; x++)
+		{
+			dst[Storage::m_nColumnSwizzleTable[y][x]] = src[x];
+		}
+		src += pitch;
+	}
+#endif
+}
+
+static void ConvertColumn16ToLinear(uint16* dst, uint32 pitch, const uint8* column)
+{
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+	auto src = reinterpret_cast<const __m128i*>(column);
+	__m128i q0 = _mm_loadu_si128(src + 0);
+	__m128i q1 = _mm_loadu_si128(src + 1);
+	__m128i q2 = _mm_loadu_si128(src + 2);
+	__m128i q3 = _mm_loadu_si128(src + 3);
+	__m128i rows[2][2] =
+	    {
+	        {_mm_unpacklo_epi64(q0, q1), _mm_unpacklo_epi64(q2, q3)},
+	        {_mm_unpackhi_epi64(q0, q1), _mm_unpackhi_epi64(q2, q3)},
+	    };
+	for(uint32 y = 0; y < 2; y++)
+	{
+		//Values are sign extended before packing, saturation never kicks in
+		__m128i a = rows[y][0];
+		__m128i b = rows[y][1];
+		__m128i lo = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+		__m128i hi = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), lo);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), hi);
+		dst += pitch;
+	}
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+	auto src = reinterpret_cast<const uint32*>(column);
+	uint32x4_t q0 = vld1q_u32(src + 0);
+	uint32x4_t q1 = vld1q_u32(src + 4);
+	uint32x4_t q2 = vld1q_u32(src + 8);
+	uint32x4_t q3 = vld1q_u32(src + 12);
+	uint32x4_t rows[2][2] =
+	    {
+	        {vcombine_u32(vget_low_u32(q0), vget_low_u32(q1)), vcombine_u32(vget_low_u32(q2), vget_low_u32(q3))},
+	        {vcombine_u32(vget_high_u32(q0), vget_high_u32(q1)), vcombine_u32(vget_high_u32(q2), vget_high_u32(q3))},
+	    };
+	for(uint32 y = 0; y < 2; y++)
+	{
+		uint32x4_t a = rows[y][0];
+		uint32x4_t b = rows[y][1];
+		vst1q_u16(dst + 0, vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+		vst1q_u16(dst + 8, vcombine_u16(vshrn_n_u32(a, 16), vshrn_n_u32(b, 16)));
+		dst += pitch;
+	}
+#else
+	typedef CGsPixelFormats::STORAGEPSMCT16 Storage;
+	auto src = reinterpret_cast<const uint16*>(column);
+	for(uint32 y = 0; y < Storage::COLUMNHEIGHT; y++)
+	{
+		for(uint32 x = 0; x < Storage::COLUMNWIDTH; x++)
+		{
+			dst[x] = src[Storage::m_nColumnSwizzleTable[y][x]];
+		}
+		dst += pitch;
+	}
+#endif
+}
+
+static void ConvertLinearToColumn16(uint8* column, const uint16* src, uint32 pitch)
+{
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+	__m128i words[2][2];
+	for(uint32 y = 0; y < 2; y++)
+	{
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+		words[y][0] = _mm_unpacklo_epi16(lo, hi);
+		words[y][1] = _mm_unpackhi_epi16(lo, hi);
+		src += pitch;
+	}
+	auto dst = reinterpret_cast<__m128i*>(column);
+	_mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(words[0][0], words[1][0]));
+	_mm_storeu_si128(dst + 1, _mm_unpackhi_epi64(words[0][0], words[1][0]));
+	_mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(words[0][1], words[1][1]));
+	_mm_storeu_si128(dst + 3, _mm_unpackhi_epi64(words[0][1], words[1][1]));
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+	uint32x4_t words[2][2];
+	for(uint32 y = 0; y < 2; y++)
+	{
+		uint16x8x2_t zipped = vzipq_u16(vld1q_u16(src + 0), vld1q_u16(src + 8));
+		words[y][0] = vreinterpretq_u32_u16(zipped.val[0]);
+		words[y][1] = vreinterpretq_u32_u16(zipped.val[1]);
+		src += pitch;
+	}
+	auto dst = reinterpret_cast<uint32*>(column);
+	vst1q_u32(dst + 0, vcombine_u32(vget_low_u32(words[0][0]), vget_low_u32(words[1][0])));
+	vst1q_u32(dst + 4, vcombine_u32(vget_high_u32(words[0][0]), vget_high_u32(words[1][0])));
+	vst1q_u32(dst + 8, vcombine_u32(vget_low_u32(words[0][1]), vget_low_u32(words[1][1])));
+	vst1q_u32(dst + 12, vcombine_u32(vget_high_u32(words[0][1]), vget_high_u32(words[1][1])));
+#else
+	typedef CGsPixelFormats::STORAGEPSMCT16 Storage;
+	auto dst = reinterpret_cast<uint16*>(column);
+	for(uint32 y = 0; y < Storage::COLUMNHEIGHT; y++)
+	{
+		for(uint32 x = 0; x < Storage::COLUMNWIDTH; x++)
+		{
+			dst[Storage::m_nColumnSwizzleTable[y][x]] = src[x];
+		}
+		src += pitch;
+	}
+#endif
+}
+
+template <typename Storage, typename ColumnHandler>
+static void ForEachPageColumn(const ColumnHandler& columnHandler)
+{
+	for(uint32 blockY = 0; blockY < (Storage::PAGEHEIGHT / Storage::BLOCKHEIGHT); blockY++)
+	{
+		for(uint32 blockX = 0; blockX < (Storage::PAGEWIDTH / Storage::BLOCKWIDTH); blockX++)
+		{
+			uint32 blockOffset = Storage::m_nBlockSwizzleTable[blockY][blockX] * CGsPixelFormats::BLOCKSIZE;
+			for(uint32 columnNum = 0; columnNum < (Storage::BLOCKHEIGHT / Storage::COLUMNHEIGHT); columnNum++)
+			{
+				uint32 columnOffset = blockOffset + (columnNum * CGsPixelFormats::COLUMNSIZE);
+				columnHandler(columnOffset, blockX * Storage::BLOCKWIDTH, (blockY * Storage::BLOCKHEIGHT) + (columnNum * Storage::COLUMNHEIGHT));
+			}
+		}
+	}
+}
+
+template <typename Storage>
+void CGsPixelFormats::ConvertPageToLinear(typename Storage::Unit* dst, uint32 pitch, const uint8* page)
+{
+	if constexpr(sizeof(typename Storage::Unit) == 4)
+	{
+		ForEachPageColumn<Storage>(
+		    [&](uint32 columnOffset, uint32 x, uint32 y) {
+			    ConvertColumn32ToLinear(dst + (y * pitch) + x, pitch, page + columnOffset);
+		    });
+	}
+	else if constexpr(sizeof(typename Storage::Unit) == 2)
+	{
+		ForEachPageColumn<Storage>(
+		    [&](uint32 columnOffset, uint32 x, uint32 y) {
+			    ConvertColumn16ToLinear(dst + (y * pitch) + x, pitch, page + columnOffset);
+		    });
+	}
+	else
+	{
+		const auto& pageOffsets = CPixelIndexor<Storage>::GetPageOffsetTable();
+		for(uint32 y = 0; y < Storage::PAGEHEIGHT; y++)
+		{
+			for(uint32 x = 0; x < Storage::PAGEWIDTH; x++)
+			{
+				uint32 offset = pageOffsets[y][x];
+				if constexpr(std::is_same_v<Storage, STORAGEPSMT4>)
+				{
+					dst[x] = (page[offset >> 1] >> ((offset & 1) * 4)) & 0x0F;
+				}
+				else
+				{
+					dst[x] = page[offset];
+				}
+			}
+			dst += pitch;
+		}
+	}
+}
+
+template <typename Storage>
+void CGsPixelFormats::ConvertLinearToPage(uint8* page, const typename Storage::Unit* src, uint32 pitch)
+{
+	if constexpr(sizeof(typename Storage::Unit) == 4)
+	{
+		ForEachPageColumn<Storage>(
+		    [&](uint32 columnOffset, uint32 x, uint32 y) {
+			    ConvertLinearToColumn32(page + columnOffset, src + (y * pitch) + x, pitch);
+		    });
+	}
+	else if constexpr(sizeof(typename Storage::Unit) == 2)
+	{
+		ForEachPageColumn<Storage>(
+		    [&](uint32 columnOffset, uint32 x, uint32 y) {
+			    ConvertLinearToColumn16(page + columnOffset, src + (y * pitch) + x, pitch);
+		    });
+	}
+	else
+	{
+		const auto& pageOffsets = CPixelIndexor<Storage>::GetPageOffsetTable();
+		for(uint32 y = 0; y < Storage::PAGEHEIGHT; y++)
+		{
+			for(uint32 x = 0; x < Storage::PAGEWIDTH; x++)
+			{
+				uint32 offset = pageOffsets[y][x];
+				if constexpr(std::is_same_v<Storage, STORAGEPSMT4>)
+				{
+					uint32 shiftAmount = (offset & 1) * 4;
+					auto& pixel = page[offset >> 1];
+					pixel = (pixel & ~(0x0F << shiftAmount)) | ((src[x] & 0x0F) << shiftAmount);
+				}
+				else
+				{
+					page[offset] = src[x];
+				}
+			}
+			src += pitch;
+		}
+	}
+}
+
+#define INSTANTIATE_PAGE_CONVERTERS(Storage)                                                                                                    \
+	template void CGsPixelFormats::ConvertPageToLinear<CGsPixelFormats::Storage>(CGsPixelFormats::Storage::Unit*, uint32, const uint8*); \
+	template void CGsPixelFormats::ConvertLinearToPage<CGsPixelFormats::Storage>(uint8*, const CGsPixelFormats::Storage::Unit*, uint32);
+
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMCT32)
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMCT16)
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMCT16S)
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMZ32)
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMZ16)
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMZ16S)
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMT8)
+INSTANTIATE_PAGE_CONVERTERS(STORAGEPSMT4)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <type_traits>
 #include "Types.h"
 #include "GSHandler.h"
 
@@ -53,8 +54,21 @@ public:
 			COLUMNHEIGHT = 2
 		};
 
-		static const int m_nBlockSwizzleTable[4][8];
-		static const int m_nColumnSwizzleTable[2][8];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[4][8] =
+		{
+			{	0,	1,	4,	5,	16,	17,	20,	21	},
+			{	2,	3,	6,	7,	18,	19,	22,	23	},
+			{	8,	9,	12,	13,	24,	25,	28,	29	},
+			{	10,	11,	14,	15,	26,	27,	30,	31	},
+		};
+
+		static constexpr int m_nColumnSwizzleTable[2][8] =
+		{
+			{	0,	1,	4,	5,	8,	9,	12,	13,	},
+			{	2,	3,	6,	7,	10,	11,	14,	15,	},
+		};
+		// clang-format on
 
 		typedef uint32 Unit;
 	};
@@ -86,8 +100,21 @@ public:
 			COLUMNHEIGHT = 2
 		};
 
-		static const int m_nBlockSwizzleTable[4][8];
-		static const int m_nColumnSwizzleTable[2][8];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[4][8] =
+		{
+			{	24,	25,	28,	29,	8,	9,	12,	13	},
+			{	26,	27,	30,	31,	10,	11,	14,	15	},
+			{	16,	17,	20,	21,	0,	1,	4,	5	},
+			{	18,	19,	22,	23,	2,	3,	6,	7	},
+		};
+
+		static constexpr int m_nColumnSwizzleTable[2][8] =
+		{
+			{	0,	1,	4,	5,	8,	9,	12,	13,	},
+			{	2,	3,	6,	7,	10,	11,	14,	15,	},
+		};
+		// clang-format on
 
 		typedef uint32 Unit;
 	};
@@ -119,8 +146,25 @@ public:
 			COLUMNHEIGHT = 2
 		};
 
-		static const int m_nBlockSwizzleTable[8][4];
-		static const int m_nColumnSwizzleTable[2][16];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[8][4] =
+		{
+			{	0,	2,	8,	10,	},
+			{	1,	3,	9,	11,	},
+			{	4,	6,	12,	14,	},
+			{	5,	7,	13,	15,	},
+			{	16,	18,	24,	26,	},
+			{	17,	19,	25,	27,	},
+			{	20,	22,	28,	30,	},
+			{	21,	23,	29,	31,	},
+		};
+
+		static constexpr int m_nColumnSwizzleTable[2][16] =
+		{
+			{	0,	2,	8,	10,	16,	18,	24,	26,	1,	3,	9,	11,	17,	19,	25,	27,	},
+			{	4,	6,	12,	14,	20,	22,	28,	30,	5,	7,	13,	15,	21,	23,	29,	31,	},
+		};
+		// clang-format on
 
 		typedef uint16 Unit;
 	};
@@ -152,8 +196,25 @@ public:
 			COLUMNHEIGHT = 2
 		};
 
-		static const int m_nBlockSwizzleTable[8][4];
-		static const int m_nColumnSwizzleTable[2][16];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[8][4] =
+		{
+			{	0,	2,	16,	18,	},
+			{	1,	3,	17,	19,	},
+			{	8,	10,	24,	26,	},
+			{	9,	11,	25,	27,	},
+			{	4,	6,	20,	22,	},
+			{	5,	7,	21,	23,	},
+			{	12,	14,	28,	30,	},
+			{	13,	15,	29,	31,	},
+		};
+
+		static constexpr int m_nColumnSwizzleTable[2][16] =
+		{
+			{	0,	2,	8,	10,	16,	18,	24,	26,	1,	3,	9,	11,	17,	19,	25,	27,	},
+			{	4,	6,	12,	14,	20,	22,	28,	30,	5,	7,	13,	15,	21,	23,	29,	31,	},
+		};
+		// clang-format on
 
 		typedef uint16 Unit;
 	};
@@ -185,8 +246,25 @@ public:
 			COLUMNHEIGHT = 2
 		};
 
-		static const int m_nBlockSwizzleTable[8][4];
-		static const int m_nColumnSwizzleTable[2][16];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[8][4] =
+		{
+			{ 24, 26, 16, 18, },
+			{ 25, 27, 17, 19, },
+			{ 28, 30, 20, 22, },
+			{ 29, 31, 21, 23, },
+			{ 8,  10, 0,  2,  },
+			{ 9,  11, 1,  3,  },
+			{ 12, 14, 4,  6,  },
+			{ 13, 15, 5,  7,  },
+		};
+
+		static constexpr int m_nColumnSwizzleTable[2][16] =
+		{
+			{ 0, 2, 8,  10, 16, 18, 24, 26, 1, 3, 9,  11, 17, 19, 25, 27, },
+			{ 4, 6, 12, 14, 20, 22, 28, 30, 5, 7, 13, 15, 21, 23, 29, 31, },
+		};
+		// clang-format on
 
 		typedef uint16 Unit;
 	};
@@ -218,8 +296,25 @@ public:
 			COLUMNHEIGHT = 2
 		};
 
-		static const int m_nBlockSwizzleTable[8][4];
-		static const int m_nColumnSwizzleTable[2][16];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[8][4] =
+		{
+			{ 24, 26, 8,  10, },
+			{ 25, 27, 9,  11, },
+			{ 16, 18, 0,  2,  },
+			{ 17, 19, 1,  3,  },
+			{ 28, 30, 12, 14, },
+			{ 29, 31, 13, 15, },
+			{ 20, 22, 4,  6,  },
+			{ 21, 23, 5,  7,  },
+		};
+
+		static constexpr int m_nColumnSwizzleTable[2][16] =
+		{
+			{ 0, 2, 8,  10, 16, 18, 24, 26, 1, 3, 9,  11, 17, 19, 25, 27, },
+			{ 4, 6, 12, 14, 20, 22, 28, 30, 5, 7, 13, 15, 21, 23, 29, 31, },
+		};
+		// clang-format on
 
 		typedef uint16 Unit;
 	};
@@ -251,8 +346,27 @@ public:
 			COLUMNHEIGHT = 4
 		};
 
-		static const int m_nBlockSwizzleTable[4][8];
-		static const int m_nColumnWordTable[2][2][8];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[4][8] =
+		{
+			{	0,	1,	4,	5,	16,	17,	20,	21	},
+			{	2,	3,	6,	7,	18,	19,	22,	23	},
+			{	8,	9,	12,	13,	24,	25,	28,	29	},
+			{	10,	11,	14,	15,	26,	27,	30,	31	},
+		};
+
+		static constexpr int m_nColumnWordTable[2][2][8] =
+		{
+			{
+				{	0,	1,	4,	5,	8,	9,	12,	13,	},
+				{	2,	3,	6,	7,	10,	11,	14,	15,	},
+			},
+			{
+				{	8,	9,	12,	13,	0,	1,	4,	5,	},
+				{	10,	11,	14,	15,	2,	3,	6,	7,	},
+			},
+		};
+		// clang-format on
 
 		typedef uint8 Unit;
 	};
@@ -284,8 +398,31 @@ public:
 			COLUMNHEIGHT = 4
 		};
 
-		static const int m_nBlockSwizzleTable[8][4];
-		static const int m_nColumnWordTable[2][2][8];
+		// clang-format off
+		static constexpr int m_nBlockSwizzleTable[8][4] =
+		{
+			{	0,	2,	8,	10,	},
+			{	1,	3,	9,	11,	},
+			{	4,	6,	12,	14,	},
+			{	5,	7,	13,	15,	},
+			{	16,	18,	24,	26,	},
+			{	17,	19,	25,	27,	},
+			{	20,	22,	28,	30,	},
+			{	21,	23,	29,	31,	}
+		};
+
+		static constexpr int m_nColumnWordTable[2][2][8] =
+		{
+			{
+				{	0,	1,	4,	5,	8,	9,	12,	13,	},
+				{	2,	3,	6,	7,	10,	11,	14,	15,	},
+			},
+			{
+				{	8,	9,	12,	13,	0,	1,	4,	5,	},
+				{	10,	11,	14,	15,	2,	3,	6,	7,	},
+			},
+		};
+		// clang-format on
 
 		typedef uint8 Unit;
 	};
@@ -298,16 +435,24 @@ public:
 	static bool IsPsmUpperByte(unsigned int);
 	static bool IsPsm24Bits(unsigned int);
 
+	//Full page converters. A linear page is PAGEWIDTH x PAGEHEIGHT units laid out in rows separated
+	//by 'pitch' units. PSMT4 pixels are stored as one byte each in linear form.
+	template <typename Storage>
+	static void ConvertPageToLinear(typename Storage::Unit*, uint32 pitch, const uint8*);
+	template <typename Storage>
+	static void ConvertLinearToPage(uint8*, const typename Storage::Unit*, uint32 pitch);
+
 	template <typename Storage>
 	class CPixelIndexor
 	{
 	public:
+		typedef uint32 PageOffsetTable[Storage::PAGEHEIGHT][Storage::PAGEWIDTH];
+
 		CPixelIndexor(uint8* pMemory, uint32 nPointer, uint32 nWidth)
 		{
 			m_nPointer = nPointer;
 			m_nWidth = nWidth;
 			m_pMemory = pMemory;
-			BuildPageOffsetTable();
 		}
 
 		typename Storage::Unit GetPixel(unsigned int nX, unsigned int nY)
@@ -327,15 +472,19 @@ public:
 			nX %= Storage::PAGEWIDTH;
 			nY %= Storage::PAGEHEIGHT;
 
-			uint32 pageOffset = m_pageOffsets[nY][nX];
+			uint32 pageOffset = m_pageOffsets.values[nY][nX];
 			auto pixelAddr = m_pMemory + ((m_nPointer + (pageNum * PAGESIZE) + pageOffset) & (CGSHandler::RAMSIZE - 1));
 			return reinterpret_cast<typename Storage::Unit*>(pixelAddr);
 		}
 
-		static uint32* GetPageOffsets()
+		static const uint32* GetPageOffsets()
 		{
-			BuildPageOffsetTable();
-			return reinterpret_cast<uint32*>(m_pageOffsets);
+			return reinterpret_cast<const uint32*>(m_pageOffsets.values);
+		}
+
+		static const PageOffsetTable& GetPageOffsetTable()
+		{
+			return m_pageOffsets.values;
 		}
 
 		uint32 GetColumnAddress(unsigned int& nX, unsigned int& nY)
@@ -357,40 +506,136 @@ public:
 			return (m_nPointer + (nPageNum * PAGESIZE) + (nBlockNum * BLOCKSIZE) + (nColumnNum * COLUMNSIZE)) & (CGSHandler::RAMSIZE - 1);
 		}
 
+		//Copies a rectangle to/from a linear buffer. Pages entirely covered by the rectangle
+		//go through the full page converters, the edges are handled pixel by pixel.
+		void ReadRect(typename Storage::Unit* dst, uint32 dstPitch, uint32 rectX, uint32 rectY, uint32 rectWidth, uint32 rectHeight)
+		{
+			ProcessRect(rectX, rectY, rectWidth, rectHeight,
+			            [&](uint32 pageAddress, uint32 x, uint32 y) {
+				            ConvertPageToLinear<Storage>(dst + ((y - rectY) * dstPitch) + (x - rectX), dstPitch, m_pMemory + pageAddress);
+			            },
+			            [&](uint32 x, uint32 y) {
+				            dst[((y - rectY) * dstPitch) + (x - rectX)] = GetPixel(x, y);
+			            });
+		}
+
+		void WriteRect(const typename Storage::Unit* src, uint32 srcPitch, uint32 rectX, uint32 rectY, uint32 rectWidth, uint32 rectHeight)
+		{
+			ProcessRect(rectX, rectY, rectWidth, rectHeight,
+			            [&](uint32 pageAddress, uint32 x, uint32 y) {
+				            ConvertLinearToPage<Storage>(m_pMemory + pageAddress, src + ((y - rectY) * srcPitch) + (x - rectX), srcPitch);
+			            },
+			            [&](uint32 x, uint32 y) {
+				            SetPixel(x, y, src[((y - rectY) * srcPitch) + (x - rectX)]);
+			            });
+		}
+
 	private:
-		static void BuildPageOffsetTable()
+		struct PAGEOFFSETTABLE
 		{
-			if(m_pageOffsetsInitialized) return;
+			PageOffsetTable values;
+		};
 
-			for(uint32 y = 0; y < Storage::PAGEHEIGHT; y++)
+		static constexpr uint32 ComputePageOffset(uint32 x, uint32 y)
+		{
+			uint32 workX = x;
+			uint32 workY = y;
+
+			uint32 blockNum = Storage::m_nBlockSwizzleTable[workY / Storage::BLOCKHEIGHT][workX / Storage::BLOCKWIDTH];
+
+			workX %= Storage::BLOCKWIDTH;
+			workY %= Storage::BLOCKHEIGHT;
+
+			uint32 columnNum = (workY / Storage::COLUMNHEIGHT);
+
+			workY %= Storage::COLUMNHEIGHT;
+
+			if constexpr(std::is_same_v<Storage, STORAGEPSMT4>)
 			{
-				for(uint32 x = 0; x < Storage::PAGEWIDTH; x++)
-				{
-					uint32 workX = x;
-					uint32 workY = y;
+				//Offset is in nibbles
+				uint32 shiftAmount = (workX & 0x18);
+				shiftAmount += (workY & 0x02) << 1;
+				uint32 nibble = shiftAmount / 4;
 
-					uint32 blockNum = Storage::m_nBlockSwizzleTable[workY / Storage::BLOCKHEIGHT][workX / Storage::BLOCKWIDTH];
+				uint32 subTable = (workY & 0x02) >> 1;
+				subTable ^= (columnNum & 0x01);
 
-					workX %= Storage::BLOCKWIDTH;
-					workY %= Storage::BLOCKHEIGHT;
+				workX &= 0x07;
+				workY &= 0x01;
 
-					uint32 columnNum = (workY / Storage::COLUMNHEIGHT);
+				return ((columnNum * COLUMNSIZE) + (blockNum * BLOCKSIZE) + (Storage::m_nColumnWordTable[subTable][workY][workX] * 4)) * 2 + nibble;
+			}
+			else if constexpr(std::is_same_v<Storage, STORAGEPSMT8>)
+			{
+				uint32 table = (workY & 0x02) >> 1;
+				uint32 byte = (workX & 0x08) >> 2;
+				byte += (workY & 0x02) >> 1;
+				table ^= ((y / Storage::COLUMNHEIGHT) & 1);
 
-					workY %= Storage::COLUMNHEIGHT;
+				workX &= 0x7;
+				workY &= 0x1;
+
+				return (blockNum * BLOCKSIZE) + (columnNum * COLUMNSIZE) + (Storage::m_nColumnWordTable[table][workY][workX] * 4) + byte;
+			}
+			else
+			{
+				return (blockNum * BLOCKSIZE) + (columnNum * COLUMNSIZE) + sizeof(typename Storage::Unit) * Storage::m_nColumnSwizzleTable[workY][workX];
+			}
+		}
 
-					uint32 offset = (blockNum * BLOCKSIZE) + (columnNum * COLUMNSIZE) + sizeof(typename Storage::Unit) * Storage::m_nColumnSwizzleTable[workY][workX];
-					m_pageOffsets[y][x] = offset;
+		static constexpr PAGEOFFSETTABLE BuildPageOffsetTable()
+		{
+			PAGEOFFSETTABLE table = {};
+			for(uint32 y = 0; y < Storage::PAGEHEIGHT; y++)
+			{
+				for(uint32 x = 0; x < Storage::PAGEWIDTH; x++)
+				{
+					table.values[y][x] = ComputePageOffset(x, y);
 				}
 			}
+			return table;
+		}
 
-			m_pageOffsetsInitialized = true;
+		template <typename PageHandler, typename PixelHandler>
+		void ProcessRect(uint32 rectX, uint32 rectY, uint32 rectWidth, uint32 rectHeight, const PageHandler& pageHandler, const PixelHandler& pixelHandler)
+		{
+			uint32 rectEndX = rectX + rectWidth;
+			uint32 rectEndY = rectY + rectHeight;
+			for(uint32 pageY = rectY / Storage::PAGEHEIGHT; (pageY * Storage::PAGEHEIGHT) < rectEndY; pageY++)
+			{
+				uint32 startY = std::max<uint32>(rectY, pageY * Storage::PAGEHEIGHT);
+				uint32 endY = std::min<uint32>(rectEndY, (pageY + 1) * Storage::PAGEHEIGHT);
+				for(uint32 pageX = rectX / Storage::PAGEWIDTH; (pageX * Storage::PAGEWIDTH) < rectEndX; pageX++)
+				{
+					uint32 startX = std::max<uint32>(rectX, pageX * Storage::PAGEWIDTH);
+					uint32 endX = std::min<uint32>(rectEndX, (pageX + 1) * Storage::PAGEWIDTH);
+					bool fullPage = ((endX - startX) == Storage::PAGEWIDTH) && ((endY - startY) == Storage::PAGEHEIGHT);
+					if(fullPage)
+					{
+						//Same as GetPixelAddress, page rows can start in the middle of a page with odd widths
+						uint32 pageNum = pageX + pageY * (m_nWidth * 64) / Storage::PAGEWIDTH;
+						uint32 pageAddress = (m_nPointer + (pageNum * PAGESIZE)) & (CGSHandler::RAMSIZE - 1);
+						if((pageAddress + PAGESIZE) <= CGSHandler::RAMSIZE)
+						{
+							pageHandler(pageAddress, startX, startY);
+							continue;
+						}
+					}
+					for(uint32 y = startY; y < endY; y++)
+					{
+						for(uint32 x = startX; x < endX; x++)
+						{
+							pixelHandler(x, y);
+						}
+					}
+				}
+			}
 		}
 
 		uint32 m_nPointer;
 		uint32 m_nWidth;
 		uint8* m_pMemory;
-		static bool m_pageOffsetsInitialized;
-		static uint32 m_pageOffsets[Storage::PAGEHEIGHT][Storage::PAGEWIDTH];
+		static constexpr PAGEOFFSETTABLE m_pageOffsets = BuildPageOffsetTable();
 	};
 
 	typedef CPixelIndexor<STORAGEPSMCT32> CPixelIndexorPSMCT32;
@@ -406,12 +651,6 @@ public:
 //////////////////////////////////////////////
 //Some storage methods templates specializations
 
-template <typename Storage>
-bool CGsPixelFormats::CPixelIndexor<Storage>::m_pageOffsetsInitialized = false;
-
-template <typename Storage>
-uint32 CGsPixelFormats::CPixelIndexor<Storage>::m_pageOffsets[Storage::PAGEHEIGHT][Storage::PAGEWIDTH];
-
 template <>
 inline uint8 CGsPixelFormats::CPixelIndexor<CGsPixelFormats::STORAGEPSMT4>::GetPixel(unsigned int nX, unsigned int nY)
 {
@@ -459,82 +698,3 @@ inline void CGsPixelFormats::CPixelIndexor<CGsPixelFormats::STORAGEPSMT4>::SetPi
 	(*pPixel) |= (nPixel << nShiftAmount);
 }
 
-template <>
-inline void CGsPixelFormats::CPixelIndexor<CGsPixelFormats::STORAGEPSMT4>::BuildPageOffsetTable()
-{
-	if(m_pageOffsetsInitialized) return;
-
-	typedef STORAGEPSMT4 Storage;
-
-	for(uint32 y = 0; y < Storage::PAGEHEIGHT; y++)
-	{
-		for(uint32 x = 0; x < Storage::PAGEWIDTH; x++)
-		{
-			uint32 workX = x;
-			uint32 workY = y;
-
-			uint32 blockNum = Storage::m_nBlockSwizzleTable[workY / Storage::BLOCKHEIGHT][workX / Storage::BLOCKWIDTH];
-
-			workX %= Storage::BLOCKWIDTH;
-			workY %= Storage::BLOCKHEIGHT;
-
-			uint32 columnNum = (workY / Storage::COLUMNHEIGHT);
-
-			workY %= Storage::COLUMNHEIGHT;
-
-			uint32 shiftAmount = (workX & 0x18);
-			shiftAmount += (workY & 0x02) << 1;
-			uint32 nibble = shiftAmount / 4;
-
-			uint32 subTable = (workY & 0x02) >> 1;
-			subTable ^= (columnNum & 0x01);
-
-			workX &= 0x07;
-			workY &= 0x01;
-
-			assert(nibble < 8);
-			uint32 offset = ((columnNum * COLUMNSIZE) + (blockNum * BLOCKSIZE) + (Storage::m_nColumnWordTable[subTable][workY][workX] * 4)) * 2 + nibble;
-			assert(offset < (PAGESIZE * 2));
-			m_pageOffsets[y][x] = offset;
-		}
-	}
-	m_pageOffsetsInitialized = true;
-}
-
-template <>
-inline void CGsPixelFormats::CPixelIndexor<CGsPixelFormats::STORAGEPSMT8>::BuildPageOffsetTable()
-{
-	if(m_pageOffsetsInitialized) return;
-
-	typedef CGsPixelFormats::STORAGEPSMT8 Storage;
-
-	for(uint32 y = 0; y < Storage::PAGEHEIGHT; y++)
-	{
-		for(uint32 x = 0; x < Storage::PAGEWIDTH; x++)
-		{
-			uint32 workX = x;
-			uint32 workY = y;
-
-			uint32 blockNum = Storage::m_nBlockSwizzleTable[workY / Storage::BLOCKHEIGHT][workX / Storage::BLOCKWIDTH];
-
-			workX %= Storage::BLOCKWIDTH;
-			workY %= Storage::BLOCKHEIGHT;
-
-			uint32 columnNum = (workY / Storage::COLUMNHEIGHT);
-
-			workY %= Storage::COLUMNHEIGHT;
-
-			uint32 table = (workY & 0x02) >> 1;
-			uint32 byte = (workX & 0x08) >> 2;
-			byte += (workY & 0x02) >> 1;
-			table ^= ((y / Storage::COLUMNHEIGHT) & 1);
-
-			workX &= 0x7;
-			workY &= 0x1;
-
-			uint32 offset = (blockNum * BLOCKSIZE) + (columnNum * COLUMNSIZE) + (Storage::m_nColumnWordTable[table][workY][workX] * 4) + byte;
-			m_pageOffsets[y][x] = offset;
-		}
-	}
-	m_pageOffsetsInitialized = true;
-}
@@ -71,8 +71,6 @@ void CCdvdfsv::CountTicks(uint32 ticks, CSifMan* sifMan)
 			return;
 		}
 
-		static const uint32 sectorSize = 0x800;
-
 		uint8* eeRam = nullptr;
 		if(auto sifManPs2 = dynamic_cast<CSifManPs2*>(sifMan))
 		{
@@ -84,10 +82,7 @@ void CCdvdfsv::CountTicks(uint32 ticks, CSifMan* sifMan)
 			if(m_opticalMedia != nullptr)
 			{
 				auto fileSystem = m_opticalMedia->GetFileSystem();
-				for(unsigned int i = 0; i < m_pendingReadCount; i++)
-				{
-					fileSystem->ReadBlock(m_pendingReadSector + i, eeRam + (m_pendingReadAddr + (i * sectorSize)));
-				}
+				fileSystem->ReadBlocks(m_pendingReadSector, m_pendingReadCount, eeRam + m_pendingReadAddr);
 			}
 		}
 		else if(m_pendingCommand == COMMAND_READIOP)
@@ -95,10 +90,7 @@ void CCdvdfsv::CountTicks(uint32 ticks, CSifMan* sifMan)
 			if(m_opticalMedia != nullptr)
 			{
 				auto fileSystem = m_opticalMedia->GetFileSystem();
-				for(unsigned int i = 0; i < m_pendingReadCount; i++)
-				{
-					fileSystem->ReadBlock(m_pendingReadSector + i, m_iopRam + (m_pendingReadAddr + (i * sectorSize)));
-				}
+				fileSystem->ReadBlocks(m_pendingReadSector, m_pendingReadCount, m_iopRam + m_pendingReadAddr);
 			}
 		}
 		else if(m_pendingCommand == COMMAND_STREAM_READ)
@@ -106,11 +98,8 @@ void CCdvdfsv::CountTicks(uint32 ticks, CSifMan* sifMan)
 			if(m_opticalMedia != nullptr)
 			{
 				auto fileSystem = m_opticalMedia->GetFileSystem();
-				for(unsigned int i = 0; i < m_pendingReadCount; i++)
-				{
-					fileSystem->ReadBlock(m_streamPos, eeRam + (m_pendingReadAddr + (i * sectorSize)));
-					m_streamPos++;
-				}
+				fileSystem->ReadBlocks(m_streamPos, m_pendingReadCount, eeRam + m_pendingReadAddr);
+				m_streamPos += m_pendingReadCount;
 			}
 		}
 		else if(m_pendingCommand == COMMAND_NDISKREADY)
@@ -127,6 +116,14 @@ void CCdvdfsv::CountTicks(uint32 ticks, CSifMan* sifMan)
 	}
 }
 
+void CCdvdfsv::PrefetchPendingRead(uint32 sector)
+{
+	//Data is only transferred when the command completes, start fetching it now
+	if(m_opticalMedia == nullptr) return;
+	auto fileSystem = m_opticalMedia->GetFileSystem();
+	fileSystem->PrefetchBlocks(sector, m_pendingReadCount);
+}
+
 void CCdvdfsv::SetOpticalMedia(COpticalMedia* opticalMedia)
 {
 	m_opticalMedia = opticalMedia;
@@ -413,6 +410,7 @@ void CCdvdfsv::Read(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize,
 	m_pendingReadSector = sector;
 	m_pendingReadCount = count;
 	m_pendingReadAddr = dstAddr & 0x1FFFFFFF;
+	PrefetchPendingRead(sector);
 }
 
 void CCdvdfsv::ReadIopMem(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, uint8* ram)
@@ -436,6 +434,7 @@ void CCdvdfsv::ReadIopMem(uint32* args, uint32 argsSize, uint32* ret, uint32 ret
 	m_pendingReadSector = sector;
 	m_pendingReadCount = count;
 	m_pendingReadAddr = dstAddr & 0x1FFFFFFF;
+	PrefetchPendingRead(sector);
 }
 
 bool CCdvdfsv::StreamCmd(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, uint8* ram)
@@ -469,6 +468,7 @@ bool CCdvdfsv::StreamCmd(uint32* args, uint32 argsSize, uint32* ret, uint32 retS
 		m_pendingReadSector = 0;
 		m_pendingReadCount = count;
 		m_pendingReadAddr = dstAddr & (PS2::EE_RAM_SIZE - 1);
+		PrefetchPendingRead(m_streamPos);
 		ret[0] = count;
 		immediateReply = false;
 		CLog::GetInstance().Print(LOG_NAME, "StreamRead(count = 0x%08X, dest = 0x%08X);\r\n",
@@ -535,7 +535,6 @@ void CCdvdfsv::ReadChain(uint32* args, uint32 argsSize, uint32* ret, uint32 retS
 	CLog::GetInstance().Print(LOG_NAME, "ReadChain(...);\r\n");
 
 	auto fileSystem = m_opticalMedia->GetFileSystem();
-	static const uint32 sectorSize = 0x800;
 
 	static const uint32 maxTupleCount = 64;
 	for(uint32 tuple = 0; tuple < maxTupleCount; tuple++)
@@ -549,10 +548,7 @@ void CCdvdfsv::ReadChain(uint32* args, uint32 argsSize, uint32* ret, uint32 retS
 			break;
 		}
 		assert((dstAddress & 1) == 0);
-		for(unsigned int sector = 0; sector < sectorCount; sector++)
-		{
-			fileSystem->ReadBlock(sectorPos + sector, ram + (dstAddress + (sector * sectorSize)));
-		}
+		fileSystem->ReadBlocks(sectorPos, sectorCount, ram + dstAddress);
 	}
 
 	//DBZ: Budokai Tenkaichi hangs in its loading screen if this command's result is not delayed.
@@ -66,6 +66,8 @@ namespace Iop
 		void ReadChain(uint32*, uint32, uint32*, uint32, uint8*);
 		void SearchFile(uint32*, uint32, uint32*, uint32, uint8*);
 
+		void PrefetchPendingRead(uint32);
+
 		CCdvdman& m_cdvdman;
 		uint8* m_iopRam = nullptr;
 		COpticalMedia* m_opticalMedia = nullptr;
@@ -14,6 +14,9 @@
 #define STATE_DISCCHANGED ("DiscChanged")
 #define STATE_PENDING_COMMAND ("PendingCommand")
 #define STATE_PENDING_COMMAND_DELAY ("PendingCommandDelay")
+#define STATE_PENDING_READ_SECTOR ("PendingReadSector")
+#define STATE_PENDING_READ_COUNT ("PendingReadCount")
+#define STATE_PENDING_READ_ADDR ("PendingReadAddr")
 
 #define FUNCTION_CDINIT "CdInit"
 #define FUNCTION_CDSTANDBY "CdStandby"
@@ -62,6 +65,9 @@ void CCdvdman::LoadState(Framework::CZipArchiveReader& archive)
 	m_discChanged = registerFile.GetRegister32(STATE_DISCCHANGED);
 	m_pendingCommand = static_cast<COMMAND>(registerFile.GetRegister32(STATE_PENDING_COMMAND));
 	m_pendingCommandDelay = registerFile.GetRegister32(STATE_PENDING_COMMAND_DELAY);
+	m_pendingReadSector = registerFile.GetRegister32(STATE_PENDING_READ_SECTOR);
+	m_pendingReadCount = registerFile.GetRegister32(STATE_PENDING_READ_COUNT);
+	m_pendingReadAddr = registerFile.GetRegister32(STATE_PENDING_READ_ADDR);
 }
 
 void CCdvdman::SaveState(Framework::CZipArchiveWriter& archive) const
@@ -72,6 +78,9 @@ void CCdvdman::SaveState(Framework::CZipArchiveWriter& archive) const
 	registerFile->SetRegister32(STATE_DISCCHANGED, m_discChanged);
 	registerFile->SetRegister32(STATE_PENDING_COMMAND, m_pendingCommand);
 	registerFile->SetRegister32(STATE_PENDING_COMMAND_DELAY, m_pendingCommandDelay);
+	registerFile->SetRegister32(STATE_PENDING_READ_SECTOR, m_pendingReadSector);
+	registerFile->SetRegister32(STATE_PENDING_READ_COUNT, m_pendingReadCount);
+	registerFile->SetRegister32(STATE_PENDING_READ_ADDR, m_pendingReadAddr);
 	archive.InsertFile(std::move(registerFile));
 }
 
@@ -407,6 +416,12 @@ void CCdvdman::CountTicks(uint32 ticks)
 			switch(m_pendingCommand)
 			{
 			case COMMAND_READ:
+				if(m_opticalMedia && (m_pendingReadCount != 0))
+				{
+					//Blocks were prefetched when the command started, this should only wait for them
+					auto fileSystem = m_opticalMedia->GetFileSystem();
+					fileSystem->ReadBlocks(m_pendingReadSector, m_pendingReadCount, m_ram + m_pendingReadAddr);
+				}
 				if(m_callbackPtr != 0)
 				{
 					m_bios.TriggerCallback(m_callbackPtr, CDVD_FUNCTION_READ);
@@ -470,16 +485,15 @@ uint32 CCdvdman::CdRead(uint32 startSector, uint32 sectorCount, uint32 bufferPtr
 		//Does that make sure it's 2048 byte mode?
 		assert(mode[2] == 0);
 	}
+	m_pendingReadCount = 0;
 	if(m_opticalMedia && (bufferPtr != 0))
 	{
-		uint8* buffer = &m_ram[bufferPtr & (PS2::IOP_RAM_SIZE - 1)];
-		static const uint32 sectorSize = 2048;
+		//Data is transferred when the command completes, start fetching it now
+		m_pendingReadSector = startSector;
+		m_pendingReadCount = sectorCount;
+		m_pendingReadAddr = bufferPtr & (PS2::IOP_RAM_SIZE - 1);
 		auto fileSystem = m_opticalMedia->GetFileSystem();
-		for(unsigned int i = 0; i < sectorCount; i++)
-		{
-			fileSystem->ReadBlock(startSector + i, buffer);
-			buffer += sectorSize;
-		}
+		fileSystem->PrefetchBlocks(startSector, sectorCount);
 	}
 	m_pendingCommand = COMMAND_READ;
 	m_pendingCommandDelay = COMMAND_READ_BASE_DELAY + (sectorCount * COMMAND_READ_SECTOR_DELAY);
@@ -626,11 +640,8 @@ uint32 CCdvdman::CdStRead(uint32 sectors, uint32 bufPtr, uint32 mode, uint32 err
 	CLog::GetInstance().Print(LOG_NAME, FUNCTION_CDSTREAD "(sectors = %d, bufPtr = 0x%08X, mode = %d, errPtr = 0x%08X);\r\n",
 	                          sectors, bufPtr, mode, errPtr);
 	auto fileSystem = m_opticalMedia->GetFileSystem();
-	for(unsigned int i = 0; i < sectors; i++)
-	{
-		fileSystem->ReadBlock(m_streamPos, m_ram + (bufPtr + (i * 0x800)));
-		m_streamPos++;
-	}
+	fileSystem->ReadBlocks(m_streamPos, sectors, m_ram + bufPtr);
+	m_streamPos += sectors;
 	if(errPtr != 0)
 	{
 		auto err = reinterpret_cast<uint32*>(m_ram + errPtr);
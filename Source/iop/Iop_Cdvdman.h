@@ -118,6 +118,9 @@ namespace Iop
 		uint32 m_streamBufferSize = 0;
 		COMMAND m_pendingCommand = COMMAND_NONE;
 		int32 m_pendingCommandDelay = 0;
+		uint32 m_pendingReadSector = 0;
+		uint32 m_pendingReadCount = 0;
+		uint32 m_pendingReadAddr = 0;
 	};
 
 	typedef std::shared_ptr<CCdvdman> CdvdmanPtr;
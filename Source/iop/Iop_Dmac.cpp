@@ -97,6 +97,32 @@ void CDmac::ResumeDma(unsigned int channelIdx)
 	channel->ResumeDma();
 }
 
+void CDmac::CountTicks(uint32 ticks)
+{
+	for(auto channel : m_channel)
+	{
+		if(!channel) continue;
+		channel->CountTicks(ticks);
+	}
+}
+
+DMA_CHANNEL_STATS CDmac::GetChannelStats(unsigned int channelId) const
+{
+	assert(channelId < MAX_CHANNEL);
+	auto channel = m_channel[channelId];
+	if(!channel) return DMA_CHANNEL_STATS();
+	return channel->GetStats();
+}
+
+void CDmac::ClearStats()
+{
+	for(auto channel : m_channel)
+	{
+		if(!channel) continue;
+		channel->ClearStats();
+	}
+}
+
 void CDmac::AssertLine(unsigned int line)
 {
 	if(line < 7)
@@ -60,6 +60,10 @@ namespace Iop
 
 		void ResumeDma(unsigned int);
 
+		void CountTicks(uint32);
+		DMA_CHANNEL_STATS GetChannelStats(unsigned int) const;
+		void ClearStats();
+
 		void AssertLine(unsigned int);
 		uint8* GetRam();
 
@@ -27,6 +27,8 @@ void CChannel::Reset()
 	m_CHCR <<= 0;
 	m_BCR <<= 0;
 	m_MADR = 0;
+	m_stalled = false;
+	ClearStats();
 }
 
 void CChannel::LoadState(Framework::CZipArchiveReader& archive)
@@ -63,6 +65,7 @@ void CChannel::ResumeDma()
 	assert(blocksTransfered <= m_BCR.ba);
 	m_BCR.ba -= blocksTransfered;
 	m_MADR += (m_BCR.bs * 4) * blocksTransfered;
+	m_stats.qwordCount += ((m_BCR.bs * 4) * blocksTransfered + 0x0F) / 0x10;
 
 	if(m_BCR.ba == 0)
 	{
@@ -70,6 +73,36 @@ void CChannel::ResumeDma()
 		m_CHCR.tr = 0;
 		m_dmac.AssertLine(m_intrLine - CIntc::LINE_DMA_BASE);
 	}
+
+	//Transfer is stalled if the device couldn't take everything
+	bool stalled = (m_CHCR.tr != 0);
+	if(m_stalled && (blocksTransfered != 0))
+	{
+		m_stats.resumeCount++;
+	}
+	if(stalled && (!m_stalled || (blocksTransfered != 0)))
+	{
+		m_stats.stallCount++;
+	}
+	m_stalled = stalled;
+}
+
+void CChannel::CountTicks(uint32 ticks)
+{
+	if(m_stalled && (m_CHCR.tr != 0))
+	{
+		m_stats.waitTicks += ticks;
+	}
+}
+
+const DMA_CHANNEL_STATS& CChannel::GetStats() const
+{
+	return m_stats;
+}
+
+void CChannel::ClearStats()
+{
+	m_stats = DMA_CHANNEL_STATS();
 }
 
 uint32 CChannel::ReadRegister(uint32 address)
@@ -2,6 +2,7 @@
 
 #include "Convertible.h"
 #include "Types.h"
+#include "../DmaStats.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
 #include <functional>
@@ -61,6 +62,10 @@ namespace Iop
 			uint32 ReadRegister(uint32);
 			void WriteRegister(uint32, uint32);
 
+			void CountTicks(uint32);
+			const DMA_CHANNEL_STATS& GetStats() const;
+			void ClearStats();
+
 		private:
 			ReceiveFunctionType m_receiveFunction;
 			CDmac& m_dmac;
@@ -70,6 +75,9 @@ namespace Iop
 			uint32 m_MADR;
 			BCR m_BCR;
 			CHCR m_CHCR;
+
+			DMA_CHANNEL_STATS m_stats;
+			bool m_stalled = false;
 		};
 	}
 }
@@ -0,0 +1,128 @@
+#include "Iop_SpuAdpcm.h"
+#include <climits>
+#include <algorithm>
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+#include <emmintrin.h>
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace Iop;
+
+//Nibbles of the whole block, including the 2 header bytes
+#define UNPACKED_SAMPLES (SpuAdpcm::BLOCK_SIZE * 2)
+#define HEADER_SAMPLES (UNPACKED_SAMPLES - SpuAdpcm::BLOCK_SAMPLES)
+
+// clang-format off
+//Table is 16 entries long to prevent reading indeterminate
+//values if predictNumber is greater or equal to 5.
+//According to some sources, entries at 5 and beyond contain 0 on real hardware
+static const int32 g_predictorTable[16][2] =
+{
+	{0, 0},
+	{60, 0},
+	{115, -52},
+	{98, -55},
+	{122, -60},
+};
+// clang-format on
+
+static void Filter(const int16* unpackedSamples, uint8 predictNumber, int16* output, int32& s1, int32& s2)
+{
+	int32 predictor0 = g_predictorTable[predictNumber][0];
+	int32 predictor1 = g_predictorTable[predictNumber][1];
+	int32 prevS1 = s1;
+	int32 prevS2 = s2;
+	for(unsigned int i = 0; i < SpuAdpcm::BLOCK_SAMPLES; i++)
+	{
+		int32 currentValue = static_cast<int32>(unpackedSamples[i]) * 64;
+		currentValue += (prevS1 * predictor0) / 64;
+		currentValue += (prevS2 * predictor1) / 64;
+		prevS2 = prevS1;
+		prevS1 = currentValue;
+		int32 result = (currentValue + 32) / 64;
+		result = std::clamp<int32>(result, SHRT_MIN, SHRT_MAX);
+		output[i] = static_cast<int16>(result);
+	}
+	s1 = prevS1;
+	s2 = prevS2;
+}
+
+void SpuAdpcm::DecodeBlockScalar(const uint8* block, int16* output, int32& s1, int32& s2)
+{
+	uint8 shiftFactor = block[0] & 0xF;
+	uint8 predictNumber = block[0] >> 4;
+
+	int16 unpackedSamples[BLOCK_SAMPLES];
+	for(unsigned int i = 0; i < (BLOCK_SAMPLES / 2); i++)
+	{
+		uint8 sampleByte = block[i + 2];
+		int16 firstSample = ((sampleByte & 0x0F) << 12);
+		int16 secondSample = ((sampleByte & 0xF0) << 8);
+		unpackedSamples[(i * 2) + 0] = firstSample >> shiftFactor;
+		unpackedSamples[(i * 2) + 1] = secondSample >> shiftFactor;
+	}
+
+	Filter(unpackedSamples, predictNumber, output, s1, s2);
+}
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+
+void SpuAdpcm::DecodeBlock(const uint8* block, int16* output, int32& s1, int32& s2)
+{
+	uint8 shiftFactor = block[0] & 0xF;
+	uint8 predictNumber = block[0] >> 4;
+
+	//Each byte is duplicated in a 16-bit lane, low nibble is then shifted to the top
+	//and high nibble is already there once the rest is masked out
+	__m128i blockBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+	__m128i shift = _mm_cvtsi32_si128(shiftFactor);
+	__m128i highNibbleMask = _mm_set1_epi16(static_cast<int16>(0xF000));
+
+	alignas(16) int16 unpackedSamples[UNPACKED_SAMPLES];
+	auto unpackedSamplesVector = reinterpret_cast<__m128i*>(unpackedSamples);
+	for(unsigned int i = 0; i < 2; i++)
+	{
+		__m128i bytes = (i == 0) ? _mm_unpacklo_epi8(blockBytes, blockBytes) : _mm_unpackhi_epi8(blockBytes, blockBytes);
+		__m128i lowNibbles = _mm_slli_epi16(bytes, 12);
+		__m128i highNibbles = _mm_and_si128(bytes, highNibbleMask);
+		_mm_store_si128(unpackedSamplesVector + (i * 2) + 0, _mm_sra_epi16(_mm_unpacklo_epi16(lowNibbles, highNibbles), shift));
+		_mm_store_si128(unpackedSamplesVector + (i * 2) + 1, _mm_sra_epi16(_mm_unpackhi_epi16(lowNibbles, highNibbles), shift));
+	}
+
+	Filter(unpackedSamples + HEADER_SAMPLES, predictNumber, output, s1, s2);
+}
+
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+
+void SpuAdpcm::DecodeBlock(const uint8* block, int16* output, int32& s1, int32& s2)
+{
+	uint8 shiftFactor = block[0] & 0xF;
+	uint8 predictNumber = block[0] >> 4;
+
+	uint8x16_t blockBytes = vld1q_u8(block);
+	int16x8_t shift = vdupq_n_s16(static_cast<int16>(-shiftFactor));
+
+	alignas(16) int16 unpackedSamples[UNPACKED_SAMPLES];
+	for(unsigned int i = 0; i < 2; i++)
+	{
+		uint16x8_t bytes = vmovl_u8((i == 0) ? vget_low_u8(blockBytes) : vget_high_u8(blockBytes));
+		int16x8_t lowNibbles = vreinterpretq_s16_u16(vshlq_n_u16(bytes, 12));
+		int16x8_t highNibbles = vreinterpretq_s16_u16(vshlq_n_u16(vandq_u16(bytes, vdupq_n_u16(0xF0)), 8));
+		int16x8x2_t samples = vzipq_s16(lowNibbles, highNibbles);
+		vst1q_s16(unpackedSamples + (i * 16) + 0, vshlq_s16(samples.val[0], shift));
+		vst1q_s16(unpackedSamples + (i * 16) + 8, vshlq_s16(samples.val[1], shift));
+	}
+
+	Filter(unpackedSamples + HEADER_SAMPLES, predictNumber, output, s1, s2);
+}
+
+#else
+
+void SpuAdpcm::DecodeBlock(const uint8* block, int16* output, int32& s1, int32& s2)
+{
+	DecodeBlockScalar(block, output, s1, s2);
+}
+
+#endif
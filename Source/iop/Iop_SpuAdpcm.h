@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Types.h"
+
+//Decodes SPU ADPCM blocks (16 bytes, 28 samples). Nibbles are unpacked and shifted
+//with SIMD, the prediction filter depends on the previous samples and stays scalar.
+//SIMD versions produce exactly the same output as the scalar version.
+
+namespace Iop
+{
+	namespace SpuAdpcm
+	{
+		enum
+		{
+			BLOCK_SIZE = 0x10,
+			BLOCK_SAMPLES = 28,
+		};
+
+		//s1 and s2 hold the filter state (last two filter outputs) and are updated
+		void DecodeBlock(const uint8*, int16*, int32& s1, int32& s2);
+		void DecodeBlockScalar(const uint8*, int16*, int32& s1, int32& s2);
+	}
+}
@@ -9,6 +9,8 @@
 #include "../states/RegisterStateUtils.h"
 #include "../states/RegisterStateFile.h"
 #include "Iop_SpuBase.h"
+#include "Iop_SpuAdpcm.h"
+#include "Iop_SpuReverb.h"
 
 using namespace Iop;
 
@@ -61,6 +63,7 @@ using namespace Iop;
 #define STATE_SAMPLEREADER_REGS_ENDFLAG ("SR_EndFlag")
 #define STATE_SAMPLEREADER_REGS_DIDCHANGEREPEAT ("SR_DidChangeRepeat")
 #define STATE_SAMPLEREADER_REGS_BUFFER_FORMAT ("SR_Buffer%d")
+#define STATE_SAMPLEREADER_REGS_PREVIOUSSAMPLE ("SR_PreviousSample")
 
 #define STATE_IRQWATCHER_REGS_PATH ("iop_spu/spu_irqwatcher.xml")
 
@@ -332,6 +335,11 @@ void CSpuBase::SetReverbEnabled(bool enabled)
 	m_reverbEnabled = enabled;
 }
 
+void CSpuBase::SetInterpolation(SpuVoiceMixer::INTERPOLATION interpolation)
+{
+	m_interpolation = interpolation;
+}
+
 uint16 CSpuBase::GetControl() const
 {
 	return m_ctrl;
@@ -691,122 +699,134 @@ void CSpuBase::MixSamples(int32 inputSample, int32 volumeLevel, int16* output)
 	*output = static_cast<int16>(resultSample);
 }
 
-void CSpuBase::Render(int16* samples, unsigned int sampleCount)
+bool CSpuBase::UpdateVoiceBlock(unsigned int channelIndex, SpuVoiceMixer::VOICE_BLOCK& block, unsigned int tickCount)
 {
-	bool updateReverb = m_reverbEnabled && (m_ctrl & CONTROL_REVERB) && (m_reverbWorkAddrStart < m_reverbWorkAddrEnd);
-	bool irqEnabled = (m_ctrl & CONTROL_IRQ);
-
-	int16* samplesBase = samples;
-	assert((sampleCount & 0x01) == 0);
-	unsigned int ticks = sampleCount / 2;
-	memset(samples, 0, sizeof(int16) * sampleCount);
-
-	for(unsigned int j = 0; j < ticks; j++)
+	auto& channel(m_channel[channelIndex]);
+	auto& reader(m_reader[channelIndex]);
+	bool audible = false;
+	for(unsigned int j = 0; j < tickCount; j++)
 	{
-		int16 reverbSample[2] = {};
-		//Update channels
-		for(unsigned int i = 0; i < 24; i++)
+		if(channel.status == KEY_ON)
 		{
-			auto& channel(m_channel[i]);
-			auto& reader(m_reader[i]);
-			if(channel.status == KEY_ON)
+			reader.SetParamsRead(channel.address, channel.repeat);
+			reader.ClearEndFlag();
+			channel.status = ATTACK;
+			channel.adsrVolume = 0;
+		}
+		else
+		{
+			if(reader.IsDone())
 			{
-				reader.SetParamsRead(channel.address, channel.repeat);
-				reader.ClearEndFlag();
-				channel.status = ATTACK;
+				channel.status = STOPPED;
 				channel.adsrVolume = 0;
+				reader.ClearIsDone();
 			}
-			else
+			if(reader.DidChangeRepeat() && !channel.repeatSet)
 			{
-				if(reader.IsDone())
-				{
-					channel.status = STOPPED;
-					channel.adsrVolume = 0;
-					reader.ClearIsDone();
-				}
-				if(reader.DidChangeRepeat() && !channel.repeatSet)
-				{
-					channel.repeat = reader.GetRepeat();
-					reader.ClearDidChangeRepeat();
-				}
-				//Update repeat in case it has been changed externally (needed for FFX)
-				reader.SetRepeat(channel.repeat);
+				channel.repeat = reader.GetRepeat();
+				reader.ClearDidChangeRepeat();
 			}
+			//Update repeat in case it has been changed externally (needed for FFX)
+			reader.SetRepeat(channel.repeat);
+		}
+
+		reader.GetSample(block, j);
 
-			int32 readSample = reader.GetSample();
-			channel.current = reader.GetCurrent();
+		UpdateAdsr(channel);
+		channel.volumeLeftAbs = ComputeChannelVolume(channel.volumeLeft, channel.volumeLeftAbs);
+		channel.volumeRightAbs = ComputeChannelVolume(channel.volumeRight, channel.volumeRightAbs);
 
-			UpdateAdsr(channel);
-			channel.volumeLeftAbs = ComputeChannelVolume(channel.volumeLeft, channel.volumeLeftAbs);
-			channel.volumeRightAbs = ComputeChannelVolume(channel.volumeRight, channel.volumeRightAbs);
+		block.adsrVolumes[j] = static_cast<int16>(channel.adsrVolume >> 16);
+		block.volumesLeft[j] = static_cast<int16>(channel.volumeLeftAbs >> 16);
+		block.volumesRight[j] = static_cast<int16>(channel.volumeRightAbs >> 16);
+
+		audible |= (block.adsrVolumes[j] != 0) && ((block.volumesLeft[j] | block.volumesRight[j]) != 0);
+	}
+	channel.current = reader.GetCurrent();
+	return audible;
+}
 
-			if(readSample == 0) continue;
+void CSpuBase::Render(int16* samples, unsigned int sampleCount)
+{
+	bool updateReverb = m_reverbEnabled && (m_ctrl & CONTROL_REVERB) && (m_reverbWorkAddrStart < m_reverbWorkAddrEnd);
+	bool irqEnabled = (m_ctrl & CONTROL_IRQ);
 
-			//Mix in adsrVolume
-			int32 inputSample = (readSample * static_cast<int32>(channel.adsrVolume >> 16)) / static_cast<int32>(MAX_ADSR_VOLUME >> 16);
+	int16* samplesBase = samples;
+	assert((sampleCount & 0x01) == 0);
+	unsigned int ticks = sampleCount / 2;
+	memset(samples, 0, sizeof(int16) * sampleCount);
 
-			if(inputSample == 0) continue;
+	//Voices are updated one after the other over a block of ticks. Each voice only
+	//depends on its own state, so this produces the same output as updating all voices
+	//at every tick, as long as samples are mixed in the same order.
+	SpuVoiceMixer::VOICE_BLOCK voiceBlock;
+	int16 reverbSamples[SpuVoiceMixer::BLOCK_SAMPLES * 2];
 
-			int32 volumeLeft = channel.volumeLeftAbs >> 16;
-			int32 volumeRight = channel.volumeRightAbs >> 16;
+	for(unsigned int blockTick = 0; blockTick < ticks; blockTick += SpuVoiceMixer::BLOCK_SAMPLES)
+	{
+		unsigned int blockTicks = std::min<unsigned int>(ticks - blockTick, SpuVoiceMixer::BLOCK_SAMPLES);
+		int16* blockSamples = samples;
+		memset(reverbSamples, 0, sizeof(reverbSamples));
 
-			MixSamples(inputSample, volumeLeft, samples + 0);
-			MixSamples(inputSample, volumeRight, samples + 1);
+		//Update channels
+		for(unsigned int i = 0; i < MAX_CHANNEL; i++)
+		{
+			if(!UpdateVoiceBlock(i, voiceBlock, blockTicks)) continue;
 
 			//Mix in reverb if enabled for this channel
-			if(updateReverb && (m_channelReverb.f & (1 << i)))
-			{
-				MixSamples(inputSample, volumeLeft, reverbSample + 0);
-				MixSamples(inputSample, volumeRight, reverbSample + 1);
-			}
+			bool mixReverb = updateReverb && (m_channelReverb.f & (1 << i));
+			SpuVoiceMixer::MixVoice(voiceBlock, blockTicks, samples, mixReverb ? reverbSamples : nullptr, m_interpolation);
 		}
 
-		if(!m_blockReader.CanReadSamples() && (m_blockWritePtr == SOUND_INPUT_DATA_SIZE))
+		for(unsigned int j = 0; j < blockTicks; j++)
 		{
-			//We're ready to consume some data
-			m_blockReader.FillBlock(m_ram + m_soundInputDataAddr);
-			m_blockWritePtr = 0;
-		}
+			if(!m_blockReader.CanReadSamples() && (m_blockWritePtr == SOUND_INPUT_DATA_SIZE))
+			{
+				//We're ready to consume some data
+				m_blockReader.FillBlock(m_ram + m_soundInputDataAddr);
+				m_blockWritePtr = 0;
+			}
 
-		if(m_blockReader.CanReadSamples())
-		{
-			int32 blockSamples[2] = {};
-			m_blockReader.GetSamples(blockSamples);
+			if(m_blockReader.CanReadSamples())
+			{
+				int32 blockSamples[2] = {};
+				m_blockReader.GetSamples(blockSamples);
 
-			MixSamples(blockSamples[0], 0x3FFF, samples + 0);
-			MixSamples(blockSamples[1], 0x3FFF, samples + 1);
-		}
+				MixSamples(blockSamples[0], 0x3FFF, samples + 0);
+				MixSamples(blockSamples[1], 0x3FFF, samples + 1);
+			}
 
-		//Simulate SPU CORE0 writing its output in RAM and check for potential interrupts
-		if(m_spuNumber == 0)
-		{
-			if(irqEnabled)
+			//Simulate SPU CORE0 writing its output in RAM and check for potential interrupts
+			if(m_spuNumber == 0)
 			{
-				//TODO: Check which core is responsible for which area
-				if(m_irqAddr == (CORE0_SIN_LEFT + m_core0OutputOffset))
-				{
-					m_irqPending = true;
-				}
-				else if(m_irqAddr == (CORE1_SIN_LEFT + m_core0OutputOffset))
+				if(irqEnabled)
 				{
-					m_irqPending = true;
-				}
-				else if(m_irqAddr == (CORE1_SIN_RIGHT + m_core0OutputOffset))
-				{
-					m_irqPending = true;
+					//TODO: Check which core is responsible for which area
+					if(m_irqAddr == (CORE0_SIN_LEFT + m_core0OutputOffset))
+					{
+						m_irqPending = true;
+					}
+					else if(m_irqAddr == (CORE1_SIN_LEFT + m_core0OutputOffset))
+					{
+						m_irqPending = true;
+					}
+					else if(m_irqAddr == (CORE1_SIN_RIGHT + m_core0OutputOffset))
+					{
+						m_irqPending = true;
+					}
 				}
+				m_core0OutputOffset += 2;
+				m_core0OutputOffset &= (CORE0_OUTPUT_SIZE - 1);
 			}
-			m_core0OutputOffset += 2;
-			m_core0OutputOffset &= (CORE0_OUTPUT_SIZE - 1);
+
+			samples += 2;
 		}
 
-		//Update reverb
+		//Reverb output is mixed last, same as if it was updated at every tick
 		if(updateReverb)
 		{
-			UpdateReverb(reverbSample, samples);
+			UpdateReverb(reverbSamples, blockSamples, blockTicks);
 		}
-
-		samples += 2;
 	}
 
 	if(irqEnabled && m_irqWatcher->HasPendingIrq(m_spuNumber))
@@ -831,42 +851,6 @@ uint32 CSpuBase::GetAdsrDelta(unsigned int index) const
 	return m_adsrLogTable[index + 32];
 }
 
-float CSpuBase::GetReverbSample(uint32 address) const
-{
-	uint32 absoluteAddress = m_reverbCurrAddr + address;
-	while(absoluteAddress >= m_reverbWorkAddrEnd)
-	{
-		absoluteAddress -= m_reverbWorkAddrEnd;
-		absoluteAddress += m_reverbWorkAddrStart;
-	}
-	return static_cast<float>(*reinterpret_cast<int16*>(m_ram + absoluteAddress));
-}
-
-void CSpuBase::SetReverbSample(uint32 address, float value)
-{
-	uint32 absoluteAddress = m_reverbCurrAddr + address;
-	while(absoluteAddress >= m_reverbWorkAddrEnd)
-	{
-		absoluteAddress -= m_reverbWorkAddrEnd;
-		absoluteAddress += m_reverbWorkAddrStart;
-	}
-	value = std::max<float>(value, SHRT_MIN);
-	value = std::min<float>(value, SHRT_MAX);
-	int16 intValue = static_cast<int16>(value);
-	*reinterpret_cast<int16*>(m_ram + absoluteAddress) = intValue;
-}
-
-uint32 CSpuBase::GetReverbOffset(unsigned int registerId) const
-{
-	return m_reverb[registerId];
-}
-
-float CSpuBase::GetReverbCoef(unsigned int registerId) const
-{
-	int16 value = static_cast<int16>(m_reverb[registerId]);
-	return static_cast<float>(value) / static_cast<float>(0x8000);
-}
-
 void CSpuBase::UpdateAdsr(CHANNEL& channel)
 {
 	static const unsigned int logIndex[8] = {0, 4, 6, 8, 9, 10, 11, 12};
@@ -974,153 +958,88 @@ void CSpuBase::UpdateAdsr(CHANNEL& channel)
 	channel.adsrVolume = static_cast<uint32>(currentAdsrLevel);
 }
 
-void CSpuBase::UpdateReverb(int16 reverbSample[2], int16* samples)
+void CSpuBase::UpdateReverb(const int16* reverbSamples, int16* samples, unsigned int ticks)
 {
-	//Feed samples to FIR filter
-	if(m_reverbTicks & 1)
-	{
-		//IIR_INPUT_A0 = buffer[IIR_SRC_A0] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
-		//IIR_INPUT_A1 = buffer[IIR_SRC_A1] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
-		//IIR_INPUT_B0 = buffer[IIR_SRC_B1] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
-		//IIR_INPUT_B1 = buffer[IIR_SRC_B0] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
-
-		float input_sample_l = static_cast<float>(reverbSample[0]) * 0.5f;
-		float input_sample_r = static_cast<float>(reverbSample[1]) * 0.5f;
-
-		float irr_coef = GetReverbCoef(IIR_COEF);
-		float in_coef_l = GetReverbCoef(IN_COEF_L);
-		float in_coef_r = GetReverbCoef(IN_COEF_R);
-
-		float iir_input_a0 = GetReverbSample(GetReverbOffset(IIR_SRC_A0)) * irr_coef + input_sample_l * in_coef_l;
-		float iir_input_a1 = GetReverbSample(GetReverbOffset(IIR_SRC_A1)) * irr_coef + input_sample_r * in_coef_r;
-		float iir_input_b0 = GetReverbSample(GetReverbOffset(IIR_SRC_B1)) * irr_coef + input_sample_l * in_coef_l;
-		float iir_input_b1 = GetReverbSample(GetReverbOffset(IIR_SRC_B0)) * irr_coef + input_sample_r * in_coef_r;
-
-		//IIR_A0 = IIR_INPUT_A0 * IIR_ALPHA + buffer[IIR_DEST_A0] * (1.0 - IIR_ALPHA);
-		//IIR_A1 = IIR_INPUT_A1 * IIR_ALPHA + buffer[IIR_DEST_A1] * (1.0 - IIR_ALPHA);
-		//IIR_B0 = IIR_INPUT_B0 * IIR_ALPHA + buffer[IIR_DEST_B0] * (1.0 - IIR_ALPHA);
-		//IIR_B1 = IIR_INPUT_B1 * IIR_ALPHA + buffer[IIR_DEST_B1] * (1.0 - IIR_ALPHA);
-
-		float iir_alpha = GetReverbCoef(IIR_ALPHA);
-
-		float iir_a0 = iir_input_a0 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_A0)) * (1.0f - iir_alpha);
-		float iir_a1 = iir_input_a1 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_A1)) * (1.0f - iir_alpha);
-		float iir_b0 = iir_input_b0 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_B0)) * (1.0f - iir_alpha);
-		float iir_b1 = iir_input_b1 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_B1)) * (1.0f - iir_alpha);
-
-		//buffer[IIR_DEST_A0 + 1sample] = IIR_A0;
-		//buffer[IIR_DEST_A1 + 1sample] = IIR_A1;
-		//buffer[IIR_DEST_B0 + 1sample] = IIR_B0;
-		//buffer[IIR_DEST_B1 + 1sample] = IIR_B1;
-
-		SetReverbSample(GetReverbOffset(IIR_DEST_A0) + 2, iir_a0);
-		SetReverbSample(GetReverbOffset(IIR_DEST_A1) + 2, iir_a1);
-		SetReverbSample(GetReverbOffset(IIR_DEST_B0) + 2, iir_b0);
-		SetReverbSample(GetReverbOffset(IIR_DEST_B1) + 2, iir_b1);
-
-		//ACC0 = buffer[ACC_SRC_A0] * ACC_COEF_A +
-		//	   buffer[ACC_SRC_B0] * ACC_COEF_B +
-		//	   buffer[ACC_SRC_C0] * ACC_COEF_C +
-		//	   buffer[ACC_SRC_D0] * ACC_COEF_D;
-		//ACC1 = buffer[ACC_SRC_A1] * ACC_COEF_A +
-		//	   buffer[ACC_SRC_B1] * ACC_COEF_B +
-		//	   buffer[ACC_SRC_C1] * ACC_COEF_C +
-		//	   buffer[ACC_SRC_D1] * ACC_COEF_D;
-
-		float acc_coef_a = GetReverbCoef(ACC_COEF_A);
-		float acc_coef_b = GetReverbCoef(ACC_COEF_B);
-		float acc_coef_c = GetReverbCoef(ACC_COEF_C);
-		float acc_coef_d = GetReverbCoef(ACC_COEF_D);
-
-		float acc0 =
-		    GetReverbSample(GetReverbOffset(ACC_SRC_A0)) * acc_coef_a +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_B0)) * acc_coef_b +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_C0)) * acc_coef_c +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_D0)) * acc_coef_d;
-
-		float acc1 =
-		    GetReverbSample(GetReverbOffset(ACC_SRC_A1)) * acc_coef_a +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_B1)) * acc_coef_b +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_C1)) * acc_coef_c +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_D1)) * acc_coef_d;
-
-		//FB_A0 = buffer[MIX_DEST_A0 - FB_SRC_A];
-		//FB_A1 = buffer[MIX_DEST_A1 - FB_SRC_A];
-		//FB_B0 = buffer[MIX_DEST_B0 - FB_SRC_B];
-		//FB_B1 = buffer[MIX_DEST_B1 - FB_SRC_B];
-
-		float fb_a0 = GetReverbSample(GetReverbOffset(MIX_DEST_A0) - GetReverbOffset(FB_SRC_A));
-		float fb_a1 = GetReverbSample(GetReverbOffset(MIX_DEST_A1) - GetReverbOffset(FB_SRC_A));
-		float fb_b0 = GetReverbSample(GetReverbOffset(MIX_DEST_B0) - GetReverbOffset(FB_SRC_B));
-		float fb_b1 = GetReverbSample(GetReverbOffset(MIX_DEST_B1) - GetReverbOffset(FB_SRC_B));
-
-		//buffer[MIX_DEST_A0] = ACC0 - FB_A0 * FB_ALPHA;
-		//buffer[MIX_DEST_A1] = ACC1 - FB_A1 * FB_ALPHA;
-		//buffer[MIX_DEST_B0] = (FB_ALPHA * ACC0) - FB_A0 * (FB_ALPHA^0x8000) - FB_B0 * FB_X;
-		//buffer[MIX_DEST_B1] = (FB_ALPHA * ACC1) - FB_A1 * (FB_ALPHA^0x8000) - FB_B1 * FB_X;
-
-		float fb_alpha = GetReverbCoef(FB_ALPHA);
-		float fb_x = GetReverbCoef(FB_X);
-
-		SetReverbSample(GetReverbOffset(MIX_DEST_A0), acc0 - fb_a0 * fb_alpha);
-		SetReverbSample(GetReverbOffset(MIX_DEST_A1), acc1 - fb_a1 * fb_alpha);
-		SetReverbSample(GetReverbOffset(MIX_DEST_B0), (fb_alpha * acc0) - fb_a0 * -fb_alpha - fb_b0 * fb_x);
-		SetReverbSample(GetReverbOffset(MIX_DEST_B1), (fb_alpha * acc1) - fb_a1 * -fb_alpha - fb_b1 * fb_x);
-
-		m_reverbCurrAddr += 2;
-		if(m_reverbCurrAddr >= m_reverbWorkAddrEnd)
-		{
-			m_reverbCurrAddr = m_reverbWorkAddrStart;
-		}
-	}
-
-	if(m_reverbWorkAddrStart != 0)
-	{
-		float sampleL = 0.333f * (GetReverbSample(GetReverbOffset(MIX_DEST_A0)) + GetReverbSample(GetReverbOffset(MIX_DEST_B0)));
-		float sampleR = 0.333f * (GetReverbSample(GetReverbOffset(MIX_DEST_A1)) + GetReverbSample(GetReverbOffset(MIX_DEST_B1)));
-
-		{
-			int16* output = samples + 0;
-			int32 resultSample = static_cast<int32>(sampleL) + static_cast<int32>(*output);
-			resultSample = std::max<int32>(resultSample, SHRT_MIN);
-			resultSample = std::min<int32>(resultSample, SHRT_MAX);
-			*output = static_cast<int16>(resultSample);
-		}
+	SpuReverb::STATE state;
+	state.ram = m_ram;
+	state.params = m_reverb;
+	state.workAddrStart = m_reverbWorkAddrStart;
+	state.workAddrEnd = m_reverbWorkAddrEnd;
+	state.currAddr = m_reverbCurrAddr;
+	state.ticks = m_reverbTicks;
 
-		{
-			int16* output = samples + 1;
-			int32 resultSample = static_cast<int32>(sampleR) + static_cast<int32>(*output);
-			resultSample = std::max<int32>(resultSample, SHRT_MIN);
-			resultSample = std::min<int32>(resultSample, SHRT_MAX);
-			*output = static_cast<int16>(resultSample);
-		}
-	}
+	SpuReverb::Process(state, reverbSamples, samples, ticks);
 
-	m_reverbTicks++;
+	m_reverbCurrAddr = state.currAddr;
+	m_reverbTicks = state.ticks;
 }
 
 ///////////////////////////////////////////////////////
 // CSpuSampleCache
 ///////////////////////////////////////////////////////
 
-const CSpuSampleCache::ITEM* CSpuSampleCache::GetItem(const KEY& key) const
+CSpuSampleCache::CSpuSampleCache()
+    : m_slots(SLOT_COUNT)
+    , m_pageGenerations(PAGE_COUNT)
 {
-	auto range = m_cache.equal_range(key.address);
-	for(auto itemIterator = range.first; itemIterator != range.second; itemIterator++)
+}
+
+const CSpuSampleCache::ITEM* CSpuSampleCache::GetItem(const KEY& key)
+{
+	uint32 slotIndex = GetSlotIndex(key);
+	for(uint32 i = 0; i < PROBE_LENGTH; i++)
 	{
-		const auto& item = itemIterator->second;
-		if((item.inS1 == key.s1) && (item.inS2 == key.s2))
+		auto& slot = m_slots[(slotIndex + i) & (SLOT_COUNT - 1)];
+		if(IsSlotValid(slot) && (slot.address == key.address) && (slot.item.inS1 == key.s1) && (slot.item.inS2 == key.s2))
 		{
-			return &item;
+			slot.referenced = true;
+			m_hitCount.store(m_hitCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			return &slot.item;
 		}
 	}
+	m_missCount.store(m_missCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 	return nullptr;
 }
 
 CSpuSampleCache::ITEM& CSpuSampleCache::RegisterItem(const KEY& key)
 {
-	auto result = m_cache.emplace(std::make_pair(key.address, ITEM()));
-	auto& item = result->second;
+	uint32 slotIndex = GetSlotIndex(key);
+	SLOT* targetSlot = nullptr;
+	for(uint32 i = 0; i < PROBE_LENGTH; i++)
+	{
+		auto& slot = m_slots[(slotIndex + i) & (SLOT_COUNT - 1)];
+		if(!IsSlotValid(slot))
+		{
+			targetSlot = &slot;
+			break;
+		}
+	}
+
+	if(!targetSlot)
+	{
+		//All slots are taken, give recently used ones a second chance. Second pass is
+		//guaranteed to find a slot since the first one clears all reference bits.
+		for(uint32 i = 0; i < (PROBE_LENGTH * 2); i++)
+		{
+			uint32 probeIndex = (m_clockHand + i) % PROBE_LENGTH;
+			auto& slot = m_slots[(slotIndex + probeIndex) & (SLOT_COUNT - 1)];
+			if(slot.referenced)
+			{
+				slot.referenced = false;
+				continue;
+			}
+			targetSlot = &slot;
+			m_clockHand = (probeIndex + 1) % PROBE_LENGTH;
+			break;
+		}
+	}
+
+	assert(targetSlot);
+	targetSlot->used = true;
+	targetSlot->referenced = false;
+	targetSlot->address = key.address;
+	targetSlot->pageGeneration = m_pageGenerations[GetPageIndex(key.address)];
+	auto& item = targetSlot->item;
 	item.inS1 = key.s1;
 	item.inS2 = key.s2;
 	return item;
@@ -1128,14 +1047,61 @@ CSpuSampleCache::ITEM& CSpuSampleCache::RegisterItem(const KEY& key)
 
 void CSpuSampleCache::Clear()
 {
-	m_cache.clear();
+	for(auto& slot : m_slots)
+	{
+		slot.used = false;
+		slot.referenced = false;
+	}
 }
 
 void CSpuSampleCache::ClearRange(uint32 address, uint32 size)
 {
-	auto lowerBound = m_cache.lower_bound(address);
-	auto upperBound = m_cache.upper_bound(address + size);
-	m_cache.erase(lowerBound, upperBound);
+	//Entries are only checked against the page of the block's first byte,
+	//also invalidate the page of a block that starts before the range and overlaps it
+	static const uint32 blockSize = 0x10;
+	uint32 beginAddress = (address >= blockSize) ? (address - (blockSize - 1)) : 0;
+	uint32 firstPage = beginAddress >> PAGE_SHIFT;
+	uint32 lastPage = (address + size) >> PAGE_SHIFT;
+	uint32 pageCount = std::min<uint32>(lastPage - firstPage + 1, PAGE_COUNT);
+	for(uint32 i = 0; i < pageCount; i++)
+	{
+		m_pageGenerations[(firstPage + i) & (PAGE_COUNT - 1)]++;
+	}
+}
+
+CSpuSampleCache::STATS CSpuSampleCache::GetStats() const
+{
+	STATS stats;
+	stats.hitCount = m_hitCount.load(std::memory_order_relaxed) - m_statsBase.hitCount;
+	stats.missCount = m_missCount.load(std::memory_order_relaxed) - m_statsBase.missCount;
+	return stats;
+}
+
+void CSpuSampleCache::ClearStats()
+{
+	m_statsBase.hitCount = m_hitCount.load(std::memory_order_relaxed);
+	m_statsBase.missCount = m_missCount.load(std::memory_order_relaxed);
+}
+
+uint32 CSpuSampleCache::GetSlotIndex(const KEY& key)
+{
+	uint32 hash = (key.address >> 3) * 0x9E3779B1;
+	hash ^= static_cast<uint32>(key.s1) * 0x85EBCA77;
+	hash ^= static_cast<uint32>(key.s2) * 0xC2B2AE3D;
+	hash ^= hash >> 15;
+	hash *= 0x2C1B3C6D;
+	hash ^= hash >> 12;
+	return hash & (SLOT_COUNT - 1);
+}
+
+uint32 CSpuSampleCache::GetPageIndex(uint32 address)
+{
+	return (address >> PAGE_SHIFT) & (PAGE_COUNT - 1);
+}
+
+bool CSpuSampleCache::IsSlotValid(const SLOT& slot) const
+{
+	return slot.used && (slot.pageGeneration == m_pageGenerations[GetPageIndex(slot.address)]);
 }
 
 ///////////////////////////////////////////////////////
@@ -1210,6 +1176,7 @@ void CSpuBase::CSampleReader::Reset()
 	m_nextSampleAddr = 0;
 	m_repeatAddr = 0;
 	memset(m_buffer, 0, sizeof(m_buffer));
+	m_previousSample = 0;
 	m_pitch = 0;
 	m_srcSampleIdx = 0;
 	m_srcSamplingRate = 0;
@@ -1260,6 +1227,7 @@ void CSpuBase::CSampleReader::LoadState(const CRegisterState& channelState)
 	m_endFlag = channelState.GetRegister32(STATE_SAMPLEREADER_REGS_ENDFLAG) != 0;
 	m_didChangeRepeat = channelState.GetRegister32(STATE_SAMPLEREADER_REGS_DIDCHANGEREPEAT) != 0;
 	RegisterStateUtils::ReadArray(channelState, m_buffer, STATE_SAMPLEREADER_REGS_BUFFER_FORMAT);
+	m_previousSample = static_cast<int16>(channelState.GetRegister32(STATE_SAMPLEREADER_REGS_PREVIOUSSAMPLE));
 
 	UpdateSampleStep();
 }
@@ -1278,6 +1246,7 @@ void CSpuBase::CSampleReader::SaveState(CRegisterState& channelState) const
 	channelState.SetRegister32(STATE_SAMPLEREADER_REGS_ENDFLAG, m_endFlag);
 	channelState.SetRegister32(STATE_SAMPLEREADER_REGS_DIDCHANGEREPEAT, m_didChangeRepeat);
 	RegisterStateUtils::WriteArray(channelState, m_buffer, STATE_SAMPLEREADER_REGS_BUFFER_FORMAT);
+	channelState.SetRegister32(STATE_SAMPLEREADER_REGS_PREVIOUSSAMPLE, static_cast<uint16>(m_previousSample));
 }
 
 void CSpuBase::CSampleReader::SetParams(uint32 address, uint32 repeat)
@@ -1287,6 +1256,7 @@ void CSpuBase::CSampleReader::SetParams(uint32 address, uint32 repeat)
 	m_repeatAddr = repeat & (m_ramSize - 1);
 	m_s1 = 0;
 	m_s2 = 0;
+	m_previousSample = 0;
 	m_nextValid = false;
 	m_done = false;
 	m_didChangeRepeat = false;
@@ -1310,27 +1280,28 @@ void CSpuBase::CSampleReader::SetPitch(uint32 baseSamplingRate, uint16 pitch)
 	UpdateSampleStep();
 }
 
-int32 CSpuBase::CSampleReader::GetSample()
+void CSpuBase::CSampleReader::GetSample(SpuVoiceMixer::VOICE_BLOCK& block, unsigned int index)
 {
+	//Interpolation between samples is done by SpuVoiceMixer
 	uint32 srcSampleIdx = m_srcSampleIdx / PITCH_BASE;
-	int32 srcSampleAlpha = m_srcSampleIdx % PITCH_BASE;
-	int32 currentSample = m_buffer[srcSampleIdx];
-	int32 nextSample = m_buffer[srcSampleIdx + 1];
-	int32 resultSample = (currentSample * (PITCH_BASE - srcSampleAlpha) / PITCH_BASE) +
-	                     (nextSample * srcSampleAlpha / PITCH_BASE);
+	block.previousSamples[index] = (srcSampleIdx == 0) ? m_previousSample : m_buffer[srcSampleIdx - 1];
+	block.currentSamples[index] = m_buffer[srcSampleIdx];
+	block.nextSamples[index] = m_buffer[srcSampleIdx + 1];
+	block.afterNextSamples[index] = m_buffer[srcSampleIdx + 2];
+	block.alphas[index] = static_cast<int16>(m_srcSampleIdx % PITCH_BASE);
 	m_srcSampleIdx += m_sampleStep;
 	if(srcSampleIdx >= BUFFER_SAMPLES)
 	{
 		m_srcSampleIdx -= BUFFER_SAMPLES * PITCH_BASE;
 		AdvanceBuffer();
 	}
-	return resultSample;
 }
 
 void CSpuBase::CSampleReader::AdvanceBuffer()
 {
 	if(m_nextValid)
 	{
+		m_previousSample = m_buffer[BUFFER_SAMPLES - 1];
 		memmove(m_buffer, m_buffer + BUFFER_SAMPLES, sizeof(int16) * BUFFER_SAMPLES);
 		UnpackSamples(m_buffer + BUFFER_SAMPLES);
 	}
@@ -1349,14 +1320,13 @@ void CSpuBase::CSampleReader::UpdateSampleStep()
 
 void CSpuBase::CSampleReader::UnpackSamples(int16* dst)
 {
-	int32 workBuffer[BUFFER_SAMPLES];
+	static_assert(BUFFER_SAMPLES == SpuAdpcm::BLOCK_SAMPLES, "Buffer sample size must match ADPCM block sample count.");
 
 	const uint8* nextSample = m_ram + m_nextSampleAddr;
 
 	m_irqWatcher->CheckIrq(m_nextSampleAddr);
 
 	//Read header
-	uint8 shiftFactor = nextSample[0] & 0xF;
 	uint8 predictNumber = nextSample[0] >> 4;
 	uint8 flags = nextSample[1];
 	assert(predictNumber < 5);
@@ -1376,55 +1346,12 @@ void CSpuBase::CSampleReader::UnpackSamples(int16* dst)
 	}
 	else
 	{
-		//Get intermediate values
-		{
-			unsigned int workBufferPtr = 0;
-			for(unsigned int i = 2; i < 16; i++)
-			{
-				uint8 sampleByte = nextSample[i];
-				int16 firstSample = ((sampleByte & 0x0F) << 12);
-				int16 secondSample = ((sampleByte & 0xF0) << 8);
-				firstSample >>= shiftFactor;
-				secondSample >>= shiftFactor;
-				workBuffer[workBufferPtr++] = firstSample;
-				workBuffer[workBufferPtr++] = secondSample;
-			}
-		}
-
-		//Generate PCM samples
-		{
-			// clang-format off
-			//Table is 16 entries long to prevent reading indeterminate
-			//values if predictNumber is greater or equal to 5.
-			//According to some sources, entries at 5 and beyond contain 0 on real hardware
-			static const int32 predictorTable[16][2] =
-			{
-				{0, 0},
-				{60, 0},
-				{115, -52},
-				{98, -55},
-				{122, -60},
-			};
-			// clang-format on
-
-			for(unsigned int i = 0; i < BUFFER_SAMPLES; i++)
-			{
-				int32 currentValue = workBuffer[i] * 64;
-				currentValue += (m_s1 * predictorTable[predictNumber][0]) / 64;
-				currentValue += (m_s2 * predictorTable[predictNumber][1]) / 64;
-				m_s2 = m_s1;
-				m_s1 = currentValue;
-				int32 result = (currentValue + 32) / 64;
-				result = std::max<int32>(result, SHRT_MIN);
-				result = std::min<int32>(result, SHRT_MAX);
-				dst[i] = static_cast<int16>(result);
-			}
+		SpuAdpcm::DecodeBlock(nextSample, dst, m_s1, m_s2);
 
-			auto& cacheItem = m_sampleCache->RegisterItem(cacheKey);
-			memcpy(&cacheItem.samples, dst, sizeof(int16) * BUFFER_SAMPLES);
-			cacheItem.outS1 = m_s1;
-			cacheItem.outS2 = m_s2;
-		}
+		auto& newCacheItem = m_sampleCache->RegisterItem(cacheKey);
+		memcpy(&newCacheItem.samples, dst, sizeof(int16) * BUFFER_SAMPLES);
+		newCacheItem.outS1 = m_s1;
+		newCacheItem.outS2 = m_s2;
 	}
 
 	if(flags & 0x04)
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <vector>
 #include "Types.h"
 #include "BasicUnion.h"
 #include "Convertible.h"
+#include "Iop_SpuVoiceMixer.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
 
@@ -11,6 +13,9 @@ class CRegisterState;
 
 namespace Iop
 {
+	//Caches decoded ADPCM blocks. Blocks are identified by their address and by the decoder
+	//state they were decoded with. Memory usage is fixed, old entries are replaced using
+	//clock (second chance) eviction among the slots an entry can live in.
 	class CSpuSampleCache
 	{
 	public:
@@ -23,6 +28,12 @@ namespace Iop
 			int32 s2;
 		};
 
+		struct STATS
+		{
+			uint32 hitCount = 0;
+			uint32 missCount = 0;
+		};
+
 		struct ITEM
 		{
 			int16 samples[BUFFER_SAMPLES];
@@ -32,13 +43,49 @@ namespace Iop
 			int32 outS2;
 		};
 
-		const ITEM* GetItem(const KEY&) const;
+		CSpuSampleCache();
+
+		const ITEM* GetItem(const KEY&);
 		ITEM& RegisterItem(const KEY&);
 		void Clear();
 		void ClearRange(uint32 address, uint32 size);
 
+		STATS GetStats() const;
+		void ClearStats();
+
 	private:
-		std::multimap<uint32, ITEM> m_cache;
+		enum
+		{
+			SLOT_COUNT = 0x4000,
+			//Amount of consecutive slots an entry can be stored in
+			PROBE_LENGTH = 8,
+			PAGE_SHIFT = 8,
+			//Covers 2MB of SPU RAM, larger addresses share pages
+			PAGE_COUNT = 0x2000,
+		};
+
+		struct SLOT
+		{
+			ITEM item;
+			uint32 address = 0;
+			uint32 pageGeneration = 0;
+			bool used = false;
+			bool referenced = false;
+		};
+
+		static uint32 GetSlotIndex(const KEY&);
+		static uint32 GetPageIndex(uint32);
+		bool IsSlotValid(const SLOT&) const;
+
+		std::vector<SLOT> m_slots;
+		std::vector<uint32> m_pageGenerations;
+		uint32 m_clockHand = 0;
+
+		//Only updated by the thread rendering the SPU, clearing moves a baseline instead
+		//of resetting them so that other threads never write to them
+		std::atomic<uint32> m_hitCount = 0;
+		std::atomic<uint32> m_missCount = 0;
+		STATS m_statsBase;
 	};
 
 	class CSpuIrqWatcher
@@ -218,6 +265,7 @@ namespace Iop
 
 		void SetVolumeAdjust(float);
 		void SetReverbEnabled(bool);
+		void SetInterpolation(SpuVoiceMixer::INTERPOLATION);
 
 		void SetBaseSamplingRate(uint32);
 		void SetDestinationSamplingRate(uint32);
@@ -306,7 +354,7 @@ namespace Iop
 			void SetParamsRead(uint32, uint32);
 			void SetParamsNoRead(uint32, uint32);
 			void SetPitch(uint32, uint16);
-			int32 GetSample();
+			void GetSample(SpuVoiceMixer::VOICE_BLOCK&, unsigned int);
 			uint32 GetRepeat() const;
 			void SetRepeat(uint32);
 			uint32 GetCurrent() const;
@@ -338,6 +386,8 @@ namespace Iop
 			uint32 m_nextSampleAddr = 0;
 			uint32 m_repeatAddr = 0;
 			int16 m_buffer[BUFFER_SAMPLES * 2];
+			//Last sample of the block preceding the one in m_buffer
+			int16 m_previousSample;
 			uint16 m_pitch;
 			int32 m_s1;
 			int32 m_s2;
@@ -377,13 +427,10 @@ namespace Iop
 			MAX_ADSR_VOLUME = 0x7FFFFFFF,
 		};
 
+		bool UpdateVoiceBlock(unsigned int, SpuVoiceMixer::VOICE_BLOCK&, unsigned int);
 		void UpdateAdsr(CHANNEL&);
-		void UpdateReverb(int16[2], int16*);
+		void UpdateReverb(const int16*, int16*, unsigned int);
 		uint32 GetAdsrDelta(unsigned int) const;
-		float GetReverbSample(uint32) const;
-		void SetReverbSample(uint32, float);
-		uint32 GetReverbOffset(unsigned int) const;
-		float GetReverbCoef(unsigned int) const;
 
 		static void MixSamples(int32, int32, int16*);
 		int32 ComputeChannelVolume(const CHANNEL_VOLUME&, int32);
@@ -415,6 +462,7 @@ namespace Iop
 		CSampleReader m_reader[MAX_CHANNEL];
 		uint32 m_adsrLogTable[160];
 		bool m_reverbEnabled;
+		SpuVoiceMixer::INTERPOLATION m_interpolation = SpuVoiceMixer::INTERPOLATION_LINEAR;
 		float m_volumeAdjust;
 
 		CBlockSampleReader m_blockReader;
@@ -0,0 +1,53 @@
+#include <cassert>
+#include "Iop_SpuRenderThread.h"
+#include "ThreadUtils.h"
+
+using namespace Iop;
+
+CSpuRenderThread::CSpuRenderThread()
+{
+	m_thread = std::thread([this]() { ThreadProc(); });
+	Framework::ThreadUtils::SetThreadName(m_thread, "SPU Render Thread");
+}
+
+CSpuRenderThread::~CSpuRenderThread()
+{
+	m_mailBox.SendCall([this]() { m_threadDone = true; });
+	m_thread.join();
+}
+
+void CSpuRenderThread::StartJob(JobFunction job)
+{
+	{
+		std::lock_guard jobLock(m_jobMutex);
+		assert(m_jobDone);
+		m_jobDone = false;
+	}
+	m_mailBox.SendCall(
+	    [this, job = std::move(job)]() {
+		    job();
+		    {
+			    std::lock_guard jobLock(m_jobMutex);
+			    m_jobDone = true;
+		    }
+		    m_jobCondition.notify_all();
+	    });
+}
+
+void CSpuRenderThread::WaitForJob()
+{
+	std::unique_lock jobLock(m_jobMutex);
+	m_jobCondition.wait(jobLock, [this]() { return m_jobDone; });
+}
+
+void CSpuRenderThread::ThreadProc()
+{
+	while(!m_threadDone)
+	{
+		m_mailBox.WaitForCall();
+		while(m_mailBox.IsPending())
+		{
+			m_mailBox.ReceiveCall();
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "../MailBox.h"
+
+namespace Iop
+{
+	//Runs SPU rendering jobs on their own thread, one at a time
+	class CSpuRenderThread
+	{
+	public:
+		typedef std::function<void()> JobFunction;
+
+		CSpuRenderThread();
+		~CSpuRenderThread();
+
+		void StartJob(JobFunction);
+		void WaitForJob();
+
+	private:
+		void ThreadProc();
+
+		CMailBox m_mailBox;
+		std::thread m_thread;
+		bool m_threadDone = false;
+
+		std::mutex m_jobMutex;
+		std::condition_variable m_jobCondition;
+		bool m_jobDone = true;
+	};
+}
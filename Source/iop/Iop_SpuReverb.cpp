@@ -0,0 +1,518 @@
+#include "Iop_SpuReverb.h"
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+#include "Iop_SpuBase.h"
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+#include <emmintrin.h>
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace Iop;
+
+static uint32 WrapAddress(const SpuReverb::STATE& state, uint32 address)
+{
+	//Same as subtracting the work area's size until the address is inside of it
+	if(address >= state.workAddrEnd)
+	{
+		uint32 size = state.workAddrEnd - state.workAddrStart;
+		address = state.workAddrStart + ((address - state.workAddrStart) % size);
+	}
+	return address;
+}
+
+static uint32 GetOffset(const SpuReverb::STATE& state, unsigned int registerId)
+{
+	return state.params[registerId];
+}
+
+static float GetCoef(const SpuReverb::STATE& state, unsigned int registerId)
+{
+	int16 value = static_cast<int16>(state.params[registerId]);
+	return static_cast<float>(value) / static_cast<float>(0x8000);
+}
+
+static float ReadSample(const SpuReverb::STATE& state, uint32 address)
+{
+	return static_cast<float>(*reinterpret_cast<int16*>(state.ram + address));
+}
+
+static float GetSample(const SpuReverb::STATE& state, uint32 offset)
+{
+	return ReadSample(state, WrapAddress(state, state.currAddr + offset));
+}
+
+static void SetSample(SpuReverb::STATE& state, uint32 offset, float value)
+{
+	uint32 address = WrapAddress(state, state.currAddr + offset);
+	value = std::max<float>(value, SHRT_MIN);
+	value = std::min<float>(value, SHRT_MAX);
+	int16 intValue = static_cast<int16>(value);
+	*reinterpret_cast<int16*>(state.ram + address) = intValue;
+}
+
+static void MixOutputSample(float sample, int16* output)
+{
+	int32 resultSample = static_cast<int32>(sample) + static_cast<int32>(*output);
+	resultSample = std::max<int32>(resultSample, SHRT_MIN);
+	resultSample = std::min<int32>(resultSample, SHRT_MAX);
+	*output = static_cast<int16>(resultSample);
+}
+
+static void MixOutput(const SpuReverb::STATE& state, int16* output)
+{
+	float sampleL = 0.333f * (GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_A0)) + GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_B0)));
+	float sampleR = 0.333f * (GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_A1)) + GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_B1)));
+	MixOutputSample(sampleL, output + 0);
+	MixOutputSample(sampleR, output + 1);
+}
+
+static void ProcessTick(SpuReverb::STATE& state, const int16* reverbSample, int16* samples)
+{
+	//Feed samples to FIR filter
+	if(state.ticks & 1)
+	{
+		//IIR_INPUT_A0 = buffer[IIR_SRC_A0] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
+		//IIR_INPUT_A1 = buffer[IIR_SRC_A1] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
+		//IIR_INPUT_B0 = buffer[IIR_SRC_B1] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
+		//IIR_INPUT_B1 = buffer[IIR_SRC_B0] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
+
+		float input_sample_l = static_cast<float>(reverbSample[0]) * 0.5f;
+		float input_sample_r = static_cast<float>(reverbSample[1]) * 0.5f;
+
+		float irr_coef = GetCoef(state, CSpuBase::IIR_COEF);
+		float in_coef_l = GetCoef(state, CSpuBase::IN_COEF_L);
+		float in_coef_r = GetCoef(state, CSpuBase::IN_COEF_R);
+
+		float iir_input_a0 = GetSample(state, GetOffset(state, CSpuBase::IIR_SRC_A0)) * irr_coef + input_sample_l * in_coef_l;
+		float iir_input_a1 = GetSample(state, GetOffset(state, CSpuBase::IIR_SRC_A1)) * irr_coef + input_sample_r * in_coef_r;
+		float iir_input_b0 = GetSample(state, GetOffset(state, CSpuBase::IIR_SRC_B1)) * irr_coef + input_sample_l * in_coef_l;
+		float iir_input_b1 = GetSample(state, GetOffset(state, CSpuBase::IIR_SRC_B0)) * irr_coef + input_sample_r * in_coef_r;
+
+		//IIR_A0 = IIR_INPUT_A0 * IIR_ALPHA + buffer[IIR_DEST_A0] * (1.0 - IIR_ALPHA);
+		//IIR_A1 = IIR_INPUT_A1 * IIR_ALPHA + buffer[IIR_DEST_A1] * (1.0 - IIR_ALPHA);
+		//IIR_B0 = IIR_INPUT_B0 * IIR_ALPHA + buffer[IIR_DEST_B0] * (1.0 - IIR_ALPHA);
+		//IIR_B1 = IIR_INPUT_B1 * IIR_ALPHA + buffer[IIR_DEST_B1] * (1.0 - IIR_ALPHA);
+
+		float iir_alpha = GetCoef(state, CSpuBase::IIR_ALPHA);
+
+		float iir_a0 = iir_input_a0 * iir_alpha + GetSample(state, GetOffset(state, CSpuBase::IIR_DEST_A0)) * (1.0f - iir_alpha);
+		float iir_a1 = iir_input_a1 * iir_alpha + GetSample(state, GetOffset(state, CSpuBase::IIR_DEST_A1)) * (1.0f - iir_alpha);
+		float iir_b0 = iir_input_b0 * iir_alpha + GetSample(state, GetOffset(state, CSpuBase::IIR_DEST_B0)) * (1.0f - iir_alpha);
+		float iir_b1 = iir_input_b1 * iir_alpha + GetSample(state, GetOffset(state, CSpuBase::IIR_DEST_B1)) * (1.0f - iir_alpha);
+
+		//buffer[IIR_DEST_A0 + 1sample] = IIR_A0;
+		//buffer[IIR_DEST_A1 + 1sample] = IIR_A1;
+		//buffer[IIR_DEST_B0 + 1sample] = IIR_B0;
+		//buffer[IIR_DEST_B1 + 1sample] = IIR_B1;
+
+		SetSample(state, GetOffset(state, CSpuBase::IIR_DEST_A0) + 2, iir_a0);
+		SetSample(state, GetOffset(state, CSpuBase::IIR_DEST_A1) + 2, iir_a1);
+		SetSample(state, GetOffset(state, CSpuBase::IIR_DEST_B0) + 2, iir_b0);
+		SetSample(state, GetOffset(state, CSpuBase::IIR_DEST_B1) + 2, iir_b1);
+
+		//ACC0 = buffer[ACC_SRC_A0] * ACC_COEF_A +
+		//	   buffer[ACC_SRC_B0] * ACC_COEF_B +
+		//	   buffer[ACC_SRC_C0] * ACC_COEF_C +
+		//	   buffer[ACC_SRC_D0] * ACC_COEF_D;
+		//ACC1 = buffer[ACC_SRC_A1] * ACC_COEF_A +
+		//	   buffer[ACC_SRC_B1] * ACC_COEF_B +
+		//	   buffer[ACC_SRC_C1] * ACC_COEF_C +
+		//	   buffer[ACC_SRC_D1] * ACC_COEF_D;
+
+		float acc_coef_a = GetCoef(state, CSpuBase::ACC_COEF_A);
+		float acc_coef_b = GetCoef(state, CSpuBase::ACC_COEF_B);
+		float acc_coef_c = GetCoef(state, CSpuBase::ACC_COEF_C);
+		float acc_coef_d = GetCoef(state, CSpuBase::ACC_COEF_D);
+
+		float acc0 =
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_A0)) * acc_coef_a +
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_B0)) * acc_coef_b +
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_C0)) * acc_coef_c +
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_D0)) * acc_coef_d;
+
+		float acc1 =
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_A1)) * acc_coef_a +
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_B1)) * acc_coef_b +
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_C1)) * acc_coef_c +
+		    GetSample(state, GetOffset(state, CSpuBase::ACC_SRC_D1)) * acc_coef_d;
+
+		//FB_A0 = buffer[MIX_DEST_A0 - FB_SRC_A];
+		//FB_A1 = buffer[MIX_DEST_A1 - FB_SRC_A];
+		//FB_B0 = buffer[MIX_DEST_B0 - FB_SRC_B];
+		//FB_B1 = buffer[MIX_DEST_B1 - FB_SRC_B];
+
+		float fb_a0 = GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_A0) - GetOffset(state, CSpuBase::FB_SRC_A));
+		float fb_a1 = GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_A1) - GetOffset(state, CSpuBase::FB_SRC_A));
+		float fb_b0 = GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_B0) - GetOffset(state, CSpuBase::FB_SRC_B));
+		float fb_b1 = GetSample(state, GetOffset(state, CSpuBase::MIX_DEST_B1) - GetOffset(state, CSpuBase::FB_SRC_B));
+
+		//buffer[MIX_DEST_A0] = ACC0 - FB_A0 * FB_ALPHA;
+		//buffer[MIX_DEST_A1] = ACC1 - FB_A1 * FB_ALPHA;
+		//buffer[MIX_DEST_B0] = (FB_ALPHA * ACC0) - FB_A0 * (FB_ALPHA^0x8000) - FB_B0 * FB_X;
+		//buffer[MIX_DEST_B1] = (FB_ALPHA * ACC1) - FB_A1 * (FB_ALPHA^0x8000) - FB_B1 * FB_X;
+
+		float fb_alpha = GetCoef(state, CSpuBase::FB_ALPHA);
+		float fb_x = GetCoef(state, CSpuBase::FB_X);
+
+		SetSample(state, GetOffset(state, CSpuBase::MIX_DEST_A0), acc0 - fb_a0 * fb_alpha);
+		SetSample(state, GetOffset(state, CSpuBase::MIX_DEST_A1), acc1 - fb_a1 * fb_alpha);
+		SetSample(state, GetOffset(state, CSpuBase::MIX_DEST_B0), (fb_alpha * acc0) - fb_a0 * -fb_alpha - fb_b0 * fb_x);
+		SetSample(state, GetOffset(state, CSpuBase::MIX_DEST_B1), (fb_alpha * acc1) - fb_a1 * -fb_alpha - fb_b1 * fb_x);
+
+		state.currAddr += 2;
+		if(state.currAddr >= state.workAddrEnd)
+		{
+			state.currAddr = state.workAddrStart;
+		}
+	}
+
+	if(state.workAddrStart != 0)
+	{
+		MixOutput(state, samples);
+	}
+
+	state.ticks++;
+}
+
+void SpuReverb::ProcessScalar(STATE& state, const int16* input, int16* output, unsigned int tickCount)
+{
+	for(unsigned int i = 0; i < tickCount; i++)
+	{
+		ProcessTick(state, input + (i * 2), output + (i * 2));
+	}
+}
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+
+typedef __m128 FloatVector;
+
+static inline FloatVector MakeVector(float a, float b, float c, float d)
+{
+	return _mm_setr_ps(a, b, c, d);
+}
+
+static inline FloatVector Add(FloatVector a, FloatVector b)
+{
+	return _mm_add_ps(a, b);
+}
+
+static inline FloatVector Sub(FloatVector a, FloatVector b)
+{
+	return _mm_sub_ps(a, b);
+}
+
+static inline FloatVector Mul(FloatVector a, FloatVector b)
+{
+	return _mm_mul_ps(a, b);
+}
+
+static inline void ConvertClamped(FloatVector value, int32* result)
+{
+	value = _mm_max_ps(value, _mm_set1_ps(SHRT_MIN));
+	value = _mm_min_ps(value, _mm_set1_ps(SHRT_MAX));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(result), _mm_cvttps_epi32(value));
+}
+
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+
+typedef float32x4_t FloatVector;
+
+static inline FloatVector MakeVector(float a, float b, float c, float d)
+{
+	float32_t values[4] = {a, b, c, d};
+	return vld1q_f32(values);
+}
+
+static inline FloatVector Add(FloatVector a, FloatVector b)
+{
+	return vaddq_f32(a, b);
+}
+
+static inline FloatVector Sub(FloatVector a, FloatVector b)
+{
+	return vsubq_f32(a, b);
+}
+
+static inline FloatVector Mul(FloatVector a, FloatVector b)
+{
+	return vmulq_f32(a, b);
+}
+
+static inline void ConvertClamped(FloatVector value, int32* result)
+{
+	value = vmaxq_f32(value, vdupq_n_f32(SHRT_MIN));
+	value = vminq_f32(value, vdupq_n_f32(SHRT_MAX));
+	vst1q_s32(result, vcvtq_s32_f32(value));
+}
+
+#else
+
+struct FloatVector
+{
+	float values[4];
+};
+
+static inline FloatVector MakeVector(float a, float b, float c, float d)
+{
+	return FloatVector{{a, b, c, d}};
+}
+
+static inline FloatVector Add(const FloatVector& a, const FloatVector& b)
+{
+	return FloatVector{{a.values[0] + b.values[0], a.values[1] + b.values[1], a.values[2] + b.values[2], a.values[3] + b.values[3]}};
+}
+
+static inline FloatVector Sub(const FloatVector& a, const FloatVector& b)
+{
+	return FloatVector{{a.values[0] - b.values[0], a.values[1] - b.values[1], a.values[2] - b.values[2], a.values[3] - b.values[3]}};
+}
+
+static inline FloatVector Mul(const FloatVector& a, const FloatVector& b)
+{
+	return FloatVector{{a.values[0] * b.values[0], a.values[1] * b.values[1], a.values[2] * b.values[2], a.values[3] * b.values[3]}};
+}
+
+static inline void ConvertClamped(const FloatVector& value, int32* result)
+{
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		result[i] = static_cast<int32>(std::clamp<float>(value.values[i], SHRT_MIN, SHRT_MAX));
+	}
+}
+
+#endif
+
+//Taps in the order they are accessed in a step. Lanes are A0, A1, B0, B1.
+enum TAP
+{
+	TAP_IIR_SRC,
+	TAP_IIR_DEST = TAP_IIR_SRC + 4,
+	TAP_IIR_WRITE = TAP_IIR_DEST + 4,
+	//A0, A1, B0, B1, C0, C1, D0, D1
+	TAP_ACC_SRC = TAP_IIR_WRITE + 4,
+	TAP_FB_SRC = TAP_ACC_SRC + 8,
+	TAP_MIX_DEST = TAP_FB_SRC + 4,
+	TAP_COUNT = TAP_MIX_DEST + 4,
+};
+
+struct COEFFICIENTS
+{
+	FloatVector iirCoef;
+	FloatVector inCoef;
+	FloatVector inputScale;
+	FloatVector iirAlpha;
+	FloatVector iirOneMinusAlpha;
+	FloatVector accCoefA;
+	FloatVector accCoefB;
+	FloatVector accCoefC;
+	FloatVector accCoefD;
+	//MIX = (ACC * mixAccCoef) - (FB_A * mixFbACoef) - (FB_B * mixFbBCoef)
+	FloatVector mixAccCoef;
+	FloatVector mixFbACoef;
+	FloatVector mixFbBCoef;
+};
+
+static FloatVector SplatVector(float value)
+{
+	return MakeVector(value, value, value, value);
+}
+
+static COEFFICIENTS GetCoefficients(const SpuReverb::STATE& state)
+{
+	float iirAlpha = GetCoef(state, CSpuBase::IIR_ALPHA);
+	float inCoefL = GetCoef(state, CSpuBase::IN_COEF_L);
+	float inCoefR = GetCoef(state, CSpuBase::IN_COEF_R);
+	float fbAlpha = GetCoef(state, CSpuBase::FB_ALPHA);
+	float fbX = GetCoef(state, CSpuBase::FB_X);
+
+	COEFFICIENTS coefs;
+	coefs.iirCoef = SplatVector(GetCoef(state, CSpuBase::IIR_COEF));
+	coefs.inCoef = MakeVector(inCoefL, inCoefR, inCoefL, inCoefR);
+	coefs.inputScale = SplatVector(0.5f);
+	coefs.iirAlpha = SplatVector(iirAlpha);
+	coefs.iirOneMinusAlpha = SplatVector(1.0f - iirAlpha);
+	coefs.accCoefA = SplatVector(GetCoef(state, CSpuBase::ACC_COEF_A));
+	coefs.accCoefB = SplatVector(GetCoef(state, CSpuBase::ACC_COEF_B));
+	coefs.accCoefC = SplatVector(GetCoef(state, CSpuBase::ACC_COEF_C));
+	coefs.accCoefD = SplatVector(GetCoef(state, CSpuBase::ACC_COEF_D));
+	//Multiplying by 1 and subtracting 0 doesn't change A's results
+	coefs.mixAccCoef = MakeVector(1.0f, 1.0f, fbAlpha, fbAlpha);
+	coefs.mixFbACoef = MakeVector(fbAlpha, fbAlpha, -fbAlpha, -fbAlpha);
+	coefs.mixFbBCoef = MakeVector(0.0f, 0.0f, fbX, fbX);
+	return coefs;
+}
+
+static void GetTapOffsets(const SpuReverb::STATE& state, uint32* offsets)
+{
+	static const unsigned int iirSrcRegisters[4] = {CSpuBase::IIR_SRC_A0, CSpuBase::IIR_SRC_A1, CSpuBase::IIR_SRC_B1, CSpuBase::IIR_SRC_B0};
+	static const unsigned int iirDestRegisters[4] = {CSpuBase::IIR_DEST_A0, CSpuBase::IIR_DEST_A1, CSpuBase::IIR_DEST_B0, CSpuBase::IIR_DEST_B1};
+	static const unsigned int accSrcRegisters[8] = {CSpuBase::ACC_SRC_A0, CSpuBase::ACC_SRC_A1, CSpuBase::ACC_SRC_B0, CSpuBase::ACC_SRC_B1,
+	                                                CSpuBase::ACC_SRC_C0, CSpuBase::ACC_SRC_C1, CSpuBase::ACC_SRC_D0, CSpuBase::ACC_SRC_D1};
+	static const unsigned int mixDestRegisters[4] = {CSpuBase::MIX_DEST_A0, CSpuBase::MIX_DEST_A1, CSpuBase::MIX_DEST_B0, CSpuBase::MIX_DEST_B1};
+	static const unsigned int fbSrcRegisters[4] = {CSpuBase::FB_SRC_A, CSpuBase::FB_SRC_A, CSpuBase::FB_SRC_B, CSpuBase::FB_SRC_B};
+
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		offsets[TAP_IIR_SRC + i] = GetOffset(state, iirSrcRegisters[i]);
+		offsets[TAP_IIR_DEST + i] = GetOffset(state, iirDestRegisters[i]);
+		offsets[TAP_IIR_WRITE + i] = GetOffset(state, iirDestRegisters[i]) + 2;
+		offsets[TAP_FB_SRC + i] = GetOffset(state, mixDestRegisters[i]) - GetOffset(state, fbSrcRegisters[i]);
+		offsets[TAP_MIX_DEST + i] = GetOffset(state, mixDestRegisters[i]);
+	}
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		offsets[TAP_ACC_SRC + i] = GetOffset(state, accSrcRegisters[i]);
+	}
+}
+
+static void WriteSamples(SpuReverb::STATE& state, const FloatVector& samples, const uint32* addresses)
+{
+	int32 values[4];
+	ConvertClamped(samples, values);
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		*reinterpret_cast<int16*>(state.ram + addresses[i]) = static_cast<int16>(values[i]);
+	}
+}
+
+//Processes a run of steps (ticks where the reverb's filters are updated) and mixes the output
+//of every tick from the first step to the last one. Steps access memory in the same order as
+//the scalar version, but tap addresses are only computed once per run and then advanced along
+//with the current address. A run ends when the current address wraps around.
+static unsigned int ProcessRun(SpuReverb::STATE& state, const COEFFICIENTS& coefs, const int16* input, int16* output, unsigned int maxStepCount)
+{
+	uint32 size = state.workAddrEnd - state.workAddrStart;
+
+	unsigned int stepCount = 1;
+	if((state.currAddr < state.workAddrEnd) && (size >= 2))
+	{
+		stepCount = std::min<unsigned int>(maxStepCount, (state.workAddrEnd - state.currAddr + 1) / 2);
+	}
+
+	uint32 offsets[TAP_COUNT];
+	GetTapOffsets(state, offsets);
+
+	uint32 addresses[TAP_COUNT];
+	for(unsigned int i = 0; i < TAP_COUNT; i++)
+	{
+		uint32 address = state.currAddr + offsets[i];
+		//Advancing a tap is only the same as recomputing it if its unwrapped address doesn't overflow
+		if(address > (UINT32_MAX - (stepCount * 2)))
+		{
+			stepCount = 1;
+		}
+		addresses[i] = WrapAddress(state, address);
+	}
+
+	bool outputEnabled = (state.workAddrStart != 0);
+
+	for(unsigned int step = 0; step < stepCount; step++)
+	{
+		{
+			const int16* stepInput = input + (step * 4);
+			float inputL = static_cast<float>(stepInput[0]);
+			float inputR = static_cast<float>(stepInput[1]);
+			FloatVector inputSamples = MakeVector(inputL, inputR, inputL, inputR);
+			FloatVector src = MakeVector(
+			    ReadSample(state, addresses[TAP_IIR_SRC + 0]), ReadSample(state, addresses[TAP_IIR_SRC + 1]),
+			    ReadSample(state, addresses[TAP_IIR_SRC + 2]), ReadSample(state, addresses[TAP_IIR_SRC + 3]));
+			FloatVector dest = MakeVector(
+			    ReadSample(state, addresses[TAP_IIR_DEST + 0]), ReadSample(state, addresses[TAP_IIR_DEST + 1]),
+			    ReadSample(state, addresses[TAP_IIR_DEST + 2]), ReadSample(state, addresses[TAP_IIR_DEST + 3]));
+
+			FloatVector iirInput = Add(Mul(src, coefs.iirCoef), Mul(Mul(inputSamples, coefs.inputScale), coefs.inCoef));
+			FloatVector iir = Add(Mul(iirInput, coefs.iirAlpha), Mul(dest, coefs.iirOneMinusAlpha));
+			WriteSamples(state, iir, addresses + TAP_IIR_WRITE);
+		}
+
+		{
+			float accA0 = ReadSample(state, addresses[TAP_ACC_SRC + 0]);
+			float accA1 = ReadSample(state, addresses[TAP_ACC_SRC + 1]);
+			float accB0 = ReadSample(state, addresses[TAP_ACC_SRC + 2]);
+			float accB1 = ReadSample(state, addresses[TAP_ACC_SRC + 3]);
+			float accC0 = ReadSample(state, addresses[TAP_ACC_SRC + 4]);
+			float accC1 = ReadSample(state, addresses[TAP_ACC_SRC + 5]);
+			float accD0 = ReadSample(state, addresses[TAP_ACC_SRC + 6]);
+			float accD1 = ReadSample(state, addresses[TAP_ACC_SRC + 7]);
+			float fbA0 = ReadSample(state, addresses[TAP_FB_SRC + 0]);
+			float fbA1 = ReadSample(state, addresses[TAP_FB_SRC + 1]);
+			float fbB0 = ReadSample(state, addresses[TAP_FB_SRC + 2]);
+			float fbB1 = ReadSample(state, addresses[TAP_FB_SRC + 3]);
+
+			FloatVector acc = Mul(MakeVector(accA0, accA1, accA0, accA1), coefs.accCoefA);
+			acc = Add(acc, Mul(MakeVector(accB0, accB1, accB0, accB1), coefs.accCoefB));
+			acc = Add(acc, Mul(MakeVector(accC0, accC1, accC0, accC1), coefs.accCoefC));
+			acc = Add(acc, Mul(MakeVector(accD0, accD1, accD0, accD1), coefs.accCoefD));
+
+			FloatVector mix = Mul(coefs.mixAccCoef, acc);
+			mix = Sub(mix, Mul(MakeVector(fbA0, fbA1, fbA0, fbA1), coefs.mixFbACoef));
+			mix = Sub(mix, Mul(MakeVector(fbB0, fbB1, fbB0, fbB1), coefs.mixFbBCoef));
+			WriteSamples(state, mix, addresses + TAP_MIX_DEST);
+		}
+
+		for(unsigned int i = 0; i < TAP_COUNT; i++)
+		{
+			addresses[i] += 2;
+			if(addresses[i] >= state.workAddrEnd)
+			{
+				addresses[i] -= size;
+			}
+		}
+
+		//Last step's output is read once the current address has been updated, it might have wrapped around
+		if(outputEnabled && (step != (stepCount - 1)))
+		{
+			float sampleL = 0.333f * (ReadSample(state, addresses[TAP_MIX_DEST + 0]) + ReadSample(state, addresses[TAP_MIX_DEST + 2]));
+			float sampleR = 0.333f * (ReadSample(state, addresses[TAP_MIX_DEST + 1]) + ReadSample(state, addresses[TAP_MIX_DEST + 3]));
+			//Step's tick and the following one (which doesn't update filters) output the same samples
+			int16* stepOutput = output + (step * 4);
+			MixOutputSample(sampleL, stepOutput + 0);
+			MixOutputSample(sampleR, stepOutput + 1);
+			MixOutputSample(sampleL, stepOutput + 2);
+			MixOutputSample(sampleR, stepOutput + 3);
+		}
+	}
+
+	state.currAddr += stepCount * 2;
+	if(state.currAddr >= state.workAddrEnd)
+	{
+		state.currAddr = state.workAddrStart;
+	}
+
+	if(outputEnabled)
+	{
+		MixOutput(state, output + ((stepCount - 1) * 4));
+	}
+
+	return stepCount;
+}
+
+void SpuReverb::Process(STATE& state, const int16* input, int16* output, unsigned int tickCount)
+{
+	auto coefs = GetCoefficients(state);
+	unsigned int tick = 0;
+	while(tick < tickCount)
+	{
+		if(state.ticks & 1)
+		{
+			unsigned int maxStepCount = (tickCount - tick + 1) / 2;
+			unsigned int stepCount = ProcessRun(state, coefs, input + (tick * 2), output + (tick * 2), maxStepCount);
+			//Run ends on its last step's tick
+			unsigned int runTicks = (stepCount * 2) - 1;
+			state.ticks += runTicks;
+			tick += runTicks;
+		}
+		else
+		{
+			if(state.workAddrStart != 0)
+			{
+				MixOutput(state, output + (tick * 2));
+			}
+			state.ticks++;
+			tick++;
+		}
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Types.h"
+
+//Runs the SPU reverb over a block of ticks. The reverb steps at every other tick and
+//reads and writes its work area in SPU RAM through taps placed relative to the current
+//address. Steps are processed in runs where tap addresses are advanced instead of being
+//recomputed, memory is accessed in the same order as when processing one tick at a time.
+//SIMD versions compute the 4 reverb channels (A0, A1, B0, B1) together, with the same
+//operations as the scalar version.
+
+namespace Iop
+{
+	namespace SpuReverb
+	{
+		struct STATE
+		{
+			uint8* ram = nullptr;
+			//Reverb registers (CSpuBase::REVERB_REG_COUNT entries)
+			const uint32* params = nullptr;
+			uint32 workAddrStart = 0;
+			uint32 workAddrEnd = 0;
+			//Updated as the reverb runs
+			uint32 currAddr = 0;
+			int ticks = 0;
+		};
+
+		//Input contains the reverb send of each tick, reverb output is mixed in output.
+		//Both buffers contain interleaved stereo samples.
+		void Process(STATE&, const int16*, int16*, unsigned int);
+		void ProcessScalar(STATE&, const int16*, int16*, unsigned int);
+	}
+}
@@ -0,0 +1,339 @@
+#include "Iop_SpuVoiceMixer.h"
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <array>
+#include <algorithm>
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+#include <emmintrin.h>
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+#include <arm_neon.h>
+#endif
+
+using namespace Iop;
+
+#define PITCH_BASE (0x1000)
+#define MAX_VOLUME (0x7FFF)
+#define CUBIC_PHASE_BITS (8)
+#define CUBIC_PHASE_COUNT (1 << CUBIC_PHASE_BITS)
+#define CUBIC_COEF_SHIFT (14)
+
+typedef std::array<int16, 4> CubicCoefs;
+
+//Catmull-Rom spline weights of the 4 samples around the interpolation point, for every phase
+static std::array<CubicCoefs, CUBIC_PHASE_COUNT> BuildCubicCoefs()
+{
+	std::array<CubicCoefs, CUBIC_PHASE_COUNT> result;
+	float scale = static_cast<float>(1 << CUBIC_COEF_SHIFT);
+	for(unsigned int phase = 0; phase < CUBIC_PHASE_COUNT; phase++)
+	{
+		float t = static_cast<float>(phase) / static_cast<float>(CUBIC_PHASE_COUNT);
+		float t2 = t * t;
+		float t3 = t2 * t;
+		auto& coefs = result[phase];
+		coefs[0] = static_cast<int16>(std::lround(scale * 0.5f * (-t3 + 2.0f * t2 - t)));
+		coefs[2] = static_cast<int16>(std::lround(scale * 0.5f * (-3.0f * t3 + 4.0f * t2 + t)));
+		coefs[3] = static_cast<int16>(std::lround(scale * 0.5f * (t3 - t2)));
+		//Make sure weights add up to 1 to keep DC gain intact
+		coefs[1] = static_cast<int16>((1 << CUBIC_COEF_SHIFT) - coefs[0] - coefs[2] - coefs[3]);
+	}
+	return result;
+}
+
+static const auto g_cubicCoefs = BuildCubicCoefs();
+
+static const CubicCoefs& GetCubicCoefs(int16 alpha)
+{
+	return g_cubicCoefs[static_cast<uint16>(alpha) >> (12 - CUBIC_PHASE_BITS)];
+}
+
+static void MixSample(int32 inputSample, int32 volumeLevel, int16* output)
+{
+	inputSample = (inputSample * volumeLevel) / MAX_VOLUME;
+	int32 resultSample = inputSample + static_cast<int32>(*output);
+	resultSample = std::clamp<int32>(resultSample, SHRT_MIN, SHRT_MAX);
+	*output = static_cast<int16>(resultSample);
+}
+
+static int32 InterpolateSample(const SpuVoiceMixer::VOICE_BLOCK& block, unsigned int index, SpuVoiceMixer::INTERPOLATION interpolation)
+{
+	if(interpolation == SpuVoiceMixer::INTERPOLATION_CUBIC)
+	{
+		const auto& coefs = GetCubicCoefs(block.alphas[index]);
+		int32 result =
+		    (block.previousSamples[index] * coefs[0]) +
+		    (block.currentSamples[index] * coefs[1]) +
+		    (block.nextSamples[index] * coefs[2]) +
+		    (block.afterNextSamples[index] * coefs[3]);
+		//Spline can overshoot the samples' range
+		result >>= CUBIC_COEF_SHIFT;
+		return std::clamp<int32>(result, SHRT_MIN, SHRT_MAX);
+	}
+	else
+	{
+		int32 alpha = block.alphas[index];
+		return (block.currentSamples[index] * (PITCH_BASE - alpha) / PITCH_BASE) +
+		       (block.nextSamples[index] * alpha / PITCH_BASE);
+	}
+}
+
+static void MixVoiceSample(const SpuVoiceMixer::VOICE_BLOCK& block, unsigned int index, int16* output, int16* reverbOutput, SpuVoiceMixer::INTERPOLATION interpolation)
+{
+	int32 readSample = InterpolateSample(block, index, interpolation);
+	int32 inputSample = (readSample * block.adsrVolumes[index]) / MAX_VOLUME;
+
+	MixSample(inputSample, block.volumesLeft[index], output + (index * 2) + 0);
+	MixSample(inputSample, block.volumesRight[index], output + (index * 2) + 1);
+
+	if(reverbOutput)
+	{
+		MixSample(inputSample, block.volumesLeft[index], reverbOutput + (index * 2) + 0);
+		MixSample(inputSample, block.volumesRight[index], reverbOutput + (index * 2) + 1);
+	}
+}
+
+void SpuVoiceMixer::MixVoiceScalar(const VOICE_BLOCK& block, unsigned int sampleCount, int16* output, int16* reverbOutput, INTERPOLATION interpolation)
+{
+	assert(sampleCount <= BLOCK_SAMPLES);
+	for(unsigned int i = 0; i < sampleCount; i++)
+	{
+		MixVoiceSample(block, i, output, reverbOutput, interpolation);
+	}
+}
+
+#if defined(FRAMEWORK_SIMD_USE_SSE) || defined(FRAMEWORK_SIMD_USE_NEON)
+
+//Weights are looked up for each sample and transposed to be used with vector operations
+static void GatherCubicCoefs(const SpuVoiceMixer::VOICE_BLOCK& block, unsigned int index, int16 coefs[4][8])
+{
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		const auto& sampleCoefs = GetCubicCoefs(block.alphas[index + i]);
+		coefs[0][i] = sampleCoefs[0];
+		coefs[1][i] = sampleCoefs[1];
+		coefs[2][i] = sampleCoefs[2];
+		coefs[3][i] = sampleCoefs[3];
+	}
+}
+
+#endif
+
+#if defined(FRAMEWORK_SIMD_USE_SSE)
+
+static inline void MultiplyWiden(__m128i a, __m128i b, __m128i& resultLo, __m128i& resultHi)
+{
+	__m128i productLo = _mm_mullo_epi16(a, b);
+	__m128i productHi = _mm_mulhi_epi16(a, b);
+	resultLo = _mm_unpacklo_epi16(productLo, productHi);
+	resultHi = _mm_unpackhi_epi16(productLo, productHi);
+}
+
+//Same as dividing by PITCH_BASE with C's integer division (rounds towards zero)
+static inline __m128i DivideByPitchBase(__m128i value)
+{
+	__m128i bias = _mm_and_si128(_mm_srai_epi32(value, 31), _mm_set1_epi32(PITCH_BASE - 1));
+	return _mm_srai_epi32(_mm_add_epi32(value, bias), 12);
+}
+
+//Same as dividing by MAX_VOLUME with C's integer division, exact for magnitudes below 0x3FFFFFFF
+static inline __m128i DivideByMaxVolume(__m128i value)
+{
+	__m128i sign = _mm_srai_epi32(value, 31);
+	__m128i absValue = _mm_sub_epi32(_mm_xor_si128(value, sign), sign);
+	__m128i result = _mm_add_epi32(_mm_add_epi32(absValue, _mm_srli_epi32(absValue, 15)), _mm_set1_epi32(1));
+	result = _mm_srli_epi32(result, 15);
+	return _mm_sub_epi32(_mm_xor_si128(result, sign), sign);
+}
+
+static inline __m128i Interpolate(__m128i currentSamples, __m128i nextSamples, __m128i alphas)
+{
+	__m128i currentLo, currentHi, nextLo, nextHi;
+	MultiplyWiden(currentSamples, _mm_sub_epi16(_mm_set1_epi16(PITCH_BASE), alphas), currentLo, currentHi);
+	MultiplyWiden(nextSamples, alphas, nextLo, nextHi);
+	__m128i resultLo = _mm_add_epi32(DivideByPitchBase(currentLo), DivideByPitchBase(nextLo));
+	__m128i resultHi = _mm_add_epi32(DivideByPitchBase(currentHi), DivideByPitchBase(nextHi));
+	return _mm_packs_epi32(resultLo, resultHi);
+}
+
+static inline __m128i InterpolateCubic(const SpuVoiceMixer::VOICE_BLOCK& block, unsigned int index)
+{
+	alignas(16) int16 coefs[4][8];
+	GatherCubicCoefs(block, index, coefs);
+
+	__m128i previousSamples = _mm_load_si128(reinterpret_cast<const __m128i*>(block.previousSamples + index));
+	__m128i currentSamples = _mm_load_si128(reinterpret_cast<const __m128i*>(block.currentSamples + index));
+	__m128i nextSamples = _mm_load_si128(reinterpret_cast<const __m128i*>(block.nextSamples + index));
+	__m128i afterNextSamples = _mm_load_si128(reinterpret_cast<const __m128i*>(block.afterNextSamples + index));
+	__m128i coefs0 = _mm_load_si128(reinterpret_cast<const __m128i*>(coefs[0]));
+	__m128i coefs1 = _mm_load_si128(reinterpret_cast<const __m128i*>(coefs[1]));
+	__m128i coefs2 = _mm_load_si128(reinterpret_cast<const __m128i*>(coefs[2]));
+	__m128i coefs3 = _mm_load_si128(reinterpret_cast<const __m128i*>(coefs[3]));
+
+	//Interleave samples and weights to multiply and add them in pairs
+	__m128i resultLo = _mm_add_epi32(
+	    _mm_madd_epi16(_mm_unpacklo_epi16(previousSamples, currentSamples), _mm_unpacklo_epi16(coefs0, coefs1)),
+	    _mm_madd_epi16(_mm_unpacklo_epi16(nextSamples, afterNextSamples), _mm_unpacklo_epi16(coefs2, coefs3)));
+	__m128i resultHi = _mm_add_epi32(
+	    _mm_madd_epi16(_mm_unpackhi_epi16(previousSamples, currentSamples), _mm_unpackhi_epi16(coefs0, coefs1)),
+	    _mm_madd_epi16(_mm_unpackhi_epi16(nextSamples, afterNextSamples), _mm_unpackhi_epi16(coefs2, coefs3)));
+	return _mm_packs_epi32(_mm_srai_epi32(resultLo, CUBIC_COEF_SHIFT), _mm_srai_epi32(resultHi, CUBIC_COEF_SHIFT));
+}
+
+static inline __m128i Scale(__m128i samples, __m128i volumes)
+{
+	__m128i productLo, productHi;
+	MultiplyWiden(samples, volumes, productLo, productHi);
+	return _mm_packs_epi32(DivideByMaxVolume(productLo), DivideByMaxVolume(productHi));
+}
+
+static inline void MixStereo(__m128i left, __m128i right, int16* output)
+{
+	auto dst = reinterpret_cast<__m128i*>(output);
+	_mm_storeu_si128(dst + 0, _mm_adds_epi16(_mm_loadu_si128(dst + 0), _mm_unpacklo_epi16(left, right)));
+	_mm_storeu_si128(dst + 1, _mm_adds_epi16(_mm_loadu_si128(dst + 1), _mm_unpackhi_epi16(left, right)));
+}
+
+void SpuVoiceMixer::MixVoice(const VOICE_BLOCK& block, unsigned int sampleCount, int16* output, int16* reverbOutput, INTERPOLATION interpolation)
+{
+	assert(sampleCount <= BLOCK_SAMPLES);
+	unsigned int i = 0;
+	for(; (i + 8) <= sampleCount; i += 8)
+	{
+		__m128i adsrVolumes = _mm_load_si128(reinterpret_cast<const __m128i*>(block.adsrVolumes + i));
+		__m128i volumesLeft = _mm_load_si128(reinterpret_cast<const __m128i*>(block.volumesLeft + i));
+		__m128i volumesRight = _mm_load_si128(reinterpret_cast<const __m128i*>(block.volumesRight + i));
+
+		__m128i readSamples;
+		if(interpolation == INTERPOLATION_CUBIC)
+		{
+			readSamples = InterpolateCubic(block, i);
+		}
+		else
+		{
+			__m128i currentSamples = _mm_load_si128(reinterpret_cast<const __m128i*>(block.currentSamples + i));
+			__m128i nextSamples = _mm_load_si128(reinterpret_cast<const __m128i*>(block.nextSamples + i));
+			__m128i alphas = _mm_load_si128(reinterpret_cast<const __m128i*>(block.alphas + i));
+			readSamples = Interpolate(currentSamples, nextSamples, alphas);
+		}
+
+		__m128i inputSamples = Scale(readSamples, adsrVolumes);
+		__m128i left = Scale(inputSamples, volumesLeft);
+		__m128i right = Scale(inputSamples, volumesRight);
+
+		MixStereo(left, right, output + (i * 2));
+		if(reverbOutput)
+		{
+			MixStereo(left, right, reverbOutput + (i * 2));
+		}
+	}
+	for(; i < sampleCount; i++)
+	{
+		MixVoiceSample(block, i, output, reverbOutput, interpolation);
+	}
+}
+
+#elif defined(FRAMEWORK_SIMD_USE_NEON)
+
+//Same as dividing by PITCH_BASE with C's integer division (rounds towards zero)
+static inline int32x4_t DivideByPitchBase(int32x4_t value)
+{
+	int32x4_t bias = vandq_s32(vshrq_n_s32(value, 31), vdupq_n_s32(PITCH_BASE - 1));
+	return vshrq_n_s32(vaddq_s32(value, bias), 12);
+}
+
+//Same as dividing by MAX_VOLUME with C's integer division, exact for magnitudes below 0x3FFFFFFF
+static inline int32x4_t DivideByMaxVolume(int32x4_t value)
+{
+	int32x4_t sign = vshrq_n_s32(value, 31);
+	uint32x4_t absValue = vreinterpretq_u32_s32(vabsq_s32(value));
+	uint32x4_t result = vaddq_u32(vaddq_u32(absValue, vshrq_n_u32(absValue, 15)), vdupq_n_u32(1));
+	result = vshrq_n_u32(result, 15);
+	return vsubq_s32(veorq_s32(vreinterpretq_s32_u32(result), sign), sign);
+}
+
+static inline int16x8_t Interpolate(int16x8_t currentSamples, int16x8_t nextSamples, int16x8_t alphas)
+{
+	int16x8_t weights = vsubq_s16(vdupq_n_s16(PITCH_BASE), alphas);
+	int32x4_t resultLo = vaddq_s32(
+	    DivideByPitchBase(vmull_s16(vget_low_s16(currentSamples), vget_low_s16(weights))),
+	    DivideByPitchBase(vmull_s16(vget_low_s16(nextSamples), vget_low_s16(alphas))));
+	int32x4_t resultHi = vaddq_s32(
+	    DivideByPitchBase(vmull_s16(vget_high_s16(currentSamples), vget_high_s16(weights))),
+	    DivideByPitchBase(vmull_s16(vget_high_s16(nextSamples), vget_high_s16(alphas))));
+	return vcombine_s16(vqmovn_s32(resultLo), vqmovn_s32(resultHi));
+}
+
+static inline int16x8_t InterpolateCubic(const SpuVoiceMixer::VOICE_BLOCK& block, unsigned int index)
+{
+	alignas(16) int16 coefs[4][8];
+	GatherCubicCoefs(block, index, coefs);
+
+	int16x8_t previousSamples = vld1q_s16(block.previousSamples + index);
+	int16x8_t currentSamples = vld1q_s16(block.currentSamples + index);
+	int16x8_t nextSamples = vld1q_s16(block.nextSamples + index);
+	int16x8_t afterNextSamples = vld1q_s16(block.afterNextSamples + index);
+	int16x8_t coefs0 = vld1q_s16(coefs[0]);
+	int16x8_t coefs1 = vld1q_s16(coefs[1]);
+	int16x8_t coefs2 = vld1q_s16(coefs[2]);
+	int16x8_t coefs3 = vld1q_s16(coefs[3]);
+
+	int32x4_t resultLo = vmull_s16(vget_low_s16(previousSamples), vget_low_s16(coefs0));
+	resultLo = vmlal_s16(resultLo, vget_low_s16(currentSamples), vget_low_s16(coefs1));
+	resultLo = vmlal_s16(resultLo, vget_low_s16(nextSamples), vget_low_s16(coefs2));
+	resultLo = vmlal_s16(resultLo, vget_low_s16(afterNextSamples), vget_low_s16(coefs3));
+	int32x4_t resultHi = vmull_s16(vget_high_s16(previousSamples), vget_high_s16(coefs0));
+	resultHi = vmlal_s16(resultHi, vget_high_s16(currentSamples), vget_high_s16(coefs1));
+	resultHi = vmlal_s16(resultHi, vget_high_s16(nextSamples), vget_high_s16(coefs2));
+	resultHi = vmlal_s16(resultHi, vget_high_s16(afterNextSamples), vget_high_s16(coefs3));
+	return vcombine_s16(vqmovn_s32(vshrq_n_s32(resultLo, CUBIC_COEF_SHIFT)), vqmovn_s32(vshrq_n_s32(resultHi, CUBIC_COEF_SHIFT)));
+}
+
+static inline int16x8_t Scale(int16x8_t samples, int16x8_t volumes)
+{
+	int32x4_t productLo = vmull_s16(vget_low_s16(samples), vget_low_s16(volumes));
+	int32x4_t productHi = vmull_s16(vget_high_s16(samples), vget_high_s16(volumes));
+	return vcombine_s16(vqmovn_s32(DivideByMaxVolume(productLo)), vqmovn_s32(DivideByMaxVolume(productHi)));
+}
+
+static inline void MixStereo(int16x8_t left, int16x8_t right, int16* output)
+{
+	int16x8x2_t samples = vld2q_s16(output);
+	samples.val[0] = vqaddq_s16(samples.val[0], left);
+	samples.val[1] = vqaddq_s16(samples.val[1], right);
+	vst2q_s16(output, samples);
+}
+
+void SpuVoiceMixer::MixVoice(const VOICE_BLOCK& block, unsigned int sampleCount, int16* output, int16* reverbOutput, INTERPOLATION interpolation)
+{
+	assert(sampleCount <= BLOCK_SAMPLES);
+	unsigned int i = 0;
+	for(; (i + 8) <= sampleCount; i += 8)
+	{
+		int16x8_t readSamples = (interpolation == INTERPOLATION_CUBIC)
+		                            ? InterpolateCubic(block, i)
+		                            : Interpolate(vld1q_s16(block.currentSamples + i), vld1q_s16(block.nextSamples + i), vld1q_s16(block.alphas + i));
+		int16x8_t inputSamples = Scale(readSamples, vld1q_s16(block.adsrVolumes + i));
+		int16x8_t left = Scale(inputSamples, vld1q_s16(block.volumesLeft + i));
+		int16x8_t right = Scale(inputSamples, vld1q_s16(block.volumesRight + i));
+
+		MixStereo(left, right, output + (i * 2));
+		if(reverbOutput)
+		{
+			MixStereo(left, right, reverbOutput + (i * 2));
+		}
+	}
+	for(; i < sampleCount; i++)
+	{
+		MixVoiceSample(block, i, output, reverbOutput, interpolation);
+	}
+}
+
+#else
+
+void SpuVoiceMixer::MixVoice(const VOICE_BLOCK& block, unsigned int sampleCount, int16* output, int16* reverbOutput, INTERPOLATION interpolation)
+{
+	MixVoiceScalar(block, sampleCount, output, reverbOutput, interpolation);
+}
+
+#endif
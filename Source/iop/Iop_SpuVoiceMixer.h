@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Types.h"
+
+//Mixes a voice's output over a block of samples. Per sample inputs are gathered by CSpuBase
+//while it steps through the voice's state (sample reader, ADSR and volume sweeps) and
+//are then interpolated, scaled and mixed here. SIMD versions use the same integer
+//operations as the scalar versions and produce exactly the same output.
+//Linear interpolation only uses the samples on each side of the interpolation point,
+//cubic interpolation uses 4 samples with a polyphase filter (Catmull-Rom spline) and
+//costs more, but has less aliasing when voices are resampled to the output rate.
+
+namespace Iop
+{
+	namespace SpuVoiceMixer
+	{
+		enum
+		{
+			BLOCK_SAMPLES = 64,
+		};
+
+		enum INTERPOLATION
+		{
+			INTERPOLATION_LINEAR,
+			INTERPOLATION_CUBIC,
+		};
+
+		struct VOICE_BLOCK
+		{
+			//Samples on each side of the interpolation point and weight of the next one (0 - 0xFFF)
+			alignas(16) int16 currentSamples[BLOCK_SAMPLES];
+			alignas(16) int16 nextSamples[BLOCK_SAMPLES];
+			//Samples before the current one and after the next one (only used by cubic interpolation)
+			alignas(16) int16 previousSamples[BLOCK_SAMPLES];
+			alignas(16) int16 afterNextSamples[BLOCK_SAMPLES];
+			alignas(16) int16 alphas[BLOCK_SAMPLES];
+			//Upper 16 bits of ADSR and channel volumes
+			alignas(16) int16 adsrVolumes[BLOCK_SAMPLES];
+			alignas(16) int16 volumesLeft[BLOCK_SAMPLES];
+			alignas(16) int16 volumesRight[BLOCK_SAMPLES];
+		};
+
+		//Output buffers contain interleaved stereo samples, reverb output can be null
+		void MixVoice(const VOICE_BLOCK&, unsigned int, int16*, int16*, INTERPOLATION);
+		void MixVoiceScalar(const VOICE_BLOCK&, unsigned int, int16*, int16*, INTERPOLATION);
+	}
+}
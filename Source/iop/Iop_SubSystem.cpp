@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <climits>
 #include "Iop_SubSystem.h"
 #include "IopBios.h"
 #include "GenericMipsExecutor.h"
@@ -80,8 +82,8 @@ CSubSystem::CSubSystem(bool ps2Mode)
 	m_cpu.m_pCOP[0] = &m_copScu;
 	m_cpu.m_pAddrTranslator = &CMIPS::TranslateAddress64;
 
-	m_dmac.SetReceiveFunction(CDmac::CHANNEL_SPU0, std::bind(&CSpuBase::ReceiveDma, &m_spuCore0, PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
-	m_dmac.SetReceiveFunction(CDmac::CHANNEL_SPU1, std::bind(&CSpuBase::ReceiveDma, &m_spuCore1, PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
+	m_dmac.SetReceiveFunction(CDmac::CHANNEL_SPU0, std::bind(&CSubSystem::ReceiveSpuDma, this, std::ref(m_spuCore0), PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
+	m_dmac.SetReceiveFunction(CDmac::CHANNEL_SPU1, std::bind(&CSubSystem::ReceiveSpuDma, this, std::ref(m_spuCore1), PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
 	m_dmac.SetReceiveFunction(CDmac::CHANNEL_DEV9, std::bind(&CSpeed::ReceiveDma, &m_speed, PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
 	m_dmac.SetReceiveFunction(CDmac::CHANNEL_SIO2in, std::bind(&CSio2::ReceiveDmaIn, &m_sio2, PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
 	m_dmac.SetReceiveFunction(CDmac::CHANNEL_SIO2out, std::bind(&CSio2::ReceiveDmaOut, &m_sio2, PLACEHOLDER_1, PLACEHOLDER_2, PLACEHOLDER_3, PLACEHOLDER_4));
@@ -92,6 +94,8 @@ CSubSystem::CSubSystem(bool ps2Mode)
 CSubSystem::~CSubSystem()
 {
 	m_bios.reset();
+	//Make sure nothing is still rendering from SPU RAM
+	m_spuRenderThread.reset();
 	delete[] m_ram;
 	delete[] m_scratchPad;
 	delete[] m_spuRam;
@@ -111,6 +115,7 @@ void CSubSystem::NotifyVBlankEnd()
 
 void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive)
 {
+	SyncSpu();
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_CPU, &m_cpu.m_State, sizeof(MIPSSTATE)));
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_RAM, m_ram, IOP_RAM_SIZE));
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_SCRATCH, m_scratchPad, IOP_SCRATCH_SIZE));
@@ -138,6 +143,7 @@ void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive)
 
 void CSubSystem::LoadState(Framework::CZipArchiveReader& archive)
 {
+	SyncSpu();
 	m_bios->PreLoadState();
 
 	//Read and check differences in memory to invalidate executor blocks only if necessary
@@ -182,6 +188,7 @@ void CSubSystem::LoadState(Framework::CZipArchiveReader& archive)
 
 void CSubSystem::Reset()
 {
+	SyncSpu();
 	memset(m_ram, 0, IOP_RAM_SIZE);
 	memset(m_scratchPad, 0, IOP_SCRATCH_SIZE);
 	memset(m_spuRam, 0, SPU_RAM_SIZE);
@@ -233,6 +240,7 @@ uint32 CSubSystem::ReadIoRegister(uint32 address)
 	}
 	else if(address >= CSpu::SPU_BEGIN && address <= CSpu::SPU_END)
 	{
+		SyncSpu();
 		return m_spu.ReadRegister(address);
 	}
 	else if(
@@ -260,6 +268,7 @@ uint32 CSubSystem::ReadIoRegister(uint32 address)
 #endif
 	else if(address >= CSpu2::REGS_BEGIN && address <= CSpu2::REGS_END)
 	{
+		SyncSpu();
 		return m_spu2.ReadRegister(address);
 	}
 	else if((address >= 0x1F801000 && address <= 0x1F801020) || (address >= 0x1F801400 && address <= 0x1F801420))
@@ -287,6 +296,12 @@ uint32 CSubSystem::ReadIoRegister(uint32 address)
 
 uint32 CSubSystem::WriteIoRegister(uint32 address, uint32 value)
 {
+	if(m_spuRenderPending && IsSpuRegister(address))
+	{
+		//Applied in order once rendering is done (see SyncSpu)
+		m_pendingSpuWrites.push_back({address, value});
+		return 0;
+	}
 	if(address >= CSpu::SPU_BEGIN && address <= CSpu::SPU_END)
 	{
 		m_spu.WriteRegister(address, static_cast<uint16>(value));
@@ -380,13 +395,11 @@ void CSubSystem::CountTicks(int ticks)
 		m_dmac.ResumeDma(Iop::CDmac::CHANNEL_SPU1);
 		m_dmaUpdateTicks -= g_dmaUpdateDelay;
 	}
+	m_dmac.CountTicks(ticks);
 	m_spuIrqUpdateTicks += ticks;
 	if(m_spuIrqUpdateTicks >= g_spuIrqCheckDelay)
 	{
-		bool irqPending = false;
-		irqPending |= m_spuCore0.GetIrqPending();
-		irqPending |= m_spuCore1.GetIrqPending();
-		if(irqPending)
+		if(GetSpuIrqPending())
 		{
 			m_intc.AssertLine(CIntc::LINE_SPU2);
 		}
@@ -427,3 +440,88 @@ int CSubSystem::ExecuteCpu(int quota)
 	}
 	return executed;
 }
+
+void CSubSystem::SetSpuRenderThreadEnabled(bool enabled)
+{
+	SyncSpu();
+	if(enabled && !m_spuRenderThread)
+	{
+		m_spuRenderThread = std::make_unique<CSpuRenderThread>();
+	}
+	else if(!enabled)
+	{
+		m_spuRenderThread.reset();
+	}
+}
+
+void CSubSystem::RenderSpu(int16* samples, unsigned int sampleCount)
+{
+	SyncSpu();
+	if(!m_spuRenderThread)
+	{
+		RenderSpuImpl(samples, sampleCount);
+		return;
+	}
+
+	//SPU state belongs to the render thread until SyncSpu is called. Anything that accesses it
+	//calls SyncSpu first, so the emulated side always sees it as if rendering was synchronous.
+	m_spuRenderMayRaiseIrq = ((m_spuCore0.GetControl() | m_spuCore1.GetControl()) & CSpuBase::CONTROL_IRQ) != 0;
+	m_spuRenderPending = true;
+	m_spuRenderThread->StartJob([this, samples, sampleCount]() { RenderSpuImpl(samples, sampleCount); });
+}
+
+void CSubSystem::SyncSpu()
+{
+	if(!m_spuRenderPending) return;
+
+	m_spuRenderThread->WaitForJob();
+	m_spuRenderPending = false;
+
+	for(const auto& write : m_pendingSpuWrites)
+	{
+		WriteIoRegister(write.address, write.value);
+	}
+	m_pendingSpuWrites.clear();
+}
+
+void CSubSystem::RenderSpuImpl(int16* samples, unsigned int sampleCount)
+{
+	m_spuCore0.Render(samples, sampleCount);
+
+	if(m_spuCore1.IsEnabled())
+	{
+		m_spuCore1Samples.resize(sampleCount);
+		auto samplesSpu1 = m_spuCore1Samples.data();
+		m_spuCore1.Render(samplesSpu1, sampleCount);
+
+		for(unsigned int i = 0; i < sampleCount; i++)
+		{
+			int32 resultSample = static_cast<int32>(samples[i]) + static_cast<int32>(samplesSpu1[i]);
+			resultSample = std::max<int32>(resultSample, SHRT_MIN);
+			resultSample = std::min<int32>(resultSample, SHRT_MAX);
+			samples[i] = static_cast<int16>(resultSample);
+		}
+	}
+}
+
+bool CSubSystem::IsSpuRegister(uint32 address) const
+{
+	return (address >= CSpu::SPU_BEGIN && address <= CSpu::SPU_END) ||
+	       (address >= CSpu2::REGS_BEGIN && address <= CSpu2::REGS_END);
+}
+
+uint32 CSubSystem::ReceiveSpuDma(CSpuBase& spuCore, uint8* buffer, uint32 blockSize, uint32 blockAmount, uint32 direction)
+{
+	SyncSpu();
+	return spuCore.ReceiveDma(buffer, blockSize, blockAmount, direction);
+}
+
+bool CSubSystem::GetSpuIrqPending()
+{
+	//A render with IRQs disabled leaves IRQ flags alone, no need to wait for it
+	if(m_spuRenderMayRaiseIrq || !m_pendingSpuWrites.empty())
+	{
+		SyncSpu();
+	}
+	return m_spuCore0.GetIrqPending() || m_spuCore1.GetIrqPending();
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "../MIPS.h"
 #include "../MA_MIPSIV.h"
 #include "../COP_SCU.h"
@@ -13,6 +14,7 @@
 #include "Iop_SpuBase.h"
 #include "Iop_Spu.h"
 #include "Iop_Spu2.h"
+#include "Iop_SpuRenderThread.h"
 #include "Iop_Sio2.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
@@ -36,6 +38,10 @@ namespace Iop
 		void SaveState(Framework::CZipArchiveWriter&);
 		void LoadState(Framework::CZipArchiveReader&);
 
+		void SetSpuRenderThreadEnabled(bool);
+		void RenderSpu(int16*, unsigned int);
+		void SyncSpu();
+
 		CMIPS m_cpu;
 		CMA_MIPSIV m_cpuArch;
 		CCOP_SCU m_copScu;
@@ -75,7 +81,24 @@ namespace Iop
 
 		void CheckPendingInterrupts();
 
+		void RenderSpuImpl(int16*, unsigned int);
+		bool IsSpuRegister(uint32) const;
+		uint32 ReceiveSpuDma(CSpuBase&, uint8*, uint32, uint32, uint32);
+		bool GetSpuIrqPending();
+
+		struct SPU_REGISTER_WRITE
+		{
+			uint32 address;
+			uint32 value;
+		};
+
 		int m_dmaUpdateTicks = 0;
 		int m_spuIrqUpdateTicks = 0;
+
+		std::unique_ptr<CSpuRenderThread> m_spuRenderThread;
+		bool m_spuRenderPending = false;
+		bool m_spuRenderMayRaiseIrq = false;
+		std::vector<SPU_REGISTER_WRITE> m_pendingSpuWrites;
+		std::vector<int16> m_spuCore1Samples;
 	};
 }
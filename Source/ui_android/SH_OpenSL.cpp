@@ -1,7 +1,9 @@
 #include <cassert>
+#include <cstring>
 #include "SH_OpenSL.h"
 
 CSH_OpenSL::CSH_OpenSL()
+    : m_ringBuffer(RING_SAMPLES, RING_MAX_WRITE_SAMPLES)
 {
 	SLresult result = SL_RESULT_SUCCESS;
 
@@ -20,7 +22,8 @@ CSH_OpenSL::CSH_OpenSL()
 
 CSH_OpenSL::~CSH_OpenSL()
 {
-	Reset();
+	(*m_playerPlay)->SetPlayState(m_playerPlay, SL_PLAYSTATE_STOPPED);
+	(*m_playerQueue)->Clear(m_playerQueue);
 	(*m_playerObject)->Destroy(m_playerObject);
 	(*m_outputMixObject)->Destroy(m_outputMixObject);
 	(*m_engineObject)->Destroy(m_engineObject);
@@ -96,6 +99,22 @@ void CSH_OpenSL::CreateAudioPlayer()
 
 	result = (*m_playerPlay)->SetPlayState(m_playerPlay, SL_PLAYSTATE_PLAYING);
 	assert(result == SL_RESULT_SUCCESS);
+
+	for(unsigned int i = 0; i < BUFFER_COUNT; i++)
+	{
+		EnqueueBuffer();
+	}
+}
+
+void CSH_OpenSL::EnqueueBuffer()
+{
+	auto buffer = m_buffers[m_currentBuffer];
+	m_ringBuffer.Read(buffer, BUFFER_SAMPLES);
+
+	SLresult result = (*m_playerQueue)->Enqueue(m_playerQueue, buffer, BUFFER_SAMPLES * sizeof(int16));
+	assert(result == SL_RESULT_SUCCESS);
+
+	m_currentBuffer = (m_currentBuffer + 1) % BUFFER_COUNT;
 }
 
 void CSH_OpenSL::QueueCallback(SLAndroidSimpleBufferQueueItf, void* context)
@@ -105,34 +124,39 @@ void CSH_OpenSL::QueueCallback(SLAndroidSimpleBufferQueueItf, void* context)
 
 void CSH_OpenSL::QueueCallbackImpl()
 {
-	assert(m_bufferCount != BUFFER_COUNT);
-	m_bufferCount++;
+	std::lock_guard<std::mutex> queueLock(m_queueMutex);
+
+	//Queue might have been refilled by Reset while this callback was waiting
+	SLAndroidSimpleBufferQueueState queueState = {};
+	SLresult result = (*m_playerQueue)->GetState(m_playerQueue, &queueState);
+	assert(result == SL_RESULT_SUCCESS);
+	if(queueState.count >= BUFFER_COUNT) return;
+
+	EnqueueBuffer();
 }
 
 void CSH_OpenSL::Reset()
 {
 	assert(m_playerQueue != nullptr);
 
+	std::lock_guard<std::mutex> queueLock(m_queueMutex);
+
 	SLresult result = SL_RESULT_SUCCESS;
 
+	//A callback might already be running, holding the lock keeps it from reading the ring while it's reset
 	result = (*m_playerQueue)->Clear(m_playerQueue);
 	assert(result == SL_RESULT_SUCCESS);
 
-	m_bufferCount = BUFFER_COUNT;
+	m_ringBuffer.Reset();
+	for(unsigned int i = 0; i < BUFFER_COUNT; i++)
+	{
+		EnqueueBuffer();
+	}
 }
 
 void CSH_OpenSL::Write(int16* buffer, unsigned int sampleCount, unsigned int)
 {
-	if(m_bufferCount == 0) return;
-
-	assert(m_playerQueue != nullptr);
-
-	SLresult result = SL_RESULT_SUCCESS;
-
-	result = (*m_playerQueue)->Enqueue(m_playerQueue, buffer, sampleCount * sizeof(int16));
-	assert(result == SL_RESULT_SUCCESS);
-
-	m_bufferCount--;
+	m_ringBuffer.Write(buffer, sampleCount);
 }
 
 bool CSH_OpenSL::HasFreeBuffers()
@@ -143,3 +167,8 @@ bool CSH_OpenSL::HasFreeBuffers()
 void CSH_OpenSL::RecycleBuffers()
 {
 }
+
+CSoundRingBuffer* CSH_OpenSL::GetRingBuffer()
+{
+	return &m_ringBuffer;
+}
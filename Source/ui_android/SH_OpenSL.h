@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../../tools/PsfPlayer/Source/SoundHandler.h"
+#include <mutex>
+#include "SoundRingBuffer.h"
 #include <SLES/OpenSLES.h>
 #include <SLES/OpenSLES_Android.h>
 
@@ -16,15 +18,21 @@ public:
 	void Write(int16*, unsigned int, unsigned int) override;
 	bool HasFreeBuffers() override;
 	void RecycleBuffers() override;
+	CSoundRingBuffer* GetRingBuffer() override;
 
 private:
+	//Buffers are refilled from the ring as soon as the player is done with them
 	enum
 	{
-		BUFFER_COUNT = 5,
+		BUFFER_COUNT = 2,
+		BUFFER_SAMPLES = 0x200,
+		RING_SAMPLES = 0x4000,
+		RING_MAX_WRITE_SAMPLES = 0x400,
 	};
 
 	void CreateOutputMix();
 	void CreateAudioPlayer();
+	void EnqueueBuffer();
 
 	static void QueueCallback(SLAndroidSimpleBufferQueueItf, void*);
 	void QueueCallbackImpl();
@@ -38,5 +46,9 @@ private:
 	SLPlayItf m_playerPlay = nullptr;
 	SLAndroidSimpleBufferQueueItf m_playerQueue = nullptr;
 
-	uint32 m_bufferCount = BUFFER_COUNT;
+	//Serializes buffer refills between the player's callback and Reset
+	std::mutex m_queueMutex;
+	CSoundRingBuffer m_ringBuffer;
+	int16 m_buffers[BUFFER_COUNT][BUFFER_SAMPLES];
+	uint32 m_currentBuffer = 0;
 };
@@ -993,30 +993,38 @@ fs::path MainWindow::GetFrameDumpDirectoryPath()
 
 void MainWindow::DumpNextFrame()
 {
-	m_virtualMachine->m_ee->m_gs->TriggerFrameDump(
-	    [&](const CFrameDump& frameDump) {
-		    try
-		    {
-			    auto frameDumpDirectoryPath = GetFrameDumpDirectoryPath();
-			    Framework::PathUtils::EnsurePathExists(frameDumpDirectoryPath);
-			    for(unsigned int i = 0; i < UINT_MAX; i++)
-			    {
-				    auto frameDumpFileName = string_format("framedump_%08d.dmp.zip", i);
-				    auto frameDumpPath = frameDumpDirectoryPath / fs::path(frameDumpFileName);
-				    if(!fs::exists(frameDumpPath))
-				    {
-					    auto dumpStream = Framework::CreateOutputStdStream(frameDumpPath.native());
-					    frameDump.Write(dumpStream);
-					    m_msgLabel->setText(QString("Dumped frame to '%1'.").arg(frameDumpFileName.c_str()));
-					    return;
-				    }
-			    }
-		    }
-		    catch(...)
-		    {
-		    }
-		    m_msgLabel->setText(QString("Failed to dump frame."));
-	    });
+	try
+	{
+		auto frameDumpDirectoryPath = GetFrameDumpDirectoryPath();
+		Framework::PathUtils::EnsurePathExists(frameDumpDirectoryPath);
+		for(unsigned int i = 0; i < UINT_MAX; i++)
+		{
+			auto frameDumpFileName = string_format("framedump_%08d.dmp", i);
+			auto frameDumpPath = frameDumpDirectoryPath / fs::path(frameDumpFileName);
+			if(!fs::exists(frameDumpPath))
+			{
+				//Packets are streamed to the file as they are received by the GS
+				auto dumpStream = std::make_shared<Framework::CStdStream>(frameDumpPath.native().c_str(), Framework::GetOutputStdStreamMode<fs::path::string_type>());
+				m_virtualMachine->m_ee->m_gs->TriggerFrameDumpStream(
+				    dumpStream, 1,
+				    [this, frameDumpFileName](bool succeeded) {
+					    if(succeeded)
+					    {
+						    m_msgLabel->setText(QString("Dumped frame to '%1'.").arg(frameDumpFileName.c_str()));
+					    }
+					    else
+					    {
+						    m_msgLabel->setText(QString("Failed to dump frame."));
+					    }
+				    });
+				return;
+			}
+		}
+	}
+	catch(...)
+	{
+	}
+	m_msgLabel->setText(QString("Failed to dump frame."));
 }
 
 void MainWindow::ToggleGsDraw()
@@ -1029,6 +1037,52 @@ void MainWindow::ToggleGsDraw()
 	m_msgLabel->setText(newState ? QString("GS Draw Enabled") : QString("GS Draw Disabled"));
 }
 
+fs::path MainWindow::GetIpuTraceDirectoryPath()
+{
+	return CAppConfig::GetInstance().GetBasePath() / fs::path("iputraces/");
+}
+
+void MainWindow::ToggleIpuTrace()
+{
+	if(debugMenuUi->actionIpuTrace->isChecked())
+	{
+		m_virtualMachine->BeginIpuTrace();
+		m_msgLabel->setText(QString("Recording IPU trace."));
+		return;
+	}
+
+	try
+	{
+		auto traceDirectoryPath = GetIpuTraceDirectoryPath();
+		Framework::PathUtils::EnsurePathExists(traceDirectoryPath);
+		for(unsigned int i = 0; i < UINT_MAX; i++)
+		{
+			auto traceFileName = string_format("iputrace_%08d.ipt", i);
+			auto tracePath = traceDirectoryPath / fs::path(traceFileName);
+			if(!fs::exists(tracePath))
+			{
+				auto future = m_virtualMachine->EndIpuTrace(tracePath);
+				m_continuationChecker->GetContinuationManager().Register(std::move(future),
+				                                                         [this, traceFileName](const bool& succeeded) {
+					                                                         if(succeeded)
+					                                                         {
+						                                                         m_msgLabel->setText(QString("Saved IPU trace to '%1'.").arg(traceFileName.c_str()));
+					                                                         }
+					                                                         else
+					                                                         {
+						                                                         m_msgLabel->setText(QString("Failed to save IPU trace."));
+					                                                         }
+				                                                         });
+				return;
+			}
+		}
+	}
+	catch(...)
+	{
+	}
+	m_msgLabel->setText(QString("Failed to save IPU trace."));
+}
+
 #endif
 
 void MainWindow::on_actionPause_when_focus_is_lost_triggered(bool checked)
@@ -1178,6 +1232,7 @@ void MainWindow::SetupDebugger()
 		connect(debugMenuUi->actionShowFrameDebugger, &QAction::triggered, this, std::bind(&MainWindow::ShowFrameDebugger, this));
 		connect(debugMenuUi->actionDumpNextFrame, &QAction::triggered, this, std::bind(&MainWindow::DumpNextFrame, this));
 		connect(debugMenuUi->actionGsDrawEnabled, &QAction::triggered, this, std::bind(&MainWindow::ToggleGsDraw, this));
+		connect(debugMenuUi->actionIpuTrace, &QAction::triggered, this, std::bind(&MainWindow::ToggleIpuTrace, this));
 	}
 
 #if defined(__APPLE__)
@@ -54,6 +54,8 @@ public:
 	fs::path GetFrameDumpDirectoryPath();
 	void DumpNextFrame();
 	void ToggleGsDraw();
+	fs::path GetIpuTraceDirectoryPath();
+	void ToggleIpuTrace();
 #endif
 
 private:
@@ -12,6 +12,36 @@ void CStatsManager::OnNewFrame(CPS2VM* virtualMachine)
 		m_cpuUtilisation.eeIdleTicks += cpuUtilisation.eeIdleTicks;
 		m_cpuUtilisation.iopTotalTicks += cpuUtilisation.iopTotalTicks;
 		m_cpuUtilisation.iopIdleTicks += cpuUtilisation.iopIdleTicks;
+
+		auto dmaStats = virtualMachine->GetDmaStatsInfo();
+		for(unsigned int i = 0; i < CDMAC::CHANNEL_COUNT; i++)
+		{
+			AccumulateDmaChannelStats(m_dmaStats.eeChannels[i], dmaStats.eeChannels[i]);
+		}
+		for(unsigned int i = 0; i < Iop::CDmac::MAX_CHANNEL; i++)
+		{
+			AccumulateDmaChannelStats(m_dmaStats.iopChannels[i], dmaStats.iopChannels[i]);
+		}
+		m_dmaStats.sif.packetCount += dmaStats.sif.packetCount;
+		m_dmaStats.sif.qwordCount += dmaStats.sif.qwordCount;
+		m_dmaStats.sif.callCount += dmaStats.sif.callCount;
+		m_dmaStats.sif.waitTicks += dmaStats.sif.waitTicks;
+
+		auto cdromCacheStats = virtualMachine->GetCdromCacheStats();
+		m_cdromCacheStats.hitCount += cdromCacheStats.hitCount;
+		m_cdromCacheStats.missCount += cdromCacheStats.missCount;
+		m_cdromCacheStats.savedBytes += cdromCacheStats.savedBytes;
+
+		//Fill levels are sampled, counters are accumulated
+		auto soundStats = virtualMachine->GetSoundStats();
+		m_soundStats.fillLevel = soundStats.fillLevel;
+		m_soundStats.targetFillLevel = soundStats.targetFillLevel;
+		m_soundStats.underrunCount += soundStats.underrunCount;
+		m_soundStats.droppedWriteCount += soundStats.droppedWriteCount;
+
+		auto spuSampleCacheStats = virtualMachine->GetSpuSampleCacheStats();
+		m_spuSampleCacheStats.hitCount += spuSampleCacheStats.hitCount;
+		m_spuSampleCacheStats.missCount += spuSampleCacheStats.missCount;
 	}
 
 #ifdef PROFILE
@@ -46,6 +76,15 @@ float CStatsManager::ComputeCpuUsageRatio(int32 idleTicks, int32 totalTicks)
 	return (1.f - idleRatio) * 100.f;
 }
 
+void CStatsManager::AccumulateDmaChannelStats(DMA_CHANNEL_STATS& total, const DMA_CHANNEL_STATS& stats)
+{
+	total.qwordCount += stats.qwordCount;
+	total.tagCount += stats.tagCount;
+	total.stallCount += stats.stallCount;
+	total.resumeCount += stats.resumeCount;
+	total.waitTicks += stats.waitTicks;
+}
+
 uint32 CStatsManager::GetFrames()
 {
 	std::lock_guard<std::mutex> statsLock(m_statsMutex);
@@ -64,6 +103,30 @@ CPS2VM::CPU_UTILISATION_INFO CStatsManager::GetCpuUtilisationInfo()
 	return m_cpuUtilisation;
 }
 
+CPS2VM::DMA_STATS_INFO CStatsManager::GetDmaStatsInfo()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_dmaStats;
+}
+
+CPS2VM::CDROM_CACHE_STATS CStatsManager::GetCdromCacheStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_cdromCacheStats;
+}
+
+CPS2VM::SOUND_STATS CStatsManager::GetSoundStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_soundStats;
+}
+
+CPS2VM::SPU_SAMPLE_CACHE_STATS CStatsManager::GetSpuSampleCacheStats()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_spuSampleCacheStats;
+}
+
 #ifdef PROFILE
 
 std::string CStatsManager::GetProfilingInfo()
@@ -107,6 +170,70 @@ std::string CStatsManager::GetProfilingInfo()
 		result += string_format("IOP Usage: %6.2f%%\r\n", iopUsageRatio);
 	}
 
+	{
+		static const char* eeChannelNames[CDMAC::CHANNEL_COUNT] =
+		    {
+		        "VIF0", "VIF1", "GIF", "fromIPU", "toIPU", "SIF0", "SIF1", "SIF2", "fromSPR", "toSPR"};
+
+		//Per frame averages, wait time is relative to the CPU's total time
+		float frames = std::max<float>(m_frames, 1);
+		auto formatChannelStats =
+		    [&](const char* name, const DMA_CHANNEL_STATS& stats, int32 totalTicks) {
+			    if((stats.qwordCount == 0) && (stats.tagCount == 0) && (stats.stallCount == 0)) return;
+			    float waitRatio = (totalTicks > 0) ? static_cast<float>(stats.waitTicks) / static_cast<float>(totalTicks) : 0;
+			    result += string_format("%10s %8.1f %6.1f %6.1f %6.1f %6.2f%%\r\n", name,
+			                            stats.qwordCount / frames, stats.tagCount / frames,
+			                            stats.stallCount / frames, stats.resumeCount / frames, waitRatio * 100.f);
+		    };
+
+		result += string_format("\r\n%10s %8s %6s %6s %6s %7s\r\n", "DMA", "QW", "Tags", "Stalls", "Resume", "Wait");
+		for(unsigned int i = 0; i < CDMAC::CHANNEL_COUNT; i++)
+		{
+			formatChannelStats(eeChannelNames[i], m_dmaStats.eeChannels[i], m_cpuUtilisation.eeTotalTicks);
+		}
+		for(unsigned int i = 0; i < Iop::CDmac::MAX_CHANNEL; i++)
+		{
+			auto name = string_format("IOP%d", i);
+			formatChannelStats(name.c_str(), m_dmaStats.iopChannels[i], m_cpuUtilisation.iopTotalTicks);
+		}
+
+		const auto& sifStats = m_dmaStats.sif;
+		float sifWaitRatio = (m_cpuUtilisation.eeTotalTicks > 0) ? static_cast<float>(sifStats.waitTicks) / static_cast<float>(m_cpuUtilisation.eeTotalTicks) : 0;
+		result += string_format("SIF: %6.1f packets %8.1f QW %6.1f calls %6.2f%% wait\r\n",
+		                        sifStats.packetCount / frames, sifStats.qwordCount / frames, sifStats.callCount / frames, sifWaitRatio * 100.f);
+	}
+
+	{
+		const auto& cacheStats = m_cdromCacheStats;
+		uint32 readCount = cacheStats.hitCount + cacheStats.missCount;
+		if(readCount != 0)
+		{
+			float hitRatio = static_cast<float>(cacheStats.hitCount) / static_cast<float>(readCount);
+			result += string_format("CDROM Cache: %6.2f%% hits %8.1fKB saved\r\n",
+			                        hitRatio * 100.f, static_cast<double>(cacheStats.savedBytes) / 1024.0);
+		}
+	}
+
+	{
+		const auto& soundStats = m_soundStats;
+		if(soundStats.targetFillLevel != 0)
+		{
+			result += string_format("Sound: %6u/%6u samples %4u underruns %4u drops\r\n",
+			                        soundStats.fillLevel, soundStats.targetFillLevel, soundStats.underrunCount, soundStats.droppedWriteCount);
+		}
+	}
+
+	{
+		const auto& cacheStats = m_spuSampleCacheStats;
+		uint32 lookupCount = cacheStats.hitCount + cacheStats.missCount;
+		if(lookupCount != 0)
+		{
+			float hitRatio = static_cast<float>(cacheStats.hitCount) / static_cast<float>(lookupCount);
+			result += string_format("SPU Sample Cache: %6.2f%% hits %8u lookups\r\n",
+			                        hitRatio * 100.f, lookupCount);
+		}
+	}
+
 	return result;
 }
 
@@ -118,6 +245,10 @@ void CStatsManager::ClearStats()
 	m_frames = 0;
 	m_drawCalls = 0;
 	m_cpuUtilisation = CPS2VM::CPU_UTILISATION_INFO();
+	m_dmaStats = CPS2VM::DMA_STATS_INFO();
+	m_cdromCacheStats = CPS2VM::CDROM_CACHE_STATS();
+	m_soundStats = CPS2VM::SOUND_STATS();
+	m_spuSampleCacheStats = CPS2VM::SPU_SAMPLE_CACHE_STATS();
 #ifdef PROFILE
 	for(auto& zonePair : m_profilerZones)
 	{
@@ -14,10 +14,15 @@ public:
 	void OnGsNewFrame(uint32);
 
 	static float ComputeCpuUsageRatio(int32 idleTicks, int32 totalTicks);
+	static void AccumulateDmaChannelStats(DMA_CHANNEL_STATS&, const DMA_CHANNEL_STATS&);
 
 	uint32 GetFrames();
 	uint32 GetDrawCalls();
 	CPS2VM::CPU_UTILISATION_INFO GetCpuUtilisationInfo();
+	CPS2VM::DMA_STATS_INFO GetDmaStatsInfo();
+	CPS2VM::CDROM_CACHE_STATS GetCdromCacheStats();
+	CPS2VM::SOUND_STATS GetSoundStats();
+	CPS2VM::SPU_SAMPLE_CACHE_STATS GetSpuSampleCacheStats();
 #ifdef PROFILE
 	std::string GetProfilingInfo();
 #endif
@@ -31,6 +36,10 @@ private:
 	uint32 m_drawCalls = 0;
 
 	CPS2VM::CPU_UTILISATION_INFO m_cpuUtilisation;
+	CPS2VM::DMA_STATS_INFO m_dmaStats;
+	CPS2VM::CDROM_CACHE_STATS m_cdromCacheStats;
+	CPS2VM::SOUND_STATS m_soundStats;
+	CPS2VM::SPU_SAMPLE_CACHE_STATS m_spuSampleCacheStats;
 
 #ifdef PROFILE
 	struct ZONEINFO
@@ -0,0 +1,94 @@
+#include <vector>
+#include "GsPageConversionTest.h"
+#include "gs/GsPixelFormats.h"
+
+//Checks that the full page converters agree with the pixel by pixel indexor path
+
+template <typename Storage>
+static void ReadRectTest(uint8* ram, uint32 bufPtr, uint32 bufWidth, uint32 rectX, uint32 rectY, uint32 rectWidth, uint32 rectHeight)
+{
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(ram, bufPtr, bufWidth);
+
+	std::vector<typename Storage::Unit> pixels(rectWidth * rectHeight);
+	indexor.ReadRect(pixels.data(), rectWidth, rectX, rectY, rectWidth, rectHeight);
+
+	for(uint32 y = 0; y < rectHeight; y++)
+	{
+		for(uint32 x = 0; x < rectWidth; x++)
+		{
+			TEST_VERIFY(pixels[x + (y * rectWidth)] == indexor.GetPixel(rectX + x, rectY + y));
+		}
+	}
+}
+
+template <typename Storage>
+static void WriteRectTest(uint8* ram, uint32 bufPtr, uint32 bufWidth, uint32 rectX, uint32 rectY, uint32 rectWidth, uint32 rectHeight)
+{
+	CGsPixelFormats::CPixelIndexor<Storage> indexor(ram, bufPtr, bufWidth);
+
+	//PSMT4 only keeps the lower nibble
+	auto pixelMask = static_cast<typename Storage::Unit>(std::is_same_v<Storage, CGsPixelFormats::STORAGEPSMT4> ? 0x0F : ~0U);
+
+	std::vector<typename Storage::Unit> pixels(rectWidth * rectHeight);
+	for(uint32 i = 0; i < pixels.size(); i++)
+	{
+		pixels[i] = static_cast<typename Storage::Unit>(i * 0x9E3779B1) & pixelMask;
+	}
+	indexor.WriteRect(pixels.data(), rectWidth, rectX, rectY, rectWidth, rectHeight);
+
+	for(uint32 y = 0; y < rectHeight; y++)
+	{
+		for(uint32 x = 0; x < rectWidth; x++)
+		{
+			TEST_VERIFY(pixels[x + (y * rectWidth)] == indexor.GetPixel(rectX + x, rectY + y));
+		}
+	}
+}
+
+template <typename Storage>
+static void ConversionTest(uint8* ram)
+{
+	uint32 bufWidth = (Storage::PAGEWIDTH * 4) / 64;
+
+	//Page aligned, only goes through the page converters
+	ReadRectTest<Storage>(ram, 0x100000, bufWidth, 0, 0, Storage::PAGEWIDTH * 2, Storage::PAGEHEIGHT * 2);
+	WriteRectTest<Storage>(ram, 0x100000, bufWidth, 0, 0, Storage::PAGEWIDTH * 2, Storage::PAGEHEIGHT * 2);
+
+	//Unaligned, mixes both paths
+	ReadRectTest<Storage>(ram, 0x200000, bufWidth, 3, 5, (Storage::PAGEWIDTH * 2) + 7, (Storage::PAGEHEIGHT * 2) + 1);
+	WriteRectTest<Storage>(ram, 0x200000, bufWidth, 3, 5, (Storage::PAGEWIDTH * 2) + 7, (Storage::PAGEHEIGHT * 2) + 1);
+
+	//Last page of RAM, next page wraps around
+	ReadRectTest<Storage>(ram, CGSHandler::RAMSIZE - CGsPixelFormats::PAGESIZE, bufWidth, 0, 0, Storage::PAGEWIDTH * 2, Storage::PAGEHEIGHT);
+	WriteRectTest<Storage>(ram, CGSHandler::RAMSIZE - CGsPixelFormats::PAGESIZE, bufWidth, 0, 0, Storage::PAGEWIDTH * 2, Storage::PAGEHEIGHT);
+}
+
+template <typename Storage>
+static void OddWidthConversionTest(uint8* ram)
+{
+	//Buffer is 1.5 pages wide, page rows don't start on a page boundary
+	uint32 bufWidth = 3;
+	ReadRectTest<Storage>(ram, 0x100000, bufWidth, 0, 0, Storage::PAGEWIDTH, Storage::PAGEHEIGHT * 3);
+	WriteRectTest<Storage>(ram, 0x100000, bufWidth, 0, 0, Storage::PAGEWIDTH, Storage::PAGEHEIGHT * 3);
+}
+
+void CGsPageConversionTest::Execute()
+{
+	std::vector<uint8> ram(CGSHandler::RAMSIZE);
+	for(uint32 i = 0; i < ram.size(); i++)
+	{
+		ram[i] = static_cast<uint8>(i * 0x3D);
+	}
+
+	ConversionTest<CGsPixelFormats::STORAGEPSMCT32>(ram.data());
+	ConversionTest<CGsPixelFormats::STORAGEPSMCT16>(ram.data());
+	ConversionTest<CGsPixelFormats::STORAGEPSMCT16S>(ram.data());
+	ConversionTest<CGsPixelFormats::STORAGEPSMZ32>(ram.data());
+	ConversionTest<CGsPixelFormats::STORAGEPSMZ16>(ram.data());
+	ConversionTest<CGsPixelFormats::STORAGEPSMZ16S>(ram.data());
+	ConversionTest<CGsPixelFormats::STORAGEPSMT8>(ram.data());
+	ConversionTest<CGsPixelFormats::STORAGEPSMT4>(ram.data());
+
+	OddWidthConversionTest<CGsPixelFormats::STORAGEPSMT8>(ram.data());
+	OddWidthConversionTest<CGsPixelFormats::STORAGEPSMT4>(ram.data());
+}
@@ -1,5 +1,6 @@
 #include <functional>
 #include "GsCachedAreaTest.h"
+#include "GsPageConversionTest.h"
 #include "GsSpriteRegionTest.h"
 #include "GsTransferInvalidationTest.h"
 
@@ -9,6 +10,7 @@ typedef std::function<CTest*()> TestFactoryFunction;
 static const TestFactoryFunction s_factories[] =
 {
 	[]() { return new CGsCachedAreaTest(); },
+	[]() { return new CGsPageConversionTest(); },
 	[]() { return new CGsSpriteRegionTest(); },
 	[]() { return new CGsTransferInvalidationTest(); }
 };
@@ -0,0 +1,231 @@
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include "FrameDump.h"
+#include "StdStreamUtils.h"
+#include "filesystem_def.h"
+#include "gs/GSH_Null.h"
+#if HAS_GSH_VULKAN
+#include "gs/GSH_Vulkan/GSH_VulkanOffscreen.h"
+#endif
+
+//Replays the packets of a frame dump through a GS handler without any CPU emulation
+//and reports throughput numbers that can be compared between handler revisions.
+
+enum PACKET_CLASS
+{
+	PACKET_CLASS_STATE,
+	PACKET_CLASS_DRAW,
+	PACKET_CLASS_IMAGE,
+	PACKET_CLASS_MAX,
+};
+
+static const char* g_packetClassNames[PACKET_CLASS_MAX] =
+    {
+        "state",
+        "draw",
+        "image",
+};
+
+struct PACKET_CLASS_STATS
+{
+	uint32 packetCount = 0;
+	uint64 writeCount = 0;
+	std::chrono::nanoseconds time = std::chrono::nanoseconds(0);
+};
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static std::unique_ptr<CGSHandler> CreateGsHandler(const char* handlerName)
+{
+	if(!strcmp(handlerName, "null"))
+	{
+		return std::make_unique<CGSH_Null>();
+	}
+#if HAS_GSH_VULKAN
+	if(!strcmp(handlerName, "vulkan"))
+	{
+		return std::make_unique<CGSH_VulkanOffscreen>();
+	}
+#endif
+	return std::unique_ptr<CGSHandler>();
+}
+
+static std::vector<PACKET_CLASS> ClassifyPackets(const CFrameDump& frameDump)
+{
+	std::vector<PACKET_CLASS> packetClasses;
+	packetClasses.reserve(frameDump.GetPackets().size());
+
+	const auto& drawingKicks = frameDump.GetDrawingKicks();
+	uint32 cmdIndex = 0;
+	for(const auto& packet : frameDump.GetPackets())
+	{
+		if(packet.registerWrites.empty())
+		{
+			packetClasses.push_back(PACKET_CLASS_IMAGE);
+			continue;
+		}
+		uint32 cmdIndexEnd = cmdIndex + static_cast<uint32>(packet.registerWrites.size());
+		auto kickIterator = drawingKicks.lower_bound(cmdIndex);
+		bool hasDrawingKick = (kickIterator != std::end(drawingKicks)) && (kickIterator->first < cmdIndexEnd);
+		packetClasses.push_back(hasDrawingKick ? PACKET_CLASS_DRAW : PACKET_CLASS_STATE);
+		cmdIndex = cmdIndexEnd;
+	}
+
+	return packetClasses;
+}
+
+static void ReplayPacket(CGSHandler* gs, const CGsPacket& packet)
+{
+	if(packet.registerWrites.empty())
+	{
+		gs->ProcessWriteBuffer(nullptr);
+		gs->FeedImageData(packet.imageData.data(), static_cast<uint32>(packet.imageData.size()));
+	}
+	else
+	{
+		for(const auto& registerWrite : packet.registerWrites)
+		{
+			gs->WriteRegister(registerWrite);
+		}
+		gs->ProcessWriteBuffer(&packet.metadata);
+	}
+}
+
+static void WaitForGs(CGSHandler* gs)
+{
+	gs->SubmitWriteBuffer();
+	gs->SendGSCall([]() {}, true, true);
+}
+
+static std::chrono::nanoseconds ReplayFrame(CGSHandler* gs, CFrameDump& frameDump)
+{
+	gs->Reset();
+	gs->InitFromFrameDump(&frameDump);
+	WaitForGs(gs);
+
+	auto startTime = Clock::now();
+	for(const auto& packet : frameDump.GetPackets())
+	{
+		ReplayPacket(gs, packet);
+	}
+	gs->ProcessWriteBuffer(nullptr);
+	gs->Finish(true);
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime);
+}
+
+static void ProfileFrame(CGSHandler* gs, CFrameDump& frameDump, const std::vector<PACKET_CLASS>& packetClasses, PACKET_CLASS_STATS* stats)
+{
+	//Waits for the GS thread after every packet, this is slower than the regular
+	//replay, but gives us the cost of each packet on the GS thread
+	gs->Reset();
+	gs->InitFromFrameDump(&frameDump);
+	WaitForGs(gs);
+
+	const auto& packets = frameDump.GetPackets();
+	for(uint32 packetIndex = 0; packetIndex < packets.size(); packetIndex++)
+	{
+		const auto& packet = packets[packetIndex];
+		auto& classStats = stats[packetClasses[packetIndex]];
+
+		auto startTime = Clock::now();
+		ReplayPacket(gs, packet);
+		WaitForGs(gs);
+		classStats.time += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime);
+		classStats.packetCount++;
+		classStats.writeCount += packet.registerWrites.size();
+	}
+	gs->ProcessWriteBuffer(nullptr);
+	gs->Finish(true);
+}
+
+int main(int argc, const char** argv)
+{
+	if(argc < 2)
+	{
+		printf("GsReplayBench <frame dump path> [handler (null");
+#if HAS_GSH_VULKAN
+		printf("|vulkan");
+#endif
+		printf(")] [iteration count]\n");
+		return -1;
+	}
+
+	auto dumpPath = fs::path(argv[1]);
+	const char* handlerName = (argc >= 3) ? argv[2] : "null";
+	uint32 iterationCount = (argc >= 4) ? strtoul(argv[3], nullptr, 0) : 100;
+	if(iterationCount == 0)
+	{
+		iterationCount = 1;
+	}
+
+	CFrameDump frameDump;
+	try
+	{
+		auto inputStream = Framework::CreateInputStdStream(dumpPath.native());
+		frameDump.Read(inputStream);
+		frameDump.IdentifyDrawingKicks();
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Failed to open frame dump: %s\n", exception.what());
+		return -1;
+	}
+
+	auto gs = CreateGsHandler(handlerName);
+	if(!gs)
+	{
+		printf("Unknown GS handler '%s'.\n", handlerName);
+		return -1;
+	}
+
+	gs->SetLoggingEnabled(false);
+	gs->Initialize();
+
+	auto packetClasses = ClassifyPackets(frameDump);
+	uint32 packetCount = static_cast<uint32>(frameDump.GetPackets().size());
+	uint32 drawCount = static_cast<uint32>(frameDump.GetDrawingKicks().size());
+
+	printf("Replaying '%s' (%d packets, %d draws) through '%s' handler %d times.\n",
+	       dumpPath.string().c_str(), packetCount, drawCount, handlerName, iterationCount);
+
+	//Warm up caches (shaders, pipelines, textures) before measuring
+	ReplayFrame(gs.get(), frameDump);
+
+	auto totalTime = std::chrono::nanoseconds(0);
+	for(uint32 i = 0; i < iterationCount; i++)
+	{
+		totalTime += ReplayFrame(gs.get(), frameDump);
+	}
+
+	PACKET_CLASS_STATS classStats[PACKET_CLASS_MAX];
+	for(uint32 i = 0; i < iterationCount; i++)
+	{
+		ProfileFrame(gs.get(), frameDump, packetClasses, classStats);
+	}
+
+	gs->Release();
+
+	double totalSeconds = std::chrono::duration<double>(totalTime).count();
+	double frameMs = (totalSeconds * 1000.0) / static_cast<double>(iterationCount);
+	printf("\n");
+	printf("Frame time:   %.3f ms\n", frameMs);
+	printf("Frames/s:     %.1f\n", static_cast<double>(iterationCount) / totalSeconds);
+	printf("Packets/s:    %.0f\n", static_cast<double>(packetCount) * static_cast<double>(iterationCount) / totalSeconds);
+	printf("Draws/s:      %.0f\n", static_cast<double>(drawCount) * static_cast<double>(iterationCount) / totalSeconds);
+
+	printf("\n");
+	printf("%-8s %10s %12s %14s %14s\n", "class", "packets", "writes", "total (ms)", "per pkt (us)");
+	for(uint32 i = 0; i < PACKET_CLASS_MAX; i++)
+	{
+		const auto& stats = classStats[i];
+		double classMs = std::chrono::duration<double, std::milli>(stats.time).count() / static_cast<double>(iterationCount);
+		double packetUs = (stats.packetCount != 0) ? std::chrono::duration<double, std::micro>(stats.time).count() / static_cast<double>(stats.packetCount) : 0;
+		printf("%-8s %10d %12llu %14.3f %14.3f\n", g_packetClassNames[i],
+		       stats.packetCount / iterationCount, static_cast<unsigned long long>(stats.writeCount / iterationCount),
+		       classMs, packetUs);
+	}
+
+	return 0;
+}
@@ -0,0 +1,119 @@
+#include "CoefficientVlcTest.h"
+#include "BitStream.h"
+#include "mpeg2/DctCoefficientTable0.h"
+#include "mpeg2/DctCoefficientTable1.h"
+#include "ee/IPU_CoefficientVlc.h"
+
+//Checks that the lookup table decoder agrees with the bit by bit decoder on random bit strings.
+
+enum
+{
+	SAMPLE_COUNT = 200000,
+};
+
+class CWordBitStream : public Framework::CBitStream
+{
+public:
+	CWordBitStream(uint32 value)
+	    : m_value(value)
+	{
+	}
+
+	void Advance(uint8 bits) override
+	{
+		if((m_position + bits) > 32)
+		{
+			throw CBitStreamException();
+		}
+		m_position += bits;
+	}
+
+	uint8 GetBitIndex() const override
+	{
+		return m_position;
+	}
+
+	bool TryPeekBits_LSBF(uint8, uint32&) override
+	{
+		return false;
+	}
+
+	bool TryPeekBits_MSBF(uint8 size, uint32& result) override
+	{
+		if((m_position + size) > 32)
+		{
+			return false;
+		}
+		uint64 bits = static_cast<uint64>(m_value) << m_position;
+		result = static_cast<uint32>((bits & 0xFFFFFFFF) >> (32 - size));
+		return true;
+	}
+
+private:
+	uint32 m_value = 0;
+	uint8 m_position = 0;
+};
+
+uint32 CCoefficientVlcTest::GenerateBits()
+{
+	m_randomState = (m_randomState * 1103515245) + 12345;
+	uint32 bits = m_randomState;
+	m_randomState = (m_randomState * 1103515245) + 12345;
+	bits = (bits & 0xFFFF0000) | (m_randomState >> 16);
+	//Add leading zeros to exercise long codes and escapes
+	return bits >> (m_randomState % 12);
+}
+
+void CCoefficientVlcTest::Execute()
+{
+	for(unsigned int i = 0; i < SAMPLE_COUNT; i++)
+	{
+		uint32 bits = GenerateBits();
+		for(unsigned int tableIndex = 0; tableIndex < IpuCoefficientVlc::TABLE_COUNT; tableIndex++)
+		{
+			auto tableId = static_cast<IpuCoefficientVlc::TABLE>(tableIndex);
+			MPEG2::CDctCoefficientTable* table = (tableId == IpuCoefficientVlc::TABLE_ONE)
+			                                         ? static_cast<MPEG2::CDctCoefficientTable*>(&MPEG2::CDctCoefficientTable1::GetInstance())
+			                                         : static_cast<MPEG2::CDctCoefficientTable*>(&MPEG2::CDctCoefficientTable0::GetInstance());
+			for(unsigned int variant = 0; variant < 4; variant++)
+			{
+				bool isMpeg2 = (variant & 1) != 0;
+				bool isFirstCoefficient = (variant & 2) != 0;
+				if(isFirstCoefficient && (tableId != IpuCoefficientVlc::TABLE_ZERO)) continue;
+
+				IpuCoefficientVlc::COEFFICIENT coefficient;
+				auto result = IpuCoefficientVlc::Decode(tableId, bits, 32, isFirstCoefficient, isMpeg2, coefficient);
+
+				CWordBitStream stream(bits);
+				bool isEob = false;
+				if(!isFirstCoefficient)
+				{
+					TEST_VERIFY(table->TryIsEndOfBlock(&stream, isEob) == MPEG2::CVLCTable::DECODE_STATUS_SUCCESS);
+				}
+				if(isEob)
+				{
+					TEST_VERIFY(result == IpuCoefficientVlc::DECODE_RESULT_ENDOFBLOCK);
+					TEST_VERIFY(table->TrySkipEndOfBlock(&stream) == MPEG2::CVLCTable::DECODE_STATUS_SUCCESS);
+					TEST_VERIFY(coefficient.length == stream.GetBitIndex());
+					continue;
+				}
+
+				MPEG2::RUNLEVELPAIR runLevelPair;
+				auto status = isFirstCoefficient ? table->TryGetRunLevelPairDc(&stream, &runLevelPair, isMpeg2) : table->TryGetRunLevelPair(&stream, &runLevelPair, isMpeg2);
+				if(status != MPEG2::CVLCTable::DECODE_STATUS_SUCCESS)
+				{
+					TEST_VERIFY(result == IpuCoefficientVlc::DECODE_RESULT_UNAVAILABLE);
+					continue;
+				}
+				TEST_VERIFY(result == IpuCoefficientVlc::DECODE_RESULT_COEFFICIENT);
+				TEST_VERIFY(coefficient.run == runLevelPair.run);
+				TEST_VERIFY(coefficient.level == static_cast<int16>(runLevelPair.level));
+				TEST_VERIFY(coefficient.length == stream.GetBitIndex());
+
+				//Codes must not be decoded if they are not entirely available
+				auto partialResult = IpuCoefficientVlc::Decode(tableId, bits, coefficient.length - 1, isFirstCoefficient, isMpeg2, coefficient);
+				TEST_VERIFY(partialResult == IpuCoefficientVlc::DECODE_RESULT_UNAVAILABLE);
+			}
+		}
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Test.h"
+#include "Types.h"
+
+class CCoefficientVlcTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	uint32 GenerateBits();
+
+	uint32 m_randomState = 1;
+};
@@ -0,0 +1,153 @@
+#include <cstring>
+#include <algorithm>
+#include "CscTest.h"
+#include "ee/IPU_Csc.h"
+
+//Checks that the macroblock converters give the same results as the original
+//pixel by pixel conversion and that SIMD and scalar versions agree.
+
+enum
+{
+	MACROBLOCK_SIZE = 0x180,
+	MACROBLOCK_COUNT = 2000,
+};
+
+static void ConvertMacroblockOriginal(const uint8* block, uint32* output, uint16 alphaTh0, uint16 alphaTh1)
+{
+	const uint8* pY = block;
+	const uint8* nBlockCb = block + 0x100;
+	const uint8* nBlockCr = block + 0x140;
+
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		for(unsigned int j = 0; j < 16; j++)
+		{
+			unsigned int cbCrIndex = (j / 2) + ((i / 2) * 8);
+
+			float nY = pY[j];
+			float nCb = nBlockCb[cbCrIndex];
+			float nCr = nBlockCr[cbCrIndex];
+
+			float nR = nY + 1.402f * (nCr - 128);
+			float nG = nY - 0.34414f * (nCb - 128) - 0.71414f * (nCr - 128);
+			float nB = nY + 1.772f * (nCb - 128);
+
+			nR = std::clamp(nR, 0.f, 255.f);
+			nG = std::clamp(nG, 0.f, 255.f);
+			nB = std::clamp(nB, 0.f, 255.f);
+
+			uint8 a = 0;
+			uint8 r = static_cast<uint8>(nR);
+			uint8 g = static_cast<uint8>(nG);
+			uint8 b = static_cast<uint8>(nB);
+
+			if(r < alphaTh0 && g < alphaTh0 && b < alphaTh0)
+			{
+				a = 0;
+			}
+			else if(r < alphaTh1 && g < alphaTh1 && b < alphaTh1)
+			{
+				a = 0x40;
+			}
+			else
+			{
+				a = 0x80;
+			}
+
+			output[j] = (a << 24) | (b << 16) | (g << 8) | (r << 0);
+		}
+
+		pY += 0x10;
+		output += 0x10;
+	}
+}
+
+static uint16 ConvertPixelTo16(uint32 pixel)
+{
+	uint16 result = 0;
+	result |= ((pixel & 0x000000F8) >> (0 + 3)) << 0;
+	result |= ((pixel & 0x0000F800) >> (8 + 3)) << 5;
+	result |= ((pixel & 0x00F80000) >> (16 + 3)) << 10;
+	result |= ((pixel & 0x80000000) >> 31) << 15;
+	return result;
+}
+
+void CCscTest::GenerateMacroblock(uint8* block, unsigned int blockIndex)
+{
+	for(unsigned int i = 0; i < MACROBLOCK_SIZE; i++)
+	{
+		m_randomState = (m_randomState * 1103515245) + 12345;
+		uint8 value = static_cast<uint8>(m_randomState >> 16);
+		switch(blockIndex % 4)
+		{
+		case 0:
+			//Full range
+			block[i] = value;
+			break;
+		case 1:
+			//Saturated colors
+			block[i] = (value & 1) ? 0xFF : 0x00;
+			break;
+		case 2:
+			//Near grey
+			block[i] = static_cast<uint8>(128 + (value % 9) - 4);
+			break;
+		case 3:
+			//Dark areas, exercises alpha thresholds
+			block[i] = (i < 0x100) ? (value & 0x3F) : static_cast<uint8>(120 + (value & 0xF));
+			break;
+		}
+	}
+}
+
+void CCscTest::Execute()
+{
+	static const uint16 thresholds[][2] =
+	    {
+	        {0, 0},
+	        {0x20, 0x40},
+	        {0x40, 0x20},
+	        {0x100, 0x1FF},
+	        {0x1FF, 0x1FF},
+	    };
+
+	for(unsigned int blockIndex = 0; blockIndex < MACROBLOCK_COUNT; blockIndex++)
+	{
+		uint8 block[MACROBLOCK_SIZE];
+		GenerateMacroblock(block, blockIndex);
+
+		for(const auto& threshold : thresholds)
+		{
+			uint16 th0 = threshold[0];
+			uint16 th1 = threshold[1];
+
+			uint32 expected32[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+			ConvertMacroblockOriginal(block, expected32, th0, th1);
+
+			uint32 output32[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+			uint32 scalarOutput32[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+			IpuCsc::ConvertMacroblock32(block, output32, th0, th1);
+			IpuCsc::ConvertMacroblock32Scalar(block, scalarOutput32, th0, th1);
+			TEST_VERIFY(!memcmp(output32, expected32, sizeof(output32)));
+			TEST_VERIFY(!memcmp(scalarOutput32, expected32, sizeof(scalarOutput32)));
+
+			uint16 expected16[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+			for(unsigned int i = 0; i < IpuCsc::MACROBLOCK_PIXEL_COUNT; i++)
+			{
+				expected16[i] = ConvertPixelTo16(expected32[i]);
+			}
+
+			uint16 output16[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+			uint16 scalarOutput16[IpuCsc::MACROBLOCK_PIXEL_COUNT];
+			IpuCsc::ConvertMacroblock16(block, output16, th0, th1, false);
+			IpuCsc::ConvertMacroblock16Scalar(block, scalarOutput16, th0, th1, false);
+			TEST_VERIFY(!memcmp(output16, expected16, sizeof(output16)));
+			TEST_VERIFY(!memcmp(scalarOutput16, expected16, sizeof(scalarOutput16)));
+
+			//No original version for dithering, SIMD and scalar must agree
+			IpuCsc::ConvertMacroblock16(block, output16, th0, th1, true);
+			IpuCsc::ConvertMacroblock16Scalar(block, scalarOutput16, th0, th1, true);
+			TEST_VERIFY(!memcmp(output16, scalarOutput16, sizeof(output16)));
+		}
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Test.h"
+#include "Types.h"
+
+class CCscTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	void GenerateMacroblock(uint8*, unsigned int);
+
+	uint32 m_randomState = 1;
+};
@@ -0,0 +1,189 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "IdctTest.h"
+#include "ee/IPU_Idct.h"
+
+//Checks the fast IDCT against the reference using the IEEE 1180 procedure:
+//random blocks are forward transformed and both IDCTs must agree within the standard's limits.
+
+enum
+{
+	BLOCK_COUNT = 10000,
+};
+
+//M_PI isn't available everywhere
+static const double g_pi = 3.14159265358979323846;
+
+static void ForwardDct(const int16* input, int16* output)
+{
+	double coefs[8][8];
+	for(unsigned int k = 0; k < 8; k++)
+	{
+		for(unsigned int n = 0; n < 8; n++)
+		{
+			double scale = (k == 0) ? sqrt(0.125) : 0.5;
+			coefs[k][n] = scale * cos(static_cast<double>((2 * n + 1) * k) * g_pi / 16.0);
+		}
+	}
+
+	double temp[8][8];
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		for(unsigned int k = 0; k < 8; k++)
+		{
+			double sum = 0;
+			for(unsigned int n = 0; n < 8; n++)
+			{
+				sum += coefs[k][n] * input[(i * 8) + n];
+			}
+			temp[i][k] = sum;
+		}
+	}
+
+	for(unsigned int k = 0; k < 8; k++)
+	{
+		for(unsigned int j = 0; j < 8; j++)
+		{
+			double sum = 0;
+			for(unsigned int n = 0; n < 8; n++)
+			{
+				sum += coefs[k][n] * temp[n][j];
+			}
+			int32 value = static_cast<int32>(floor(sum + 0.5));
+			output[(k * 8) + j] = static_cast<int16>(std::clamp<int32>(value, -2048, 2047));
+		}
+	}
+}
+
+void CIdctTest::Execute()
+{
+	CheckAccuracy(256, 255, 1);
+	CheckAccuracy(5, 5, 1);
+	CheckAccuracy(300, 300, 1);
+	CheckAccuracy(256, 255, -1);
+	CheckAccuracy(5, 5, -1);
+	CheckAccuracy(300, 300, -1);
+	CheckImplementationsMatch();
+	CheckSpecialBlocks();
+}
+
+int32 CIdctTest::GenerateRandom(int32 low, int32 high)
+{
+	//Generator from the IEEE 1180 specification
+	m_randomState = (m_randomState * 1103515245) + 12345;
+	double value = static_cast<double>(m_randomState & 0x7FFFFFFE) / static_cast<double>(0x7FFFFFFF);
+	value *= static_cast<double>(low + high + 1);
+	return static_cast<int32>(value) - low;
+}
+
+void CIdctTest::CheckAccuracy(int32 low, int32 high, int32 sign)
+{
+	m_randomState = 1;
+
+	int32 peakError = 0;
+	int64 errorSum[64] = {};
+	int64 squaredErrorSum[64] = {};
+
+	for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+	{
+		int16 block[64];
+		for(unsigned int i = 0; i < 64; i++)
+		{
+			block[i] = static_cast<int16>(GenerateRandom(low, high) * sign);
+		}
+
+		int16 coefs[64];
+		ForwardDct(block, coefs);
+
+		int16 referenceOutput[64];
+		int16 output[64];
+		IpuIdct::TransformReference(coefs, referenceOutput);
+		IpuIdct::Transform(coefs, output);
+
+		for(unsigned int i = 0; i < 64; i++)
+		{
+			int32 error = output[i] - referenceOutput[i];
+			peakError = std::max<int32>(peakError, abs(error));
+			errorSum[i] += error;
+			squaredErrorSum[i] += error * error;
+		}
+	}
+
+	double overallError = 0;
+	double overallSquaredError = 0;
+	for(unsigned int i = 0; i < 64; i++)
+	{
+		double pixelError = static_cast<double>(errorSum[i]) / BLOCK_COUNT;
+		double pixelSquaredError = static_cast<double>(squaredErrorSum[i]) / BLOCK_COUNT;
+		TEST_VERIFY(fabs(pixelError) <= 0.015);
+		TEST_VERIFY(pixelSquaredError <= 0.06);
+		overallError += pixelError;
+		overallSquaredError += pixelSquaredError;
+	}
+
+	TEST_VERIFY(peakError <= 1);
+	TEST_VERIFY(fabs(overallError / 64) <= 0.0015);
+	TEST_VERIFY((overallSquaredError / 64) <= 0.02);
+}
+
+void CIdctTest::CheckImplementationsMatch()
+{
+	//SIMD and scalar versions must be bit exact, even with coefficients that overflow
+	m_randomState = 1;
+	for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+	{
+		int16 coefs[64];
+		for(unsigned int i = 0; i < 64; i++)
+		{
+			switch(blockIndex % 3)
+			{
+			case 0:
+				coefs[i] = static_cast<int16>(GenerateRandom(32768, 32767));
+				break;
+			case 1:
+				coefs[i] = static_cast<int16>(GenerateRandom(2048, 2047));
+				break;
+			case 2:
+				coefs[i] = ((i % 5) == 0) ? static_cast<int16>(GenerateRandom(2048, 2047)) : 0;
+				break;
+			}
+		}
+
+		int16 output[64];
+		int16 scalarOutput[64];
+		IpuIdct::Transform(coefs, output);
+		IpuIdct::TransformScalar(coefs, scalarOutput);
+		TEST_VERIFY(!memcmp(output, scalarOutput, sizeof(output)));
+	}
+}
+
+void CIdctTest::CheckSpecialBlocks()
+{
+	//Empty block
+	{
+		int16 coefs[64] = {};
+		int16 output[64];
+		IpuIdct::Transform(coefs, output);
+		for(unsigned int i = 0; i < 64; i++)
+		{
+			TEST_VERIFY(output[i] == 0);
+		}
+	}
+
+	//DC only blocks
+	for(int32 dc = -2048; dc < 2048; dc++)
+	{
+		int16 coefs[64] = {};
+		coefs[0] = static_cast<int16>(dc);
+
+		int16 output[64];
+		IpuIdct::Transform(coefs, output);
+
+		int16 expected = static_cast<int16>(std::clamp<int32>(static_cast<int32>(floor((static_cast<double>(dc) / 8.0) + 0.5)), -256, 255));
+		for(unsigned int i = 0; i < 64; i++)
+		{
+			TEST_VERIFY(output[i] == expected);
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Test.h"
+#include "Types.h"
+
+class CIdctTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	int32 GenerateRandom(int32, int32);
+
+	void CheckAccuracy(int32, int32, int32);
+	void CheckImplementationsMatch();
+	void CheckSpecialBlocks();
+
+	uint32 m_randomState = 1;
+};
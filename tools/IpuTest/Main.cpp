@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include "CoefficientVlcTest.h"
+#include "CscTest.h"
+#include "IdctTest.h"
+#include "TraceReplayer.h"
+#include "TraceTest.h"
+#include "StdStreamUtils.h"
+#include "filesystem_def.h"
+
+typedef std::function<CTest*()> TestFactoryFunction;
+
+// clang-format off
+static const TestFactoryFunction s_factories[] =
+{
+	[]() { return new CCoefficientVlcTest(); },
+	[]() { return new CCscTest(); },
+	[]() { return new CIdctTest(); },
+	[]() { return new CTraceTest(); }
+};
+// clang-format on
+
+static int ReplayTrace(int argc, const char** argv)
+{
+	const char* tracePath = nullptr;
+	uint32 iterationCount = 10;
+	bool fastIdctEnabled = true;
+	bool decodeAheadEnabled = false;
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "--reference-idct"))
+		{
+			fastIdctEnabled = false;
+		}
+		else if(!strcmp(argv[i], "--decode-ahead"))
+		{
+			decodeAheadEnabled = true;
+		}
+		else if(!tracePath)
+		{
+			tracePath = argv[i];
+		}
+		else
+		{
+			iterationCount = std::max<uint32>(strtoul(argv[i], nullptr, 0), 1);
+		}
+	}
+
+	if(!tracePath)
+	{
+		printf("IpuTest [<trace path> [iteration count] [--reference-idct] [--decode-ahead]]\n");
+		return -1;
+	}
+
+	CIpuTrace trace;
+	try
+	{
+		auto inputStream = Framework::CreateInputStdStream(fs::path(tracePath).native());
+		trace.Read(inputStream);
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Failed to open IPU trace: %s\n", exception.what());
+		return -1;
+	}
+
+	CTraceReplayer replayer;
+	replayer.SetFastIdctEnabled(fastIdctEnabled);
+	replayer.SetDecodeAheadEnabled(decodeAheadEnabled);
+
+	printf("Replaying '%s' (%d events) %d times.\n", tracePath, static_cast<uint32>(trace.GetEvents().size()), iterationCount);
+
+	CTraceReplayer::RESULT totalResult;
+	for(uint32 i = 0; i < iterationCount; i++)
+	{
+		auto result = replayer.Replay(trace);
+		if(result.mismatchCount != 0)
+		{
+			printf("Output mismatch: %d of %d commands differ, first one is command %d.\n",
+			       result.mismatchCount, result.commandCount, result.firstMismatchCommand);
+			return 1;
+		}
+		totalResult.commandCount = result.commandCount;
+		for(uint32 classIndex = 0; classIndex < CTraceReplayer::COMMAND_CLASS_MAX; classIndex++)
+		{
+			totalResult.classStats[classIndex].commandCount += result.classStats[classIndex].commandCount;
+			totalResult.classStats[classIndex].time += result.classStats[classIndex].time;
+		}
+	}
+
+	printf("All %d commands match.\n\n", totalResult.commandCount);
+	printf("%-8s %10s %14s %14s\n", "command", "count", "total (ms)", "per cmd (us)");
+	for(uint32 classIndex = 0; classIndex < CTraceReplayer::COMMAND_CLASS_MAX; classIndex++)
+	{
+		const auto& stats = totalResult.classStats[classIndex];
+		double classMs = std::chrono::duration<double, std::milli>(stats.time).count() / static_cast<double>(iterationCount);
+		double commandUs = (stats.commandCount != 0) ? std::chrono::duration<double, std::micro>(stats.time).count() / static_cast<double>(stats.commandCount) : 0;
+		printf("%-8s %10d %14.3f %14.3f\n", CTraceReplayer::GetCommandClassName(static_cast<CTraceReplayer::COMMAND_CLASS>(classIndex)),
+		       stats.commandCount / iterationCount, classMs, commandUs);
+	}
+
+	return 0;
+}
+
+int main(int argc, const char** argv)
+{
+	if(argc >= 2)
+	{
+		return ReplayTrace(argc, argv);
+	}
+
+	for(const auto& factory : s_factories)
+	{
+		auto test = factory();
+		test->Execute();
+		delete test;
+	}
+	return 0;
+}
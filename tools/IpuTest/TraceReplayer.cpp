@@ -0,0 +1,246 @@
+#include <cassert>
+#include <cstring>
+#include "TraceReplayer.h"
+
+enum
+{
+	IPU_CMD_IDEC = 0x01,
+	IPU_CMD_BDEC = 0x02,
+	IPU_CMD_VDEC = 0x03,
+	IPU_CMD_FDEC = 0x04,
+	IPU_CMD_SETIQ = 0x05,
+	IPU_CMD_SETVQ = 0x06,
+	IPU_CMD_CSC = 0x07,
+};
+
+enum
+{
+	IPU_CTRL_RST = 0x40000000,
+	//Busy bit and FIFO counter depend on DMA timing and are not part of a command's result
+	IPU_CTRL_RESULT_MASK = 0x7FFFFFF0,
+};
+
+//Enough to get through IDEC's startup delay in one step
+static const uint32 g_commandDelayTicks = 1000;
+
+static const char* g_commandClassNames[CTraceReplayer::COMMAND_CLASS_MAX] =
+    {
+        "BDEC",
+        "IDEC",
+        "VDEC",
+        "CSC",
+        "other",
+};
+
+typedef std::chrono::high_resolution_clock Clock;
+
+CTraceReplayer::CTraceReplayer()
+    : m_ipu(m_intc)
+{
+	m_ipu.SetDMA3ReceiveHandler(
+	    [this](const void* data, uint32 size) {
+		    auto bytes = reinterpret_cast<const uint8*>(data);
+		    m_output.insert(m_output.end(), bytes, bytes + (size * 0x10));
+		    return size;
+	    });
+}
+
+void CTraceReplayer::SetFastIdctEnabled(bool enabled)
+{
+	m_ipu.SetFastIdctEnabled(enabled);
+}
+
+void CTraceReplayer::SetDecodeAheadEnabled(bool enabled)
+{
+	m_ipu.SetDecodeAheadEnabled(enabled);
+}
+
+CTraceReplayer::RESULT CTraceReplayer::Replay(const CIpuTrace& trace)
+{
+	RESULT result;
+
+	m_pendingDma4Data.clear();
+	m_pendingDma4Offset = 0;
+	m_output.clear();
+	m_commandResults.clear();
+	m_commandCode = 0;
+
+	RestoreInitialState(trace);
+
+	for(const auto& event : trace.GetEvents())
+	{
+		switch(event.type)
+		{
+		case CIpuTrace::EVENT_TYPE_REGISTERWRITE:
+			if(event.address == CIPU::IPU_CMD)
+			{
+				m_commandCode = event.value;
+			}
+			m_ipu.SetRegister(event.address, event.value);
+			break;
+		case CIpuTrace::EVENT_TYPE_DMA4DATA:
+			m_pendingDma4Data.insert(m_pendingDma4Data.end(), event.data.begin(), event.data.end());
+			break;
+		case CIpuTrace::EVENT_TYPE_COMMANDEND:
+		{
+			//Command should be done by now, unless it needs data that the trace doesn't have
+			Execute(result);
+			bool matches = false;
+			if(!m_commandResults.empty())
+			{
+				const auto& commandResult = m_commandResults.front();
+				matches = (commandResult.ctrl == (event.address & IPU_CTRL_RESULT_MASK)) &&
+				          (commandResult.cmd == event.value) &&
+				          (commandResult.outputHash == event.outputHash);
+				m_commandResults.pop_front();
+			}
+			if(!matches)
+			{
+				if(result.mismatchCount == 0)
+				{
+					result.firstMismatchCommand = result.commandCount;
+				}
+				result.mismatchCount++;
+			}
+			result.commandCount++;
+		}
+		break;
+		default:
+			assert(false);
+			break;
+		}
+		Execute(result);
+	}
+
+	return result;
+}
+
+const char* CTraceReplayer::GetCommandClassName(COMMAND_CLASS commandClass)
+{
+	assert(commandClass < COMMAND_CLASS_MAX);
+	return g_commandClassNames[commandClass];
+}
+
+void CTraceReplayer::RestoreInitialState(const CIpuTrace& trace)
+{
+	//Quantizer matrices and VQ CLUT survive resets, load them through the commands that set them
+	m_ipu.Reset();
+
+	WriteInFifo(trace.GetIntraIq(), 0x40);
+	ExecuteImmediateCommand(IPU_CMD_SETIQ << 28);
+
+	WriteInFifo(trace.GetNonIntraIq(), 0x40);
+	ExecuteImmediateCommand((IPU_CMD_SETIQ << 28) | 0x08000000);
+
+	uint8 vqClut[0x20];
+	for(uint32 i = 0; i < 0x10; i++)
+	{
+		uint16 color = trace.GetVqClut()[i];
+		vqClut[(i * 2) + 0] = static_cast<uint8>(color >> 8);
+		vqClut[(i * 2) + 1] = static_cast<uint8>(color);
+	}
+	WriteInFifo(vqClut, sizeof(vqClut));
+	ExecuteImmediateCommand(IPU_CMD_SETVQ << 28);
+
+	m_ipu.SetRegister(CIPU::IPU_CTRL, IPU_CTRL_RST);
+}
+
+void CTraceReplayer::WriteInFifo(const uint8* data, uint32 size)
+{
+	assert((size % 4) == 0);
+	for(uint32 i = 0; i < size; i += 4)
+	{
+		uint32 value = 0;
+		memcpy(&value, data + i, 4);
+		m_ipu.SetRegister(CIPU::IPU_IN_FIFO + (i & 0xC), value);
+	}
+}
+
+void CTraceReplayer::ExecuteImmediateCommand(uint32 commandCode)
+{
+	m_ipu.SetRegister(CIPU::IPU_CMD, commandCode);
+	while(m_ipu.WillExecuteCommand())
+	{
+		m_ipu.ExecuteCommand();
+	}
+}
+
+void CTraceReplayer::Execute(RESULT& result)
+{
+	//Same as the EE subsystem, except that DMA3 accepts everything right away and
+	//that IDEC's delay is skipped
+	while(1)
+	{
+		uint32 fedQwc = 0;
+		if(m_pendingDma4Offset != m_pendingDma4Data.size())
+		{
+			uint32 qwc = static_cast<uint32>(m_pendingDma4Data.size() - m_pendingDma4Offset) / 0x10;
+			fedQwc = m_ipu.ReceiveDMA4(0, qwc, false, m_pendingDma4Data.data() + m_pendingDma4Offset, nullptr);
+			m_pendingDma4Offset += fedQwc * 0x10;
+			if(m_pendingDma4Offset == m_pendingDma4Data.size())
+			{
+				m_pendingDma4Data.clear();
+				m_pendingDma4Offset = 0;
+			}
+		}
+
+		if(!m_ipu.WillExecuteCommand())
+		{
+			break;
+		}
+
+		if(m_ipu.IsCommandDelayed())
+		{
+			m_ipu.CountTicks(g_commandDelayTicks);
+		}
+
+		auto& classStats = result.classStats[GetCommandClass(m_commandCode)];
+		auto startTime = Clock::now();
+		m_ipu.ExecuteCommand();
+		bool hasOutput = m_ipu.HasPendingOUTFIFOData();
+		if(hasOutput)
+		{
+			m_ipu.FlushOUTFIFOData();
+		}
+		classStats.time += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime);
+
+		if(!m_ipu.WillExecuteCommand())
+		{
+			uint32 commandId = m_commandCode >> 28;
+			bool hasResult = (commandId == IPU_CMD_VDEC) || (commandId == IPU_CMD_FDEC);
+
+			COMMAND_RESULT commandResult;
+			commandResult.ctrl = m_ipu.GetRegister(CIPU::IPU_CTRL) & IPU_CTRL_RESULT_MASK;
+			commandResult.cmd = hasResult ? m_ipu.GetRegister(CIPU::IPU_CMD) : 0;
+			commandResult.outputHash = CIpuTrace::ComputeOutputHash(m_output);
+			m_commandResults.push_back(commandResult);
+			m_output.clear();
+			classStats.commandCount++;
+			//Data received after the command's end still needs to go in the FIFO
+			continue;
+		}
+
+		if((fedQwc == 0) && !hasOutput)
+		{
+			//Waiting for data that hasn't been received yet
+			break;
+		}
+	}
+}
+
+CTraceReplayer::COMMAND_CLASS CTraceReplayer::GetCommandClass(uint32 commandCode)
+{
+	switch(commandCode >> 28)
+	{
+	case IPU_CMD_BDEC:
+		return COMMAND_CLASS_BDEC;
+	case IPU_CMD_IDEC:
+		return COMMAND_CLASS_IDEC;
+	case IPU_CMD_VDEC:
+		return COMMAND_CLASS_VDEC;
+	case IPU_CMD_CSC:
+		return COMMAND_CLASS_CSC;
+	default:
+		return COMMAND_CLASS_OTHER;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <vector>
+#include "Types.h"
+#include "ee/INTC.h"
+#include "ee/IPU.h"
+#include "ee/IPU_Trace.h"
+
+//Feeds an IPU trace through a standalone CIPU instance, checks that every command
+//produces the same output as when the trace was recorded and measures the time
+//spent executing each kind of command.
+
+class CTraceReplayer
+{
+public:
+	enum COMMAND_CLASS
+	{
+		COMMAND_CLASS_BDEC,
+		COMMAND_CLASS_IDEC,
+		COMMAND_CLASS_VDEC,
+		COMMAND_CLASS_CSC,
+		COMMAND_CLASS_OTHER,
+		COMMAND_CLASS_MAX,
+	};
+
+	struct COMMAND_CLASS_STATS
+	{
+		uint32 commandCount = 0;
+		std::chrono::nanoseconds time = std::chrono::nanoseconds(0);
+	};
+
+	struct RESULT
+	{
+		uint32 commandCount = 0;
+		uint32 mismatchCount = 0;
+		uint32 firstMismatchCommand = ~0U;
+		COMMAND_CLASS_STATS classStats[COMMAND_CLASS_MAX];
+	};
+
+	CTraceReplayer();
+
+	void SetFastIdctEnabled(bool);
+	void SetDecodeAheadEnabled(bool);
+
+	RESULT Replay(const CIpuTrace&);
+
+	static const char* GetCommandClassName(COMMAND_CLASS);
+
+private:
+	struct COMMAND_RESULT
+	{
+		uint32 ctrl = 0;
+		uint32 cmd = 0;
+		uint64 outputHash = 0;
+	};
+
+	void RestoreInitialState(const CIpuTrace&);
+	void WriteInFifo(const uint8*, uint32);
+	void ExecuteImmediateCommand(uint32);
+	void Execute(RESULT&);
+
+	static COMMAND_CLASS GetCommandClass(uint32);
+
+	CINTC m_intc;
+	CIPU m_ipu;
+
+	std::vector<uint8> m_pendingDma4Data;
+	uint32 m_pendingDma4Offset = 0;
+	std::vector<uint8> m_output;
+	std::deque<COMMAND_RESULT> m_commandResults;
+	uint32 m_commandCode = 0;
+};
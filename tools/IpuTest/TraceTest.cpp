@@ -0,0 +1,295 @@
+#include <algorithm>
+#include "TraceTest.h"
+#include "TraceReplayer.h"
+#include "MemStream.h"
+
+//Records a trace of a few commands, replays it and checks that the replay gives the same results
+//with and without decode ahead. Also checks that a corrupted trace is detected.
+
+enum
+{
+	IDEC_MACROBLOCK_COUNT = 40,
+	CSC_MACROBLOCK_COUNT = 4,
+	MACROBLOCK_SIZE = 0x180,
+	DMA4_CHUNK_QWC = 3,
+};
+
+static const uint32 g_ipuCtrlRst = 0x40000000;
+
+struct COEFFICIENT_CODE
+{
+	uint32 code;
+	uint32 length;
+	uint32 run;
+};
+
+//Some B-14 codes, without their sign bit
+static const COEFFICIENT_CODE g_coefficientCodes[] =
+    {
+        {0x3, 2, 0},
+        {0x3, 3, 1},
+        {0x4, 4, 0},
+        {0x5, 4, 2},
+        {0x5, 5, 0},
+        {0x7, 5, 3},
+        {0x6, 6, 1},
+};
+
+void CTraceTest::CBitWriter::Write(uint32 value, uint32 length)
+{
+	for(uint32 i = 0; i < length; i++)
+	{
+		if((m_bitCount % 8) == 0)
+		{
+			m_data.push_back(0);
+		}
+		if((value >> (length - i - 1)) & 1)
+		{
+			m_data.back() |= 0x80 >> (m_bitCount % 8);
+		}
+		m_bitCount++;
+	}
+}
+
+std::vector<uint8> CTraceTest::CBitWriter::GetData()
+{
+	auto data = m_data;
+	data.resize((data.size() + 0xF) & ~0xF);
+	return data;
+}
+
+void CTraceTest::Execute()
+{
+	CIpuTrace trace;
+	RecordTrace(trace);
+	TEST_VERIFY(trace.IsStarted());
+
+	Framework::CMemStream traceStream;
+	trace.Write(traceStream);
+	traceStream.Seek(0, Framework::STREAM_SEEK_SET);
+
+	CIpuTrace loadedTrace;
+	loadedTrace.Read(traceStream);
+	TEST_VERIFY(loadedTrace.GetEvents().size() == trace.GetEvents().size());
+
+	{
+		CTraceReplayer replayer;
+		auto result = replayer.Replay(loadedTrace);
+		TEST_VERIFY(result.commandCount != 0);
+		TEST_VERIFY(result.mismatchCount == 0);
+		TEST_VERIFY(result.classStats[CTraceReplayer::COMMAND_CLASS_IDEC].commandCount == 1);
+		TEST_VERIFY(result.classStats[CTraceReplayer::COMMAND_CLASS_BDEC].commandCount == 1);
+		TEST_VERIFY(result.classStats[CTraceReplayer::COMMAND_CLASS_VDEC].commandCount == 1);
+		TEST_VERIFY(result.classStats[CTraceReplayer::COMMAND_CLASS_CSC].commandCount == 1);
+	}
+
+	{
+		CTraceReplayer replayer;
+		replayer.SetDecodeAheadEnabled(true);
+		auto result = replayer.Replay(loadedTrace);
+		TEST_VERIFY(result.mismatchCount == 0);
+	}
+
+	{
+		//Flip a bit in the CSC command's input
+		const auto traceBuffer = traceStream.GetBuffer();
+		const auto traceBufferEnd = traceBuffer + traceStream.GetSize();
+		auto cscDataIterator = std::search(traceBuffer, traceBufferEnd, m_cscStream.begin(), m_cscStream.end());
+		TEST_VERIFY(cscDataIterator != traceBufferEnd);
+
+		uint8 corruptValue = cscDataIterator[0] ^ 0x80;
+		traceStream.Seek(cscDataIterator - traceBuffer, Framework::STREAM_SEEK_SET);
+		traceStream.Write8(corruptValue);
+		traceStream.Seek(0, Framework::STREAM_SEEK_SET);
+
+		CIpuTrace corruptTrace;
+		corruptTrace.Read(traceStream);
+
+		CTraceReplayer replayer;
+		auto result = replayer.Replay(corruptTrace);
+		TEST_VERIFY(result.mismatchCount == 1);
+		TEST_VERIFY(result.firstMismatchCommand == (result.commandCount - 1));
+	}
+}
+
+void CTraceTest::RecordTrace(CIpuTrace& trace)
+{
+	CINTC intc;
+	CIPU ipu(intc);
+	ipu.SetDMA3ReceiveHandler([](const void*, uint32 size) { return size; });
+	ipu.Reset();
+	ipu.SetTrace(&trace);
+
+	//Nothing is recorded before a reset
+	ipu.SetRegister(CIPU::IPU_CTRL, 0);
+	TEST_VERIFY(!trace.IsStarted());
+	ipu.SetRegister(CIPU::IPU_CTRL, g_ipuCtrlRst);
+	TEST_VERIFY(trace.IsStarted());
+
+	//SETIQ (intra)
+	{
+		std::vector<uint8> matrix(0x40);
+		for(uint32 i = 0; i < 0x40; i++)
+		{
+			matrix[i] = static_cast<uint8>(8 + (i / 2));
+		}
+		RunCommand(ipu, 0x50000000, matrix);
+	}
+
+	//SETTH
+	RunCommand(ipu, 0x90000000 | (0x60 << 16) | 0x20, std::vector<uint8>());
+
+	//IDEC (RGB32, quantiser scale 8)
+	RunCommand(ipu, 0x00000000, std::vector<uint8>());
+	RunCommand(ipu, 0x10000000 | (8 << 16), GenerateIdecStream(IDEC_MACROBLOCK_COUNT));
+
+	//BDEC (intra, DC reset, quantiser scale 4)
+	RunCommand(ipu, 0x00000000, std::vector<uint8>());
+	RunCommand(ipu, 0x20000000 | (1 << 27) | (1 << 26) | (4 << 16), GenerateBdecStream());
+
+	//VDEC (macroblock address increment)
+	{
+		CBitWriter writer;
+		writer.Write(0x3, 3);
+		RunCommand(ipu, 0x00000000, std::vector<uint8>());
+		RunCommand(ipu, 0x30000000, writer.GetData());
+	}
+
+	//CSC (RGB32)
+	RunCommand(ipu, 0x00000000, std::vector<uint8>());
+	m_cscStream = GenerateCscStream(CSC_MACROBLOCK_COUNT);
+	RunCommand(ipu, 0x70000000 | CSC_MACROBLOCK_COUNT, m_cscStream);
+
+	ipu.SetTrace(nullptr);
+}
+
+void CTraceTest::RunCommand(CIPU& ipu, uint32 command, const std::vector<uint8>& data)
+{
+	ipu.SetRegister(CIPU::IPU_CMD, command);
+
+	//Send data in small chunks to get commands to wait for more
+	uint32 address = 0;
+	while(1)
+	{
+		uint32 qwc = std::min<uint32>(static_cast<uint32>(data.size() - address) / 0x10, DMA4_CHUNK_QWC);
+		if(qwc != 0)
+		{
+			address += ipu.ReceiveDMA4(address, qwc, false, const_cast<uint8*>(data.data()), nullptr) * 0x10;
+		}
+		if(!ipu.WillExecuteCommand())
+		{
+			break;
+		}
+		ipu.CountTicks(100);
+		ipu.ExecuteCommand();
+		if(ipu.HasPendingOUTFIFOData())
+		{
+			ipu.FlushOUTFIFOData();
+		}
+	}
+}
+
+void CTraceTest::WriteIntraBlocks(CBitWriter& writer)
+{
+	//DC size VLCs (B-12 and B-13) for sizes 0 to 4
+	static const uint32 dcSizeLuma[][2] = {{0x4, 3}, {0x0, 2}, {0x1, 2}, {0x5, 3}, {0x6, 3}};
+	static const uint32 dcSizeChroma[][2] = {{0x0, 2}, {0x1, 2}, {0x2, 2}, {0x6, 3}, {0xE, 4}};
+
+	for(uint32 blockIndex = 0; blockIndex < 6; blockIndex++)
+	{
+		uint32 dcSize = GenerateRandom() % 5;
+		const auto& dcSizeCode = (blockIndex < 4) ? dcSizeLuma[dcSize] : dcSizeChroma[dcSize];
+		writer.Write(dcSizeCode[0], dcSizeCode[1]);
+		if(dcSize != 0)
+		{
+			writer.Write(GenerateRandom(), dcSize);
+		}
+
+		uint32 position = 1;
+		uint32 coefficientCount = GenerateRandom() % 10;
+		for(uint32 i = 0; i < coefficientCount; i++)
+		{
+			if((GenerateRandom() % 5) == 0)
+			{
+				//Escape
+				uint32 run = GenerateRandom() % 4;
+				if((position + run) > 63)
+				{
+					break;
+				}
+				int32 level = static_cast<int32>(GenerateRandom() % 256) - 128;
+				writer.Write(0x1, 6);
+				writer.Write(run, 6);
+				writer.Write((level == 0) ? 1 : level, 12);
+				position += run + 1;
+			}
+			else
+			{
+				const auto& code = g_coefficientCodes[GenerateRandom() % (sizeof(g_coefficientCodes) / sizeof(g_coefficientCodes[0]))];
+				if((position + code.run) > 63)
+				{
+					break;
+				}
+				writer.Write(code.code, code.length);
+				writer.Write(GenerateRandom(), 1);
+				position += code.run + 1;
+			}
+		}
+
+		//End of block
+		writer.Write(0x2, 2);
+	}
+}
+
+std::vector<uint8> CTraceTest::GenerateIdecStream(uint32 macroblockCount)
+{
+	CBitWriter writer;
+	for(uint32 i = 0; i < macroblockCount; i++)
+	{
+		if(i != 0)
+		{
+			//Macroblock address increment
+			writer.Write(0x1, 1);
+		}
+		if((GenerateRandom() % 4) == 0)
+		{
+			//Intra with quantiser scale
+			writer.Write(0x1, 2);
+			writer.Write(1 + (GenerateRandom() % 31), 5);
+		}
+		else
+		{
+			writer.Write(0x1, 1);
+		}
+		WriteIntraBlocks(writer);
+	}
+	//Picture start code
+	writer.Write(0, 8);
+	writer.Write(0, 16);
+	writer.Write(0x1, 8);
+	writer.Write(0, 8);
+	return writer.GetData();
+}
+
+std::vector<uint8> CTraceTest::GenerateBdecStream()
+{
+	CBitWriter writer;
+	WriteIntraBlocks(writer);
+	return writer.GetData();
+}
+
+std::vector<uint8> CTraceTest::GenerateCscStream(uint32 macroblockCount)
+{
+	std::vector<uint8> data(macroblockCount * MACROBLOCK_SIZE);
+	for(auto& value : data)
+	{
+		value = static_cast<uint8>(GenerateRandom());
+	}
+	return data;
+}
+
+uint32 CTraceTest::GenerateRandom()
+{
+	m_randomState = (m_randomState * 1103515245) + 12345;
+	return m_randomState >> 16;
+}
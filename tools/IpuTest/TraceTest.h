@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+#include "Types.h"
+#include "ee/IPU_Trace.h"
+
+class CIPU;
+
+class CTraceTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	class CBitWriter
+	{
+	public:
+		void Write(uint32, uint32);
+		std::vector<uint8> GetData();
+
+	private:
+		std::vector<uint8> m_data;
+		uint32 m_bitCount = 0;
+	};
+
+	void RecordTrace(CIpuTrace&);
+	void RunCommand(CIPU&, uint32, const std::vector<uint8>&);
+
+	void WriteIntraBlocks(CBitWriter&);
+	std::vector<uint8> GenerateIdecStream(uint32);
+	std::vector<uint8> GenerateBdecStream();
+	std::vector<uint8> GenerateCscStream(uint32);
+
+	uint32 GenerateRandom();
+
+	uint32 m_randomState = 1;
+	std::vector<uint8> m_cscStream;
+};
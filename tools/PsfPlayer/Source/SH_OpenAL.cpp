@@ -3,11 +3,10 @@
 #include <assert.h>
 
 //#define LOGGING
-#define SAMPLE_RATE 44100
 
+//Let the device pick its own mixing frequency, buffers are resampled to it if needed
 ALCint g_attrList[] =
     {
-        ALC_FREQUENCY, SAMPLE_RATE,
         0, 0};
 
 #define CHECK_AL_ERROR()                     \
@@ -23,6 +22,14 @@ CSH_OpenAL::CSH_OpenAL()
 	m_context.MakeCurrent();
 	alGenBuffers(MAX_BUFFERS, m_bufferNames);
 	CHECK_AL_ERROR();
+
+	ALCint frequency = 0;
+	alcGetIntegerv(m_device, ALC_FREQUENCY, 1, &frequency);
+	if(frequency > 0)
+	{
+		m_sampleRate = frequency;
+	}
+
 	Reset();
 }
 
@@ -67,6 +74,11 @@ bool CSH_OpenAL::HasFreeBuffers()
 	return m_availableBuffers.size() != 0;
 }
 
+uint32 CSH_OpenAL::GetSampleRate() const
+{
+	return m_sampleRate;
+}
+
 uint32 CSH_OpenAL::GetFreeBufferCount() const
 {
 	return m_availableBuffers.size();
@@ -24,6 +24,7 @@ public:
 	void Write(int16*, unsigned int, unsigned int) override;
 	bool HasFreeBuffers() override;
 	void RecycleBuffers() override;
+	uint32 GetSampleRate() const override;
 
 	uint32 GetFreeBufferCount() const;
 
@@ -36,6 +37,7 @@ private:
 
 	BufferList m_availableBuffers;
 	uint64 m_lastUpdateTime;
+	uint32 m_sampleRate = DEFAULT_SAMPLE_RATE;
 	bool m_mustSync;
 	ALuint m_bufferNames[MAX_BUFFERS];
 };
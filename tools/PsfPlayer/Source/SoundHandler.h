@@ -3,11 +3,18 @@
 #include <functional>
 #include "Types.h"
 
+class CSoundRingBuffer;
+
 class CSoundHandler
 {
 public:
 	typedef std::function<CSoundHandler*(void)> FactoryFunction;
 
+	enum
+	{
+		DEFAULT_SAMPLE_RATE = 44100,
+	};
+
 	virtual ~CSoundHandler()
 	{
 	}
@@ -17,5 +24,19 @@ public:
 	virtual bool HasFreeBuffers() = 0;
 	virtual void RecycleBuffers() = 0;
 
+	//Sampling rate the output device mixes at, writing samples at that rate
+	//avoids having them resampled once more by the system's mixer
+	virtual uint32 GetSampleRate() const
+	{
+		return DEFAULT_SAMPLE_RATE;
+	}
+
+	//Handlers that pull samples from their device's callback expose a ring that samples
+	//can be rendered into directly, instead of having them written in buffers
+	virtual CSoundRingBuffer* GetRingBuffer()
+	{
+		return nullptr;
+	}
+
 private:
 };
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "filesystem_def.h"
+#include "PsfVm.h"
+#include "PsfLoader.h"
+#include "PsfArchive.h"
+#include "PsfTags.h"
+#include "PlaybackController.h"
+#include "Playlist.h"
+#include "ThreadPool.h"
+#include "SH_WaveFile.h"
+
+#define PLAYLIST_EXTENSION ".psfpl"
+
+struct TRACK
+{
+	fs::path path;
+	fs::path archivePath;
+	fs::path outputPath;
+};
+typedef std::vector<TRACK> TrackList;
+
+static bool IsArchiveExtension(const std::string& extension)
+{
+	return (extension == ".zip") || (extension == ".rar");
+}
+
+static void GatherTracks(TrackList& tracks, const fs::path& inputPath, const fs::path& outputPath)
+{
+	auto extension = inputPath.extension().string();
+	if(IsArchiveExtension(extension))
+	{
+		//Tracks from an archive go in their own folder to avoid name clashes between archives
+		auto archiveOutputPath = outputPath / inputPath.stem();
+		fs::create_directories(archiveOutputPath);
+		auto archive = CPsfArchive::CreateFromPath(inputPath);
+		for(const auto& fileInfo : archive->GetFiles())
+		{
+			fs::path itemPath = fileInfo.name;
+			auto itemExtension = itemPath.extension().string();
+			if(itemExtension.empty() || !CPlaylist::IsLoadableExtension(itemExtension.c_str() + 1))
+			{
+				continue;
+			}
+			TRACK track;
+			track.path = itemPath;
+			track.archivePath = inputPath;
+			track.outputPath = archiveOutputPath / itemPath.filename().replace_extension(".wav");
+			tracks.push_back(track);
+		}
+	}
+	else if(extension == PLAYLIST_EXTENSION)
+	{
+		CPlaylist playlist;
+		playlist.Read(inputPath);
+		for(unsigned int i = 0; i < playlist.GetItemCount(); i++)
+		{
+			fs::path itemPath = playlist.GetItem(i).path;
+			TRACK track;
+			track.path = itemPath;
+			track.outputPath = outputPath / itemPath.filename().replace_extension(".wav");
+			tracks.push_back(track);
+		}
+	}
+	else if(!extension.empty() && CPlaylist::IsLoadableExtension(extension.c_str() + 1))
+	{
+		TRACK track;
+		track.path = inputPath;
+		track.outputPath = outputPath / inputPath.filename().replace_extension(".wav");
+		tracks.push_back(track);
+	}
+	else
+	{
+		printf("Warning: Skipping '%s', unsupported file type.\r\n", inputPath.string().c_str());
+	}
+}
+
+static void MakeOutputPathsUnique(TrackList& tracks)
+{
+	//Tracks coming from different folders can share a name, number the duplicates
+	//so that they don't overwrite each other. Comparison ignores case since output
+	//might go to a case insensitive file system.
+	auto makeKey = [](const fs::path& path) {
+		auto key = path.generic_string();
+		std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return key;
+	};
+	std::set<std::string> usedPaths;
+	for(auto& track : tracks)
+	{
+		auto outputPath = track.outputPath;
+		for(unsigned int index = 2; usedPaths.count(makeKey(outputPath)) != 0; index++)
+		{
+			auto fileName = track.outputPath.stem().string() + " (" + std::to_string(index) + ").wav";
+			outputPath = track.outputPath.parent_path() / fileName;
+		}
+		usedPaths.insert(makeKey(outputPath));
+		track.outputPath = outputPath;
+	}
+}
+
+static void RenderTrack(const TRACK& track)
+{
+	CPsfVm virtualMachine;
+	CPlaybackController playbackController;
+
+	CPsfBase::TagMap tags;
+	CPsfLoader::LoadPsf(virtualMachine, track.path.wstring(), track.archivePath, &tags);
+
+	CSH_WaveFile* waveFile = nullptr;
+	virtualMachine.SetSpuHandler(
+	    [&]() -> CSoundHandler* {
+		    waveFile = new CSH_WaveFile(track.outputPath);
+		    return waveFile;
+	    });
+
+	std::mutex completedMutex;
+	std::condition_variable completedCondition;
+	bool completed = false;
+
+	//These are all raised from the VM's thread, between two updates of the subsystem
+	auto newFrameConnection = virtualMachine.OnNewFrame.Connect(
+	    [&]() { playbackController.Tick(); });
+	auto volumeChangedConnection = playbackController.VolumeChanged.Connect(
+	    [&](float volume) { virtualMachine.SetVolumeAdjust(volume); });
+	auto playbackCompletedConnection = playbackController.PlaybackCompleted.Connect(
+	    [&]() {
+		    waveFile->SetEnded();
+		    std::lock_guard<std::mutex> completedLock(completedMutex);
+		    completed = true;
+		    completedCondition.notify_one();
+	    });
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	playbackController.Play(CPsfTags(tags));
+	virtualMachine.Resume();
+
+	{
+		std::unique_lock<std::mutex> completedLock(completedMutex);
+		completedCondition.wait(completedLock, [&]() { return completed; });
+	}
+
+	virtualMachine.Pause();
+	//Destroys the handler, which completes the output file
+	virtualMachine.SetSpuHandler(nullptr);
+
+	auto renderTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	double trackTime = static_cast<double>(playbackController.GetFrameCount()) / 60.0;
+	printf("Rendered '%s': %.1fs of audio in %.2fs (%.1fx realtime).\r\n",
+	       track.outputPath.string().c_str(), trackTime, renderTime, trackTime / renderTime);
+	fflush(stdout);
+}
+
+static void Render(const TrackList& tracks, unsigned int jobCount)
+{
+	//Each job owns a VM thread which does the work, the pool only bounds how many run at once
+	Framework::CThreadPool threadPool(jobCount);
+	for(const auto& track : tracks)
+	{
+		threadPool.Enqueue(
+		    [track]() {
+			    try
+			    {
+				    RenderTrack(track);
+			    }
+			    catch(const std::exception& exception)
+			    {
+				    printf("Failed to render '%s', reason: '%s'.\r\n",
+				           track.path.string().c_str(), exception.what());
+				    fflush(stdout);
+			    }
+		    });
+	}
+}
+
+static void PrintUsage()
+{
+	printf("PsfBatch usage:\r\n");
+	printf("\tPsfBatch [-j JobCount] [OutputPath] [InputFile...]\r\n");
+	printf("\tInput files can be PSF files, archives (zip, rar) or playlists (psfpl).\r\n");
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int jobCount = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+	int argIndex = 1;
+	if((argc > 2) && !strcmp(argv[argIndex], "-j"))
+	{
+		jobCount = std::max(atoi(argv[argIndex + 1]), 1);
+		argIndex += 2;
+	}
+
+	if((argc - argIndex) < 2)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	try
+	{
+		fs::path outputPath(argv[argIndex++]);
+		fs::create_directories(outputPath);
+
+		TrackList tracks;
+		for(; argIndex < argc; argIndex++)
+		{
+			try
+			{
+				GatherTracks(tracks, fs::path(argv[argIndex]), outputPath);
+			}
+			catch(const std::exception& exception)
+			{
+				printf("Warning: Skipping '%s', reason: '%s'.\r\n", argv[argIndex], exception.what());
+			}
+		}
+
+		MakeOutputPathsUnique(tracks);
+
+		printf("Rendering %zu tracks using %u jobs...\r\n", tracks.size(), jobCount);
+		fflush(stdout);
+
+		auto startTime = std::chrono::steady_clock::now();
+		Render(tracks, jobCount);
+		auto totalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+		printf("Done in %.2fs.\r\n", totalTime);
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Failed to render: %s\r\n", exception.what());
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,72 @@
+#include "SH_WaveFile.h"
+#include "StdStreamUtils.h"
+
+CSH_WaveFile::CSH_WaveFile(const fs::path& outputPath)
+    : m_outputStream(Framework::CreateOutputStdStream(outputPath.native()))
+{
+	WriteHeader();
+}
+
+CSH_WaveFile::~CSH_WaveFile()
+{
+	//Patch the header now that the size of the data is known
+	m_outputStream.Seek(0, Framework::STREAM_SEEK_SET);
+	WriteHeader();
+}
+
+void CSH_WaveFile::Reset()
+{
+}
+
+void CSH_WaveFile::Write(int16* samples, unsigned int sampleCount, unsigned int sampleRate)
+{
+	if(m_ended) return;
+	m_sampleRate = sampleRate;
+	uint32 size = sampleCount * sizeof(int16);
+	m_outputStream.Write(samples, size);
+	m_dataSize += size;
+}
+
+bool CSH_WaveFile::HasFreeBuffers()
+{
+	//Never throttle the VM, we want to render as fast as possible
+	return true;
+}
+
+void CSH_WaveFile::RecycleBuffers()
+{
+}
+
+void CSH_WaveFile::SetEnded()
+{
+	m_ended = true;
+}
+
+void CSH_WaveFile::WriteHeader()
+{
+	static const char riffSignature[4] = {'R', 'I', 'F', 'F'};
+	static const char waveSignature[4] = {'W', 'A', 'V', 'E'};
+	static const char fmtSignature[4] = {'f', 'm', 't', ' '};
+	static const char dataSignature[4] = {'d', 'a', 't', 'a'};
+
+	uint32 blockAlign = CHANNEL_COUNT * BITS_PER_SAMPLE / 8;
+
+	//RIFF header
+	m_outputStream.Write(riffSignature, 4);
+	m_outputStream.Write32(4 + (8 + 16) + (8 + m_dataSize));
+	m_outputStream.Write(waveSignature, 4);
+
+	//fmt chunk (PCM)
+	m_outputStream.Write(fmtSignature, 4);
+	m_outputStream.Write32(16);
+	m_outputStream.Write16(1);
+	m_outputStream.Write16(CHANNEL_COUNT);
+	m_outputStream.Write32(m_sampleRate);
+	m_outputStream.Write32(m_sampleRate * blockAlign);
+	m_outputStream.Write16(blockAlign);
+	m_outputStream.Write16(BITS_PER_SAMPLE);
+
+	//data chunk
+	m_outputStream.Write(dataSignature, 4);
+	m_outputStream.Write32(m_dataSize);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../SoundHandler.h"
+#include "StdStream.h"
+#include "filesystem_def.h"
+
+class CSH_WaveFile : public CSoundHandler
+{
+public:
+	CSH_WaveFile(const fs::path&);
+	virtual ~CSH_WaveFile();
+
+	void Reset() override;
+	void Write(int16*, unsigned int, unsigned int) override;
+	bool HasFreeBuffers() override;
+	void RecycleBuffers() override;
+
+	//Samples written after this is set are dropped, used to stop exactly when
+	//the track ends even if the VM keeps running for a little while
+	void SetEnded();
+
+private:
+	enum
+	{
+		CHANNEL_COUNT = 2,
+		BITS_PER_SAMPLE = 16,
+	};
+
+	void WriteHeader();
+
+	Framework::CStdStream m_outputStream;
+	uint32 m_sampleRate = DEFAULT_SAMPLE_RATE;
+	uint32 m_dataSize = 0;
+	bool m_ended = false;
+};
@@ -0,0 +1,49 @@
+#include <cstring>
+#include "AdpcmTest.h"
+#include "iop/Iop_SpuAdpcm.h"
+
+//Checks that the SIMD ADPCM decoder gives the same results as the scalar one for all
+//shift factors and predictors (including invalid ones) and with saturating outputs.
+
+using namespace Iop;
+
+enum
+{
+	BLOCK_COUNT = 20000,
+};
+
+void CAdpcmTest::Execute()
+{
+	int32 s1 = 0;
+	int32 s2 = 0;
+	int32 s1Scalar = 0;
+	int32 s2Scalar = 0;
+	for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+	{
+		uint8 block[SpuAdpcm::BLOCK_SIZE];
+		for(unsigned int i = 0; i < SpuAdpcm::BLOCK_SIZE; i++)
+		{
+			block[i] = static_cast<uint8>(GenerateRandom());
+		}
+		//Mostly use valid predictors to let the filter state build up
+		if((blockIndex % 8) != 0)
+		{
+			block[0] = static_cast<uint8>(((GenerateRandom() % 5) << 4) | (blockIndex & 0x0F));
+		}
+
+		int16 output[SpuAdpcm::BLOCK_SAMPLES];
+		int16 outputScalar[SpuAdpcm::BLOCK_SAMPLES];
+		SpuAdpcm::DecodeBlock(block, output, s1, s2);
+		SpuAdpcm::DecodeBlockScalar(block, outputScalar, s1Scalar, s2Scalar);
+
+		TEST_VERIFY(!memcmp(output, outputScalar, sizeof(output)));
+		TEST_VERIFY(s1 == s1Scalar);
+		TEST_VERIFY(s2 == s2Scalar);
+	}
+}
+
+uint32 CAdpcmTest::GenerateRandom()
+{
+	m_randomState = (m_randomState * 1103515245) + 12345;
+	return m_randomState >> 16;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Test.h"
+
+class CAdpcmTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	uint32 GenerateRandom();
+
+	uint32 m_randomState = 1;
+};
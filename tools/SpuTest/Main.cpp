@@ -1,27 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
+#include <vector>
+#include "AdpcmTest.h"
 #include "KeyOnOffTest.h"
 #include "MultiCoreIrqTest.h"
+#include "ReverbTest.h"
+#include "SampleCacheTest.h"
 #include "SetRepeatTest.h"
 #include "SetRepeatTest2.h"
 #include "SimpleIrqTest.h"
 #include "SweepTest.h"
+#include "VoiceMixerTest.h"
+#include "iop/Iop_SpuAdpcm.h"
 
 typedef std::function<CTest*()> TestFactoryFunction;
 
 // clang-format off
 static const TestFactoryFunction s_factories[] =
 {
+	[]() { return new CAdpcmTest(); },
 	[]() { return new CKeyOnOffTest(); },
 	[]() { return new CMultiCoreIrqTest(); },
+	[]() { return new CReverbTest(); },
+	[]() { return new CSampleCacheTest(); },
 	[]() { return new CSetRepeatTest(); },
 	[]() { return new CSetRepeatTest2(); },
 	[]() { return new CSimpleIrqTest(); },
 	[]() { return new CSweepTest(); },
+	[]() { return new CVoiceMixerTest(); },
 };
 // clang-format on
 
+typedef void (*AdpcmDecodeFunction)(const uint8*, int16*, int32&, int32&);
+
+//Keeps decoding from being optimized out
+static volatile int16 g_adpcmBenchmarkSink = 0;
+
+static double BenchmarkAdpcmDecoder(AdpcmDecodeFunction decodeFunction, const std::vector<uint8>& blocks, uint32 iterationCount)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+
+	uint32 blockCount = static_cast<uint32>(blocks.size() / Iop::SpuAdpcm::BLOCK_SIZE);
+	int16 output[Iop::SpuAdpcm::BLOCK_SAMPLES];
+	auto startTime = Clock::now();
+	for(uint32 iteration = 0; iteration < iterationCount; iteration++)
+	{
+		int32 s1 = 0;
+		int32 s2 = 0;
+		for(uint32 i = 0; i < blockCount; i++)
+		{
+			decodeFunction(blocks.data() + (i * Iop::SpuAdpcm::BLOCK_SIZE), output, s1, s2);
+			g_adpcmBenchmarkSink = output[i % Iop::SpuAdpcm::BLOCK_SAMPLES];
+		}
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+	double sampleCount = static_cast<double>(blockCount) * Iop::SpuAdpcm::BLOCK_SAMPLES * iterationCount;
+	return sampleCount / seconds / 1000000.0;
+}
+
+static int BenchmarkAdpcm(int argc, const char** argv)
+{
+	uint32 blockCount = 0x10000;
+	uint32 iterationCount = 100;
+	if(argc >= 3)
+	{
+		blockCount = std::max<uint32>(strtoul(argv[2], nullptr, 0), 1);
+	}
+	if(argc >= 4)
+	{
+		iterationCount = std::max<uint32>(strtoul(argv[3], nullptr, 0), 1);
+	}
+
+	//Random data with valid predictors, similar to what the SPU reads
+	std::vector<uint8> blocks(blockCount * Iop::SpuAdpcm::BLOCK_SIZE);
+	uint32 randomState = 1;
+	for(auto& blockByte : blocks)
+	{
+		randomState = (randomState * 1103515245) + 12345;
+		blockByte = static_cast<uint8>(randomState >> 16);
+	}
+	for(uint32 i = 0; i < blockCount; i++)
+	{
+		auto& header = blocks[i * Iop::SpuAdpcm::BLOCK_SIZE];
+		header = static_cast<uint8>((((header >> 4) % 5) << 4) | (header & 0x0F));
+	}
+
+	printf("Decoding %d ADPCM blocks %d times.\n", blockCount, iterationCount);
+	double scalarRate = BenchmarkAdpcmDecoder(&Iop::SpuAdpcm::DecodeBlockScalar, blocks, iterationCount);
+	double rate = BenchmarkAdpcmDecoder(&Iop::SpuAdpcm::DecodeBlock, blocks, iterationCount);
+	printf("%-8s %14s\n", "decoder", "Msamples/s");
+	printf("%-8s %14.3f\n", "scalar", scalarRate);
+	printf("%-8s %14.3f\n", "default", rate);
+
+	return 0;
+}
+
 int main(int argc, const char** argv)
 {
+	if((argc >= 2) && !strcmp(argv[1], "--adpcm-benchmark"))
+	{
+		return BenchmarkAdpcm(argc, argv);
+	}
+
 	for(const auto& factory : s_factories)
 	{
 		auto test = factory();
@@ -0,0 +1,126 @@
+#include <cmath>
+#include "ReverbTest.h"
+#include "iop/Iop_SpuBase.h"
+#include "iop/Iop_SpuReverb.h"
+
+//Checks that the block reverb sounds the same as the scalar one, with random registers and
+//with actual reverb presets. Results are compared with a signal to noise ratio instead of
+//exactly since platforms may fuse multiplies and adds differently between both versions.
+
+using namespace Iop;
+
+enum
+{
+	RAM_SIZE = 0x40000,
+	WORK_AREA_START = 0x20000,
+	TRIAL_COUNT = 40,
+	BLOCK_COUNT = 500,
+	MAX_BLOCK_TICKS = 64,
+};
+
+static const double g_minSnr = 60.0;
+
+//Room and Hall presets, offsets are in units of 8 bytes
+static const uint32 g_presets[][CSpuBase::REVERB_REG_COUNT] =
+{
+	{
+		0x007D, 0x005B, 0x6D80, 0x54B8, 0xBED0, 0x0000, 0x0000, 0xBA80, 0x5800, 0x5300, 0x04D6, 0x0333, 0x03F0, 0x0227, 0x0374, 0x01EF,
+		0x0334, 0x01B5, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x01B4, 0x0136, 0x00B8, 0x005C, 0x8000, 0x8000
+	},
+	{
+		0x01A5, 0x0139, 0x6000, 0x5000, 0x4C00, 0xB800, 0xBC00, 0xC000, 0x6000, 0x5C00, 0x15BA, 0x11BB, 0x14C2, 0x10BD, 0x11BC, 0x0DC1,
+		0x11C0, 0x0DC3, 0x0DC0, 0x09C1, 0x0BC4, 0x07C1, 0x0A00, 0x06CD, 0x09C2, 0x05C1, 0x05C0, 0x041A, 0x0274, 0x013A, 0x8000, 0x8000
+	},
+};
+
+void CReverbTest::Execute()
+{
+	m_reverbRam.resize(RAM_SIZE);
+	m_reverbRamScalar.resize(RAM_SIZE);
+
+	for(unsigned int trial = 0; trial < TRIAL_COUNT; trial++)
+	{
+		uint32 params[CSpuBase::REVERB_REG_COUNT];
+		uint32 workAreaSize = 0;
+		if(trial & 1)
+		{
+			const auto& preset = g_presets[(trial / 2) % 2];
+			for(unsigned int i = 0; i < CSpuBase::REVERB_REG_COUNT; i++)
+			{
+				params[i] = CSpuBase::g_reverbParamIsAddress[i] ? (preset[i] * 8) : preset[i];
+			}
+			workAreaSize = 0x10000;
+		}
+		else
+		{
+			//Small work areas and offsets make sure taps wrap around and overlap
+			bool small = (trial % 4) == 0;
+			for(unsigned int i = 0; i < CSpuBase::REVERB_REG_COUNT; i++)
+			{
+				params[i] = CSpuBase::g_reverbParamIsAddress[i] ? ((GenerateRandom() % (small ? 0x10 : 0x2000)) * 2) : (GenerateRandom() & 0xFFFF);
+			}
+			workAreaSize = small ? ((GenerateRandom() % 0x40) + 2) : (0x8000 + (GenerateRandom() % 0x8000));
+		}
+		RunTrial(params, WORK_AREA_START + ((GenerateRandom() % 0x40) * 2), workAreaSize);
+	}
+}
+
+void CReverbTest::RunTrial(const uint32* params, uint32 workAddrStart, uint32 workAreaSize)
+{
+	for(auto& value : m_reverbRam)
+	{
+		value = static_cast<uint8>(GenerateRandom());
+	}
+	m_reverbRamScalar = m_reverbRam;
+
+	SpuReverb::STATE state;
+	state.ram = m_reverbRam.data();
+	state.params = params;
+	state.workAddrStart = workAddrStart;
+	state.workAddrEnd = workAddrStart + workAreaSize;
+	state.currAddr = workAddrStart;
+	state.ticks = GenerateRandom() & 1;
+
+	SpuReverb::STATE stateScalar = state;
+	stateScalar.ram = m_reverbRamScalar.data();
+
+	double signalPower = 0;
+	double noisePower = 0;
+	for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+	{
+		unsigned int tickCount = (GenerateRandom() % MAX_BLOCK_TICKS) + 1;
+		int16 input[MAX_BLOCK_TICKS * 2];
+		int16 output[MAX_BLOCK_TICKS * 2] = {};
+		int16 outputScalar[MAX_BLOCK_TICKS * 2] = {};
+		for(unsigned int i = 0; i < (tickCount * 2); i++)
+		{
+			input[i] = static_cast<int16>(GenerateRandom());
+		}
+
+		SpuReverb::Process(state, input, output, tickCount);
+		SpuReverb::ProcessScalar(stateScalar, input, outputScalar, tickCount);
+
+		TEST_VERIFY(state.currAddr == stateScalar.currAddr);
+		TEST_VERIFY(state.ticks == stateScalar.ticks);
+
+		for(unsigned int i = 0; i < (tickCount * 2); i++)
+		{
+			double signal = outputScalar[i];
+			double noise = static_cast<double>(output[i]) - signal;
+			signalPower += signal * signal;
+			noisePower += noise * noise;
+		}
+	}
+
+	if(noisePower != 0)
+	{
+		double snr = 10.0 * std::log10(signalPower / noisePower);
+		TEST_VERIFY(snr >= g_minSnr);
+	}
+}
+
+uint32 CReverbTest::GenerateRandom()
+{
+	m_randomState = (m_randomState * 1103515245) + 12345;
+	return m_randomState >> 16;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+
+class CReverbTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	void RunTrial(const uint32*, uint32, uint32);
+	uint32 GenerateRandom();
+
+	uint32 m_randomState = 1;
+	std::vector<uint8> m_reverbRam;
+	std::vector<uint8> m_reverbRamScalar;
+};
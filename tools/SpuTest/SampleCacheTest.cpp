@@ -0,0 +1,83 @@
+#include "SampleCacheTest.h"
+
+//Checks lookups, range invalidation and that the cache keeps returning
+//correct entries once it's full and needs to replace some of them.
+
+using namespace Iop;
+
+enum
+{
+	FILL_ITEM_COUNT = 0x10000,
+};
+
+void CSampleCacheTest::Execute()
+{
+	//Lookups need to match address and decoder state
+	{
+		auto key = CSpuSampleCache::KEY{0x1000, 100, -200};
+		TEST_VERIFY(!m_spuSampleCache.GetItem(key));
+		RegisterItem(key);
+		TEST_VERIFY(m_spuSampleCache.GetItem(key));
+		TEST_VERIFY(!m_spuSampleCache.GetItem(CSpuSampleCache::KEY{0x1000, 100, 0}));
+		TEST_VERIFY(!m_spuSampleCache.GetItem(CSpuSampleCache::KEY{0x1010, 100, -200}));
+		TEST_VERIFY(m_spuSampleCache.GetStats().hitCount == 1);
+		TEST_VERIFY(m_spuSampleCache.GetStats().missCount == 3);
+	}
+
+	//Writing to SPU RAM invalidates blocks overlapping the written range, but not the ones far from it
+	{
+		auto key = CSpuSampleCache::KEY{0x2000, 0, 0};
+		auto farKey = CSpuSampleCache::KEY{0x8000, 0, 0};
+		RegisterItem(key);
+		RegisterItem(farKey);
+		m_spuSampleCache.ClearRange(0x2008, 2);
+		TEST_VERIFY(!m_spuSampleCache.GetItem(key));
+		TEST_VERIFY(m_spuSampleCache.GetItem(farKey));
+
+		RegisterItem(key);
+		TEST_VERIFY(m_spuSampleCache.GetItem(key));
+		m_spuSampleCache.Clear();
+		TEST_VERIFY(!m_spuSampleCache.GetItem(key));
+		TEST_VERIFY(!m_spuSampleCache.GetItem(farKey));
+	}
+
+	//Register more items than the cache can hold, items found must still be the right ones
+	{
+		m_spuSampleCache.ClearStats();
+		for(uint32 i = 0; i < FILL_ITEM_COUNT; i++)
+		{
+			RegisterItem(CSpuSampleCache::KEY{i * 0x10, static_cast<int32>(i), -static_cast<int32>(i)});
+		}
+		for(uint32 i = 0; i < FILL_ITEM_COUNT; i++)
+		{
+			auto key = CSpuSampleCache::KEY{i * 0x10, static_cast<int32>(i), -static_cast<int32>(i)};
+			if(auto item = m_spuSampleCache.GetItem(key))
+			{
+				for(unsigned int j = 0; j < CSpuSampleCache::BUFFER_SAMPLES; j++)
+				{
+					TEST_VERIFY(item->samples[j] == GetItemSample(key, j));
+				}
+			}
+		}
+		auto stats = m_spuSampleCache.GetStats();
+		TEST_VERIFY(stats.hitCount != 0);
+		TEST_VERIFY(stats.missCount != 0);
+		TEST_VERIFY((stats.hitCount + stats.missCount) == FILL_ITEM_COUNT);
+	}
+}
+
+void CSampleCacheTest::RegisterItem(const CSpuSampleCache::KEY& key)
+{
+	auto& item = m_spuSampleCache.RegisterItem(key);
+	for(unsigned int i = 0; i < CSpuSampleCache::BUFFER_SAMPLES; i++)
+	{
+		item.samples[i] = GetItemSample(key, i);
+	}
+	item.outS1 = key.s2;
+	item.outS2 = key.s1;
+}
+
+int16 CSampleCacheTest::GetItemSample(const CSpuSampleCache::KEY& key, unsigned int index)
+{
+	return static_cast<int16>((key.address >> 4) + (key.s1 * 3) + index);
+}
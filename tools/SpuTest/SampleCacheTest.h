@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Test.h"
+
+class CSampleCacheTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	void RegisterItem(const Iop::CSpuSampleCache::KEY&);
+	static int16 GetItemSample(const Iop::CSpuSampleCache::KEY&, unsigned int);
+};
@@ -0,0 +1,82 @@
+#include <climits>
+#include <cstring>
+#include "VoiceMixerTest.h"
+
+//Checks that the SIMD voice mixer gives the same results as the scalar one, including
+//extreme samples and volumes and outputs that need to be saturated, with both
+//interpolation modes.
+
+using namespace Iop;
+
+enum
+{
+	BLOCK_COUNT = 2000,
+	OUTPUT_SIZE = SpuVoiceMixer::BLOCK_SAMPLES * 2,
+};
+
+void CVoiceMixerTest::Execute()
+{
+	SpuVoiceMixer::VOICE_BLOCK block;
+	for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+	{
+		GenerateBlock(block);
+
+		unsigned int sampleCount = 1 + (blockIndex % SpuVoiceMixer::BLOCK_SAMPLES);
+		bool mixReverb = (blockIndex & 1) != 0;
+		auto interpolation = (blockIndex & 2) ? SpuVoiceMixer::INTERPOLATION_CUBIC : SpuVoiceMixer::INTERPOLATION_LINEAR;
+
+		int16 output[OUTPUT_SIZE];
+		int16 reverbOutput[OUTPUT_SIZE];
+		for(unsigned int i = 0; i < OUTPUT_SIZE; i++)
+		{
+			output[i] = GenerateSample();
+			reverbOutput[i] = GenerateSample();
+		}
+
+		int16 outputScalar[OUTPUT_SIZE];
+		int16 reverbOutputScalar[OUTPUT_SIZE];
+		memcpy(outputScalar, output, sizeof(output));
+		memcpy(reverbOutputScalar, reverbOutput, sizeof(reverbOutput));
+
+		SpuVoiceMixer::MixVoice(block, sampleCount, output, mixReverb ? reverbOutput : nullptr, interpolation);
+		SpuVoiceMixer::MixVoiceScalar(block, sampleCount, outputScalar, mixReverb ? reverbOutputScalar : nullptr, interpolation);
+
+		TEST_VERIFY(!memcmp(output, outputScalar, sizeof(output)));
+		TEST_VERIFY(!memcmp(reverbOutput, reverbOutputScalar, sizeof(reverbOutput)));
+	}
+}
+
+void CVoiceMixerTest::GenerateBlock(Iop::SpuVoiceMixer::VOICE_BLOCK& block)
+{
+	for(unsigned int i = 0; i < SpuVoiceMixer::BLOCK_SAMPLES; i++)
+	{
+		block.previousSamples[i] = GenerateSample();
+		block.currentSamples[i] = GenerateSample();
+		block.nextSamples[i] = GenerateSample();
+		block.afterNextSamples[i] = GenerateSample();
+		block.alphas[i] = static_cast<int16>(GenerateRandom() % 0x1000);
+		//Volumes are positive 15-bit values
+		block.adsrVolumes[i] = static_cast<int16>(((GenerateRandom() % 4) == 0) ? 0x7FFF : (GenerateRandom() & 0x7FFF));
+		block.volumesLeft[i] = static_cast<int16>(((GenerateRandom() % 4) == 0) ? 0x7FFF : (GenerateRandom() & 0x7FFF));
+		block.volumesRight[i] = static_cast<int16>(((GenerateRandom() % 4) == 0) ? 0 : (GenerateRandom() & 0x7FFF));
+	}
+}
+
+int16 CVoiceMixerTest::GenerateSample()
+{
+	switch(GenerateRandom() % 8)
+	{
+	case 0:
+		return SHRT_MIN;
+	case 1:
+		return SHRT_MAX;
+	default:
+		return static_cast<int16>(GenerateRandom());
+	}
+}
+
+uint32 CVoiceMixerTest::GenerateRandom()
+{
+	m_randomState = (m_randomState * 1103515245) + 12345;
+	return m_randomState >> 16;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Test.h"
+#include "iop/Iop_SpuVoiceMixer.h"
+
+class CVoiceMixerTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	void GenerateBlock(Iop::SpuVoiceMixer::VOICE_BLOCK&);
+	int16 GenerateSample();
+	uint32 GenerateRandom();
+
+	uint32 m_randomState = 1;
+};
@@ -0,0 +1,69 @@
+#include <cassert>
+#include <cstring>
+#include "TestVif.h"
+
+CTestVif::CTestVif(CVpu& vpu, CINTC& intc, uint8* ram, uint8* spr)
+    : CVif(0, vpu, intc, ram, spr)
+{
+}
+
+void CTestVif::SetupUnpack(const UNPACK_PARAMS& params)
+{
+	Reset();
+	m_CYCLE.nCL = params.cl;
+	m_CYCLE.nWL = params.wl;
+	m_MODE = params.mode;
+	m_MASK = params.mask;
+	memcpy(m_R, params.row, sizeof(m_R));
+	memcpy(m_C, params.col, sizeof(m_C));
+	m_CODE.nIMM = (params.dstAddr & 0x3FF) | (params.usn ? 0x4000 : 0);
+	m_CODE.nNUM = params.num;
+	m_CODE.nCMD = 0x60 | (params.useMask ? 0x10 : 0) | (params.dataType & 0x0F);
+	m_NUM = params.num;
+}
+
+void CTestVif::SetSource(uint32 address, uint32 size)
+{
+	m_stream.SetDmaParams(address, size, false);
+}
+
+void CTestVif::SkipSource(uint32 size)
+{
+	uint8 dummy[0x10];
+	assert(size <= sizeof(dummy));
+	m_stream.Read(dummy, size);
+}
+
+void CTestVif::ExecuteUnpack(bool compiled)
+{
+	uint32 dstAddr = m_CODE.nIMM & 0x3FF;
+	if(compiled)
+	{
+		Cmd_UNPACK(m_stream, m_CODE, dstAddr);
+	}
+	else
+	{
+		auto unpackFct = GetUnpacker(m_CODE);
+		((*this).*(unpackFct))(m_stream, m_CODE, dstAddr, 0);
+	}
+}
+
+bool CTestVif::IsUnpackWaiting() const
+{
+	return m_STAT.nVPS != 0;
+}
+
+uint8 CTestVif::GetNum() const
+{
+	return m_NUM;
+}
+
+void CTestVif::GetRow(uint32* row) const
+{
+	memcpy(row, m_R, sizeof(m_R));
+}
+
+uint32 CTestVif::GetRemainingSourceBytes() const
+{
+	return m_stream.GetAvailableReadBytes();
+}
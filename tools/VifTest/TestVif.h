@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ee/Vif.h"
+
+//Exposes the VIF's UNPACK machinery so that the compiled and generic unpackers can be
+//run on the same state.
+class CTestVif : public CVif
+{
+public:
+	struct UNPACK_PARAMS
+	{
+		uint8 dataType = 0;
+		bool usn = false;
+		bool useMask = false;
+		uint32 mask = 0;
+		uint8 mode = 0;
+		uint32 cl = 1;
+		uint32 wl = 1;
+		uint8 num = 0;
+		uint32 dstAddr = 0;
+		uint32 row[4] = {};
+		uint32 col[4] = {};
+	};
+
+	CTestVif(CVpu&, CINTC&, uint8*, uint8*);
+
+	void SetupUnpack(const UNPACK_PARAMS&);
+	void SetSource(uint32, uint32);
+	void SkipSource(uint32);
+	void ExecuteUnpack(bool);
+
+	bool IsUnpackWaiting() const;
+	uint8 GetNum() const;
+	void GetRow(uint32*) const;
+	uint32 GetRemainingSourceBytes() const;
+};
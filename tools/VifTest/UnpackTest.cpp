@@ -0,0 +1,153 @@
+#include <cstring>
+#include <memory>
+#include "UnpackTest.h"
+#include "Ps2Const.h"
+
+//Runs every UNPACK configuration through the generic unpackers and through the path that
+//uses compiled routines, with the same source data, and checks that both give the same results.
+//Source data is split in two DMA chunks and starts after a VIFcode sized header, so that
+//commands resume mid cycle and with bytes left from the previous chunk.
+
+enum
+{
+	FIRST_CHUNK_ADDRESS = 0x10000,
+	SECOND_CHUNK_ADDRESS = 0x20000,
+	MAX_CYCLE_LENGTH = 16,
+};
+
+// clang-format off
+static const uint32 g_elementSizes[0x10] =
+{
+	4, 2, 1, 0,  //S-32, S-16, S-8
+	8, 4, 2, 0,  //V2-32, V2-16, V2-8
+	12, 6, 3, 0, //V3-32, V3-16, V3-8
+	16, 8, 4, 2, //V4-32, V4-16, V4-8, V4-5
+};
+// clang-format on
+
+CUnpackTest::CUnpackTest()
+    : m_ram(reinterpret_cast<uint8*>(framework_aligned_alloc(PS2::EE_RAM_SIZE, 0x10)))
+    , m_spr(reinterpret_cast<uint8*>(framework_aligned_alloc(PS2::EE_SPR_SIZE, 0x10)))
+    , m_vuMem(reinterpret_cast<uint8*>(framework_aligned_alloc(PS2::VUMEM0SIZE, 0x10)))
+    , m_microMem(reinterpret_cast<uint8*>(framework_aligned_alloc(PS2::MICROMEM0SIZE, 0x10)))
+    , m_initialVuMem(new uint8[PS2::VUMEM0SIZE])
+    , m_referenceVuMem(new uint8[PS2::VUMEM0SIZE])
+    , m_ee(MEMORYMAP_ENDIAN_LSBF)
+    , m_dmac(m_ram, m_spr, m_vuMem, nullptr, m_ee)
+    , m_gif(m_gs, m_dmac, m_ram, m_spr)
+    , m_vpu(0, CVpu::VPUINIT(m_microMem, m_vuMem, nullptr), m_gif, m_intc, m_ram, m_spr)
+{
+}
+
+CUnpackTest::~CUnpackTest()
+{
+	framework_aligned_free(m_ram);
+	framework_aligned_free(m_spr);
+	framework_aligned_free(m_vuMem);
+	framework_aligned_free(m_microMem);
+	delete[] m_initialVuMem;
+	delete[] m_referenceVuMem;
+}
+
+void CUnpackTest::Execute()
+{
+	const uint32 vuMemQwordCount = PS2::VUMEM0SIZE / 0x10;
+
+	for(uint32 cl = 1; cl <= MAX_CYCLE_LENGTH; cl++)
+	{
+		for(uint32 wl = 1; wl <= MAX_CYCLE_LENGTH; wl++)
+		{
+			//A new VIF for every cycle configuration keeps the amount of compiled routines low
+			auto vif = std::make_unique<CTestVif>(m_vpu, m_intc, m_ram, m_spr);
+			for(uint32 dataType = 0; dataType < 0x10; dataType++)
+			{
+				if(g_elementSizes[dataType] == 0) continue;
+				for(uint32 usn = 0; usn < 2; usn++)
+				{
+					for(uint32 mode = 0; mode < 3; mode++)
+					{
+						for(uint32 useMask = 0; useMask < 2; useMask++)
+						{
+							for(uint32 wrap = 0; wrap < 2; wrap++)
+							{
+								CTestVif::UNPACK_PARAMS params;
+								params.dataType = static_cast<uint8>(dataType);
+								params.usn = (usn != 0);
+								params.mode = static_cast<uint8>(mode);
+								params.useMask = (useMask != 0);
+								params.mask = params.useMask ? m_random() : 0;
+								params.cl = cl;
+								params.wl = wl;
+								params.num = static_cast<uint8>(m_random());
+								params.dstAddr = (m_random() % 8);
+								if(wrap)
+								{
+									params.dstAddr = vuMemQwordCount - 1 - params.dstAddr;
+								}
+								for(uint32 i = 0; i < 4; i++)
+								{
+									params.row[i] = m_random();
+									params.col[i] = m_random();
+								}
+								TestUnpack(*vif, params);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void CUnpackTest::RunUnpack(CTestVif& vif, const CTestVif::UNPACK_PARAMS& params, const SOURCE& source, bool compiled)
+{
+	memcpy(m_vuMem, m_initialVuMem, PS2::VUMEM0SIZE);
+	vif.SetupUnpack(params);
+	vif.SetSource(FIRST_CHUNK_ADDRESS, source.firstChunkSize);
+	vif.SkipSource(source.headerSize);
+	vif.ExecuteUnpack(compiled);
+	if(vif.IsUnpackWaiting() && (source.totalSize != source.firstChunkSize))
+	{
+		vif.SetSource(SECOND_CHUNK_ADDRESS, source.totalSize - source.firstChunkSize);
+		vif.ExecuteUnpack(compiled);
+	}
+}
+
+void CUnpackTest::TestUnpack(CTestVif& vif, const CTestVif::UNPACK_PARAMS& params)
+{
+	uint32 writeCount = (params.num == 0) ? 256 : params.num;
+
+	//Enough data for a read on every write, anything left over stays in the source
+	SOURCE source;
+	source.headerSize = (m_random() % 4) * 4;
+	source.totalSize = (source.headerSize + (writeCount * g_elementSizes[params.dataType]) + 0xF) & ~0xF;
+	source.firstChunkSize = ((m_random() % (source.totalSize / 0x10)) + 1) * 0x10;
+
+	for(uint32 i = 0; i < source.totalSize; i++)
+	{
+		uint32 address = (i < source.firstChunkSize) ? (FIRST_CHUNK_ADDRESS + i) : (SECOND_CHUNK_ADDRESS + i - source.firstChunkSize);
+		m_ram[address] = static_cast<uint8>(m_random());
+	}
+
+	for(uint32 i = 0; i < PS2::VUMEM0SIZE; i++)
+	{
+		m_initialVuMem[i] = static_cast<uint8>(m_random());
+	}
+
+	RunUnpack(vif, params, source, false);
+	TEST_VERIFY(!vif.IsUnpackWaiting());
+	memcpy(m_referenceVuMem, m_vuMem, PS2::VUMEM0SIZE);
+	uint32 referenceRow[4];
+	vif.GetRow(referenceRow);
+	uint8 referenceNum = vif.GetNum();
+	uint32 referenceRemainingBytes = vif.GetRemainingSourceBytes();
+
+	RunUnpack(vif, params, source, true);
+	TEST_VERIFY(!vif.IsUnpackWaiting());
+	TEST_VERIFY(memcmp(m_vuMem, m_referenceVuMem, PS2::VUMEM0SIZE) == 0);
+	uint32 row[4];
+	vif.GetRow(row);
+	TEST_VERIFY(memcmp(row, referenceRow, sizeof(row)) == 0);
+	TEST_VERIFY(vif.GetNum() == referenceNum);
+	TEST_VERIFY(vif.GetRemainingSourceBytes() == referenceRemainingBytes);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <random>
+#include "AlignedAlloc.h"
+#include "Test.h"
+#include "MIPS.h"
+#include "ee/DMAC.h"
+#include "ee/GIF.h"
+#include "ee/INTC.h"
+#include "ee/Vpu.h"
+#include "TestVif.h"
+
+class CUnpackTest : public CTest
+{
+public:
+	CUnpackTest();
+	virtual ~CUnpackTest();
+
+	void Execute() override;
+
+	void* operator new(size_t allocSize)
+	{
+		return framework_aligned_alloc(allocSize, 0x10);
+	}
+
+	void operator delete(void* ptr)
+	{
+		return framework_aligned_free(ptr);
+	}
+
+private:
+	struct SOURCE
+	{
+		uint32 headerSize = 0;
+		uint32 firstChunkSize = 0;
+		uint32 totalSize = 0;
+	};
+
+	void RunUnpack(CTestVif&, const CTestVif::UNPACK_PARAMS&, const SOURCE&, bool);
+	void TestUnpack(CTestVif&, const CTestVif::UNPACK_PARAMS&);
+
+	uint8* m_ram = nullptr;
+	uint8* m_spr = nullptr;
+	uint8* m_vuMem = nullptr;
+	uint8* m_microMem = nullptr;
+	uint8* m_initialVuMem = nullptr;
+	uint8* m_referenceVuMem = nullptr;
+	CMIPS m_ee;
+	CGSHandler* m_gs = nullptr;
+	CINTC m_intc;
+	CDMAC m_dmac;
+	CGIF m_gif;
+	CVpu m_vpu;
+	std::mt19937 m_random;
+};